@@ -56,6 +56,9 @@ let package = Package(
             cSettings: [
                 .define("MARKETING_VERSION", to: "\"\(ProjectSettings.marketingVersion)\""),
                 .define("NS_BLOCK_ASSERTIONS", to: "1", .when(configuration: .release))
+            ],
+            linkerSettings: [
+                .linkedLibrary("z")
             ]
         ),
         .target(
@@ -92,6 +95,9 @@ let package = Package(
         .testTarget(
             name: "SRGAnalyticsTests",
             dependencies: ["SRGAnalytics", "SRGAnalyticsMediaPlayer", "SRGAnalyticsDataProvider"],
+            resources: [
+                .copy("Resources")
+            ],
             cSettings: [
                 .headerSearchPath("Private")
             ]
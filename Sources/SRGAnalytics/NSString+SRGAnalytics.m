@@ -6,24 +6,62 @@
 
 #import "NSString+SRGAnalytics.h"
 
+#import "SRGAnalyticsStringFormatting.h"
+
+#import <os/lock.h>
+
 @implementation NSString (SRGAnalytics)
 
 - (NSString *)srg_comScoreFormattedString
 {
-    // Remove accentuated characters
-    NSLocale *posixLocale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
-    NSString *normalizedString = [self.lowercaseString stringByFoldingWithOptions:NSDiacriticInsensitiveSearch locale:posixLocale];
-    
     // See rules at https://confluence.srg.beecollaboration.com/display/SRGPLAY/Measurement+of+SRG+Player+Apps#MeasurementofSRGPlayerApps-SupportedCharacters
-    NSCharacterSet *andSet = [NSCharacterSet characterSetWithCharactersInString:@"+&"];
-    normalizedString = [[normalizedString componentsSeparatedByCharactersInSet:andSet] componentsJoinedByString:@"and"];
+    static SRGAnalyticsFormattingCache *s_cache;
+    static os_unfair_lock s_lock = OS_UNFAIR_LOCK_INIT;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_cache = SRGAnalyticsFormattingCacheCreate();
+    });
+    
+    // Copy the UTF-8 bytes instead of using a C string, which would be truncated at the first embedded null character
+    NSUInteger inputLength = [self lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    
+    // Page titles and levels are short, use the stack in most cases
+    char inputStackBuffer[128];
+    char *input = (inputLength <= sizeof(inputStackBuffer)) ? inputStackBuffer : malloc(inputLength);
+    if (! input) {
+        return nil;
+    }
+    [self getBytes:input maxLength:inputLength usedLength:&inputLength encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, self.length) remainingRange:NULL];
+    
+    char outputStackBuffer[512];
+    size_t outputCapacity = SRGAnalyticsFormattedStringMaximumLength(inputLength);
+    char *output = (outputCapacity <= sizeof(outputStackBuffer)) ? outputStackBuffer : malloc(outputCapacity);
+    if (! output) {
+        if (input != inputStackBuffer) {
+            free(input);
+        }
+        return nil;
+    }
     
-    // Squash all non-alphanumeric characters as a single hyphen
-    NSRegularExpression *regularExpression = [NSRegularExpression regularExpressionWithPattern:@"[^a-z0-9]+" options:0 error:NULL];
-    normalizedString = [regularExpression stringByReplacingMatchesInString:normalizedString options:0 range:NSMakeRange(0, normalizedString.length) withTemplate:@"-"];
+    size_t outputLength = 0;
+    if (s_cache) {
+        os_unfair_lock_lock(&s_lock);
+        outputLength = SRGAnalyticsFormattingCacheFormatString(s_cache, input, inputLength, output, outputCapacity, NULL);
+        os_unfair_lock_unlock(&s_lock);
+    }
+    else {
+        outputLength = SRGAnalyticsFormatString(input, inputLength, output, outputCapacity);
+    }
     
-    // Trim hyphens at both ends, if any
-    return [normalizedString stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"-"]];
+    // The output only contains ASCII characters
+    NSString *formattedString = [[NSString alloc] initWithBytes:output length:outputLength encoding:NSASCIIStringEncoding];
+    if (input != inputStackBuffer) {
+        free(input);
+    }
+    if (output != outputStackBuffer) {
+        free(output);
+    }
+    return formattedString;
 }
 
 @end
@@ -0,0 +1,36 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventSink.h"
+
+@import TCServerSide_noIDFA;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Sink sending events to Commanders Act.
+ */
+@interface SRGAnalyticsCommandersActEventSink : NSObject <SRGAnalyticsEventSink>
+
+/**
+ *  Create a sink sending events through the specified server-side instance.
+ */
+- (instancetype)initWithServerSide:(ServerSide *)serverSide NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The server-side instance used.
+ */
+@property (nonatomic, readonly) ServerSide *serverSide;
+
+@end
+
+@interface SRGAnalyticsCommandersActEventSink (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
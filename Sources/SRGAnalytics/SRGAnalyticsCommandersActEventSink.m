@@ -0,0 +1,99 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsCommandersActEventSink.h"
+
+@interface SRGAnalyticsCommandersActEventSink ()
+
+@property (nonatomic) ServerSide *serverSide;
+
+@end
+
+@implementation SRGAnalyticsCommandersActEventSink
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithServerSide:(ServerSide *)serverSide
+{
+    if (self = [super init]) {
+        self.serverSide = serverSide;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithServerSide:[[ServerSide alloc] initWithSiteID:0 andSourceKey:@""]];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark SRGAnalyticsEventSink protocol
+
+// The Commanders Act SDK manages retries itself once an event has been executed
+- (void)deliverPayloads:(NSArray<NSDictionary<NSString *, id> *> *)payloads completion:(void (^)(SRGAnalyticsEventSinkDeliveryResult))completion
+{
+    for (NSDictionary<NSString *, id> *payload in payloads) {
+        TCEvent *event = [self commandersActEventForPayload:payload];
+        if (event) {
+            [self.serverSide execute:event];
+        }
+    }
+    completion(SRGAnalyticsEventSinkDeliveryResultSuccess);
+}
+
+#pragma mark Events
+
+// Payloads might have been replayed from a journal written by a previous version, check them
+- (TCEvent *)commandersActEventForPayload:(NSDictionary<NSString *, id> *)payload
+{
+    NSString *name = payload[SRGAnalyticsPayloadNameKey];
+    if (! [name isKindOfClass:NSString.class]) {
+        return nil;
+    }
+    
+    TCEvent *event = nil;
+    if ([payload[SRGAnalyticsPayloadKindKey] isEqual:SRGAnalyticsPayloadKindPageView]) {
+        NSString *pageType = payload[SRGAnalyticsPayloadPageTypeKey];
+        if (! [pageType isKindOfClass:NSString.class]) {
+            return nil;
+        }
+        
+        TCPageViewEvent *pageViewEvent = [[TCPageViewEvent alloc] initWithType:pageType];
+        pageViewEvent.pageName = name;
+        event = pageViewEvent;
+    }
+    else {
+        event = [[TCCustomEvent alloc] initWithName:name];
+    }
+    
+    NSDictionary<NSString *, NSString *> *labels = payload[SRGAnalyticsPayloadLabelsKey];
+    if ([labels isKindOfClass:NSDictionary.class]) {
+        [labels enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull value, BOOL * _Nonnull stop) {
+            if ([value isKindOfClass:NSString.class]) {
+                [event addAdditionalProperty:key withStringValue:value];
+            }
+        }];
+    }
+    
+    return event;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; serverSide = %@>",
+            self.class,
+            self,
+            self.serverSide];
+}
+
+@end
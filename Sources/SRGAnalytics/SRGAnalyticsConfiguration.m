@@ -34,6 +34,12 @@ SRGAnalyticsBusinessUnitIdentifier const SRGAnalyticsBusinessUnitIdentifierSWI =
         self.sourceKey = sourceKey;
         self.siteName = siteName;
         self.centralized = YES;
+        self.requestInterceptionEnabled = YES;
+        self.eventQueueCapacity = 1024;
+        self.eventQueueOverflowPolicy = SRGAnalyticsEventQueueOverflowPolicyDropOldest;
+        self.eventDeliveryMaximumPendingCount = 20;
+        self.pageViewDebounceInterval = 0.;
+        self.eventSamplingPolicies = @{};
     }
     return self;
 }
@@ -67,6 +73,18 @@ SRGAnalyticsBusinessUnitIdentifier const SRGAnalyticsBusinessUnitIdentifierSWI =
     configuration.siteName = self.siteName;
     configuration.centralized = self.centralized;
     configuration.unitTesting = self.unitTesting;
+    configuration.requestInterceptionEnabled = self.requestInterceptionEnabled;
+    configuration.eventQueueCapacity = self.eventQueueCapacity;
+    configuration.eventQueueOverflowPolicy = self.eventQueueOverflowPolicy;
+    configuration.eventDeliveryDelay = self.eventDeliveryDelay;
+    configuration.eventDeliveryMaximumPendingCount = self.eventDeliveryMaximumPendingCount;
+    configuration.pageViewDebounceInterval = self.pageViewDebounceInterval;
+    configuration.startupDeferred = self.startupDeferred;
+    configuration.mediaHeartbeatDeltaEncodingEnabled = self.mediaHeartbeatDeltaEncodingEnabled;
+    configuration.eventSamplingPolicies = self.eventSamplingPolicies;
+    configuration.samplingIdentifier = self.samplingIdentifier;
+    configuration.metricsEnabled = self.metricsEnabled;
+    configuration.journalDirectoryURL = self.journalDirectoryURL;
     return configuration;
 }
 
@@ -0,0 +1,36 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Delta-encode the labels of successive records belonging to a same session (@see `SRGAnalyticsLabelsDelta.h` for
+ *  the wire format). Not thread-safe.
+ */
+@interface SRGAnalyticsDeltaEncoder : NSObject
+
+/**
+ *  The session identifier, generated when the encoder is created.
+ */
+@property (nonatomic, readonly, copy) NSString *sessionIdentifier;
+
+/**
+ *  Encode the labels of the next record of the session. Key frames contain all labels. Other records only contain
+ *  labels which changed since the previous record. The first record is always a key frame.
+ */
+- (NSDictionary<NSString *, NSString *> *)encodedLabelsWithLabels:(NSDictionary<NSString *, NSString *> *)labels keyFrame:(BOOL)keyFrame;
+
+/**
+ *  Encode the next record as a key frame, whatever is requested. Must be called when a record of the session is lost,
+ *  so that the following records do not refer to a base the receiver never got.
+ */
+- (void)setNeedsKeyFrame;
+
+@end
+
+NS_ASSUME_NONNULL_END
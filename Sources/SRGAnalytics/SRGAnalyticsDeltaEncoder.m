@@ -0,0 +1,94 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsDeltaEncoder.h"
+
+#import "SRGAnalyticsLabelsDelta.h"
+
+@interface SRGAnalyticsDeltaEncoder ()
+
+@property (nonatomic, copy) NSString *sessionIdentifier;
+@property (nonatomic) uint64_t sequence;
+@property (nonatomic, copy) NSDictionary<NSString *, NSString *> *previousLabels;
+@property (nonatomic) BOOL needsKeyFrame;
+
+@end
+
+@implementation SRGAnalyticsDeltaEncoder
+
+#pragma mark Object lifecycle
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        self.sessionIdentifier = NSUUID.UUID.UUIDString.lowercaseString;
+    }
+    return self;
+}
+
+#pragma mark Encoding
+
+- (NSDictionary<NSString *, NSString *> *)encodedLabelsWithLabels:(NSDictionary<NSString *, NSString *> *)labels keyFrame:(BOOL)keyFrame
+{
+    NSDictionary<NSString *, NSString *> *previousLabels = self.previousLabels;
+    
+    NSMutableDictionary<NSString *, NSString *> *encodedLabels = nil;
+    if (keyFrame || ! previousLabels || self.needsKeyFrame) {
+        encodedLabels = labels.mutableCopy;
+    }
+    else {
+        encodedLabels = [NSMutableDictionary dictionary];
+        [labels enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull value, BOOL * _Nonnull stop) {
+            NSString *previousValue = previousLabels[key];
+            if (! previousValue || ! [value isEqualToString:previousValue]) {
+                encodedLabels[key] = value;
+            }
+        }];
+        
+        NSMutableArray<NSString *> *removedKeys = nil;
+        for (NSString *key in previousLabels) {
+            if (! labels[key]) {
+                if (! removedKeys) {
+                    removedKeys = [NSMutableArray array];
+                }
+                [removedKeys addObject:key];
+            }
+        }
+        if (removedKeys) {
+            [removedKeys sortUsingSelector:@selector(compare:)];
+            encodedLabels[@SRGAnalyticsLabelsDeltaRemovedKey] = [removedKeys componentsJoinedByString:@","];
+        }
+        
+        encodedLabels[@SRGAnalyticsLabelsDeltaBaseKey] = @(self.sequence - 1).stringValue;
+    }
+    
+    encodedLabels[@SRGAnalyticsLabelsDeltaSessionKey] = self.sessionIdentifier;
+    encodedLabels[@SRGAnalyticsLabelsDeltaSequenceKey] = @(self.sequence).stringValue;
+    
+    self.sequence += 1;
+    self.previousLabels = labels;
+    self.needsKeyFrame = NO;
+    
+    return encodedLabels.copy;
+}
+
+- (void)setNeedsKeyFrame
+{
+    self.needsKeyFrame = YES;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; sessionIdentifier = %@; sequence = %@>",
+            self.class,
+            self,
+            self.sessionIdentifier,
+            @(self.sequence)];
+}
+
+@end
@@ -0,0 +1,35 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Reconstruct full labels from delta-encoded ones (@see `SRGAnalyticsLabelsDelta.h`). Not thread-safe.
+ */
+@interface SRGAnalyticsDeltaExpander : NSObject
+
+/**
+ *  Create an expander able to follow up to `sessionCapacity` sessions at the same time.
+ */
+- (instancetype)initWithSessionCapacity:(NSUInteger)sessionCapacity;
+
+/**
+ *  Return the full labels of a record. Labels which are not delta-encoded are returned as is. Returns `nil` if the
+ *  record the labels are based on is unknown, or if the labels are malformed.
+ */
+- (nullable NSDictionary<NSString *, NSString *> *)expandedLabelsWithLabels:(NSDictionary<NSString *, NSString *> *)labels;
+
+@end
+
+@interface SRGAnalyticsDeltaExpander (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
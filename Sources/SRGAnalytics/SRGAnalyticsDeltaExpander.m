@@ -0,0 +1,88 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsDeltaExpander.h"
+
+#import "SRGAnalyticsLabelsDelta.h"
+
+static void SRGAnalyticsDeltaExpanderAddLabel(const char *key, const char *value, void *context);
+
+@interface SRGAnalyticsDeltaExpander () {
+@private
+    SRGAnalyticsLabelsDeltaExpander *_expander;
+}
+
+@end
+
+@implementation SRGAnalyticsDeltaExpander
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithSessionCapacity:(NSUInteger)sessionCapacity
+{
+    if (self = [super init]) {
+        _expander = SRGAnalyticsLabelsDeltaExpanderCreate(sessionCapacity);
+        if (! _expander) {
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    SRGAnalyticsLabelsDeltaExpanderDestroy(_expander);
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithSessionCapacity:1];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Expansion
+
+- (NSDictionary<NSString *, NSString *> *)expandedLabelsWithLabels:(NSDictionary<NSString *, NSString *> *)labels
+{
+    NSMutableDictionary<NSString *, NSString *> *expandedLabels = [NSMutableDictionary dictionaryWithCapacity:labels.count];
+    
+    @autoreleasepool {
+        NSUInteger count = labels.count;
+        SRGAnalyticsLabel *cLabels = malloc((count + 1) * sizeof(SRGAnalyticsLabel));
+        if (! cLabels) {
+            return nil;
+        }
+        
+        __block NSUInteger index = 0;
+        [labels enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull value, BOOL * _Nonnull stop) {
+            cLabels[index++] = (SRGAnalyticsLabel){ key.UTF8String, value.UTF8String };
+        }];
+        
+        SRGAnalyticsLabelsDeltaStatus status = SRGAnalyticsLabelsDeltaExpanderExpand(_expander, cLabels, count, SRGAnalyticsDeltaExpanderAddLabel, (__bridge void *)expandedLabels);
+        free(cLabels);
+        
+        if (status != SRGAnalyticsLabelsDeltaStatusUnencoded && status != SRGAnalyticsLabelsDeltaStatusExpanded) {
+            return nil;
+        }
+    }
+    
+    return expandedLabels.copy;
+}
+
+@end
+
+#pragma mark Static functions
+
+static void SRGAnalyticsDeltaExpanderAddLabel(const char *key, const char *value, void *context)
+{
+    NSMutableDictionary<NSString *, NSString *> *labels = (__bridge NSMutableDictionary *)context;
+    labels[@(key)] = @(value);
+}
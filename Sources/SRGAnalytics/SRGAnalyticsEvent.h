@@ -0,0 +1,105 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsDeltaEncoder.h"
+#import "SRGAnalyticsLabels.h"
+#import "SRGAnalyticsLabelsSnapshot.h"
+#import "SRGAnalyticsPageViewLabels.h"
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Event kinds.
+ */
+typedef NS_ENUM(NSInteger, SRGAnalyticsEventKind) {
+    SRGAnalyticsEventKindPageView = 0,
+    SRGAnalyticsEventKindCustom
+};
+
+/**
+ *  Immutable record of an event, as captured when it was recorded. All information required to build the labels
+ *  eventually sent is captured, so that labels can be built later on a background thread.
+ */
+@interface SRGAnalyticsEvent : NSObject
+
+/**
+ *  Create a page view event record.
+ */
++ (SRGAnalyticsEvent *)pageViewEventWithTitle:(NSString *)title
+                                         type:(NSString *)type
+                                       levels:(nullable NSArray<NSString *> *)levels
+                                       labels:(nullable SRGAnalyticsPageViewLabels *)labels
+                         fromPushNotification:(BOOL)fromPushNotification;
+
+/**
+ *  Create a custom event record. Labels can be supplied as a labels object, a dictionary or both (in which case
+ *  dictionary entries are added to labels object entries).
+ */
++ (SRGAnalyticsEvent *)customEventWithName:(NSString *)name
+                                    labels:(nullable SRGAnalyticsLabels *)labels
+                          labelsDictionary:(nullable NSDictionary<NSString *, NSString *> *)labelsDictionary;
+
+/**
+ *  The event kind.
+ */
+@property (nonatomic, readonly) SRGAnalyticsEventKind kind;
+
+/**
+ *  The event name (the page title for page views).
+ */
+@property (nonatomic, readonly, copy) NSString *name;
+
+/**
+ *  The page type and levels (page views only).
+ */
+@property (nonatomic, readonly, copy, nullable) NSString *pageType;
+@property (nonatomic, readonly, copy, nullable) NSArray<NSString *> *levels;
+@property (nonatomic, readonly) BOOL fromPushNotification;
+
+/**
+ *  Labels associated with the event.
+ */
+@property (nonatomic, readonly, nullable) SRGAnalyticsLabels *labels;
+@property (nonatomic, readonly, copy, nullable) NSDictionary<NSString *, NSString *> *labelsDictionary;
+
+/**
+ *  Default labels at the time the event was recorded.
+ */
+@property (nonatomic, nullable) SRGAnalyticsLabelsSnapshot *labelsSnapshot;
+
+/**
+ *  The unit testing identifier at the time the event was recorded, if any.
+ */
+@property (nonatomic, copy, nullable) NSString *unitTestingIdentifier;
+
+/**
+ *  When set, the encoder with which labels are delta-encoded once built. Delta records are only produced when
+ *  `deltaKeyFrame` is `NO`.
+ */
+@property (nonatomic, nullable) SRGAnalyticsDeltaEncoder *deltaEncoder;
+@property (nonatomic, getter=isDeltaKeyFrame) BOOL deltaKeyFrame;
+
+/**
+ *  The number of events the event stands for when sampled, 0 if the event is not subject to sampling.
+ */
+@property (nonatomic) double samplingWeight;
+
+/**
+ *  The date at which the event was recorded.
+ */
+@property (nonatomic, readonly) NSDate *date;
+
+@end
+
+@interface SRGAnalyticsEvent (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
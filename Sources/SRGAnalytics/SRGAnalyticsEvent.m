@@ -0,0 +1,85 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEvent.h"
+
+@interface SRGAnalyticsEvent ()
+
+@property (nonatomic) SRGAnalyticsEventKind kind;
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, copy) NSString *pageType;
+@property (nonatomic, copy) NSArray<NSString *> *levels;
+@property (nonatomic) BOOL fromPushNotification;
+@property (nonatomic) SRGAnalyticsLabels *labels;
+@property (nonatomic, copy) NSDictionary<NSString *, NSString *> *labelsDictionary;
+@property (nonatomic) NSDate *date;
+
+@end
+
+@implementation SRGAnalyticsEvent
+
+#pragma mark Class methods
+
++ (SRGAnalyticsEvent *)pageViewEventWithTitle:(NSString *)title
+                                         type:(NSString *)type
+                                       levels:(NSArray<NSString *> *)levels
+                                       labels:(SRGAnalyticsPageViewLabels *)labels
+                         fromPushNotification:(BOOL)fromPushNotification
+{
+    SRGAnalyticsEvent *event = [[SRGAnalyticsEvent alloc] initWithKind:SRGAnalyticsEventKindPageView name:title];
+    event.pageType = type;
+    event.levels = levels;
+    event.labels = labels.copy;
+    event.fromPushNotification = fromPushNotification;
+    return event;
+}
+
++ (SRGAnalyticsEvent *)customEventWithName:(NSString *)name
+                                    labels:(SRGAnalyticsLabels *)labels
+                          labelsDictionary:(NSDictionary<NSString *, NSString *> *)labelsDictionary
+{
+    SRGAnalyticsEvent *event = [[SRGAnalyticsEvent alloc] initWithKind:SRGAnalyticsEventKindCustom name:name];
+    event.labels = labels.copy;
+    event.labelsDictionary = labelsDictionary;
+    return event;
+}
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithKind:(SRGAnalyticsEventKind)kind name:(NSString *)name
+{
+    if (self = [super init]) {
+        self.kind = kind;
+        self.name = name;
+        self.date = NSDate.date;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithKind:SRGAnalyticsEventKindCustom name:@""];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; kind = %@; name = %@; date = %@>",
+            self.class,
+            self,
+            @(self.kind),
+            self.name,
+            self.date];
+}
+
+@end
@@ -0,0 +1,71 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Factor applied to the batching interval when the window is extended.
+ */
+OBJC_EXPORT const double SRGAnalyticsEventBatcherExtendedWindowFactor;
+
+/**
+ *  Collect objects and hand them over in batches, either when a time window elapses (starting when the first object
+ *  of a batch is added) or when a maximum batch size has been reached.
+ *
+ *  @discussion Not thread-safe. All methods must be called from the queue provided at initialization, on which the
+ *              handler is called as well.
+ */
+@interface SRGAnalyticsEventBatcher<ObjectType> : NSObject
+
+/**
+ *  Create a batcher delivering batches to the specified handler, called on the provided serial queue.
+ */
+- (instancetype)initWithQueue:(dispatch_queue_t)queue handler:(void (^)(NSArray<ObjectType> *objects))handler NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The time window during which objects are collected. If set to 0 (default), no batching is made and objects are
+ *  handed over as soon as they are added.
+ */
+@property (nonatomic) NSTimeInterval interval;
+
+/**
+ *  The maximum number of objects in a batch. A batch is handed over as soon as it reaches this size. Default value
+ *  is 20.
+ */
+@property (nonatomic) NSUInteger maximumCount;
+
+/**
+ *  Set to `YES` to extend the time window by `SRGAnalyticsEventBatcherExtendedWindowFactor`, e.g. when network
+ *  access is expensive. Applies to batches started afterwards.
+ */
+@property (nonatomic, getter=isWindowExtended) BOOL windowExtended;
+
+/**
+ *  The number of objects waiting in the current batch.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ *  Add an object to the current batch.
+ */
+- (void)addObject:(ObjectType)object;
+
+/**
+ *  Immediately hand over the current batch, if not empty.
+ */
+- (void)flush;
+
+@end
+
+@interface SRGAnalyticsEventBatcher (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,118 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventBatcher.h"
+
+const double SRGAnalyticsEventBatcherExtendedWindowFactor = 4.;
+
+@interface SRGAnalyticsEventBatcher ()
+
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic, copy) void (^handler)(NSArray *objects);
+
+@property (nonatomic) NSMutableArray *objects;
+@property (nonatomic) dispatch_source_t timer;
+
+@end
+
+@implementation SRGAnalyticsEventBatcher
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue handler:(void (^)(NSArray * _Nonnull))handler
+{
+    if (self = [super init]) {
+        self.queue = queue;
+        self.handler = handler;
+        self.objects = [NSMutableArray array];
+        self.maximumCount = 20;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithQueue:dispatch_get_main_queue() handler:^(NSArray *objects) {}];
+}
+
+#pragma clang diagnostic pop
+
+- (void)dealloc
+{
+    self.timer = nil;
+}
+
+#pragma mark Getters and setters
+
+- (void)setTimer:(dispatch_source_t)timer
+{
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+    }
+    _timer = timer;
+}
+
+- (NSUInteger)count
+{
+    return self.objects.count;
+}
+
+#pragma mark Batching
+
+- (void)addObject:(id)object
+{
+    [self.objects addObject:object];
+
+    if (self.interval <= 0. || self.objects.count >= MAX(self.maximumCount, 1)) {
+        [self flush];
+    }
+    else if (! self.timer) {
+        NSTimeInterval interval = self.windowExtended ? self.interval * SRGAnalyticsEventBatcherExtendedWindowFactor : self.interval;
+
+        // A leeway lets the system coalesce the wake-up with other activity
+        dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.queue);
+        dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)), DISPATCH_TIME_FOREVER, (uint64_t)(interval * 0.1 * NSEC_PER_SEC));
+
+        __weak __typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(timer, ^{
+            [weakSelf flush];
+        });
+        dispatch_resume(timer);
+        self.timer = timer;
+    }
+}
+
+- (void)flush
+{
+    self.timer = nil;
+
+    if (self.objects.count == 0) {
+        return;
+    }
+
+    NSArray *objects = self.objects.copy;
+    [self.objects removeAllObjects];
+    self.handler(objects);
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; interval = %@; maximumCount = %@; windowExtended = %@; count = %@>",
+            self.class,
+            self,
+            @(self.interval),
+            @(self.maximumCount),
+            self.windowExtended ? @"YES" : @"NO",
+            @(self.count)];
+}
+
+@end
@@ -0,0 +1,101 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  A record of the journal, wrapping a payload.
+ */
+@interface SRGAnalyticsEventJournalRecord : NSObject
+
+/**
+ *  Create a record which is not persisted to any journal.
+ */
+- (instancetype)initWithPayload:(NSDictionary<NSString *, id> *)payload NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The record payload.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, id> *payload;
+
+/**
+ *  Return `YES` iff the record has been persisted to a journal, and has not been acknowledged yet.
+ */
+@property (nonatomic, readonly, getter=isPersisted) BOOL persisted;
+
+@end
+
+@interface SRGAnalyticsEventJournalRecord (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/**
+ *  Persistent journal of event payloads (JSON-serializable dictionaries), surviving process kills and power loss.
+ *  Payloads are kept until acknowledged, and available as pending records when the journal is opened again.
+ *
+ *  @discussion Not thread-safe. A journal must be used from a single serial queue. Records are delivered at least
+ *              once, i.e. a record whose acknowledgement did not reach the disk because of a power loss is available
+ *              again when the journal is opened again.
+ */
+@interface SRGAnalyticsEventJournal : NSObject
+
+/**
+ *  The directory where the journal used by the tracker is stored.
+ */
+@property (class, nonatomic, readonly) NSURL *defaultDirectoryURL;
+
+/**
+ *  Open the journal stored at the specified location (created if needed). Returns `nil` if the journal could
+ *  not be opened.
+ */
+- (nullable instancetype)initWithDirectoryURL:(NSURL *)directoryURL NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Records which were persisted but not acknowledged when the journal was opened, in the order they were appended.
+ */
+@property (nonatomic, readonly) NSArray<SRGAnalyticsEventJournalRecord *> *replayedRecords;
+
+/**
+ *  Append a payload to the journal, returning the corresponding record. If the payload could not be persisted, an
+ *  unpersisted record is returned.
+ */
+- (SRGAnalyticsEventJournalRecord *)recordByAppendingPayload:(NSDictionary<NSString *, id> *)payload;
+
+/**
+ *  Acknowledge a record, which will not be replayed anymore. Does nothing if the record is not persisted.
+ */
+- (void)acknowledgeRecord:(SRGAnalyticsEventJournalRecord *)record;
+
+/**
+ *  The number of records which have not been acknowledged yet.
+ */
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+/**
+ *  The number of records discarded without having been acknowledged because the journal was full. A warning is logged
+ *  when this happens.
+ */
+@property (nonatomic, readonly) NSUInteger evictedCount;
+
+/**
+ *  Flush pending changes to disk. Changes are periodically flushed, but this method can be called when the process
+ *  is likely to be suspended or terminated.
+ */
+- (void)synchronize;
+
+@end
+
+@interface SRGAnalyticsEventJournal (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
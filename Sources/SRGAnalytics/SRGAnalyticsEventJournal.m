@@ -0,0 +1,225 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventJournal.h"
+
+#import "SRGAnalyticsJournal.h"
+#import "SRGAnalyticsLogger.h"
+#import "SRGAnalyticsMetrics+Private.h"
+
+@interface SRGAnalyticsEventJournalRecord ()
+
+@property (nonatomic) NSDictionary<NSString *, id> *payload;
+@property (nonatomic) SRGAnalyticsJournalToken token;
+
+@end
+
+@interface SRGAnalyticsEventJournal () {
+@private
+    SRGAnalyticsJournal *_journal;
+    NSUInteger _reportedEvictedCount;
+}
+
+@property (nonatomic) NSArray<SRGAnalyticsEventJournalRecord *> *replayedRecords;
+
+@end
+
+static void SRGAnalyticsEventJournalCollectRecord(SRGAnalyticsJournalToken token, const void *bytes, size_t length, void *context)
+{
+    NSMutableArray<SRGAnalyticsEventJournalRecord *> *records = (__bridge NSMutableArray *)context;
+
+    NSData *data = [NSData dataWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO];
+    id payload = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+    if (! [payload isKindOfClass:NSDictionary.class]) {
+        return;
+    }
+
+    SRGAnalyticsEventJournalRecord *record = [[SRGAnalyticsEventJournalRecord alloc] initWithPayload:payload];
+    record.token = token;
+    [records addObject:record];
+}
+
+@implementation SRGAnalyticsEventJournalRecord
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithPayload:(NSDictionary<NSString *, id> *)payload
+{
+    if (self = [super init]) {
+        self.payload = payload;
+        self.token = SRGAnalyticsJournalTokenInvalid;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithPayload:@{}];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Getters and setters
+
+- (BOOL)isPersisted
+{
+    return self.token != SRGAnalyticsJournalTokenInvalid;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; persisted = %@; payload = %@>",
+            self.class,
+            self,
+            self.persisted ? @"YES" : @"NO",
+            self.payload];
+}
+
+@end
+
+@implementation SRGAnalyticsEventJournal
+
+#pragma mark Class methods
+
++ (NSURL *)defaultDirectoryURL
+{
+#if TARGET_OS_TV
+    // tvOS applications can only write to their caches directory
+    NSSearchPathDirectory searchPathDirectory = NSCachesDirectory;
+#else
+    NSSearchPathDirectory searchPathDirectory = NSApplicationSupportDirectory;
+#endif
+    NSURL *baseURL = [NSFileManager.defaultManager URLsForDirectory:searchPathDirectory inDomains:NSUserDomainMask].firstObject;
+    return [[baseURL URLByAppendingPathComponent:@"ch.srgssr.analytics"] URLByAppendingPathComponent:@"Journal"];
+}
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL
+{
+    if (self = [super init]) {
+        NSError *error = nil;
+        if (! [NSFileManager.defaultManager createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:&error]) {
+            SRGAnalyticsLogError(@"journal", @"Could not create the journal directory. Reason: %@", error);
+            return nil;
+        }
+        [directoryURL setResourceValue:@YES forKey:NSURLIsExcludedFromBackupKey error:NULL];
+
+        _journal = SRGAnalyticsJournalOpen(directoryURL.fileSystemRepresentation, SRGAnalyticsJournalOptionsDefault());
+        if (! _journal) {
+            SRGAnalyticsLogError(@"journal", @"Could not open the journal at %@", directoryURL);
+            return nil;
+        }
+
+        [self reportEvictedRecords];
+        
+        NSMutableArray<SRGAnalyticsEventJournalRecord *> *replayedRecords = [NSMutableArray array];
+        SRGAnalyticsJournalEnumeratePendingRecords(_journal, SRGAnalyticsEventJournalCollectRecord, (__bridge void *)replayedRecords);
+        self.replayedRecords = replayedRecords.copy;
+
+        if (replayedRecords.count != 0) {
+            SRGAnalyticsLogInfo(@"journal", @"%@ events to replay", @(replayedRecords.count));
+        }
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithDirectoryURL:SRGAnalyticsEventJournal.defaultDirectoryURL];
+}
+
+#pragma clang diagnostic pop
+
+- (void)dealloc
+{
+    SRGAnalyticsJournalClose(_journal);
+}
+
+#pragma mark Getters and setters
+
+- (NSUInteger)pendingCount
+{
+    return SRGAnalyticsJournalPendingCount(_journal);
+}
+
+- (NSUInteger)evictedCount
+{
+    return SRGAnalyticsJournalEvictedCount(_journal);
+}
+
+#pragma mark Records
+
+- (SRGAnalyticsEventJournalRecord *)recordByAppendingPayload:(NSDictionary<NSString *, id> *)payload
+{
+    SRGAnalyticsEventJournalRecord *record = [[SRGAnalyticsEventJournalRecord alloc] initWithPayload:payload];
+
+    uint64_t serializationStartTime = SRGAnalyticsMetricsStartTime();
+    NSData *data = [NSJSONSerialization dataWithJSONObject:payload options:0 error:NULL];
+    SRGAnalyticsMetricsRecordLatency(SRGAnalyticsMetricsLatencySerialization, serializationStartTime);
+    
+    if (data) {
+        SRGAnalyticsMetricsRecordProducedBytes(data.length);
+        record.token = SRGAnalyticsJournalAppend(_journal, data.bytes, data.length);
+    }
+
+    if (! record.persisted) {
+        SRGAnalyticsLogWarning(@"journal", @"An event could not be persisted to the journal");
+    }
+    
+    [self reportEvictedRecords];
+    return record;
+}
+
+- (void)acknowledgeRecord:(SRGAnalyticsEventJournalRecord *)record
+{
+    if (! record.persisted) {
+        return;
+    }
+
+    SRGAnalyticsJournalAcknowledge(_journal, record.token);
+    record.token = SRGAnalyticsJournalTokenInvalid;
+}
+
+// Records are only evicted when the journal is opened or when a record is appended
+- (void)reportEvictedRecords
+{
+    NSUInteger evictedCount = self.evictedCount;
+    if (evictedCount != _reportedEvictedCount) {
+        SRGAnalyticsLogWarning(@"journal", @"The journal is full. %@ pending events have been discarded", @(evictedCount - _reportedEvictedCount));
+        _reportedEvictedCount = evictedCount;
+    }
+}
+
+- (void)synchronize
+{
+    if (! SRGAnalyticsJournalSynchronize(_journal)) {
+        SRGAnalyticsLogWarning(@"journal", @"The journal could not be synchronized to disk");
+    }
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; pendingCount = %@; evictedCount = %@>",
+            self.class,
+            self,
+            @(self.pendingCount),
+            @(self.evictedCount)];
+}
+
+@end
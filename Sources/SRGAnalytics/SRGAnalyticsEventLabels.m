@@ -6,41 +6,89 @@
 
 #import "SRGAnalyticsEventLabels.h"
 
-#import "NSMutableDictionary+SRGAnalytics.h"
 #import "SRGAnalyticsLabels+Private.h"
 
 @implementation SRGAnalyticsEventLabels
 
+@synthesize type = _type;
+@synthesize value = _value;
+@synthesize source = _source;
+@synthesize extraValue1 = _extraValue1;
+@synthesize extraValue2 = _extraValue2;
+@synthesize extraValue3 = _extraValue3;
+@synthesize extraValue4 = _extraValue4;
+@synthesize extraValue5 = _extraValue5;
+
 #pragma mark Getters and setters
 
-- (NSDictionary<NSString *, NSString *> *)labelsDictionary
+- (void)setType:(NSString *)type
 {
-    NSMutableDictionary<NSString *, NSString *> *dictionary = [NSMutableDictionary dictionary];
-    
-    [dictionary srg_safelySetString:self.type forKey:@"event_type"];
-    [dictionary srg_safelySetString:self.value forKey:@"event_value"];
-    [dictionary srg_safelySetString:self.source forKey:@"event_source"];
-    
-    [dictionary srg_safelySetString:self.extraValue1 forKey:@"event_value_1"];
-    [dictionary srg_safelySetString:self.extraValue2 forKey:@"event_value_2"];
-    [dictionary srg_safelySetString:self.extraValue3 forKey:@"event_value_3"];
-    [dictionary srg_safelySetString:self.extraValue4 forKey:@"event_value_4"];
-    [dictionary srg_safelySetString:self.extraValue5 forKey:@"event_value_5"];
-    
-    [dictionary addEntriesFromDictionary:[super labelsDictionary]];
-    return dictionary.copy;
+    _type = type.copy;
+    [self invalidateLabelStores];
+}
+
+- (void)setValue:(NSString *)value
+{
+    _value = value.copy;
+    [self invalidateLabelStores];
 }
 
-- (NSDictionary<NSString *, NSString *> *)comScoreLabelsDictionary
+- (void)setSource:(NSString *)source
 {
-    NSMutableDictionary<NSString *, NSString *> *dictionary = [NSMutableDictionary dictionary];
+    _source = source.copy;
+    [self invalidateLabelStores];
+}
+
+- (void)setExtraValue1:(NSString *)extraValue1
+{
+    _extraValue1 = extraValue1.copy;
+    [self invalidateLabelStores];
+}
+
+- (void)setExtraValue2:(NSString *)extraValue2
+{
+    _extraValue2 = extraValue2.copy;
+    [self invalidateLabelStores];
+}
+
+- (void)setExtraValue3:(NSString *)extraValue3
+{
+    _extraValue3 = extraValue3.copy;
+    [self invalidateLabelStores];
+}
+
+- (void)setExtraValue4:(NSString *)extraValue4
+{
+    _extraValue4 = extraValue4.copy;
+    [self invalidateLabelStores];
+}
+
+- (void)setExtraValue5:(NSString *)extraValue5
+{
+    _extraValue5 = extraValue5.copy;
+    [self invalidateLabelStores];
+}
+
+#pragma mark Label stores
+
+- (void)fillLabelStore:(SRGAnalyticsLabelStore *)labelStore comScoreLabelStore:(SRGAnalyticsLabelStore *)comScoreLabelStore
+{
+    [labelStore setString:self.type forLabelKey:SRGAnalyticsLabelKeyEventType];
+    [labelStore setString:self.value forLabelKey:SRGAnalyticsLabelKeyEventValue];
+    [labelStore setString:self.source forLabelKey:SRGAnalyticsLabelKeyEventSource];
+    
+    [labelStore setString:self.extraValue1 forLabelKey:SRGAnalyticsLabelKeyEventValue1];
+    [labelStore setString:self.extraValue2 forLabelKey:SRGAnalyticsLabelKeyEventValue2];
+    [labelStore setString:self.extraValue3 forLabelKey:SRGAnalyticsLabelKeyEventValue3];
+    [labelStore setString:self.extraValue4 forLabelKey:SRGAnalyticsLabelKeyEventValue4];
+    [labelStore setString:self.extraValue5 forLabelKey:SRGAnalyticsLabelKeyEventValue5];
     
-    [dictionary srg_safelySetString:self.type forKey:@"srg_evgroup"];
-    [dictionary srg_safelySetString:self.value forKey:@"srg_evvalue"];
-    [dictionary srg_safelySetString:self.source forKey:@"srg_evsource"];
+    [comScoreLabelStore setString:self.type forLabelKey:SRGAnalyticsLabelKeyComScoreEventGroup];
+    [comScoreLabelStore setString:self.value forLabelKey:SRGAnalyticsLabelKeyComScoreEventValue];
+    [comScoreLabelStore setString:self.source forLabelKey:SRGAnalyticsLabelKeyComScoreEventSource];
     
-    [dictionary addEntriesFromDictionary:[super comScoreLabelsDictionary]];
-    return dictionary.copy;
+    // Custom information overrides official labels
+    [super fillLabelStore:labelStore comScoreLabelStore:comScoreLabelStore];
 }
 
 #pragma mark NSCopying protocol
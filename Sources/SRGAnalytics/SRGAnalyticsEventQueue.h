@@ -0,0 +1,73 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsConfiguration.h"
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Bounded multiple producer, single consumer queue. Enqueuing is cheap and can be performed from any thread, while
+ *  objects are delivered in order to a handler called on a dedicated serial queue.
+ */
+@interface SRGAnalyticsEventQueue<ObjectType> : NSObject
+
+/**
+ *  Create a queue with the specified capacity and overflow policy. The handler is called on the queue `workerQueue`
+ *  for each enqueued object.
+ *
+ *  @discussion The capacity is rounded up to the next power of two.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+                  overflowPolicy:(SRGAnalyticsEventQueueOverflowPolicy)overflowPolicy
+                         handler:(void (^)(ObjectType object))handler NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Enqueue an object. Returns `NO` if the object could not be enqueued, which can only happen with the drop newest
+ *  policy (or when blocking would deadlock, i.e. when enqueuing from the worker queue with the block policy).
+ */
+- (BOOL)enqueueObject:(ObjectType)object;
+
+/**
+ *  The serial queue on which the handler is called.
+ */
+@property (nonatomic, readonly) dispatch_queue_t workerQueue;
+
+/**
+ *  Execute a block on the worker queue and wait until it has been executed. When called from the worker queue (e.g.
+ *  from the handler) the block is executed immediately, instead of deadlocking.
+ */
+- (void)performBlockAndWaitOnWorkerQueue:(void (NS_NOESCAPE ^)(void))block;
+
+/**
+ *  Queue capacity and policy.
+ */
+@property (nonatomic, readonly) NSUInteger capacity;
+@property (nonatomic, readonly) SRGAnalyticsEventQueueOverflowPolicy overflowPolicy;
+
+/**
+ *  The number of objects currently waiting in the queue.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ *  Counters for objects which have been enqueued, dropped (without being delivered to the handler) and dispatched
+ *  (delivered to the handler) since the queue was created.
+ */
+@property (nonatomic, readonly) uint64_t enqueuedCount;
+@property (nonatomic, readonly) uint64_t droppedCount;
+@property (nonatomic, readonly) uint64_t dispatchedCount;
+
+@end
+
+@interface SRGAnalyticsEventQueue (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,223 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventQueue.h"
+
+#import "SRGAnalyticsLogger.h"
+#import "SRGAnalyticsRingBuffer.h"
+
+#import <stdatomic.h>
+
+static void *s_workerQueueKey = &s_workerQueueKey;
+
+@interface SRGAnalyticsEventQueue () {
+@private
+    SRGAnalyticsRingBuffer *_ringBuffer;
+    dispatch_semaphore_t _spaceSemaphore;
+
+    atomic_bool _drainScheduled;
+    atomic_uint _waitingProducerCount;
+
+    atomic_uint_fast64_t _enqueuedCount;
+    atomic_uint_fast64_t _droppedCount;
+    atomic_uint_fast64_t _dispatchedCount;
+}
+
+@property (nonatomic) dispatch_queue_t workerQueue;
+@property (nonatomic) SRGAnalyticsEventQueueOverflowPolicy overflowPolicy;
+@property (nonatomic, copy) void (^handler)(id object);
+
+@end
+
+@implementation SRGAnalyticsEventQueue
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+                  overflowPolicy:(SRGAnalyticsEventQueueOverflowPolicy)overflowPolicy
+                         handler:(void (^)(id _Nonnull))handler
+{
+    if (self = [super init]) {
+        _ringBuffer = SRGAnalyticsRingBufferCreate(MAX(capacity, 1));
+        if (! _ringBuffer) {
+            return nil;
+        }
+        _spaceSemaphore = dispatch_semaphore_create(0);
+
+        atomic_init(&_drainScheduled, false);
+        atomic_init(&_waitingProducerCount, 0);
+        atomic_init(&_enqueuedCount, 0);
+        atomic_init(&_droppedCount, 0);
+        atomic_init(&_dispatchedCount, 0);
+
+        dispatch_queue_attr_t attributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        self.workerQueue = dispatch_queue_create("ch.srgssr.analytics.events", attributes);
+        dispatch_queue_set_specific(self.workerQueue, s_workerQueueKey, (__bridge void *)self, NULL);
+
+        self.overflowPolicy = overflowPolicy;
+        self.handler = handler;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithCapacity:0 overflowPolicy:SRGAnalyticsEventQueueOverflowPolicyDropOldest handler:^(id object) {}];
+}
+
+#pragma clang diagnostic pop
+
+- (void)dealloc
+{
+    if (! _ringBuffer) {
+        return;
+    }
+    
+    void *item = NULL;
+    while (SRGAnalyticsRingBufferPop(_ringBuffer, &item)) {
+        CFRelease(item);
+    }
+    SRGAnalyticsRingBufferDestroy(_ringBuffer);
+}
+
+#pragma mark Getters and setters
+
+- (NSUInteger)capacity
+{
+    return SRGAnalyticsRingBufferCapacity(_ringBuffer);
+}
+
+- (NSUInteger)count
+{
+    return SRGAnalyticsRingBufferCount(_ringBuffer);
+}
+
+- (uint64_t)enqueuedCount
+{
+    return atomic_load_explicit(&_enqueuedCount, memory_order_relaxed);
+}
+
+- (uint64_t)droppedCount
+{
+    return atomic_load_explicit(&_droppedCount, memory_order_relaxed);
+}
+
+- (uint64_t)dispatchedCount
+{
+    return atomic_load_explicit(&_dispatchedCount, memory_order_relaxed);
+}
+
+#pragma mark Enqueuing
+
+- (BOOL)enqueueObject:(id)object
+{
+    NSParameterAssert(object);
+
+    void *item = (void *)CFBridgingRetain(object);
+    while (! SRGAnalyticsRingBufferPush(_ringBuffer, item)) {
+        if (! [self makeRoomForObject]) {
+            CFRelease(item);
+            atomic_fetch_add_explicit(&_droppedCount, 1, memory_order_relaxed);
+            SRGAnalyticsLogDebug(@"queue", @"Queue full. An event has been dropped");
+            return NO;
+        }
+    }
+    atomic_fetch_add_explicit(&_enqueuedCount, 1, memory_order_relaxed);
+
+    // Only wake up the worker if no drain is already pending. The flag is cleared by the worker before it starts
+    // draining, so that an object pushed while draining is either consumed by the current drain or triggers a new one.
+    if (! atomic_exchange(&_drainScheduled, true)) {
+        dispatch_async(self.workerQueue, ^{
+            [self drain];
+        });
+    }
+    return YES;
+}
+
+// Return `YES` iff pushing should be attempted again
+- (BOOL)makeRoomForObject
+{
+    switch (self.overflowPolicy) {
+        case SRGAnalyticsEventQueueOverflowPolicyDropOldest: {
+            void *oldestItem = NULL;
+            if (SRGAnalyticsRingBufferPop(_ringBuffer, &oldestItem)) {
+                CFRelease(oldestItem);
+                atomic_fetch_add_explicit(&_droppedCount, 1, memory_order_relaxed);
+                SRGAnalyticsLogDebug(@"queue", @"Queue full. The oldest event has been dropped");
+            }
+            return YES;
+        }
+
+        case SRGAnalyticsEventQueueOverflowPolicyBlock: {
+            // Waiting on the worker queue would never end since only the worker makes room.
+            if (dispatch_get_specific(s_workerQueueKey) == (__bridge void *)self) {
+                return NO;
+            }
+
+            // Use a timeout so that a signal racing with the wait cannot leave a producer stuck.
+            atomic_fetch_add(&_waitingProducerCount, 1);
+            dispatch_semaphore_wait(_spaceSemaphore, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_MSEC));
+            atomic_fetch_sub(&_waitingProducerCount, 1);
+            return YES;
+        }
+
+        default: {
+            return NO;
+        }
+    }
+}
+
+#pragma mark Draining
+
+- (void)drain
+{
+    atomic_store(&_drainScheduled, false);
+
+    void *item = NULL;
+    while (SRGAnalyticsRingBufferPop(_ringBuffer, &item)) {
+        if (atomic_load(&_waitingProducerCount) != 0) {
+            dispatch_semaphore_signal(_spaceSemaphore);
+        }
+
+        @autoreleasepool {
+            id object = CFBridgingRelease(item);
+            self.handler(object);
+        }
+        atomic_fetch_add_explicit(&_dispatchedCount, 1, memory_order_relaxed);
+    }
+}
+
+#pragma mark Worker queue
+
+- (void)performBlockAndWaitOnWorkerQueue:(void (NS_NOESCAPE ^)(void))block
+{
+    if (dispatch_get_specific(s_workerQueueKey) == (__bridge void *)self) {
+        block();
+    }
+    else {
+        dispatch_sync(self.workerQueue, block);
+    }
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; capacity = %@; count = %@; enqueued = %@; dropped = %@; dispatched = %@>",
+            self.class,
+            self,
+            @(self.capacity),
+            @(self.count),
+            @(self.enqueuedCount),
+            @(self.droppedCount),
+            @(self.dispatchedCount)];
+}
+
+@end
@@ -0,0 +1,53 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsSamplingPolicy.h"
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Applies sampling policies to events, by event name (@see `SRGAnalyticsSamplingPolicy`). Sampling decisions are made
+ *  once when the sampler is created, rate limiting is applied each time an event is submitted.
+ *
+ *  @discussion Thread-safe.
+ */
+@interface SRGAnalyticsEventSampler : NSObject
+
+/**
+ *  Return an identifier for the application installation, generated the first time and persisted in the specified user
+ *  defaults afterwards. Used as default sampling identifier, so that sampling decisions are stable across launches.
+ */
++ (NSString *)installationIdentifierWithUserDefaults:(NSUserDefaults *)userDefaults;
+
+/**
+ *  Create a sampler applying the specified policies, with decisions based on the specified identifier.
+ */
+- (instancetype)initWithPolicies:(NSDictionary<NSString *, SRGAnalyticsSamplingPolicy *> *)policies
+                      identifier:(NSString *)identifier NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The identifier which sampling decisions are based on.
+ */
+@property (nonatomic, readonly, copy) NSString *identifier;
+
+/**
+ *  Return `NO` iff an event with the specified name, submitted at the specified monotonic time (in nanoseconds), must
+ *  be discarded. If the event must be sent, `weight` is set to the number of events it stands for, or to 0 if no policy
+ *  applies to the event.
+ */
+- (BOOL)shouldSendEventWithName:(NSString *)name time:(uint64_t)time weight:(double *)weight;
+
+@end
+
+@interface SRGAnalyticsEventSampler (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
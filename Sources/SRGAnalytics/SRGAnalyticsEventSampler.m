@@ -0,0 +1,143 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventSampler.h"
+
+#import "SRGAnalyticsSampling.h"
+
+#import <os/lock.h>
+#import <time.h>
+
+typedef struct {
+    bool sampled;
+    bool limited;
+    double samplingRate;
+    SRGAnalyticsTokenBucket bucket;
+    uint64_t discardedCount;                    // Events discarded by rate limiting since the last event sent
+} SRGAnalyticsEventSamplingState;
+
+@interface SRGAnalyticsEventSampler () {
+@private
+    os_unfair_lock _lock;
+    SRGAnalyticsEventSamplingState *_states;
+}
+
+@property (nonatomic, copy) NSString *identifier;
+
+// Index of the state of each event name with a policy. Never mutated after initialization.
+@property (nonatomic) NSDictionary<NSString *, NSNumber *> *stateIndexes;
+
+@end
+
+static NSString * const SRGAnalyticsInstallationIdentifierKey = @"ch.srgssr.analytics.installation_identifier";
+
+@implementation SRGAnalyticsEventSampler
+
+#pragma mark Class methods
+
++ (NSString *)installationIdentifierWithUserDefaults:(NSUserDefaults *)userDefaults
+{
+    NSString *installationIdentifier = [userDefaults stringForKey:SRGAnalyticsInstallationIdentifierKey];
+    if (installationIdentifier.length == 0) {
+        installationIdentifier = NSUUID.UUID.UUIDString.lowercaseString;
+        [userDefaults setObject:installationIdentifier forKey:SRGAnalyticsInstallationIdentifierKey];
+    }
+    return installationIdentifier;
+}
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithPolicies:(NSDictionary<NSString *, SRGAnalyticsSamplingPolicy *> *)policies identifier:(NSString *)identifier
+{
+    if (self = [super init]) {
+        self.identifier = identifier;
+        
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _states = calloc(MAX(policies.count, 1), sizeof(SRGAnalyticsEventSamplingState));
+        
+        uint64_t time = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+        
+        NSMutableDictionary<NSString *, NSNumber *> *stateIndexes = [NSMutableDictionary dictionary];
+        [policies enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull name, SRGAnalyticsSamplingPolicy * _Nonnull policy, BOOL * _Nonnull stop) {
+            NSUInteger index = stateIndexes.count;
+            
+            SRGAnalyticsEventSamplingState *state = &self->_states[index];
+            state->samplingRate = policy.samplingRate;
+            state->sampled = SRGAnalyticsSamplingPosition(identifier.UTF8String, name.UTF8String) < policy.samplingRate;
+            if (policy.maximumEventCount != 0) {
+                state->limited = true;
+                SRGAnalyticsTokenBucketInit(&state->bucket, policy.maximumEventCount, (uint64_t)(policy.interval * NSEC_PER_SEC), time);
+            }
+            
+            stateIndexes[name] = @(index);
+        }];
+        self.stateIndexes = stateIndexes.copy;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithPolicies:@{} identifier:@""];
+}
+
+#pragma clang diagnostic pop
+
+- (void)dealloc
+{
+    free(_states);
+}
+
+#pragma mark Sampling
+
+- (BOOL)shouldSendEventWithName:(NSString *)name time:(uint64_t)time weight:(double *)weight
+{
+    NSNumber *stateIndex = self.stateIndexes[name];
+    if (! stateIndex) {
+        *weight = 0.;
+        return YES;
+    }
+    
+    SRGAnalyticsEventSamplingState *state = &_states[stateIndex.unsignedIntegerValue];
+    if (! state->sampled) {
+        return NO;
+    }
+    
+    uint64_t discardedCount = 0;
+    
+    os_unfair_lock_lock(&_lock);
+    if (state->limited) {
+        if (! SRGAnalyticsTokenBucketConsume(&state->bucket, time)) {
+            state->discardedCount += 1;
+            os_unfair_lock_unlock(&_lock);
+            return NO;
+        }
+        discardedCount = state->discardedCount;
+        state->discardedCount = 0;
+    }
+    os_unfair_lock_unlock(&_lock);
+    
+    // Events discarded by rate limiting are accounted for by the next event sent
+    *weight = (1. + discardedCount) / state->samplingRate;
+    return YES;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; identifier = %@; eventNames = %@>",
+            self.class,
+            self,
+            self.identifier,
+            self.stateIndexes.allKeys];
+}
+
+@end
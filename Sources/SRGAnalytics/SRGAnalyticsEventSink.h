@@ -0,0 +1,76 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Event payload keys. Payloads are JSON-serializable dictionaries.
+ */
+OBJC_EXPORT NSString * const SRGAnalyticsPayloadKindKey;                // The event kind (`NSString`, see below).
+OBJC_EXPORT NSString * const SRGAnalyticsPayloadNameKey;                // The page view title or event name (`NSString`).
+OBJC_EXPORT NSString * const SRGAnalyticsPayloadPageTypeKey;            // The page view type (`NSString`), for page views only.
+OBJC_EXPORT NSString * const SRGAnalyticsPayloadLabelsKey;              // The event labels (`NSDictionary<NSString *, NSString *>`).
+
+/**
+ *  Event kinds.
+ */
+OBJC_EXPORT NSString * const SRGAnalyticsPayloadKindPageView;
+OBJC_EXPORT NSString * const SRGAnalyticsPayloadKindCustom;
+
+/**
+ *  Outcomes of a delivery.
+ */
+typedef NS_ENUM(NSInteger, SRGAnalyticsEventSinkDeliveryResult) {
+    /**
+     *  The payloads have been delivered.
+     */
+    SRGAnalyticsEventSinkDeliveryResultSuccess = 0,
+    /**
+     *  The payloads could not be delivered, but might be later (e.g. network or server error).
+     */
+    SRGAnalyticsEventSinkDeliveryResultFailure,
+    /**
+     *  The payloads have been permanently rejected and must not be delivered again (e.g. client error).
+     */
+    SRGAnalyticsEventSinkDeliveryResultRejection
+};
+
+/**
+ *  Sinks receive the payloads of events delivered by the tracker. Several sinks can be attached to the tracker at the
+ *  same time (@see `SRGAnalyticsTracker+Private.h`).
+ *
+ *  Each event is delivered once to non-durable sinks. Durable sinks receive their pending events again, in order,
+ *  until they report success or rejection, one batch at a time. Events are kept in the tracker journal until all
+ *  durable sinks are done with them.
+ */
+@protocol SRGAnalyticsEventSink <NSObject>
+
+/**
+ *  Deliver event payloads, in the order in which the events were recorded. Called on the tracker worker thread.
+ *
+ *  @param completion Must be called exactly once, on any thread, when delivery is complete. The result is ignored
+ *                    for sinks which are not durable.
+ */
+- (void)deliverPayloads:(NSArray<NSDictionary<NSString *, id> *> *)payloads completion:(void (^)(SRGAnalyticsEventSinkDeliveryResult result))completion;
+
+@optional
+
+/**
+ *  Return `YES` iff events must be kept by the tracker until the sink has delivered or rejected them, and delivered
+ *  again after a failure. Default value is `NO`.
+ */
+@property (nonatomic, readonly, getter=isDurable) BOOL durable;
+
+/**
+ *  Called on the tracker worker thread when the process is likely to be suspended or terminated.
+ */
+- (void)synchronize;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,15 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventSink.h"
+
+NSString * const SRGAnalyticsPayloadKindKey = @"kind";
+NSString * const SRGAnalyticsPayloadNameKey = @"name";
+NSString * const SRGAnalyticsPayloadPageTypeKey = @"page_type";
+NSString * const SRGAnalyticsPayloadLabelsKey = @"labels";
+
+NSString * const SRGAnalyticsPayloadKindPageView = @"page_view";
+NSString * const SRGAnalyticsPayloadKindCustom = @"custom";
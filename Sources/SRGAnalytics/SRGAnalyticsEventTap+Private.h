@@ -0,0 +1,20 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventTap.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SRGAnalyticsEventTap (Private)
+
+/**
+ *  Call the handler if the event matches the tap filters.
+ */
+- (void)receiveEventWithName:(NSString *)name pageType:(nullable NSString *)pageType labels:(NSDictionary<NSString *, NSString *> *)labels;
+
+@end
+
+NS_ASSUME_NONNULL_END
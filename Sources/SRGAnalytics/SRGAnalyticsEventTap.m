@@ -0,0 +1,87 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventTap.h"
+
+#import "SRGAnalyticsEventTap+Private.h"
+
+@interface SRGAnalyticsEventTap ()
+
+@property (nonatomic, copy) NSSet<NSString *> *eventNames;
+@property (nonatomic, copy) NSString *unitTestingIdentifier;
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic, copy) SRGAnalyticsEventTapHandler handler;
+
+@end
+
+@implementation SRGAnalyticsEventTap
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithEventNames:(NSSet<NSString *> *)eventNames
+             unitTestingIdentifier:(NSString *)unitTestingIdentifier
+                             queue:(dispatch_queue_t)queue
+                           handler:(SRGAnalyticsEventTapHandler)handler
+{
+    if (self = [super init]) {
+        self.eventNames = eventNames;
+        self.unitTestingIdentifier = unitTestingIdentifier;
+        self.queue = queue;
+        self.handler = handler;
+    }
+    return self;
+}
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue handler:(SRGAnalyticsEventTapHandler)handler
+{
+    return [self initWithEventNames:nil unitTestingIdentifier:nil queue:queue handler:handler];
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithQueue:nil handler:^(NSString *name, NSString *pageType, NSDictionary<NSString *, NSString *> *labels) {}];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Events
+
+- (void)receiveEventWithName:(NSString *)name pageType:(NSString *)pageType labels:(NSDictionary<NSString *, NSString *> *)labels
+{
+    if (self.eventNames && ! [self.eventNames containsObject:name]) {
+        return;
+    }
+    
+    if (self.unitTestingIdentifier && ! [labels[@"srg_test_id"] isEqualToString:self.unitTestingIdentifier]) {
+        return;
+    }
+    
+    if (self.queue) {
+        dispatch_async(self.queue, ^{
+            self.handler(name, pageType, labels);
+        });
+    }
+    else {
+        self.handler(name, pageType, labels);
+    }
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; eventNames = %@; unitTestingIdentifier = %@>",
+            self.class,
+            self,
+            self.eventNames,
+            self.unitTestingIdentifier];
+}
+
+@end
@@ -0,0 +1,38 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventSink.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Sink appending payloads to a local file, one JSON object per line. Useful to inspect or replay the events sent
+ *  during a session. The sink is durable: Events are kept by the tracker until they have been written.
+ *
+ *  @discussion Must be used from a single serial queue (which the tracker worker thread is).
+ */
+@interface SRGAnalyticsFileEventSink : NSObject <SRGAnalyticsEventSink>
+
+/**
+ *  Create a sink appending payloads to the file at the specified location (created if needed). Returns `nil` if the
+ *  file could not be opened.
+ */
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The file location.
+ */
+@property (nonatomic, readonly) NSURL *fileURL;
+
+@end
+
+@interface SRGAnalyticsFileEventSink (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
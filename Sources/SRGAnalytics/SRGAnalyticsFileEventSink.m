@@ -0,0 +1,113 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsFileEventSink.h"
+
+#import "SRGAnalyticsLogger.h"
+
+#import <fcntl.h>
+#import <unistd.h>
+
+@interface SRGAnalyticsFileEventSink () {
+@private
+    int _fileDescriptor;
+}
+
+@property (nonatomic) NSURL *fileURL;
+
+@end
+
+@implementation SRGAnalyticsFileEventSink
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL
+{
+    if (self = [super init]) {
+        self.fileURL = fileURL;
+        
+        _fileDescriptor = open(fileURL.fileSystemRepresentation, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (_fileDescriptor < 0) {
+            SRGAnalyticsLogError(@"sink", @"Could not open file at %@ (errno %@)", fileURL, @(errno));
+            return nil;
+        }
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithFileURL:[NSURL fileURLWithPath:@""]];
+}
+
+#pragma clang diagnostic pop
+
+- (void)dealloc
+{
+    if (_fileDescriptor >= 0) {
+        close(_fileDescriptor);
+    }
+}
+
+#pragma mark SRGAnalyticsEventSink protocol
+
+- (BOOL)isDurable
+{
+    return YES;
+}
+
+- (void)deliverPayloads:(NSArray<NSDictionary<NSString *, id> *> *)payloads completion:(void (^)(SRGAnalyticsEventSinkDeliveryResult))completion
+{
+    // Write all lines at once, so that a batch is never interleaved with another writer
+    NSMutableData *data = [NSMutableData data];
+    for (NSDictionary<NSString *, id> *payload in payloads) {
+        NSData *payloadData = [NSJSONSerialization dataWithJSONObject:payload options:0 error:NULL];
+        if (! payloadData) {
+            SRGAnalyticsLogWarning(@"sink", @"Payload could not be serialized and was not written");
+            continue;
+        }
+        [data appendData:payloadData];
+        [data appendBytes:"\n" length:1];
+    }
+    
+    const uint8_t *bytes = data.bytes;
+    size_t remainingLength = data.length;
+    while (remainingLength != 0) {
+        ssize_t writtenLength = write(_fileDescriptor, bytes, remainingLength);
+        if (writtenLength < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SRGAnalyticsLogError(@"sink", @"Could not write to %@ (errno %@)", self.fileURL, @(errno));
+            completion(SRGAnalyticsEventSinkDeliveryResultFailure);
+            return;
+        }
+        bytes += writtenLength;
+        remainingLength -= writtenLength;
+    }
+    completion(SRGAnalyticsEventSinkDeliveryResultSuccess);
+}
+
+- (void)synchronize
+{
+    fsync(_fileDescriptor);
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; fileURL = %@>",
+            self.class,
+            self,
+            self.fileURL];
+}
+
+@end
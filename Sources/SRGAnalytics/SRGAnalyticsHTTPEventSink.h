@@ -0,0 +1,43 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventSink.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Sink posting each batch of payloads as a gzip-compressed JSON array (`Content-Encoding: gzip`) to an HTTP endpoint,
+ *  e.g. a local collector used for load tests. Events held back by the tracker are posted in a single request (@see
+ *  `SRGAnalyticsConfiguration.eventDeliveryDelay`). The sink is durable: Events are kept by the tracker until a batch
+ *  containing them has been successfully posted (2xx response), and posted again after network or server errors.
+ *  Batches rejected with a client error (4xx response, except 408 and 429) or which cannot be serialized are discarded.
+ */
+@interface SRGAnalyticsHTTPEventSink : NSObject <SRGAnalyticsEventSink>
+
+/**
+ *  Create a sink posting batches to the specified URL, using the specified session.
+ */
+- (instancetype)initWithURL:(NSURL *)URL session:(NSURLSession *)session NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Same as `-initWithURL:session:`, using an ephemeral session.
+ */
+- (instancetype)initWithURL:(NSURL *)URL;
+
+/**
+ *  The endpoint URL.
+ */
+@property (nonatomic, readonly) NSURL *URL;
+
+@end
+
+@interface SRGAnalyticsHTTPEventSink (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
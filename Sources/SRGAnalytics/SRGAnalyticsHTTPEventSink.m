@@ -0,0 +1,151 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsHTTPEventSink.h"
+
+#import "SRGAnalyticsLogger.h"
+
+#import <zlib.h>
+
+@interface SRGAnalyticsHTTPEventSink ()
+
+@property (nonatomic) NSURL *URL;
+@property (nonatomic) NSURLSession *session;
+
+@end
+
+// Functions
+static NSData *SRGAnalyticsHTTPEventSinkGzipCompressedData(NSData *data);
+static SRGAnalyticsEventSinkDeliveryResult SRGAnalyticsHTTPEventSinkDeliveryResult(NSInteger statusCode, NSURL *URL);
+
+@implementation SRGAnalyticsHTTPEventSink
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithURL:(NSURL *)URL session:(NSURLSession *)session
+{
+    if (self = [super init]) {
+        self.URL = URL;
+        self.session = session;
+    }
+    return self;
+}
+
+- (instancetype)initWithURL:(NSURL *)URL
+{
+    return [self initWithURL:URL session:[NSURLSession sessionWithConfiguration:NSURLSessionConfiguration.ephemeralSessionConfiguration]];
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithURL:[NSURL URLWithString:@"http://localhost"]];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark SRGAnalyticsEventSink protocol
+
+- (BOOL)isDurable
+{
+    return YES;
+}
+
+- (void)deliverPayloads:(NSArray<NSDictionary<NSString *, id> *> *)payloads completion:(void (^)(SRGAnalyticsEventSinkDeliveryResult))completion
+{
+    NSError *error = nil;
+    NSData *body = [NSJSONSerialization dataWithJSONObject:payloads options:0 error:&error];
+    if (! body) {
+        SRGAnalyticsLogWarning(@"sink", @"Batch could not be serialized and has been discarded. Reason: %@", error);
+        completion(SRGAnalyticsEventSinkDeliveryResultRejection);
+        return;
+    }
+    
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:self.URL];
+    request.HTTPMethod = @"POST";
+    [request setValue:@"application/json" forHTTPHeaderField:@"Content-Type"];
+    
+    // Batches are highly redundant (labels are mostly the same for all events) and compress well
+    NSData *compressedBody = SRGAnalyticsHTTPEventSinkGzipCompressedData(body);
+    if (compressedBody) {
+        request.HTTPBody = compressedBody;
+        [request setValue:@"gzip" forHTTPHeaderField:@"Content-Encoding"];
+    }
+    else {
+        request.HTTPBody = body;
+    }
+    
+    [[self.session dataTaskWithRequest:request completionHandler:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
+        if (error) {
+            SRGAnalyticsLogWarning(@"sink", @"Batch could not be posted to %@. Reason: %@", request.URL, error);
+            completion(SRGAnalyticsEventSinkDeliveryResultFailure);
+            return;
+        }
+        
+        NSInteger statusCode = [response isKindOfClass:NSHTTPURLResponse.class] ? ((NSHTTPURLResponse *)response).statusCode : 0;
+        completion(SRGAnalyticsHTTPEventSinkDeliveryResult(statusCode, request.URL));
+    }] resume];
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; URL = %@>",
+            self.class,
+            self,
+            self.URL];
+}
+
+@end
+
+#pragma mark Functions
+
+// Return `nil` if compression failed
+static NSData *SRGAnalyticsHTTPEventSinkGzipCompressedData(NSData *data)
+{
+    z_stream stream = { 0 };
+    
+    // Adding 16 to the window size produces a gzip header and trailer instead of zlib ones
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return nil;
+    }
+    
+    NSMutableData *compressedData = [NSMutableData dataWithLength:deflateBound(&stream, (uLong)data.length)];
+    stream.next_in = (Bytef *)data.bytes;
+    stream.avail_in = (uInt)data.length;
+    stream.next_out = compressedData.mutableBytes;
+    stream.avail_out = (uInt)compressedData.length;
+    
+    // The output buffer is large enough for the whole data to be compressed at once
+    int status = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (status != Z_STREAM_END) {
+        return nil;
+    }
+    
+    compressedData.length = stream.total_out;
+    return compressedData.copy;
+}
+
+// Client errors are permanent, except timeouts and rate limiting
+static SRGAnalyticsEventSinkDeliveryResult SRGAnalyticsHTTPEventSinkDeliveryResult(NSInteger statusCode, NSURL *URL)
+{
+    if (statusCode >= 200 && statusCode < 300) {
+        return SRGAnalyticsEventSinkDeliveryResultSuccess;
+    }
+    else if (statusCode >= 400 && statusCode < 500 && statusCode != 408 && statusCode != 429) {
+        SRGAnalyticsLogWarning(@"sink", @"Batch rejected by %@ and discarded. Status code: %@", URL, @(statusCode));
+        return SRGAnalyticsEventSinkDeliveryResultRejection;
+    }
+    else {
+        SRGAnalyticsLogWarning(@"sink", @"Batch could not be posted to %@. Status code: %@", URL, @(statusCode));
+        return SRGAnalyticsEventSinkDeliveryResultFailure;
+    }
+}
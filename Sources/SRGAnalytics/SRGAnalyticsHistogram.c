@@ -0,0 +1,94 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsHistogram.h"
+
+#include <math.h>
+
+// Values below 2^SRGAnalyticsHistogramSubBucketBits are recorded exactly. Larger values are split into groups of
+// values sharing their most significant bit, each group being divided into 2^(SRGAnalyticsHistogramSubBucketBits - 1)
+// buckets of equal width.
+#define SRGAnalyticsHistogramSubBucketBits 4
+#define SRGAnalyticsHistogramSubBucketCount (1 << SRGAnalyticsHistogramSubBucketBits)
+#define SRGAnalyticsHistogramSubBucketHalfCount (SRGAnalyticsHistogramSubBucketCount / 2)
+
+_Static_assert(SRGAnalyticsHistogramBucketCount == SRGAnalyticsHistogramSubBucketCount + (64 - SRGAnalyticsHistogramSubBucketBits) * SRGAnalyticsHistogramSubBucketHalfCount,
+               "Inconsistent bucket count");
+
+size_t SRGAnalyticsHistogramBucketIndex(uint64_t value)
+{
+    if (value < SRGAnalyticsHistogramSubBucketCount) {
+        return (size_t)value;
+    }
+    
+    unsigned int mostSignificantBit = 63 - (unsigned int)__builtin_clzll(value);
+    unsigned int shift = mostSignificantBit - (SRGAnalyticsHistogramSubBucketBits - 1);
+    uint64_t subBucket = value >> shift;         // In [half count, count)
+    return SRGAnalyticsHistogramSubBucketCount + (shift - 1) * SRGAnalyticsHistogramSubBucketHalfCount + (size_t)(subBucket - SRGAnalyticsHistogramSubBucketHalfCount);
+}
+
+uint64_t SRGAnalyticsHistogramBucketUpperBound(size_t index)
+{
+    if (index < SRGAnalyticsHistogramSubBucketCount) {
+        return (uint64_t)index;
+    }
+    
+    size_t offset = index - SRGAnalyticsHistogramSubBucketCount;
+    unsigned int shift = (unsigned int)(offset / SRGAnalyticsHistogramSubBucketHalfCount) + 1;
+    uint64_t subBucket = offset % SRGAnalyticsHistogramSubBucketHalfCount + SRGAnalyticsHistogramSubBucketHalfCount;
+    
+    // The last bucket ends at UINT64_MAX
+    uint64_t lowerBound = subBucket << shift;
+    return lowerBound + (((uint64_t)1 << shift) - 1);
+}
+
+void SRGAnalyticsHistogramRecord(SRGAnalyticsHistogram *histogram, uint64_t value)
+{
+    atomic_fetch_add_explicit(&histogram->counts[SRGAnalyticsHistogramBucketIndex(value)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->sum, value, memory_order_relaxed);
+    
+    uint64_t maximum = atomic_load_explicit(&histogram->maximum, memory_order_relaxed);
+    while (value > maximum && ! atomic_compare_exchange_weak_explicit(&histogram->maximum, &maximum, value, memory_order_relaxed, memory_order_relaxed));
+}
+
+void SRGAnalyticsHistogramCopy(SRGAnalyticsHistogram *histogram, SRGAnalyticsHistogramSnapshot *snapshot, bool reset)
+{
+    for (size_t i = 0; i < SRGAnalyticsHistogramBucketCount; ++i) {
+        snapshot->counts[i] = reset ? atomic_exchange_explicit(&histogram->counts[i], 0, memory_order_relaxed) : atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+    }
+    snapshot->count = reset ? atomic_exchange_explicit(&histogram->count, 0, memory_order_relaxed) : atomic_load_explicit(&histogram->count, memory_order_relaxed);
+    snapshot->sum = reset ? atomic_exchange_explicit(&histogram->sum, 0, memory_order_relaxed) : atomic_load_explicit(&histogram->sum, memory_order_relaxed);
+    snapshot->maximum = reset ? atomic_exchange_explicit(&histogram->maximum, 0, memory_order_relaxed) : atomic_load_explicit(&histogram->maximum, memory_order_relaxed);
+}
+
+uint64_t SRGAnalyticsHistogramSnapshotValueAtQuantile(const SRGAnalyticsHistogramSnapshot *snapshot, double quantile)
+{
+    // Use bucket counts rather than the total, which might be slightly off if values were recorded during the copy
+    uint64_t count = 0;
+    for (size_t i = 0; i < SRGAnalyticsHistogramBucketCount; ++i) {
+        count += snapshot->counts[i];
+    }
+    if (count == 0) {
+        return 0;
+    }
+    
+    double clampedQuantile = fmin(fmax(quantile, 0.), 1.);
+    uint64_t rank = (uint64_t)ceil(clampedQuantile * (double)count);
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    uint64_t cumulativeCount = 0;
+    for (size_t i = 0; i < SRGAnalyticsHistogramBucketCount; ++i) {
+        cumulativeCount += snapshot->counts[i];
+        if (cumulativeCount >= rank) {
+            uint64_t upperBound = SRGAnalyticsHistogramBucketUpperBound(i);
+            return (snapshot->maximum != 0 && upperBound > snapshot->maximum) ? snapshot->maximum : upperBound;
+        }
+    }
+    return snapshot->maximum;
+}
@@ -0,0 +1,79 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGAnalyticsHistogram_h
+#define SRGAnalyticsHistogram_h
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Number of buckets of a histogram. Values below 16 have their own bucket, larger values are grouped into buckets
+ *  whose width is 1/8 of their lower bound, so that any 64-bit value is recorded with a relative error below 12.5%
+ *  in fixed memory.
+ */
+#define SRGAnalyticsHistogramBucketCount 496
+
+/**
+ *  Log-linear histogram of unsigned 64-bit values (HDR-style). Values can be recorded from any number of threads
+ *  concurrently without locking. Zero-initialized histograms are empty and ready for use.
+ */
+typedef struct {
+    _Atomic uint64_t counts[SRGAnalyticsHistogramBucketCount];
+    _Atomic uint64_t count;
+    _Atomic uint64_t sum;
+    _Atomic uint64_t maximum;
+} SRGAnalyticsHistogram;
+
+/**
+ *  Plain copy of a histogram.
+ */
+typedef struct {
+    uint64_t counts[SRGAnalyticsHistogramBucketCount];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t maximum;
+} SRGAnalyticsHistogramSnapshot;
+
+/**
+ *  Record a value.
+ */
+void SRGAnalyticsHistogramRecord(SRGAnalyticsHistogram *histogram, uint64_t value);
+
+/**
+ *  Copy histogram values into a snapshot, optionally resetting the histogram. Values recorded concurrently are either
+ *  part of the snapshot or kept in the histogram, but never lost (totals might be momentarily inconsistent with bucket
+ *  counts, though).
+ */
+void SRGAnalyticsHistogramCopy(SRGAnalyticsHistogram *histogram, SRGAnalyticsHistogramSnapshot *snapshot, bool reset);
+
+/**
+ *  Return the bucket index of a value.
+ */
+size_t SRGAnalyticsHistogramBucketIndex(uint64_t value);
+
+/**
+ *  Return the highest value recorded in a bucket.
+ */
+uint64_t SRGAnalyticsHistogramBucketUpperBound(size_t index);
+
+/**
+ *  Return a value such that approximately the specified fraction (between 0 and 1) of recorded values are lower or
+ *  equal to it, 0 if the snapshot is empty. The value is never larger than the maximum recorded value.
+ */
+uint64_t SRGAnalyticsHistogramSnapshotValueAtQuantile(const SRGAnalyticsHistogramSnapshot *snapshot, double quantile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGAnalyticsHistogram_h */
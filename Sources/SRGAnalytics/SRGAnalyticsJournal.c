@@ -0,0 +1,616 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsJournal.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Segment files are made of fixed-size frames. The first frame contains the segment header, records start at the
+// second frame and occupy as many consecutive frames as required. The magic number of a record is written last, so
+// that a record interrupted by a process kill is seen as the end of the segment. Records partially written to disk
+// because of a power loss are detected by their CRC, which covers everything but the magic number and the state (the
+// state is updated in place when the record is acknowledged).
+
+#define SRGAnalyticsJournalFrameSize 256
+#define SRGAnalyticsJournalSegmentMagic 0x4A475253      // 'SRGJ'
+#define SRGAnalyticsJournalRecordMagic 0x52475253       // 'SRGR'
+#define SRGAnalyticsJournalVersion 1
+#define SRGAnalyticsJournalFileExtension ".srgjournal"
+
+typedef enum {
+    SRGAnalyticsJournalRecordStateCommitted = 1,
+    SRGAnalyticsJournalRecordStateAcknowledged = 2
+} SRGAnalyticsJournalRecordState;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frameSize;
+    uint32_t identifier;
+} SRGAnalyticsJournalSegmentHeader;
+
+typedef struct {
+    _Atomic uint32_t magic;
+    _Atomic uint32_t state;
+    uint64_t sequence;
+    uint32_t length;
+    uint32_t frameCount;
+    uint32_t crc;
+    uint32_t reserved;
+} SRGAnalyticsJournalRecordHeader;
+
+typedef struct {
+    uint32_t identifier;
+    uint8_t *base;
+    size_t size;
+    size_t frameCount;
+    size_t usedFrameCount;
+    size_t pendingCount;
+    bool writable;
+    bool dirty;
+} SRGAnalyticsJournalSegment;
+
+struct SRGAnalyticsJournal {
+    char *directoryPath;
+    SRGAnalyticsJournalOptions options;
+
+    SRGAnalyticsJournalSegment *segments;
+    size_t segmentCount;
+    size_t segmentCapacity;
+
+    uint32_t nextSegmentIdentifier;
+    uint64_t nextSequence;
+    size_t pendingCount;
+    size_t evictedCount;
+    size_t unsynchronizedCount;
+    bool directoryDirty;
+};
+
+#pragma mark CRC
+
+static uint32_t s_crcTable[256];
+static pthread_once_t s_crcTableOnce = PTHREAD_ONCE_INIT;
+
+static void SRGAnalyticsJournalInitCRCTable(void)
+{
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t value = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            value = (value & 1) ? (value >> 1) ^ 0xEDB88320 : (value >> 1);
+        }
+        s_crcTable[i] = value;
+    }
+}
+
+uint32_t SRGAnalyticsJournalCRC32(uint32_t crc, const void *bytes, size_t length)
+{
+    pthread_once(&s_crcTableOnce, SRGAnalyticsJournalInitCRCTable);
+
+    const uint8_t *data = bytes;
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = s_crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint32_t SRGAnalyticsJournalRecordCRC(const SRGAnalyticsJournalRecordHeader *header)
+{
+    uint32_t crc = SRGAnalyticsJournalCRC32(0, &header->sequence, sizeof(header->sequence));
+    crc = SRGAnalyticsJournalCRC32(crc, &header->length, sizeof(header->length));
+    crc = SRGAnalyticsJournalCRC32(crc, &header->frameCount, sizeof(header->frameCount));
+    return SRGAnalyticsJournalCRC32(crc, header + 1, header->length);
+}
+
+#pragma mark Segments
+
+static SRGAnalyticsJournalRecordHeader *SRGAnalyticsJournalSegmentRecordHeader(const SRGAnalyticsJournalSegment *segment, size_t frameIndex)
+{
+    return (SRGAnalyticsJournalRecordHeader *)(segment->base + frameIndex * SRGAnalyticsJournalFrameSize);
+}
+
+static size_t SRGAnalyticsJournalFrameCountForLength(size_t length)
+{
+    return (sizeof(SRGAnalyticsJournalRecordHeader) + length + SRGAnalyticsJournalFrameSize - 1) / SRGAnalyticsJournalFrameSize;
+}
+
+static char *SRGAnalyticsJournalSegmentPath(const SRGAnalyticsJournal *journal, uint32_t identifier)
+{
+    size_t length = strlen(journal->directoryPath) + 32;
+    char *path = malloc(length);
+    if (path) {
+        snprintf(path, length, "%s/%010u" SRGAnalyticsJournalFileExtension, journal->directoryPath, identifier);
+    }
+    return path;
+}
+
+// Read the record starting at the specified frame. Returns `false` when the end of the segment has been reached.
+// Otherwise `*frameCount` is set to the number of frames occupied by the record, and `*valid` tells whether its
+// content is intact.
+static bool SRGAnalyticsJournalSegmentReadRecord(const SRGAnalyticsJournalSegment *segment, size_t frameIndex, size_t *frameCount, bool *valid)
+{
+    if (frameIndex >= segment->frameCount) {
+        return false;
+    }
+
+    SRGAnalyticsJournalRecordHeader *header = SRGAnalyticsJournalSegmentRecordHeader(segment, frameIndex);
+    if (atomic_load_explicit(&header->magic, memory_order_acquire) != SRGAnalyticsJournalRecordMagic) {
+        return false;
+    }
+
+    // A corrupted frame count makes it impossible to find the next record
+    size_t availableFrameCount = segment->frameCount - frameIndex;
+    if (header->frameCount == 0 || header->frameCount > availableFrameCount
+            || header->length > header->frameCount * SRGAnalyticsJournalFrameSize - sizeof(SRGAnalyticsJournalRecordHeader)) {
+        return false;
+    }
+
+    *frameCount = header->frameCount;
+    *valid = (header->crc == SRGAnalyticsJournalRecordCRC(header));
+    return true;
+}
+
+static bool SRGAnalyticsJournalMapSegment(SRGAnalyticsJournalSegment *segment, int fd, size_t size)
+{
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    segment->base = base;
+    segment->size = size;
+    segment->frameCount = size / SRGAnalyticsJournalFrameSize;
+    return true;
+}
+
+static bool SRGAnalyticsJournalAddSegment(SRGAnalyticsJournal *journal, SRGAnalyticsJournalSegment segment)
+{
+    if (journal->segmentCount == journal->segmentCapacity) {
+        size_t capacity = journal->segmentCapacity ? journal->segmentCapacity * 2 : 8;
+        SRGAnalyticsJournalSegment *segments = realloc(journal->segments, capacity * sizeof(SRGAnalyticsJournalSegment));
+        if (! segments) {
+            return false;
+        }
+        journal->segments = segments;
+        journal->segmentCapacity = capacity;
+    }
+
+    journal->segments[journal->segmentCount] = segment;
+    journal->segmentCount++;
+    return true;
+}
+
+static void SRGAnalyticsJournalRemoveSegmentAtIndex(SRGAnalyticsJournal *journal, size_t index)
+{
+    SRGAnalyticsJournalSegment *segment = &journal->segments[index];
+    munmap(segment->base, segment->size);
+
+    char *path = SRGAnalyticsJournalSegmentPath(journal, segment->identifier);
+    if (path) {
+        unlink(path);
+        free(path);
+    }
+    journal->pendingCount -= segment->pendingCount;
+    journal->directoryDirty = true;
+
+    memmove(&journal->segments[index], &journal->segments[index + 1], (journal->segmentCount - index - 1) * sizeof(SRGAnalyticsJournalSegment));
+    journal->segmentCount--;
+}
+
+// Discard the oldest segments until there is room for a new one, counting pending records lost in the process
+static void SRGAnalyticsJournalEvictSegments(SRGAnalyticsJournal *journal)
+{
+    while (journal->segmentCount != 0 && journal->segmentCount >= journal->options.maximumSegmentCount) {
+        journal->evictedCount += journal->segments[0].pendingCount;
+        SRGAnalyticsJournalRemoveSegmentAtIndex(journal, 0);
+    }
+}
+
+static SRGAnalyticsJournalSegment *SRGAnalyticsJournalCreateSegment(SRGAnalyticsJournal *journal)
+{
+    // Discard the oldest segments if needed so that the journal cannot grow indefinitely
+    SRGAnalyticsJournalEvictSegments(journal);
+
+    uint32_t identifier = journal->nextSegmentIdentifier;
+    char *path = SRGAnalyticsJournalSegmentPath(journal, identifier);
+    if (! path) {
+        return NULL;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        free(path);
+        return NULL;
+    }
+
+    SRGAnalyticsJournalSegment segment = { 0 };
+    size_t size = journal->options.segmentSize;
+    if (ftruncate(fd, (off_t)size) != 0 || ! SRGAnalyticsJournalMapSegment(&segment, fd, size)) {
+        close(fd);
+        unlink(path);
+        free(path);
+        return NULL;
+    }
+    close(fd);
+
+    SRGAnalyticsJournalSegmentHeader *header = (SRGAnalyticsJournalSegmentHeader *)segment.base;
+    header->version = SRGAnalyticsJournalVersion;
+    header->frameSize = SRGAnalyticsJournalFrameSize;
+    header->identifier = identifier;
+    header->magic = SRGAnalyticsJournalSegmentMagic;
+
+    segment.identifier = identifier;
+    segment.usedFrameCount = 1;
+    segment.writable = true;
+    segment.dirty = true;
+
+    if (! SRGAnalyticsJournalAddSegment(journal, segment)) {
+        munmap(segment.base, segment.size);
+        unlink(path);
+        free(path);
+        return NULL;
+    }
+    free(path);
+
+    journal->nextSegmentIdentifier++;
+    journal->directoryDirty = true;
+    return &journal->segments[journal->segmentCount - 1];
+}
+
+// Open an existing segment, find out where its records end and how many of them are pending. Returns `false` if the
+// file is not a valid segment.
+static bool SRGAnalyticsJournalLoadSegment(SRGAnalyticsJournal *journal, uint32_t identifier)
+{
+    char *path = SRGAnalyticsJournalSegmentPath(journal, identifier);
+    if (! path) {
+        return false;
+    }
+
+    int fd = open(path, O_RDWR);
+    free(path);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat status;
+    SRGAnalyticsJournalSegment segment = { 0 };
+    if (fstat(fd, &status) != 0 || status.st_size < 2 * SRGAnalyticsJournalFrameSize || status.st_size % SRGAnalyticsJournalFrameSize != 0
+            || ! SRGAnalyticsJournalMapSegment(&segment, fd, (size_t)status.st_size)) {
+        close(fd);
+        return false;
+    }
+    close(fd);
+
+    SRGAnalyticsJournalSegmentHeader *header = (SRGAnalyticsJournalSegmentHeader *)segment.base;
+    if (header->magic != SRGAnalyticsJournalSegmentMagic || header->version != SRGAnalyticsJournalVersion
+            || header->frameSize != SRGAnalyticsJournalFrameSize || header->identifier != identifier) {
+        munmap(segment.base, segment.size);
+        return false;
+    }
+
+    segment.identifier = identifier;
+
+    size_t frameIndex = 1;
+    size_t frameCount = 0;
+    bool valid = false;
+    while (SRGAnalyticsJournalSegmentReadRecord(&segment, frameIndex, &frameCount, &valid)) {
+        SRGAnalyticsJournalRecordHeader *recordHeader = SRGAnalyticsJournalSegmentRecordHeader(&segment, frameIndex);
+        if (valid) {
+            if (atomic_load_explicit(&recordHeader->state, memory_order_relaxed) == SRGAnalyticsJournalRecordStateCommitted) {
+                segment.pendingCount++;
+            }
+            if (recordHeader->sequence >= journal->nextSequence) {
+                journal->nextSequence = recordHeader->sequence + 1;
+            }
+        }
+        frameIndex += frameCount;
+    }
+    segment.usedFrameCount = frameIndex;
+
+    if (! SRGAnalyticsJournalAddSegment(journal, segment)) {
+        munmap(segment.base, segment.size);
+        return false;
+    }
+    journal->pendingCount += segment.pendingCount;
+    return true;
+}
+
+static int SRGAnalyticsJournalCompareIdentifiers(const void *identifier1, const void *identifier2)
+{
+    uint32_t value1 = *(const uint32_t *)identifier1;
+    uint32_t value2 = *(const uint32_t *)identifier2;
+    return (value1 > value2) - (value1 < value2);
+}
+
+static bool SRGAnalyticsJournalLoadSegments(SRGAnalyticsJournal *journal)
+{
+    DIR *directory = opendir(journal->directoryPath);
+    if (! directory) {
+        return false;
+    }
+
+    uint32_t *identifiers = NULL;
+    size_t identifierCount = 0;
+    size_t identifierCapacity = 0;
+
+    struct dirent *entry = NULL;
+    while ((entry = readdir(directory))) {
+        unsigned int identifier = 0;
+        char extension[16] = { 0 };
+        if (sscanf(entry->d_name, "%10u%15s", &identifier, extension) != 2 || identifier == 0
+                || strcmp(extension, SRGAnalyticsJournalFileExtension) != 0) {
+            continue;
+        }
+
+        if (identifierCount == identifierCapacity) {
+            identifierCapacity = identifierCapacity ? identifierCapacity * 2 : 16;
+            uint32_t *reallocatedIdentifiers = realloc(identifiers, identifierCapacity * sizeof(uint32_t));
+            if (! reallocatedIdentifiers) {
+                break;
+            }
+            identifiers = reallocatedIdentifiers;
+        }
+        identifiers[identifierCount] = identifier;
+        identifierCount++;
+    }
+    closedir(directory);
+
+    if (identifierCount != 0) {
+        qsort(identifiers, identifierCount, sizeof(uint32_t), SRGAnalyticsJournalCompareIdentifiers);
+    }
+
+    for (size_t i = 0; i < identifierCount; ++i) {
+        uint32_t identifier = identifiers[i];
+        if (identifier >= journal->nextSegmentIdentifier) {
+            journal->nextSegmentIdentifier = identifier + 1;
+        }
+
+        // Discard unreadable segments as well as segments which do not contain pending records anymore
+        if (! SRGAnalyticsJournalLoadSegment(journal, identifier)) {
+            char *path = SRGAnalyticsJournalSegmentPath(journal, identifier);
+            if (path) {
+                unlink(path);
+                free(path);
+            }
+        }
+        else if (journal->segments[journal->segmentCount - 1].pendingCount == 0) {
+            SRGAnalyticsJournalRemoveSegmentAtIndex(journal, journal->segmentCount - 1);
+        }
+    }
+    free(identifiers);
+
+    // Respect the maximum segment count, keeping room for a new segment
+    SRGAnalyticsJournalEvictSegments(journal);
+    return true;
+}
+
+static SRGAnalyticsJournalSegment *SRGAnalyticsJournalSegmentWithIdentifier(const SRGAnalyticsJournal *journal, uint32_t identifier, size_t *index)
+{
+    // Records are usually acknowledged in order, thus most likely in the oldest segment
+    for (size_t i = 0; i < journal->segmentCount; ++i) {
+        if (journal->segments[i].identifier == identifier) {
+            *index = i;
+            return &journal->segments[i];
+        }
+    }
+    return NULL;
+}
+
+#pragma mark Journal
+
+SRGAnalyticsJournalOptions SRGAnalyticsJournalOptionsDefault(void)
+{
+    SRGAnalyticsJournalOptions options = {
+        .segmentSize = 64 * 1024,
+        .maximumSegmentCount = 64,
+        .synchronizationInterval = 32
+    };
+    return options;
+}
+
+SRGAnalyticsJournal *SRGAnalyticsJournalOpen(const char *directoryPath, SRGAnalyticsJournalOptions options)
+{
+    if (! directoryPath) {
+        return NULL;
+    }
+
+    SRGAnalyticsJournal *journal = calloc(1, sizeof(SRGAnalyticsJournal));
+    if (! journal) {
+        return NULL;
+    }
+
+    journal->directoryPath = strdup(directoryPath);
+    if (! journal->directoryPath) {
+        free(journal);
+        return NULL;
+    }
+
+    size_t frameCount = options.segmentSize / SRGAnalyticsJournalFrameSize;
+    options.segmentSize = (frameCount < 2 ? 2 : frameCount) * SRGAnalyticsJournalFrameSize;
+    options.maximumSegmentCount = (options.maximumSegmentCount < 1) ? 1 : options.maximumSegmentCount;
+    journal->options = options;
+    journal->nextSegmentIdentifier = 1;
+    journal->nextSequence = 1;
+
+    if (! SRGAnalyticsJournalLoadSegments(journal)) {
+        SRGAnalyticsJournalClose(journal);
+        return NULL;
+    }
+    return journal;
+}
+
+void SRGAnalyticsJournalClose(SRGAnalyticsJournal *journal)
+{
+    if (! journal) {
+        return;
+    }
+
+    SRGAnalyticsJournalSynchronize(journal);
+
+    for (size_t i = 0; i < journal->segmentCount; ++i) {
+        munmap(journal->segments[i].base, journal->segments[i].size);
+    }
+    free(journal->segments);
+    free(journal->directoryPath);
+    free(journal);
+}
+
+size_t SRGAnalyticsJournalMaximumRecordLength(const SRGAnalyticsJournal *journal)
+{
+    return journal->options.segmentSize - SRGAnalyticsJournalFrameSize - sizeof(SRGAnalyticsJournalRecordHeader);
+}
+
+SRGAnalyticsJournalToken SRGAnalyticsJournalAppend(SRGAnalyticsJournal *journal, const void *bytes, size_t length)
+{
+    if (length > SRGAnalyticsJournalMaximumRecordLength(journal)) {
+        return SRGAnalyticsJournalTokenInvalid;
+    }
+
+    size_t frameCount = SRGAnalyticsJournalFrameCountForLength(length);
+
+    SRGAnalyticsJournalSegment *segment = (journal->segmentCount != 0) ? &journal->segments[journal->segmentCount - 1] : NULL;
+    if (! segment || ! segment->writable || segment->usedFrameCount + frameCount > segment->frameCount) {
+        // A full segment can be discarded immediately if all its records have already been acknowledged
+        if (segment && segment->writable && segment->pendingCount == 0) {
+            SRGAnalyticsJournalRemoveSegmentAtIndex(journal, journal->segmentCount - 1);
+        }
+
+        segment = SRGAnalyticsJournalCreateSegment(journal);
+        if (! segment) {
+            return SRGAnalyticsJournalTokenInvalid;
+        }
+    }
+
+    size_t frameIndex = segment->usedFrameCount;
+    SRGAnalyticsJournalRecordHeader *header = SRGAnalyticsJournalSegmentRecordHeader(segment, frameIndex);
+    memcpy(header + 1, bytes, length);
+    header->sequence = journal->nextSequence;
+    header->length = (uint32_t)length;
+    header->frameCount = (uint32_t)frameCount;
+    header->crc = SRGAnalyticsJournalRecordCRC(header);
+    atomic_store_explicit(&header->state, SRGAnalyticsJournalRecordStateCommitted, memory_order_relaxed);
+    atomic_store_explicit(&header->magic, SRGAnalyticsJournalRecordMagic, memory_order_release);
+
+    segment->usedFrameCount += frameCount;
+    segment->pendingCount++;
+    segment->dirty = true;
+
+    journal->nextSequence++;
+    journal->pendingCount++;
+
+    journal->unsynchronizedCount++;
+    if (journal->unsynchronizedCount >= journal->options.synchronizationInterval) {
+        SRGAnalyticsJournalSynchronize(journal);
+    }
+
+    return ((SRGAnalyticsJournalToken)segment->identifier << 32) | (SRGAnalyticsJournalToken)frameIndex;
+}
+
+bool SRGAnalyticsJournalAcknowledge(SRGAnalyticsJournal *journal, SRGAnalyticsJournalToken token)
+{
+    uint32_t identifier = (uint32_t)(token >> 32);
+    size_t frameIndex = (size_t)(token & 0xFFFFFFFF);
+
+    size_t index = 0;
+    SRGAnalyticsJournalSegment *segment = SRGAnalyticsJournalSegmentWithIdentifier(journal, identifier, &index);
+    if (! segment || frameIndex == 0 || frameIndex >= segment->usedFrameCount) {
+        return false;
+    }
+
+    SRGAnalyticsJournalRecordHeader *header = SRGAnalyticsJournalSegmentRecordHeader(segment, frameIndex);
+    if (atomic_load_explicit(&header->magic, memory_order_relaxed) != SRGAnalyticsJournalRecordMagic
+            || atomic_load_explicit(&header->state, memory_order_relaxed) != SRGAnalyticsJournalRecordStateCommitted) {
+        return false;
+    }
+
+    atomic_store_explicit(&header->state, SRGAnalyticsJournalRecordStateAcknowledged, memory_order_relaxed);
+    segment->pendingCount--;
+    segment->dirty = true;
+    journal->pendingCount--;
+
+    // The segment currently written to is kept until full
+    bool isWrittenTo = segment->writable && index == journal->segmentCount - 1;
+    if (segment->pendingCount == 0 && ! isWrittenTo) {
+        SRGAnalyticsJournalRemoveSegmentAtIndex(journal, index);
+    }
+    return true;
+}
+
+size_t SRGAnalyticsJournalEnumeratePendingRecords(const SRGAnalyticsJournal *journal, SRGAnalyticsJournalRecordCallback callback, void *context)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < journal->segmentCount; ++i) {
+        const SRGAnalyticsJournalSegment *segment = &journal->segments[i];
+        if (segment->pendingCount == 0) {
+            continue;
+        }
+
+        size_t frameIndex = 1;
+        size_t frameCount = 0;
+        bool valid = false;
+        while (frameIndex < segment->usedFrameCount && SRGAnalyticsJournalSegmentReadRecord(segment, frameIndex, &frameCount, &valid)) {
+            SRGAnalyticsJournalRecordHeader *header = SRGAnalyticsJournalSegmentRecordHeader(segment, frameIndex);
+            if (valid && atomic_load_explicit(&header->state, memory_order_relaxed) == SRGAnalyticsJournalRecordStateCommitted) {
+                SRGAnalyticsJournalToken token = ((SRGAnalyticsJournalToken)segment->identifier << 32) | (SRGAnalyticsJournalToken)frameIndex;
+                callback(token, header + 1, header->length, context);
+                count++;
+            }
+            frameIndex += frameCount;
+        }
+    }
+    return count;
+}
+
+size_t SRGAnalyticsJournalPendingCount(const SRGAnalyticsJournal *journal)
+{
+    return journal->pendingCount;
+}
+
+size_t SRGAnalyticsJournalEvictedCount(const SRGAnalyticsJournal *journal)
+{
+    return journal->evictedCount;
+}
+
+bool SRGAnalyticsJournalSynchronize(SRGAnalyticsJournal *journal)
+{
+    bool success = true;
+    for (size_t i = 0; i < journal->segmentCount; ++i) {
+        SRGAnalyticsJournalSegment *segment = &journal->segments[i];
+        if (! segment->dirty) {
+            continue;
+        }
+
+        if (msync(segment->base, segment->size, MS_SYNC) == 0) {
+            segment->dirty = false;
+        }
+        else {
+            success = false;
+        }
+    }
+
+    // Make segment creations and deletions durable as well
+    if (journal->directoryDirty) {
+        int fd = open(journal->directoryPath, O_RDONLY);
+        if (fd >= 0) {
+            if (fsync(fd) == 0) {
+                journal->directoryDirty = false;
+            }
+            close(fd);
+        }
+    }
+
+    journal->unsynchronizedCount = 0;
+    return success;
+}
@@ -0,0 +1,108 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGAnalyticsJournal_h
+#define SRGAnalyticsJournal_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Append-only journal of opaque records, stored in memory-mapped segment files within a directory.
+ *
+ *  Records are made of fixed-size frames and protected by a CRC, so that records which were only partially written
+ *  when the process or the device died are detected and ignored when the journal is opened again. Records are
+ *  acknowledged in place once they do not need to be kept anymore. Segments whose records have all been acknowledged
+ *  are deleted, which means the journal never needs to be rewritten.
+ *
+ *  A journal is not thread-safe and must be used from a single thread (or serial queue) at a time.
+ */
+typedef struct SRGAnalyticsJournal SRGAnalyticsJournal;
+
+/**
+ *  Opaque token identifying a record within a journal. Never equal to `SRGAnalyticsJournalTokenInvalid`.
+ */
+typedef uint64_t SRGAnalyticsJournalToken;
+
+static const SRGAnalyticsJournalToken SRGAnalyticsJournalTokenInvalid = 0;
+
+/**
+ *  Journal options. Use `SRGAnalyticsJournalOptionsDefault()` to get reasonable defaults.
+ */
+typedef struct {
+    size_t segmentSize;                 // Size of each segment file, in bytes (rounded to a multiple of the frame size).
+    size_t maximumSegmentCount;         // When reached, the oldest segment is discarded, even if it contains pending records.
+    size_t synchronizationInterval;     // Number of appended records after which the journal is synchronized to disk.
+} SRGAnalyticsJournalOptions;
+
+SRGAnalyticsJournalOptions SRGAnalyticsJournalOptionsDefault(void);
+
+/**
+ *  Open (or create) a journal stored in an existing directory. Records which had not been acknowledged when the
+ *  journal was last used are available for replay, @see `SRGAnalyticsJournalEnumeratePendingRecords`. Returns `NULL`
+ *  if the journal could not be opened.
+ */
+SRGAnalyticsJournal *SRGAnalyticsJournalOpen(const char *directoryPath, SRGAnalyticsJournalOptions options);
+
+/**
+ *  Synchronize and close a journal.
+ */
+void SRGAnalyticsJournalClose(SRGAnalyticsJournal *journal);
+
+/**
+ *  The largest record length which can be appended to the journal.
+ */
+size_t SRGAnalyticsJournalMaximumRecordLength(const SRGAnalyticsJournal *journal);
+
+/**
+ *  Append a record. Returns its token, or `SRGAnalyticsJournalTokenInvalid` if the record could not be appended
+ *  (too large or I/O error).
+ */
+SRGAnalyticsJournalToken SRGAnalyticsJournalAppend(SRGAnalyticsJournal *journal, const void *bytes, size_t length);
+
+/**
+ *  Acknowledge a record, which won't be enumerated anymore. Returns `false` if the token is unknown (e.g. because
+ *  the record was already acknowledged or its segment discarded).
+ */
+bool SRGAnalyticsJournalAcknowledge(SRGAnalyticsJournal *journal, SRGAnalyticsJournalToken token);
+
+/**
+ *  Enumerate records which have not been acknowledged yet, in the order they were appended.
+ */
+typedef void (*SRGAnalyticsJournalRecordCallback)(SRGAnalyticsJournalToken token, const void *bytes, size_t length, void *context);
+
+size_t SRGAnalyticsJournalEnumeratePendingRecords(const SRGAnalyticsJournal *journal, SRGAnalyticsJournalRecordCallback callback, void *context);
+
+/**
+ *  The number of records which have not been acknowledged yet.
+ */
+size_t SRGAnalyticsJournalPendingCount(const SRGAnalyticsJournal *journal);
+
+/**
+ *  The number of pending records discarded since the journal was opened, because the maximum segment count was reached.
+ */
+size_t SRGAnalyticsJournalEvictedCount(const SRGAnalyticsJournal *journal);
+
+/**
+ *  Synchronize records appended or acknowledged since the last synchronization to disk. Returns `false` on failure.
+ */
+bool SRGAnalyticsJournalSynchronize(SRGAnalyticsJournal *journal);
+
+/**
+ *  CRC-32 (IEEE 802.3) checksum of a buffer, continuing from a previous checksum (0 initially).
+ */
+uint32_t SRGAnalyticsJournalCRC32(uint32_t crc, const void *bytes, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGAnalyticsJournal_h */
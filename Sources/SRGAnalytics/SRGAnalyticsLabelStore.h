@@ -0,0 +1,118 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Identifiers of well-known label keys, which are stored in a flat array by label stores.
+ */
+typedef NS_ENUM(NSInteger, SRGAnalyticsLabelKey) {
+    SRGAnalyticsLabelKeyEventType = 0,
+    SRGAnalyticsLabelKeyEventValue,
+    SRGAnalyticsLabelKeyEventSource,
+    SRGAnalyticsLabelKeyEventValue1,
+    SRGAnalyticsLabelKeyEventValue2,
+    SRGAnalyticsLabelKeyEventValue3,
+    SRGAnalyticsLabelKeyEventValue4,
+    SRGAnalyticsLabelKeyEventValue5,
+    SRGAnalyticsLabelKeyComScoreEventGroup,
+    SRGAnalyticsLabelKeyComScoreEventValue,
+    SRGAnalyticsLabelKeyComScoreEventSource,
+    SRGAnalyticsLabelKeyNavigationPropertyType,
+    SRGAnalyticsLabelKeyNavigationLevel1,
+    SRGAnalyticsLabelKeyNavigationLevel2,
+    SRGAnalyticsLabelKeyNavigationLevel3,
+    SRGAnalyticsLabelKeyNavigationLevel4,
+    SRGAnalyticsLabelKeyNavigationLevel5,
+    SRGAnalyticsLabelKeyNavigationLevel6,
+    SRGAnalyticsLabelKeyNavigationLevel7,
+    SRGAnalyticsLabelKeyNavigationLevel8,
+    SRGAnalyticsLabelKeyContentBusinessUnitOwner,
+    SRGAnalyticsLabelKeyAccessedAfterPushNotification,
+    SRGAnalyticsLabelKeyMediaPosition,
+    SRGAnalyticsLabelKeyMediaTimeshift,
+    SRGAnalyticsLabelKeyMediaVolume,
+    SRGAnalyticsLabelKeyMediaBandwidth,
+    SRGAnalyticsLabelKeyMediaPlaybackRate,
+    SRGAnalyticsLabelKeyMediaPlayerDisplay,
+    SRGAnalyticsLabelKeyMediaPlayerVersion,
+    SRGAnalyticsLabelKeyMediaAudioTrack,
+    SRGAnalyticsLabelKeyMediaAudioDescriptionOn,
+    SRGAnalyticsLabelKeyMediaSubtitlesOn,
+    SRGAnalyticsLabelKeyMediaSubtitleSelection,
+    SRGAnalyticsLabelKeySegmentChangeOrigin,
+    SRGAnalyticsLabelKeySourceIdentifier,
+    SRGAnalyticsLabelKeyTestIdentifier,
+    SRGAnalyticsLabelKeyCount
+};
+
+/**
+ *  Return the interned string for a well-known key.
+ */
+OBJC_EXPORT NSString *SRGAnalyticsLabelKeyString(SRGAnalyticsLabelKey key);
+
+/**
+ *  Return the identifier of a key if it is well-known, `NSNotFound` otherwise.
+ */
+OBJC_EXPORT NSInteger SRGAnalyticsLabelKeyFromString(NSString *string);
+
+/**
+ *  Compact label container. Values for well-known keys are stored in a flat array indexed by key identifier, other
+ *  values in a dictionary. The structural hash and a dictionary representation are computed lazily and cached until
+ *  the store is mutated.
+ *
+ *  @discussion Not thread-safe. A store must not be mutated while being read from another thread.
+ */
+@interface SRGAnalyticsLabelStore : NSObject <NSCopying>
+
+/**
+ *  Set a value for a key (remove it if `nil`).
+ */
+- (void)setString:(nullable NSString *)string forKey:(NSString *)key;
+- (void)setString:(nullable NSString *)string forLabelKey:(SRGAnalyticsLabelKey)key;
+
+/**
+ *  Add all entries from a dictionary, replacing existing values.
+ */
+- (void)addEntriesFromDictionary:(nullable NSDictionary<NSString *, NSString *> *)dictionary;
+
+/**
+ *  Add all entries from another store, replacing existing values.
+ */
+- (void)addEntriesFromStore:(nullable SRGAnalyticsLabelStore *)store;
+
+/**
+ *  Value lookup.
+ */
+- (nullable NSString *)stringForKey:(NSString *)key;
+- (nullable NSString *)stringForLabelKey:(SRGAnalyticsLabelKey)key;
+
+/**
+ *  The number of entries.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ *  Enumerate entries, well-known keys first.
+ */
+- (void)enumerateKeysAndStringsUsingBlock:(void (NS_NOESCAPE ^)(NSString *key, NSString *string))block;
+
+/**
+ *  Add all entries to a mutable dictionary, replacing existing values. Stores can be merged this way without
+ *  intermediate dictionary.
+ */
+- (void)addEntriesToDictionary:(NSMutableDictionary<NSString *, NSString *> *)dictionary;
+
+/**
+ *  Immutable dictionary representation (cached).
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSString *> *dictionary;
+
+@end
+
+NS_ASSUME_NONNULL_END
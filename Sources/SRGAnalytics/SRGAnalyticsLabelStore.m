@@ -0,0 +1,295 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsLabelStore.h"
+
+_Static_assert(SRGAnalyticsLabelKeyCount <= 64, "Well-known key presence is stored as a 64-bit mask");
+
+static NSString * const s_labelKeyStrings[] = {
+    [SRGAnalyticsLabelKeyEventType] = @"event_type",
+    [SRGAnalyticsLabelKeyEventValue] = @"event_value",
+    [SRGAnalyticsLabelKeyEventSource] = @"event_source",
+    [SRGAnalyticsLabelKeyEventValue1] = @"event_value_1",
+    [SRGAnalyticsLabelKeyEventValue2] = @"event_value_2",
+    [SRGAnalyticsLabelKeyEventValue3] = @"event_value_3",
+    [SRGAnalyticsLabelKeyEventValue4] = @"event_value_4",
+    [SRGAnalyticsLabelKeyEventValue5] = @"event_value_5",
+    [SRGAnalyticsLabelKeyComScoreEventGroup] = @"srg_evgroup",
+    [SRGAnalyticsLabelKeyComScoreEventValue] = @"srg_evvalue",
+    [SRGAnalyticsLabelKeyComScoreEventSource] = @"srg_evsource",
+    [SRGAnalyticsLabelKeyNavigationPropertyType] = @"navigation_property_type",
+    [SRGAnalyticsLabelKeyNavigationLevel1] = @"navigation_level_1",
+    [SRGAnalyticsLabelKeyNavigationLevel2] = @"navigation_level_2",
+    [SRGAnalyticsLabelKeyNavigationLevel3] = @"navigation_level_3",
+    [SRGAnalyticsLabelKeyNavigationLevel4] = @"navigation_level_4",
+    [SRGAnalyticsLabelKeyNavigationLevel5] = @"navigation_level_5",
+    [SRGAnalyticsLabelKeyNavigationLevel6] = @"navigation_level_6",
+    [SRGAnalyticsLabelKeyNavigationLevel7] = @"navigation_level_7",
+    [SRGAnalyticsLabelKeyNavigationLevel8] = @"navigation_level_8",
+    [SRGAnalyticsLabelKeyContentBusinessUnitOwner] = @"content_bu_owner",
+    [SRGAnalyticsLabelKeyAccessedAfterPushNotification] = @"accessed_after_push_notification",
+    [SRGAnalyticsLabelKeyMediaPosition] = @"media_position",
+    [SRGAnalyticsLabelKeyMediaTimeshift] = @"media_timeshift",
+    [SRGAnalyticsLabelKeyMediaVolume] = @"media_volume",
+    [SRGAnalyticsLabelKeyMediaBandwidth] = @"media_bandwidth",
+    [SRGAnalyticsLabelKeyMediaPlaybackRate] = @"media_playback_rate",
+    [SRGAnalyticsLabelKeyMediaPlayerDisplay] = @"media_player_display",
+    [SRGAnalyticsLabelKeyMediaPlayerVersion] = @"media_player_version",
+    [SRGAnalyticsLabelKeyMediaAudioTrack] = @"media_audio_track",
+    [SRGAnalyticsLabelKeyMediaAudioDescriptionOn] = @"media_audiodescription_on",
+    [SRGAnalyticsLabelKeyMediaSubtitlesOn] = @"media_subtitles_on",
+    [SRGAnalyticsLabelKeyMediaSubtitleSelection] = @"media_subtitle_selection",
+    [SRGAnalyticsLabelKeySegmentChangeOrigin] = @"segment_change_origin",
+    [SRGAnalyticsLabelKeySourceIdentifier] = @"source_id",
+    [SRGAnalyticsLabelKeyTestIdentifier] = @"srg_test_id"
+};
+
+NSString *SRGAnalyticsLabelKeyString(SRGAnalyticsLabelKey key)
+{
+    NSCParameterAssert(key >= 0 && key < SRGAnalyticsLabelKeyCount);
+    return s_labelKeyStrings[key];
+}
+
+NSInteger SRGAnalyticsLabelKeyFromString(NSString *string)
+{
+    static NSDictionary<NSString *, NSNumber *> *s_labelKeys;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        NSMutableDictionary<NSString *, NSNumber *> *labelKeys = [NSMutableDictionary dictionary];
+        for (NSInteger key = 0; key < SRGAnalyticsLabelKeyCount; ++key) {
+            labelKeys[s_labelKeyStrings[key]] = @(key);
+        }
+        s_labelKeys = labelKeys.copy;
+    });
+
+    NSNumber *key = s_labelKeys[string];
+    return key ? key.integerValue : NSNotFound;
+}
+
+@interface SRGAnalyticsLabelStore () {
+@private
+    NSString *_strings[SRGAnalyticsLabelKeyCount];
+    uint64_t _presenceMask;
+    NSMutableDictionary<NSString *, NSString *> *_otherStrings;
+
+    NSDictionary<NSString *, NSString *> *_dictionary;
+    NSUInteger _hash;
+    BOOL _hashValid;
+}
+
+@end
+
+@implementation SRGAnalyticsLabelStore
+
+#pragma mark Getters and setters
+
+- (NSUInteger)count
+{
+    return (NSUInteger)__builtin_popcountll(_presenceMask) + _otherStrings.count;
+}
+
+- (NSDictionary<NSString *, NSString *> *)dictionary
+{
+    if (! _dictionary) {
+        NSMutableDictionary<NSString *, NSString *> *dictionary = [NSMutableDictionary dictionaryWithCapacity:self.count];
+        [self addEntriesToDictionary:dictionary];
+        _dictionary = dictionary.copy;
+    }
+    return _dictionary;
+}
+
+#pragma mark Mutation
+
+- (void)invalidateCaches
+{
+    _dictionary = nil;
+    _hashValid = NO;
+}
+
+- (void)setString:(NSString *)string forLabelKey:(SRGAnalyticsLabelKey)key
+{
+    NSParameterAssert(key >= 0 && key < SRGAnalyticsLabelKeyCount);
+
+    _strings[key] = string.copy;
+    if (string) {
+        _presenceMask |= (1ULL << key);
+    }
+    else {
+        _presenceMask &= ~(1ULL << key);
+    }
+    [self invalidateCaches];
+}
+
+- (void)setString:(NSString *)string forKey:(NSString *)key
+{
+    NSInteger labelKey = SRGAnalyticsLabelKeyFromString(key);
+    if (labelKey != NSNotFound) {
+        [self setString:string forLabelKey:labelKey];
+        return;
+    }
+
+    if (string) {
+        if (! _otherStrings) {
+            _otherStrings = [NSMutableDictionary dictionary];
+        }
+        _otherStrings[key] = string.copy;
+    }
+    else {
+        [_otherStrings removeObjectForKey:key];
+    }
+    [self invalidateCaches];
+}
+
+- (void)addEntriesFromDictionary:(NSDictionary<NSString *, NSString *> *)dictionary
+{
+    [dictionary enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull string, BOOL * _Nonnull stop) {
+        [self setString:string forKey:key];
+    }];
+}
+
+- (void)addEntriesFromStore:(SRGAnalyticsLabelStore *)store
+{
+    if (! store) {
+        return;
+    }
+
+    uint64_t mask = store->_presenceMask;
+    while (mask != 0) {
+        NSInteger key = __builtin_ctzll(mask);
+        _strings[key] = store->_strings[key];
+        mask &= mask - 1;
+    }
+    _presenceMask |= store->_presenceMask;
+
+    if (store->_otherStrings.count != 0) {
+        if (! _otherStrings) {
+            _otherStrings = [NSMutableDictionary dictionary];
+        }
+        [_otherStrings addEntriesFromDictionary:store->_otherStrings];
+    }
+    [self invalidateCaches];
+}
+
+#pragma mark Lookup
+
+- (NSString *)stringForLabelKey:(SRGAnalyticsLabelKey)key
+{
+    NSParameterAssert(key >= 0 && key < SRGAnalyticsLabelKeyCount);
+    return _strings[key];
+}
+
+- (NSString *)stringForKey:(NSString *)key
+{
+    NSInteger labelKey = SRGAnalyticsLabelKeyFromString(key);
+    return (labelKey != NSNotFound) ? _strings[labelKey] : _otherStrings[key];
+}
+
+- (void)enumerateKeysAndStringsUsingBlock:(void (NS_NOESCAPE ^)(NSString * _Nonnull, NSString * _Nonnull))block
+{
+    uint64_t mask = _presenceMask;
+    while (mask != 0) {
+        NSInteger key = __builtin_ctzll(mask);
+        block(s_labelKeyStrings[key], _strings[key]);
+        mask &= mask - 1;
+    }
+
+    [_otherStrings enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull string, BOOL * _Nonnull stop) {
+        block(key, string);
+    }];
+}
+
+- (void)addEntriesToDictionary:(NSMutableDictionary<NSString *, NSString *> *)dictionary
+{
+    uint64_t mask = _presenceMask;
+    while (mask != 0) {
+        NSInteger key = __builtin_ctzll(mask);
+        dictionary[s_labelKeyStrings[key]] = _strings[key];
+        mask &= mask - 1;
+    }
+
+    if (_otherStrings) {
+        [dictionary addEntriesFromDictionary:_otherStrings];
+    }
+}
+
+#pragma mark NSCopying protocol
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    SRGAnalyticsLabelStore *store = [[self.class allocWithZone:zone] init];
+    [store addEntriesFromStore:self];
+    store->_dictionary = _dictionary;
+    store->_hash = _hash;
+    store->_hashValid = _hashValid;
+    return store;
+}
+
+#pragma mark Equality
+
+- (BOOL)isEqual:(id)object
+{
+    if (object == self) {
+        return YES;
+    }
+
+    if (! [object isKindOfClass:SRGAnalyticsLabelStore.class]) {
+        return NO;
+    }
+
+    SRGAnalyticsLabelStore *otherStore = object;
+    if (_presenceMask != otherStore->_presenceMask || _otherStrings.count != otherStore->_otherStrings.count) {
+        return NO;
+    }
+
+    if (_hashValid && otherStore->_hashValid && _hash != otherStore->_hash) {
+        return NO;
+    }
+
+    uint64_t mask = _presenceMask;
+    while (mask != 0) {
+        NSInteger key = __builtin_ctzll(mask);
+        if (! [_strings[key] isEqualToString:otherStore->_strings[key]]) {
+            return NO;
+        }
+        mask &= mask - 1;
+    }
+
+    return _otherStrings.count == 0 || [_otherStrings isEqualToDictionary:otherStore->_otherStrings];
+}
+
+- (NSUInteger)hash
+{
+    if (! _hashValid) {
+        // Order-independent combination of entry hashes, consistent with equality
+        NSUInteger hash = (NSUInteger)_presenceMask;
+        uint64_t mask = _presenceMask;
+        while (mask != 0) {
+            NSInteger key = __builtin_ctzll(mask);
+            hash += ((NSUInteger)(key + 1) * 31) ^ _strings[key].hash;
+            mask &= mask - 1;
+        }
+
+        for (NSString *key in _otherStrings) {
+            hash += (key.hash * 31) ^ _otherStrings[key].hash;
+        }
+
+        _hash = hash;
+        _hashValid = YES;
+    }
+    return _hash;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; dictionary = %@>",
+            self.class,
+            self,
+            self.dictionary];
+}
+
+@end
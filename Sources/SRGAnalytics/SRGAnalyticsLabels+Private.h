@@ -4,6 +4,7 @@
 //  License information is available from the LICENSE file.
 //
 
+#import "SRGAnalyticsLabelStore.h"
 #import "SRGAnalyticsLabels.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -23,6 +24,23 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, readonly) NSDictionary<NSString *, NSString *> *comScoreLabelsDictionary;
 
+/**
+ *  Compact stores backing the above dictionaries, built lazily and cached until labels are modified. Stores must not
+ *  be mutated.
+ */
+@property (nonatomic, readonly) SRGAnalyticsLabelStore *labelStore;
+@property (nonatomic, readonly) SRGAnalyticsLabelStore *comScoreLabelStore;
+
+/**
+ *  Fill stores with label values. Subclasses adding labels must override this method, calling the parent
+ *  implementation last so that custom information takes precedence.
+ */
+- (void)fillLabelStore:(SRGAnalyticsLabelStore *)labelStore comScoreLabelStore:(SRGAnalyticsLabelStore *)comScoreLabelStore;
+
+/**
+ *  Subclasses must call this method when a property contributing to labels is modified.
+ */
+- (void)invalidateLabelStores;
 
 @end
 
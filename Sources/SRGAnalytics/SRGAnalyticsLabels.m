@@ -6,28 +6,117 @@
 
 #import "SRGAnalyticsLabels.h"
 
+#import "SRGAnalyticsLabels+Private.h"
+
+#import <os/lock.h>
+
+@interface SRGAnalyticsLabels () {
+@private
+    os_unfair_lock _lock;
+    SRGAnalyticsLabelStore *_labelStore;
+    SRGAnalyticsLabelStore *_comScoreLabelStore;
+}
+
+@end
+
 @implementation SRGAnalyticsLabels
 
-- (NSDictionary<NSString *, NSString *> *)labelsDictionary
+@synthesize customInfo = _customInfo;
+@synthesize comScoreCustomInfo = _comScoreCustomInfo;
+
+#pragma mark Object lifecycle
+
+- (instancetype)init
 {
-    NSMutableDictionary<NSString *, NSString *> *dictionary = [NSMutableDictionary dictionary];
-    
-    if (self.customInfo) {
-        [dictionary addEntriesFromDictionary:self.customInfo];
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
     }
-    
-    return dictionary.copy;
+    return self;
+}
+
+#pragma mark Getters and setters
+
+- (void)setCustomInfo:(NSDictionary<NSString *,NSString *> *)customInfo
+{
+    _customInfo = customInfo.copy;
+    [self invalidateLabelStores];
+}
+
+- (void)setComScoreCustomInfo:(NSDictionary<NSString *,NSString *> *)comScoreCustomInfo
+{
+    _comScoreCustomInfo = comScoreCustomInfo.copy;
+    [self invalidateLabelStores];
+}
+
+- (NSDictionary<NSString *, NSString *> *)labelsDictionary
+{
+    os_unfair_lock_lock(&_lock);
+    [self buildLabelStoresIfNeeded];
+    NSDictionary<NSString *, NSString *> *dictionary = _labelStore.dictionary;
+    os_unfair_lock_unlock(&_lock);
+    return dictionary;
 }
 
 - (NSDictionary<NSString *, NSString *> *)comScoreLabelsDictionary
 {
-    NSMutableDictionary<NSString *, NSString *> *dictionary = [NSMutableDictionary dictionary];
-    
-    if (self.comScoreCustomInfo) {
-        [dictionary addEntriesFromDictionary:self.comScoreCustomInfo];
+    os_unfair_lock_lock(&_lock);
+    [self buildLabelStoresIfNeeded];
+    NSDictionary<NSString *, NSString *> *dictionary = _comScoreLabelStore.dictionary;
+    os_unfair_lock_unlock(&_lock);
+    return dictionary;
+}
+
+- (SRGAnalyticsLabelStore *)labelStore
+{
+    os_unfair_lock_lock(&_lock);
+    [self buildLabelStoresIfNeeded];
+    SRGAnalyticsLabelStore *labelStore = _labelStore;
+    os_unfair_lock_unlock(&_lock);
+    return labelStore;
+}
+
+- (SRGAnalyticsLabelStore *)comScoreLabelStore
+{
+    os_unfair_lock_lock(&_lock);
+    [self buildLabelStoresIfNeeded];
+    SRGAnalyticsLabelStore *comScoreLabelStore = _comScoreLabelStore;
+    os_unfair_lock_unlock(&_lock);
+    return comScoreLabelStore;
+}
+
+#pragma mark Label stores
+
+// Must be called with the lock held
+- (void)buildLabelStoresIfNeeded
+{
+    if (_labelStore) {
+        return;
     }
     
-    return dictionary.copy;
+    SRGAnalyticsLabelStore *labelStore = [[SRGAnalyticsLabelStore alloc] init];
+    SRGAnalyticsLabelStore *comScoreLabelStore = [[SRGAnalyticsLabelStore alloc] init];
+    [self fillLabelStore:labelStore comScoreLabelStore:comScoreLabelStore];
+    
+    // Compute hashes now so that stores can be safely read from any thread afterwards
+    [labelStore hash];
+    [comScoreLabelStore hash];
+    
+    _labelStore = labelStore;
+    _comScoreLabelStore = comScoreLabelStore;
+}
+
+- (void)fillLabelStore:(SRGAnalyticsLabelStore *)labelStore comScoreLabelStore:(SRGAnalyticsLabelStore *)comScoreLabelStore
+{
+    [labelStore addEntriesFromDictionary:self.customInfo];
+    [comScoreLabelStore addEntriesFromDictionary:self.comScoreCustomInfo];
+}
+
+- (void)invalidateLabelStores
+{
+    os_unfair_lock_lock(&_lock);
+    _labelStore = nil;
+    _comScoreLabelStore = nil;
+    os_unfair_lock_unlock(&_lock);
 }
 
 #pragma mark NSCopying protocol
@@ -35,8 +124,8 @@
 - (id)copyWithZone:(NSZone *)zone
 {
     SRGAnalyticsLabels *labels = [[self.class allocWithZone:zone] init];
-    labels.customInfo = self.customInfo;
-    labels.comScoreCustomInfo = self.comScoreCustomInfo;
+    labels.customInfo = self.customInfo.copy;
+    labels.comScoreCustomInfo = self.comScoreCustomInfo.copy;
     return labels;
 }
 
@@ -49,13 +138,13 @@
     }
     
     SRGAnalyticsLabels *otherLabels = object;
-    return [[self labelsDictionary] isEqual:[otherLabels labelsDictionary]]
-        && [[self comScoreLabelsDictionary] isEqual:[otherLabels comScoreLabelsDictionary]];
+    return [self.labelStore isEqual:otherLabels.labelStore]
+        && [self.comScoreLabelStore isEqual:otherLabels.comScoreLabelStore];
 }
 
 - (NSUInteger)hash
 {
-    return [NSString stringWithFormat:@"%@_%@", @([self labelsDictionary].hash), @([self comScoreLabelsDictionary].hash)].hash;
+    return self.labelStore.hash * 31 + self.comScoreLabelStore.hash;
 }
 
 #pragma mark Description
@@ -0,0 +1,374 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsLabelsDelta.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    char *key;
+    char *value;
+} SRGAnalyticsOwnedLabel;
+
+typedef struct {
+    char *identifier;
+    uint64_t sequence;
+    uint64_t lastUse;
+    SRGAnalyticsOwnedLabel *labels;         // Sorted by key
+    size_t count;
+} SRGAnalyticsLabelsDeltaSession;
+
+struct SRGAnalyticsLabelsDeltaExpander {
+    SRGAnalyticsLabelsDeltaSession *sessions;
+    size_t sessionCount;
+    size_t sessionCapacity;
+    uint64_t clock;
+};
+
+#pragma mark Helpers
+
+static int SRGAnalyticsLabelCompare(const void *label1, const void *label2)
+{
+    return strcmp(((const SRGAnalyticsLabel *)label1)->key, ((const SRGAnalyticsLabel *)label2)->key);
+}
+
+static int SRGAnalyticsStringCompare(const void *string1, const void *string2)
+{
+    return strcmp(*(const char * const *)string1, *(const char * const *)string2);
+}
+
+static bool SRGAnalyticsParseSequence(const char *string, uint64_t *sequence)
+{
+    if (! string || *string < '0' || *string > '9') {
+        return false;
+    }
+
+    errno = 0;
+    char *end = NULL;
+    unsigned long long value = strtoull(string, &end, 10);
+    if (errno != 0 || *end != '\0') {
+        return false;
+    }
+
+    *sequence = value;
+    return true;
+}
+
+static void SRGAnalyticsOwnedLabelsFree(SRGAnalyticsOwnedLabel *labels, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        free(labels[i].key);
+        free(labels[i].value);
+    }
+    free(labels);
+}
+
+static bool SRGAnalyticsOwnedLabelSet(SRGAnalyticsOwnedLabel *ownedLabel, const char *key, const char *value)
+{
+    ownedLabel->key = strdup(key);
+    ownedLabel->value = strdup(value);
+    return ownedLabel->key && ownedLabel->value;
+}
+
+#pragma mark Sessions
+
+static void SRGAnalyticsLabelsDeltaSessionClear(SRGAnalyticsLabelsDeltaSession *session)
+{
+    free(session->identifier);
+    SRGAnalyticsOwnedLabelsFree(session->labels, session->count);
+    memset(session, 0, sizeof(*session));
+}
+
+static SRGAnalyticsLabelsDeltaSession *SRGAnalyticsLabelsDeltaExpanderFindSession(SRGAnalyticsLabelsDeltaExpander *expander, const char *identifier)
+{
+    for (size_t i = 0; i < expander->sessionCount; ++i) {
+        if (strcmp(expander->sessions[i].identifier, identifier) == 0) {
+            return &expander->sessions[i];
+        }
+    }
+    return NULL;
+}
+
+// Return a new session, evicting the least recently used one if needed
+static SRGAnalyticsLabelsDeltaSession *SRGAnalyticsLabelsDeltaExpanderCreateSession(SRGAnalyticsLabelsDeltaExpander *expander, const char *identifier)
+{
+    char *identifierCopy = strdup(identifier);
+    if (! identifierCopy) {
+        return NULL;
+    }
+
+    SRGAnalyticsLabelsDeltaSession *session = NULL;
+    if (expander->sessionCount < expander->sessionCapacity) {
+        session = &expander->sessions[expander->sessionCount];
+        ++expander->sessionCount;
+    }
+    else {
+        session = &expander->sessions[0];
+        for (size_t i = 1; i < expander->sessionCount; ++i) {
+            if (expander->sessions[i].lastUse < session->lastUse) {
+                session = &expander->sessions[i];
+            }
+        }
+        SRGAnalyticsLabelsDeltaSessionClear(session);
+    }
+
+    session->identifier = identifierCopy;
+    return session;
+}
+
+#pragma mark Expander
+
+SRGAnalyticsLabelsDeltaExpander *SRGAnalyticsLabelsDeltaExpanderCreate(size_t sessionCapacity)
+{
+    SRGAnalyticsLabelsDeltaExpander *expander = calloc(1, sizeof(SRGAnalyticsLabelsDeltaExpander));
+    if (! expander) {
+        return NULL;
+    }
+
+    expander->sessionCapacity = sessionCapacity != 0 ? sessionCapacity : 1;
+    expander->sessions = calloc(expander->sessionCapacity, sizeof(SRGAnalyticsLabelsDeltaSession));
+    if (! expander->sessions) {
+        free(expander);
+        return NULL;
+    }
+    return expander;
+}
+
+void SRGAnalyticsLabelsDeltaExpanderDestroy(SRGAnalyticsLabelsDeltaExpander *expander)
+{
+    if (! expander) {
+        return;
+    }
+
+    for (size_t i = 0; i < expander->sessionCount; ++i) {
+        SRGAnalyticsLabelsDeltaSessionClear(&expander->sessions[i]);
+    }
+    free(expander->sessions);
+    free(expander);
+}
+
+void SRGAnalyticsLabelsDeltaExpanderEndSession(SRGAnalyticsLabelsDeltaExpander *expander, const char *sessionIdentifier)
+{
+    SRGAnalyticsLabelsDeltaSession *session = SRGAnalyticsLabelsDeltaExpanderFindSession(expander, sessionIdentifier);
+    if (! session) {
+        return;
+    }
+
+    SRGAnalyticsLabelsDeltaSessionClear(session);
+
+    // Keep sessions contiguous
+    SRGAnalyticsLabelsDeltaSession *lastSession = &expander->sessions[expander->sessionCount - 1];
+    if (session != lastSession) {
+        *session = *lastSession;
+        memset(lastSession, 0, sizeof(*lastSession));
+    }
+    --expander->sessionCount;
+}
+
+// Merge sorted changes into the sorted labels of the base record, omitting removed keys (sorted as well) which have
+// not been changed. Returns `NULL` on allocation failure.
+static SRGAnalyticsOwnedLabel *SRGAnalyticsLabelsDeltaMerge(const SRGAnalyticsOwnedLabel *baseLabels, size_t baseCount,
+                                                            const SRGAnalyticsLabel *changes, size_t changeCount,
+                                                            const char * const *removedKeys, size_t removedKeyCount,
+                                                            size_t *count)
+{
+    SRGAnalyticsOwnedLabel *labels = calloc(baseCount + changeCount + 1, sizeof(SRGAnalyticsOwnedLabel));
+    if (! labels) {
+        return NULL;
+    }
+
+    size_t i = 0, j = 0, k = 0;
+    while (i < baseCount || j < changeCount) {
+        int comparison = (i == baseCount) ? 1 : (j == changeCount) ? -1 : strcmp(baseLabels[i].key, changes[j].key);
+
+        bool success = true;
+        if (comparison < 0) {
+            const char *key = baseLabels[i].key;
+            if (removedKeyCount == 0 || ! bsearch(&key, removedKeys, removedKeyCount, sizeof(const char *), SRGAnalyticsStringCompare)) {
+                success = SRGAnalyticsOwnedLabelSet(&labels[k++], key, baseLabels[i].value);
+            }
+            ++i;
+        }
+        else {
+            success = SRGAnalyticsOwnedLabelSet(&labels[k++], changes[j].key, changes[j].value);
+            if (comparison == 0) {
+                ++i;
+            }
+            ++j;
+        }
+
+        if (! success) {
+            SRGAnalyticsOwnedLabelsFree(labels, k);
+            return NULL;
+        }
+    }
+
+    *count = k;
+    return labels;
+}
+
+// Split a comma-separated list into sorted keys, pointing into `buffer` (modified in place)
+static const char **SRGAnalyticsLabelsDeltaSplitKeys(char *buffer, size_t *count)
+{
+    size_t capacity = 1;
+    for (const char *character = buffer; *character; ++character) {
+        if (*character == ',') {
+            ++capacity;
+        }
+    }
+
+    const char **keys = calloc(capacity, sizeof(const char *));
+    if (! keys) {
+        return NULL;
+    }
+
+    size_t keyCount = 0;
+    char *start = buffer;
+    while (start) {
+        char *end = strchr(start, ',');
+        if (end) {
+            *end = '\0';
+        }
+        if (*start) {
+            keys[keyCount++] = start;
+        }
+        start = end ? end + 1 : NULL;
+    }
+
+    qsort(keys, keyCount, sizeof(const char *), SRGAnalyticsStringCompare);
+    *count = keyCount;
+    return keys;
+}
+
+SRGAnalyticsLabelsDeltaStatus SRGAnalyticsLabelsDeltaExpanderExpand(SRGAnalyticsLabelsDeltaExpander *expander,
+                                                                    const SRGAnalyticsLabel *labels,
+                                                                    size_t count,
+                                                                    SRGAnalyticsLabelsDeltaCallback callback,
+                                                                    void *context)
+{
+    const char *sessionIdentifier = NULL, *sequenceString = NULL, *baseString = NULL, *removedString = NULL;
+
+    SRGAnalyticsLabel *changes = malloc((count + 1) * sizeof(SRGAnalyticsLabel));
+    if (! changes) {
+        return SRGAnalyticsLabelsDeltaStatusInvalid;
+    }
+
+    size_t changeCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const char *key = labels[i].key;
+        if (strcmp(key, SRGAnalyticsLabelsDeltaSessionKey) == 0) {
+            sessionIdentifier = labels[i].value;
+        }
+        else if (strcmp(key, SRGAnalyticsLabelsDeltaSequenceKey) == 0) {
+            sequenceString = labels[i].value;
+        }
+        else if (strcmp(key, SRGAnalyticsLabelsDeltaBaseKey) == 0) {
+            baseString = labels[i].value;
+        }
+        else if (strcmp(key, SRGAnalyticsLabelsDeltaRemovedKey) == 0) {
+            removedString = labels[i].value;
+        }
+        else {
+            changes[changeCount++] = labels[i];
+        }
+    }
+    qsort(changes, changeCount, sizeof(SRGAnalyticsLabel), SRGAnalyticsLabelCompare);
+
+    SRGAnalyticsLabelsDeltaStatus status = SRGAnalyticsLabelsDeltaStatusInvalid;
+    char *removedBuffer = NULL;
+    const char **removedKeys = NULL;
+
+    if (! sessionIdentifier) {
+        for (size_t i = 0; i < changeCount; ++i) {
+            callback(changes[i].key, changes[i].value, context);
+        }
+        status = SRGAnalyticsLabelsDeltaStatusUnencoded;
+        goto exit;
+    }
+
+    uint64_t sequence = 0;
+    if (! SRGAnalyticsParseSequence(sequenceString, &sequence)) {
+        goto exit;
+    }
+
+    for (size_t i = 1; i < changeCount; ++i) {
+        if (strcmp(changes[i - 1].key, changes[i].key) == 0) {
+            goto exit;
+        }
+    }
+
+    SRGAnalyticsLabelsDeltaSession *session = SRGAnalyticsLabelsDeltaExpanderFindSession(expander, sessionIdentifier);
+    SRGAnalyticsOwnedLabel *expandedLabels = NULL;
+    size_t expandedCount = 0;
+
+    // Key frame
+    if (! baseString) {
+        if (removedString) {
+            goto exit;
+        }
+
+        expandedLabels = SRGAnalyticsLabelsDeltaMerge(NULL, 0, changes, changeCount, NULL, 0, &expandedCount);
+        if (! expandedLabels) {
+            goto exit;
+        }
+
+        if (! session) {
+            session = SRGAnalyticsLabelsDeltaExpanderCreateSession(expander, sessionIdentifier);
+            if (! session) {
+                SRGAnalyticsOwnedLabelsFree(expandedLabels, expandedCount);
+                goto exit;
+            }
+        }
+    }
+    // Delta
+    else {
+        uint64_t base = 0;
+        if (! SRGAnalyticsParseSequence(baseString, &base)) {
+            goto exit;
+        }
+
+        if (! session || session->sequence != base) {
+            status = SRGAnalyticsLabelsDeltaStatusMissingBase;
+            goto exit;
+        }
+
+        size_t removedKeyCount = 0;
+        if (removedString) {
+            removedBuffer = strdup(removedString);
+            if (! removedBuffer) {
+                goto exit;
+            }
+            removedKeys = SRGAnalyticsLabelsDeltaSplitKeys(removedBuffer, &removedKeyCount);
+            if (! removedKeys) {
+                goto exit;
+            }
+        }
+
+        expandedLabels = SRGAnalyticsLabelsDeltaMerge(session->labels, session->count, changes, changeCount, removedKeys, removedKeyCount, &expandedCount);
+        if (! expandedLabels) {
+            goto exit;
+        }
+    }
+
+    SRGAnalyticsOwnedLabelsFree(session->labels, session->count);
+    session->labels = expandedLabels;
+    session->count = expandedCount;
+    session->sequence = sequence;
+    session->lastUse = ++expander->clock;
+
+    for (size_t i = 0; i < expandedCount; ++i) {
+        callback(expandedLabels[i].key, expandedLabels[i].value, context);
+    }
+    status = SRGAnalyticsLabelsDeltaStatusExpanded;
+
+exit:
+    free(removedKeys);
+    free(removedBuffer);
+    free(changes);
+    return status;
+}
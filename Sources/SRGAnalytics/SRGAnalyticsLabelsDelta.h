@@ -0,0 +1,100 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGAnalyticsLabelsDelta_h
+#define SRGAnalyticsLabelsDelta_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Delta-encoded label records.
+ *
+ *  Records of a session are numbered in sequence, starting at 0. A key frame contains all labels. Other records only
+ *  contain labels which were added or changed since the previous record (their base), as well as the list of labels
+ *  which were removed. Both kinds of records contain the following reserved labels:
+ *
+ *    - `delta_session_id`: The session identifier.
+ *    - `delta_sequence`: The decimal sequence number of the record within its session.
+ *
+ *  Delta records additionally contain:
+ *
+ *    - `delta_base`: The decimal sequence number of the record the delta applies to.
+ *    - `delta_removed`: Comma-separated keys of labels removed since the base record (omitted if none).
+ *
+ *  Records without a `delta_session_id` label are not delta-encoded. Label keys must not contain commas.
+ */
+#define SRGAnalyticsLabelsDeltaSessionKey "delta_session_id"
+#define SRGAnalyticsLabelsDeltaSequenceKey "delta_sequence"
+#define SRGAnalyticsLabelsDeltaBaseKey "delta_base"
+#define SRGAnalyticsLabelsDeltaRemovedKey "delta_removed"
+
+/**
+ *  A label, as a pair of NUL-terminated UTF-8 strings.
+ */
+typedef struct {
+    const char *key;
+    const char *value;
+} SRGAnalyticsLabel;
+
+/**
+ *  Expansion status.
+ */
+typedef enum {
+    SRGAnalyticsLabelsDeltaStatusUnencoded = 0,     // The record is not delta-encoded and is provided as is.
+    SRGAnalyticsLabelsDeltaStatusExpanded,          // The record (key frame or delta) has been expanded.
+    SRGAnalyticsLabelsDeltaStatusMissingBase,       // The base of a delta record is unknown (session evicted, records lost or out of order).
+    SRGAnalyticsLabelsDeltaStatusInvalid            // The record is malformed or memory could not be allocated.
+} SRGAnalyticsLabelsDeltaStatus;
+
+/**
+ *  Expander reconstructing full records from delta-encoded ones. Records of a session must be expanded in sequence.
+ *  Sessions are forgotten once a key frame is received for another one while `sessionCapacity` sessions are already
+ *  known, least recently used first.
+ *
+ *  An expander is not thread-safe and must be used from a single thread (or serial queue) at a time.
+ */
+typedef struct SRGAnalyticsLabelsDeltaExpander SRGAnalyticsLabelsDeltaExpander;
+
+/**
+ *  Create an expander. Returns `NULL` if memory could not be allocated.
+ */
+SRGAnalyticsLabelsDeltaExpander *SRGAnalyticsLabelsDeltaExpanderCreate(size_t sessionCapacity);
+
+/**
+ *  Destroy an expander.
+ */
+void SRGAnalyticsLabelsDeltaExpanderDestroy(SRGAnalyticsLabelsDeltaExpander *expander);
+
+/**
+ *  Forget a session, e.g. once it is known to have ended.
+ */
+void SRGAnalyticsLabelsDeltaExpanderEndSession(SRGAnalyticsLabelsDeltaExpander *expander, const char *sessionIdentifier);
+
+/**
+ *  Expand a record made of `count` labels with unique keys, in any order. If the returned status is
+ *  `SRGAnalyticsLabelsDeltaStatusUnencoded` or `SRGAnalyticsLabelsDeltaStatusExpanded`, the callback is called
+ *  for each label of the full record, in key order. Reserved labels are omitted from expanded records. Strings
+ *  received by the callback are only valid during the call.
+ */
+typedef void (*SRGAnalyticsLabelsDeltaCallback)(const char *key, const char *value, void *context);
+
+SRGAnalyticsLabelsDeltaStatus SRGAnalyticsLabelsDeltaExpanderExpand(SRGAnalyticsLabelsDeltaExpander *expander,
+                                                                    const SRGAnalyticsLabel *labels,
+                                                                    size_t count,
+                                                                    SRGAnalyticsLabelsDeltaCallback callback,
+                                                                    void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGAnalyticsLabelsDelta_h */
@@ -0,0 +1,52 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsLabels.h"
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Immutable snapshot of the default labels sent with each event, merging global labels with labels supplied by the
+ *  tracker data source. A snapshot is built once and shared by reference by all events recorded until global labels,
+ *  or the labels supplied by the data source, change.
+ */
+@interface SRGAnalyticsLabelsSnapshot : NSObject
+
+/**
+ *  Create a snapshot with the specified version number.
+ */
+- (instancetype)initWithGlobalLabels:(nullable SRGAnalyticsLabels *)globalLabels
+                    dataSourceLabels:(nullable SRGAnalyticsLabels *)dataSourceLabels
+                             version:(uint64_t)version NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The snapshot version. Each snapshot built by a tracker has a larger version number than the previous one.
+ */
+@property (nonatomic, readonly) uint64_t version;
+
+/**
+ *  The labels the snapshot was built from.
+ */
+@property (nonatomic, readonly, nullable) SRGAnalyticsLabels *globalLabels;
+@property (nonatomic, readonly, nullable) SRGAnalyticsLabels *dataSourceLabels;
+
+/**
+ *  Merged labels for Commanders Act and comScore. Data source labels take precedence over global labels.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSString *> *labelsDictionary;
+@property (nonatomic, readonly) NSDictionary<NSString *, NSString *> *comScoreLabelsDictionary;
+
+@end
+
+@interface SRGAnalyticsLabelsSnapshot (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,74 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsLabelsSnapshot.h"
+
+#import "SRGAnalyticsLabels+Private.h"
+
+static void SRGAnalyticsAddLabels(SRGAnalyticsLabels *labels, NSMutableDictionary *labelsDictionary, NSMutableDictionary *comScoreLabelsDictionary)
+{
+    [labels.labelStore addEntriesToDictionary:labelsDictionary];
+    [labels.comScoreLabelStore addEntriesToDictionary:comScoreLabelsDictionary];
+}
+
+@interface SRGAnalyticsLabelsSnapshot ()
+
+@property (nonatomic) uint64_t version;
+@property (nonatomic) SRGAnalyticsLabels *globalLabels;
+@property (nonatomic) SRGAnalyticsLabels *dataSourceLabels;
+@property (nonatomic) NSDictionary<NSString *, NSString *> *labelsDictionary;
+@property (nonatomic) NSDictionary<NSString *, NSString *> *comScoreLabelsDictionary;
+
+@end
+
+@implementation SRGAnalyticsLabelsSnapshot
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithGlobalLabels:(SRGAnalyticsLabels *)globalLabels
+                    dataSourceLabels:(SRGAnalyticsLabels *)dataSourceLabels
+                             version:(uint64_t)version
+{
+    if (self = [super init]) {
+        self.version = version;
+        self.globalLabels = globalLabels.copy;
+        self.dataSourceLabels = dataSourceLabels.copy;
+
+        NSMutableDictionary<NSString *, NSString *> *labelsDictionary = [NSMutableDictionary dictionary];
+        NSMutableDictionary<NSString *, NSString *> *comScoreLabelsDictionary = [NSMutableDictionary dictionary];
+        SRGAnalyticsAddLabels(self.globalLabels, labelsDictionary, comScoreLabelsDictionary);
+        SRGAnalyticsAddLabels(self.dataSourceLabels, labelsDictionary, comScoreLabelsDictionary);
+        
+        self.labelsDictionary = labelsDictionary.copy;
+        self.comScoreLabelsDictionary = comScoreLabelsDictionary.copy;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithGlobalLabels:nil dataSourceLabels:nil version:0];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; version = %@; labelsDictionary = %@; comScoreLabelsDictionary = %@>",
+            self.class,
+            self,
+            @(self.version),
+            self.labelsDictionary,
+            self.comScoreLabelsDictionary];
+}
+
+@end
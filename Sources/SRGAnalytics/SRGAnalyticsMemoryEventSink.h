@@ -0,0 +1,52 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventSink.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Sink keeping the most recent payloads in memory, mostly useful for tests and benchmarks. When full, the oldest
+ *  payloads are discarded.
+ *
+ *  @discussion Thread-safe.
+ */
+@interface SRGAnalyticsMemoryEventSink : NSObject <SRGAnalyticsEventSink>
+
+/**
+ *  Create a sink keeping at most `capacity` payloads.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The maximum number of payloads kept.
+ */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/**
+ *  The payloads currently kept, from the oldest to the most recent one.
+ */
+@property (nonatomic, readonly) NSArray<NSDictionary<NSString *, id> *> *payloads;
+
+/**
+ *  The total number of payloads delivered to the sink, including discarded ones.
+ */
+@property (nonatomic, readonly) NSUInteger deliveredCount;
+
+/**
+ *  Discard all payloads and reset the delivered count.
+ */
+- (void)reset;
+
+@end
+
+@interface SRGAnalyticsMemoryEventSink (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,115 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsMemoryEventSink.h"
+
+#import <os/lock.h>
+
+@interface SRGAnalyticsMemoryEventSink () {
+@private
+    os_unfair_lock _lock;
+    NSMutableArray<NSDictionary<NSString *, id> *> *_payloads;
+    NSUInteger _headIndex;                  // Index of the oldest payload once the sink is full
+    NSUInteger _deliveredCount;
+}
+
+@property (nonatomic) NSUInteger capacity;
+
+@end
+
+@implementation SRGAnalyticsMemoryEventSink
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        self.capacity = MAX(capacity, 1);
+        _payloads = [NSMutableArray arrayWithCapacity:MIN(self.capacity, 1024)];
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithCapacity:1];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Getters and setters
+
+- (NSArray<NSDictionary<NSString *,id> *> *)payloads
+{
+    os_unfair_lock_lock(&_lock);
+    NSArray<NSDictionary<NSString *, id> *> *payloads = nil;
+    if (_headIndex == 0) {
+        payloads = _payloads.copy;
+    }
+    else {
+        NSRange olderRange = NSMakeRange(_headIndex, _payloads.count - _headIndex);
+        payloads = [[_payloads subarrayWithRange:olderRange] arrayByAddingObjectsFromArray:[_payloads subarrayWithRange:NSMakeRange(0, _headIndex)]];
+    }
+    os_unfair_lock_unlock(&_lock);
+    return payloads;
+}
+
+- (NSUInteger)deliveredCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger deliveredCount = _deliveredCount;
+    os_unfair_lock_unlock(&_lock);
+    return deliveredCount;
+}
+
+#pragma mark Reset
+
+- (void)reset
+{
+    os_unfair_lock_lock(&_lock);
+    [_payloads removeAllObjects];
+    _headIndex = 0;
+    _deliveredCount = 0;
+    os_unfair_lock_unlock(&_lock);
+}
+
+#pragma mark SRGAnalyticsEventSink protocol
+
+- (void)deliverPayloads:(NSArray<NSDictionary<NSString *, id> *> *)payloads completion:(void (^)(SRGAnalyticsEventSinkDeliveryResult))completion
+{
+    os_unfair_lock_lock(&_lock);
+    for (NSDictionary<NSString *, id> *payload in payloads) {
+        if (_payloads.count < self.capacity) {
+            [_payloads addObject:payload];
+        }
+        else {
+            _payloads[_headIndex] = payload;
+            _headIndex = (_headIndex + 1) % self.capacity;
+        }
+    }
+    _deliveredCount += payloads.count;
+    os_unfair_lock_unlock(&_lock);
+    
+    completion(SRGAnalyticsEventSinkDeliveryResultSuccess);
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; capacity = %@; deliveredCount = %@>",
+            self.class,
+            self,
+            @(self.capacity),
+            @(self.deliveredCount)];
+}
+
+@end
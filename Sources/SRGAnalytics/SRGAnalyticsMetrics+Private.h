@@ -0,0 +1,76 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsMetrics.h"
+
+@import Foundation;
+
+#import <stdatomic.h>
+#import <time.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Latencies recorded by the tracker pipeline.
+ */
+typedef NS_ENUM(NSInteger, SRGAnalyticsMetricsLatency) {
+    SRGAnalyticsMetricsLatencyLabelBuild = 0,
+    SRGAnalyticsMetricsLatencyLabelMerge,
+    SRGAnalyticsMetricsLatencySerialization,
+    SRGAnalyticsMetricsLatencyDispatch,
+    SRGAnalyticsMetricsLatencyCount
+};
+
+/**
+ *  Maximum number of distinct event names counted between resets (@see `SRGAnalyticsMetricsOtherEventsName`).
+ */
+static const NSUInteger SRGAnalyticsMetricsMaximumEventNameCount = 64;
+
+OBJC_EXPORT _Atomic(bool) SRGAnalyticsMetricsEnabledFlag;
+
+/**
+ *  Return `YES` iff metrics are collected. Metrics functions below do nothing when metrics are disabled, but callers
+ *  should check this function first when computing values is not free.
+ */
+static inline BOOL SRGAnalyticsMetricsEnabled(void)
+{
+    return atomic_load_explicit(&SRGAnalyticsMetricsEnabledFlag, memory_order_relaxed);
+}
+
+/**
+ *  Return the start time of a latency measurement, 0 if metrics are disabled.
+ */
+static inline uint64_t SRGAnalyticsMetricsStartTime(void)
+{
+    return SRGAnalyticsMetricsEnabled() ? clock_gettime_nsec_np(CLOCK_UPTIME_RAW) : 0;
+}
+
+/**
+ *  Enable or disable metrics collection. Metrics are reset when enabled.
+ */
+OBJC_EXPORT void SRGAnalyticsMetricsSetEnabled(BOOL enabled);
+
+/**
+ *  Record the latency of a measurement started at the specified time (@see `SRGAnalyticsMetricsStartTime()`). Does
+ *  nothing if the start time is 0.
+ */
+OBJC_EXPORT void SRGAnalyticsMetricsRecordLatency(SRGAnalyticsMetricsLatency latency, uint64_t startTime);
+
+/**
+ *  Counters and high-water marks.
+ */
+OBJC_EXPORT void SRGAnalyticsMetricsRecordEvent(NSString *name);
+OBJC_EXPORT void SRGAnalyticsMetricsRecordProducedBytes(NSUInteger byteCount);
+OBJC_EXPORT void SRGAnalyticsMetricsRecordEventQueueDepth(NSUInteger depth);
+OBJC_EXPORT void SRGAnalyticsMetricsRecordHeartbeatTimerWakeUp(void);
+OBJC_EXPORT void SRGAnalyticsMetricsRecordMediaPlayerTrackerHeartbeats(NSUInteger heartbeatCount);
+
+/**
+ *  Return a snapshot of collected metrics, optionally resetting them. Returns `nil` if metrics are disabled.
+ */
+OBJC_EXPORT SRGAnalyticsMetricsSnapshot * _Nullable SRGAnalyticsMetricsTakeSnapshot(BOOL reset);
+
+NS_ASSUME_NONNULL_END
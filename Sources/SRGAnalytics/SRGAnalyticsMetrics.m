@@ -0,0 +1,311 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsMetrics+Private.h"
+
+#import "SRGAnalyticsHistogram.h"
+
+#import <os/lock.h>
+
+SRGAnalyticsMetricsStage const SRGAnalyticsMetricsStageLabelBuild = @"label_build";
+SRGAnalyticsMetricsStage const SRGAnalyticsMetricsStageLabelMerge = @"label_merge";
+SRGAnalyticsMetricsStage const SRGAnalyticsMetricsStageSerialization = @"serialization";
+SRGAnalyticsMetricsStage const SRGAnalyticsMetricsStageDispatch = @"dispatch";
+
+NSString * const SRGAnalyticsMetricsOtherEventsName = @"(other)";
+
+_Atomic(bool) SRGAnalyticsMetricsEnabledFlag = false;
+
+// Fixed storage, so that no allocation is required when recording values
+static SRGAnalyticsHistogram s_latencyHistograms[SRGAnalyticsMetricsLatencyCount];
+static SRGAnalyticsHistogram s_mediaPlayerTrackerHeartbeatsHistogram;
+static _Atomic uint64_t s_producedByteCount = 0;
+static _Atomic uint64_t s_eventQueueHighWaterMark = 0;
+static _Atomic uint64_t s_heartbeatTimerWakeUpCount = 0;
+static _Atomic uint64_t s_startTime = 0;
+
+static os_unfair_lock s_eventCountsLock = OS_UNFAIR_LOCK_INIT;
+static NSMutableDictionary<NSString *, NSNumber *> *s_eventCounts = nil;
+
+@interface SRGAnalyticsMetricsDistribution ()
+
+- (instancetype)initWithSnapshot:(const SRGAnalyticsHistogramSnapshot *)snapshot scale:(double)scale;
+
+@property (nonatomic) NSData *snapshotData;
+@property (nonatomic) double scale;
+
+@end
+
+@interface SRGAnalyticsMetricsSnapshot ()
+
+- (instancetype)initWithDuration:(NSTimeInterval)duration;
+
+@property (nonatomic) NSTimeInterval duration;
+@property (nonatomic) NSDictionary<SRGAnalyticsMetricsStage, SRGAnalyticsMetricsDistribution *> *stageLatencies;
+@property (nonatomic) NSDictionary<NSString *, NSNumber *> *eventCounts;
+@property (nonatomic) unsigned long long producedByteCount;
+@property (nonatomic) NSUInteger eventQueueHighWaterMark;
+@property (nonatomic) NSUInteger heartbeatTimerWakeUpCount;
+@property (nonatomic) SRGAnalyticsMetricsDistribution *mediaPlayerTrackerHeartbeats;
+
+@end
+
+@implementation SRGAnalyticsMetricsDistribution
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithSnapshot:(const SRGAnalyticsHistogramSnapshot *)snapshot scale:(double)scale
+{
+    if (self = [super init]) {
+        self.snapshotData = [NSData dataWithBytes:snapshot length:sizeof(SRGAnalyticsHistogramSnapshot)];
+        self.scale = scale;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    SRGAnalyticsHistogramSnapshot snapshot = { 0 };
+    return [self initWithSnapshot:&snapshot scale:1.];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Getters and setters
+
+- (const SRGAnalyticsHistogramSnapshot *)snapshot
+{
+    return self.snapshotData.bytes;
+}
+
+- (NSUInteger)count
+{
+    return (NSUInteger)self.snapshot->count;
+}
+
+- (double)mean
+{
+    const SRGAnalyticsHistogramSnapshot *snapshot = self.snapshot;
+    return (snapshot->count != 0) ? (double)snapshot->sum / (double)snapshot->count * self.scale : 0.;
+}
+
+- (double)maximum
+{
+    return (double)self.snapshot->maximum * self.scale;
+}
+
+#pragma mark Percentiles
+
+- (double)valueAtPercentile:(double)percentile
+{
+    return (double)SRGAnalyticsHistogramSnapshotValueAtQuantile(self.snapshot, percentile / 100.) * self.scale;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; count = %@; mean = %@; p50 = %@; p99 = %@; maximum = %@>",
+            self.class,
+            self,
+            @(self.count),
+            @(self.mean),
+            @([self valueAtPercentile:50.]),
+            @([self valueAtPercentile:99.]),
+            @(self.maximum)];
+}
+
+@end
+
+@implementation SRGAnalyticsMetricsSnapshot
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithDuration:(NSTimeInterval)duration
+{
+    if (self = [super init]) {
+        self.duration = duration;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithDuration:0.];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; duration = %@; stageLatencies = %@; eventCounts = %@; producedByteCount = %@; "
+            "eventQueueHighWaterMark = %@; heartbeatTimerWakeUpCount = %@; mediaPlayerTrackerHeartbeats = %@>",
+            self.class,
+            self,
+            @(self.duration),
+            self.stageLatencies,
+            self.eventCounts,
+            @(self.producedByteCount),
+            @(self.eventQueueHighWaterMark),
+            @(self.heartbeatTimerWakeUpCount),
+            self.mediaPlayerTrackerHeartbeats];
+}
+
+@end
+
+#pragma mark Functions
+
+static uint64_t SRGAnalyticsMetricsCurrentTime(void)
+{
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+static uint64_t SRGAnalyticsMetricsLoadCounter(_Atomic uint64_t *counter, BOOL reset)
+{
+    return reset ? atomic_exchange_explicit(counter, 0, memory_order_relaxed) : atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+void SRGAnalyticsMetricsSetEnabled(BOOL enabled)
+{
+    if (enabled && ! SRGAnalyticsMetricsEnabled()) {
+        SRGAnalyticsHistogramSnapshot *snapshot = malloc(sizeof(SRGAnalyticsHistogramSnapshot));
+        for (NSInteger i = 0; i < SRGAnalyticsMetricsLatencyCount; ++i) {
+            SRGAnalyticsHistogramCopy(&s_latencyHistograms[i], snapshot, true);
+        }
+        SRGAnalyticsHistogramCopy(&s_mediaPlayerTrackerHeartbeatsHistogram, snapshot, true);
+        free(snapshot);
+        
+        atomic_store_explicit(&s_producedByteCount, 0, memory_order_relaxed);
+        atomic_store_explicit(&s_eventQueueHighWaterMark, 0, memory_order_relaxed);
+        atomic_store_explicit(&s_heartbeatTimerWakeUpCount, 0, memory_order_relaxed);
+        atomic_store_explicit(&s_startTime, SRGAnalyticsMetricsCurrentTime(), memory_order_relaxed);
+        
+        os_unfair_lock_lock(&s_eventCountsLock);
+        s_eventCounts = [NSMutableDictionary dictionary];
+        os_unfair_lock_unlock(&s_eventCountsLock);
+    }
+    atomic_store_explicit(&SRGAnalyticsMetricsEnabledFlag, enabled, memory_order_relaxed);
+}
+
+void SRGAnalyticsMetricsRecordLatency(SRGAnalyticsMetricsLatency latency, uint64_t startTime)
+{
+    if (startTime == 0 || ! SRGAnalyticsMetricsEnabled()) {
+        return;
+    }
+    
+    uint64_t currentTime = SRGAnalyticsMetricsCurrentTime();
+    SRGAnalyticsHistogramRecord(&s_latencyHistograms[latency], (currentTime > startTime) ? currentTime - startTime : 0);
+}
+
+void SRGAnalyticsMetricsRecordEvent(NSString *name)
+{
+    if (! SRGAnalyticsMetricsEnabled()) {
+        return;
+    }
+    
+    os_unfair_lock_lock(&s_eventCountsLock);
+    // Names can be page titles, bound the number of counters
+    if (! s_eventCounts[name] && s_eventCounts.count >= SRGAnalyticsMetricsMaximumEventNameCount) {
+        name = SRGAnalyticsMetricsOtherEventsName;
+    }
+    s_eventCounts[name] = @(s_eventCounts[name].unsignedIntegerValue + 1);
+    os_unfair_lock_unlock(&s_eventCountsLock);
+}
+
+void SRGAnalyticsMetricsRecordProducedBytes(NSUInteger byteCount)
+{
+    if (! SRGAnalyticsMetricsEnabled()) {
+        return;
+    }
+    
+    atomic_fetch_add_explicit(&s_producedByteCount, byteCount, memory_order_relaxed);
+}
+
+void SRGAnalyticsMetricsRecordEventQueueDepth(NSUInteger depth)
+{
+    if (! SRGAnalyticsMetricsEnabled()) {
+        return;
+    }
+    
+    uint64_t highWaterMark = atomic_load_explicit(&s_eventQueueHighWaterMark, memory_order_relaxed);
+    while (depth > highWaterMark && ! atomic_compare_exchange_weak_explicit(&s_eventQueueHighWaterMark, &highWaterMark, depth, memory_order_relaxed, memory_order_relaxed));
+}
+
+void SRGAnalyticsMetricsRecordHeartbeatTimerWakeUp(void)
+{
+    if (! SRGAnalyticsMetricsEnabled()) {
+        return;
+    }
+    
+    atomic_fetch_add_explicit(&s_heartbeatTimerWakeUpCount, 1, memory_order_relaxed);
+}
+
+void SRGAnalyticsMetricsRecordMediaPlayerTrackerHeartbeats(NSUInteger heartbeatCount)
+{
+    if (! SRGAnalyticsMetricsEnabled()) {
+        return;
+    }
+    
+    SRGAnalyticsHistogramRecord(&s_mediaPlayerTrackerHeartbeatsHistogram, heartbeatCount);
+}
+
+SRGAnalyticsMetricsSnapshot *SRGAnalyticsMetricsTakeSnapshot(BOOL reset)
+{
+    if (! SRGAnalyticsMetricsEnabled()) {
+        return nil;
+    }
+    
+    uint64_t currentTime = SRGAnalyticsMetricsCurrentTime();
+    uint64_t startTime = reset ? atomic_exchange_explicit(&s_startTime, currentTime, memory_order_relaxed) : atomic_load_explicit(&s_startTime, memory_order_relaxed);
+    NSTimeInterval duration = (currentTime > startTime) ? (double)(currentTime - startTime) / NSEC_PER_SEC : 0.;
+    SRGAnalyticsMetricsSnapshot *metricsSnapshot = [[SRGAnalyticsMetricsSnapshot alloc] initWithDuration:duration];
+    
+    static NSArray<SRGAnalyticsMetricsStage> *s_stages;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_stages = @[ SRGAnalyticsMetricsStageLabelBuild, SRGAnalyticsMetricsStageLabelMerge, SRGAnalyticsMetricsStageSerialization, SRGAnalyticsMetricsStageDispatch ];
+    });
+    
+    // Snapshots are large, avoid the stack
+    SRGAnalyticsHistogramSnapshot *snapshot = malloc(sizeof(SRGAnalyticsHistogramSnapshot));
+    
+    NSMutableDictionary<SRGAnalyticsMetricsStage, SRGAnalyticsMetricsDistribution *> *stageLatencies = [NSMutableDictionary dictionary];
+    for (NSInteger i = 0; i < SRGAnalyticsMetricsLatencyCount; ++i) {
+        SRGAnalyticsHistogramCopy(&s_latencyHistograms[i], snapshot, reset);
+        if (snapshot->count != 0) {
+            stageLatencies[s_stages[i]] = [[SRGAnalyticsMetricsDistribution alloc] initWithSnapshot:snapshot scale:1. / NSEC_PER_SEC];
+        }
+    }
+    metricsSnapshot.stageLatencies = stageLatencies.copy;
+    
+    SRGAnalyticsHistogramCopy(&s_mediaPlayerTrackerHeartbeatsHistogram, snapshot, reset);
+    metricsSnapshot.mediaPlayerTrackerHeartbeats = [[SRGAnalyticsMetricsDistribution alloc] initWithSnapshot:snapshot scale:1.];
+    
+    free(snapshot);
+    
+    metricsSnapshot.producedByteCount = SRGAnalyticsMetricsLoadCounter(&s_producedByteCount, reset);
+    metricsSnapshot.eventQueueHighWaterMark = (NSUInteger)SRGAnalyticsMetricsLoadCounter(&s_eventQueueHighWaterMark, reset);
+    metricsSnapshot.heartbeatTimerWakeUpCount = (NSUInteger)SRGAnalyticsMetricsLoadCounter(&s_heartbeatTimerWakeUpCount, reset);
+    
+    os_unfair_lock_lock(&s_eventCountsLock);
+    metricsSnapshot.eventCounts = s_eventCounts.copy ?: @{};
+    if (reset) {
+        [s_eventCounts removeAllObjects];
+    }
+    os_unfair_lock_unlock(&s_eventCountsLock);
+    
+    return metricsSnapshot;
+}
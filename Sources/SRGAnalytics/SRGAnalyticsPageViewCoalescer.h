@@ -0,0 +1,50 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsPageViewLabels.h"
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Coalesces automatic page views recorded in rapid succession (e.g. when quickly switching tabs or bouncing through
+ *  the app switcher). Identical page views (same title, type, levels and labels) are sent at most once within the
+ *  specified time interval. Page views differing in any of these values are never coalesced.
+ *
+ *  @discussion Must be used from the main thread.
+ */
+@interface SRGAnalyticsPageViewCoalescer : NSObject
+
+/**
+ *  Create a coalescer with the specified time interval.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The interval during which identical page views are coalesced.
+ */
+@property (nonatomic, readonly) NSTimeInterval interval;
+
+/**
+ *  Return `YES` iff the page view must be sent, `NO` if an identical page view has been sent within the interval. When
+ *  `YES` is returned the page view is recorded as sent.
+ */
+- (BOOL)shouldTrackPageViewWithTitle:(NSString *)title
+                                type:(NSString *)type
+                              levels:(nullable NSArray<NSString *> *)levels
+                              labels:(nullable SRGAnalyticsPageViewLabels *)labels
+                fromPushNotification:(BOOL)fromPushNotification;
+
+@end
+
+@interface SRGAnalyticsPageViewCoalescer (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,166 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsPageViewCoalescer.h"
+
+// Identifies identical page views
+@interface SRGAnalyticsPageViewKey : NSObject <NSCopying>
+
+- (instancetype)initWithTitle:(NSString *)title
+                         type:(NSString *)type
+                       levels:(NSArray<NSString *> *)levels
+                       labels:(SRGAnalyticsPageViewLabels *)labels
+         fromPushNotification:(BOOL)fromPushNotification;
+
+@property (nonatomic, readonly, copy) NSString *title;
+@property (nonatomic, readonly, copy) NSString *type;
+@property (nonatomic, readonly, copy) NSArray<NSString *> *levels;
+@property (nonatomic, readonly) SRGAnalyticsPageViewLabels *labels;
+@property (nonatomic, readonly) BOOL fromPushNotification;
+
+@end
+
+@interface SRGAnalyticsPageViewCoalescer ()
+
+@property (nonatomic) NSTimeInterval interval;
+
+@property (nonatomic) NSMutableDictionary<SRGAnalyticsPageViewKey *, NSNumber *> *pageViewTimes;
+
+@end
+
+@implementation SRGAnalyticsPageViewCoalescer
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+{
+    if (self = [super init]) {
+        self.interval = interval;
+        self.pageViewTimes = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithInterval:0.];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Coalescing
+
+- (BOOL)shouldTrackPageViewWithTitle:(NSString *)title
+                                type:(NSString *)type
+                              levels:(NSArray<NSString *> *)levels
+                              labels:(SRGAnalyticsPageViewLabels *)labels
+                fromPushNotification:(BOOL)fromPushNotification
+{
+    NSTimeInterval currentTime = NSProcessInfo.processInfo.systemUptime;
+    [self discardTimesBefore:currentTime - self.interval];
+    
+    SRGAnalyticsPageViewKey *key = [[SRGAnalyticsPageViewKey alloc] initWithTitle:title
+                                                                             type:type
+                                                                           levels:levels
+                                                                           labels:labels
+                                                             fromPushNotification:fromPushNotification];
+    NSNumber *time = self.pageViewTimes[key];
+    if (time && currentTime - time.doubleValue < self.interval) {
+        return NO;
+    }
+    
+    self.pageViewTimes[key] = @(currentTime);
+    return YES;
+}
+
+// Only a few page views are sent within an interval, the dictionary therefore remains small
+- (void)discardTimesBefore:(NSTimeInterval)time
+{
+    NSMutableArray<SRGAnalyticsPageViewKey *> *expiredKeys = nil;
+    for (SRGAnalyticsPageViewKey *key in self.pageViewTimes) {
+        if (self.pageViewTimes[key].doubleValue <= time) {
+            if (! expiredKeys) {
+                expiredKeys = [NSMutableArray array];
+            }
+            [expiredKeys addObject:key];
+        }
+    }
+    if (expiredKeys) {
+        [self.pageViewTimes removeObjectsForKeys:expiredKeys];
+    }
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; interval = %@; count = %@>",
+            self.class,
+            self,
+            @(self.interval),
+            @(self.pageViewTimes.count)];
+}
+
+@end
+
+@implementation SRGAnalyticsPageViewKey
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithTitle:(NSString *)title
+                         type:(NSString *)type
+                       levels:(NSArray<NSString *> *)levels
+                       labels:(SRGAnalyticsPageViewLabels *)labels
+         fromPushNotification:(BOOL)fromPushNotification
+{
+    if (self = [super init]) {
+        _title = title.copy;
+        _type = type.copy;
+        _levels = levels.copy;
+        _labels = labels.copy;
+        _fromPushNotification = fromPushNotification;
+    }
+    return self;
+}
+
+#pragma mark Equality
+
+- (BOOL)isEqual:(id)object
+{
+    if (! [object isKindOfClass:SRGAnalyticsPageViewKey.class]) {
+        return NO;
+    }
+    
+    SRGAnalyticsPageViewKey *otherKey = object;
+    return [self.title isEqualToString:otherKey.title]
+        && [self.type isEqualToString:otherKey.type]
+        && (self.levels == otherKey.levels || [self.levels isEqualToArray:otherKey.levels])
+        && (self.labels == otherKey.labels || [self.labels isEqual:otherKey.labels])
+        && self.fromPushNotification == otherKey.fromPushNotification;
+}
+
+- (NSUInteger)hash
+{
+    NSUInteger hash = self.title.hash;
+    hash = hash * 31 + self.type.hash;
+    hash = hash * 31 + self.levels.lastObject.hash + self.levels.count;
+    hash = hash * 31 + self.labels.hash;
+    return hash * 2 + (self.fromPushNotification ? 1 : 0);
+}
+
+#pragma mark NSCopying protocol
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // Immutable
+    return self;
+}
+
+@end
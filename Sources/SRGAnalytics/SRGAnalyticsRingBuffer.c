@@ -0,0 +1,134 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsRingBuffer.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Bounded queue by Dmitry Vyukov: each cell carries a sequence number telling whether it is ready to be written
+// (sequence == position) or read (sequence == position + 1). Producers and consumers only contend on their own
+// position counter, which live on separate cache lines.
+
+#define SRGAnalyticsRingBufferCacheLineSize 64
+
+typedef struct {
+    _Atomic size_t sequence;
+    void *item;
+} SRGAnalyticsRingBufferCell;
+
+struct SRGAnalyticsRingBuffer {
+    SRGAnalyticsRingBufferCell *cells;
+    size_t mask;
+
+    _Alignas(SRGAnalyticsRingBufferCacheLineSize) _Atomic size_t pushPosition;
+    _Alignas(SRGAnalyticsRingBufferCacheLineSize) _Atomic size_t popPosition;
+};
+
+SRGAnalyticsRingBuffer *SRGAnalyticsRingBufferCreate(size_t capacity)
+{
+    size_t effectiveCapacity = 2;
+    while (effectiveCapacity < capacity) {
+        if (effectiveCapacity > SIZE_MAX / 2) {
+            return NULL;
+        }
+        effectiveCapacity *= 2;
+    }
+
+    SRGAnalyticsRingBuffer *ringBuffer = calloc(1, sizeof(SRGAnalyticsRingBuffer));
+    if (! ringBuffer) {
+        return NULL;
+    }
+
+    ringBuffer->cells = calloc(effectiveCapacity, sizeof(SRGAnalyticsRingBufferCell));
+    if (! ringBuffer->cells) {
+        free(ringBuffer);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < effectiveCapacity; ++i) {
+        atomic_init(&ringBuffer->cells[i].sequence, i);
+    }
+    ringBuffer->mask = effectiveCapacity - 1;
+    atomic_init(&ringBuffer->pushPosition, 0);
+    atomic_init(&ringBuffer->popPosition, 0);
+    return ringBuffer;
+}
+
+void SRGAnalyticsRingBufferDestroy(SRGAnalyticsRingBuffer *ringBuffer)
+{
+    if (! ringBuffer) {
+        return;
+    }
+
+    free(ringBuffer->cells);
+    free(ringBuffer);
+}
+
+size_t SRGAnalyticsRingBufferCapacity(const SRGAnalyticsRingBuffer *ringBuffer)
+{
+    return ringBuffer->mask + 1;
+}
+
+size_t SRGAnalyticsRingBufferCount(const SRGAnalyticsRingBuffer *ringBuffer)
+{
+    size_t popPosition = atomic_load_explicit(&((SRGAnalyticsRingBuffer *)ringBuffer)->popPosition, memory_order_relaxed);
+    size_t pushPosition = atomic_load_explicit(&((SRGAnalyticsRingBuffer *)ringBuffer)->pushPosition, memory_order_relaxed);
+    size_t count = pushPosition - popPosition;
+
+    // Both positions are read independently, clamp the result to a meaningful value
+    size_t capacity = ringBuffer->mask + 1;
+    return (count > capacity) ? capacity : count;
+}
+
+bool SRGAnalyticsRingBufferPush(SRGAnalyticsRingBuffer *ringBuffer, void *item)
+{
+    size_t position = atomic_load_explicit(&ringBuffer->pushPosition, memory_order_relaxed);
+    while (true) {
+        SRGAnalyticsRingBufferCell *cell = &ringBuffer->cells[position & ringBuffer->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ringBuffer->pushPosition, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                cell->item = item;
+                atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+                return true;
+            }
+            // `position` has been updated by the failed exchange, retry with it
+        }
+        else if (difference < 0) {
+            return false;
+        }
+        else {
+            position = atomic_load_explicit(&ringBuffer->pushPosition, memory_order_relaxed);
+        }
+    }
+}
+
+bool SRGAnalyticsRingBufferPop(SRGAnalyticsRingBuffer *ringBuffer, void **item)
+{
+    size_t position = atomic_load_explicit(&ringBuffer->popPosition, memory_order_relaxed);
+    while (true) {
+        SRGAnalyticsRingBufferCell *cell = &ringBuffer->cells[position & ringBuffer->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ringBuffer->popPosition, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                *item = cell->item;
+                cell->item = NULL;
+                atomic_store_explicit(&cell->sequence, position + ringBuffer->mask + 1, memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0) {
+            return false;
+        }
+        else {
+            position = atomic_load_explicit(&ringBuffer->popPosition, memory_order_relaxed);
+        }
+    }
+}
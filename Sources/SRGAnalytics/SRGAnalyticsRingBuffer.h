@@ -0,0 +1,59 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGAnalyticsRingBuffer_h
+#define SRGAnalyticsRingBuffer_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Bounded lock-free FIFO ring buffer of opaque pointers. Any number of threads can push and pop concurrently. Items
+ *  are not owned by the buffer, which never retains or releases them.
+ */
+typedef struct SRGAnalyticsRingBuffer SRGAnalyticsRingBuffer;
+
+/**
+ *  Create a ring buffer able to hold at least `capacity` items. The capacity is rounded up to the next power of two
+ *  (at least 2). Returns `NULL` if memory could not be allocated.
+ */
+SRGAnalyticsRingBuffer *SRGAnalyticsRingBufferCreate(size_t capacity);
+
+/**
+ *  Destroy a ring buffer. Items still in the buffer are discarded without being released.
+ */
+void SRGAnalyticsRingBufferDestroy(SRGAnalyticsRingBuffer *ringBuffer);
+
+/**
+ *  The effective capacity of the ring buffer.
+ */
+size_t SRGAnalyticsRingBufferCapacity(const SRGAnalyticsRingBuffer *ringBuffer);
+
+/**
+ *  The number of items currently in the buffer. The value is only a snapshot when other threads push or pop
+ *  concurrently.
+ */
+size_t SRGAnalyticsRingBufferCount(const SRGAnalyticsRingBuffer *ringBuffer);
+
+/**
+ *  Push an item at the end of the buffer. Returns `false` if the buffer is full.
+ */
+bool SRGAnalyticsRingBufferPush(SRGAnalyticsRingBuffer *ringBuffer, void *item);
+
+/**
+ *  Pop the item at the front of the buffer. Returns `false` if the buffer is empty.
+ */
+bool SRGAnalyticsRingBufferPop(SRGAnalyticsRingBuffer *ringBuffer, void **item);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGAnalyticsRingBuffer_h */
@@ -0,0 +1,60 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsSampling.h"
+
+// 64-bit FNV-1a, with a byte separating both strings so that ("ab", "c") and ("a", "bc") differ
+static uint64_t SRGAnalyticsSamplingHash(const char *identifier, const char *name)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const unsigned char *byte = (const unsigned char *)identifier; *byte != '\0'; ++byte) {
+        hash = (hash ^ *byte) * 0x100000001b3;
+    }
+    hash = (hash ^ 0xff) * 0x100000001b3;
+    for (const unsigned char *byte = (const unsigned char *)name; *byte != '\0'; ++byte) {
+        hash = (hash ^ *byte) * 0x100000001b3;
+    }
+    
+    // FNV-1a high bits are poorly mixed for short inputs differing only at the end. Finalize them (splitmix64).
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111eb;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+double SRGAnalyticsSamplingPosition(const char *identifier, const char *name)
+{
+    // Keep 53 bits so that the conversion to double is exact
+    return (double)(SRGAnalyticsSamplingHash(identifier, name) >> 11) * 0x1.0p-53;
+}
+
+void SRGAnalyticsTokenBucketInit(SRGAnalyticsTokenBucket *bucket, uint64_t capacity, uint64_t interval, uint64_t time)
+{
+    bucket->capacity = (double)capacity;
+    bucket->tokens = (double)capacity;
+    bucket->tokensPerNanosecond = (interval != 0) ? (double)capacity / (double)interval : 0.;
+    bucket->time = time;
+}
+
+bool SRGAnalyticsTokenBucketConsume(SRGAnalyticsTokenBucket *bucket, uint64_t time)
+{
+    if (time > bucket->time) {
+        bucket->tokens += (double)(time - bucket->time) * bucket->tokensPerNanosecond;
+        if (bucket->tokens > bucket->capacity) {
+            bucket->tokens = bucket->capacity;
+        }
+        bucket->time = time;
+    }
+    
+    if (bucket->tokens < 1.) {
+        return false;
+    }
+    
+    bucket->tokens -= 1.;
+    return true;
+}
@@ -0,0 +1,49 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGAnalyticsSampling_h
+#define SRGAnalyticsSampling_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Return the position of an identifier within the sample space of an event name, in [0, 1). Positions are uniformly
+ *  distributed and only depend on the UTF-8 contents of both strings, so that they are stable across launches and
+ *  devices. An identifier is part of a sample with rate `r` if its position is strictly lower than `r`.
+ */
+double SRGAnalyticsSamplingPosition(const char *identifier, const char *name);
+
+/**
+ *  Token bucket. Up to `capacity` tokens are available at once and tokens are refilled continuously, `capacity` tokens
+ *  per interval. Times are expressed in nanoseconds and must be monotonic.
+ */
+typedef struct {
+    double capacity;
+    double tokens;
+    double tokensPerNanosecond;
+    uint64_t time;
+} SRGAnalyticsTokenBucket;
+
+/**
+ *  Initialize a full bucket at the specified time. The interval must be positive.
+ */
+void SRGAnalyticsTokenBucketInit(SRGAnalyticsTokenBucket *bucket, uint64_t capacity, uint64_t interval, uint64_t time);
+
+/**
+ *  Consume a token at the specified time. Returns `false` if no token is available.
+ */
+bool SRGAnalyticsTokenBucketConsume(SRGAnalyticsTokenBucket *bucket, uint64_t time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGAnalyticsSampling_h */
@@ -0,0 +1,63 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsSamplingPolicy.h"
+
+@implementation SRGAnalyticsSamplingPolicy
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithSamplingRate:(double)samplingRate
+                   maximumEventCount:(NSUInteger)maximumEventCount
+                            interval:(NSTimeInterval)interval
+{
+    if (self = [super init]) {
+        _samplingRate = fmax(fmin(samplingRate, 1.), 0.);
+        if (maximumEventCount != 0 && interval > 0.) {
+            _maximumEventCount = maximumEventCount;
+            _interval = interval;
+        }
+    }
+    return self;
+}
+
+- (instancetype)initWithSamplingRate:(double)samplingRate
+{
+    return [self initWithSamplingRate:samplingRate maximumEventCount:0 interval:0.];
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithSamplingRate:1.];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark NSCopying protocol
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // Immutable
+    return self;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; samplingRate = %@; maximumEventCount = %@; interval = %@>",
+            self.class,
+            self,
+            @(self.samplingRate),
+            @(self.maximumEventCount),
+            @(self.interval)];
+}
+
+@end
@@ -0,0 +1,389 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsStringFormatting.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Formatting is made in a single pass over the UTF-8 input. Each code point is mapped to a lowercase ASCII letter or
+// digit, to `and`, to nothing (combining marks, removed by diacritic folding) or to a separator. A pending separator
+// is written as a hyphen only when followed by some other output, which squashes runs and trims both ends for free.
+
+#define SRGAnalyticsFormattingCacheCapacity 32
+#define SRGAnalyticsFormattingCacheMaximumLength 128
+
+// Marker for characters replaced with `and`
+#define SRGAnalyticsAndMarker '&'
+
+static const char s_asciiTable[128] = {
+    ['0'] = '0', ['1'] = '1', ['2'] = '2', ['3'] = '3', ['4'] = '4', ['5'] = '5', ['6'] = '6', ['7'] = '7', ['8'] = '8', ['9'] = '9',
+    ['A'] = 'a', ['B'] = 'b', ['C'] = 'c', ['D'] = 'd', ['E'] = 'e', ['F'] = 'f', ['G'] = 'g', ['H'] = 'h', ['I'] = 'i',
+    ['J'] = 'j', ['K'] = 'k', ['L'] = 'l', ['M'] = 'm', ['N'] = 'n', ['O'] = 'o', ['P'] = 'p', ['Q'] = 'q', ['R'] = 'r',
+    ['S'] = 's', ['T'] = 't', ['U'] = 'u', ['V'] = 'v', ['W'] = 'w', ['X'] = 'x', ['Y'] = 'y', ['Z'] = 'z',
+    ['a'] = 'a', ['b'] = 'b', ['c'] = 'c', ['d'] = 'd', ['e'] = 'e', ['f'] = 'f', ['g'] = 'g', ['h'] = 'h', ['i'] = 'i',
+    ['j'] = 'j', ['k'] = 'k', ['l'] = 'l', ['m'] = 'm', ['n'] = 'n', ['o'] = 'o', ['p'] = 'p', ['q'] = 'q', ['r'] = 'r',
+    ['s'] = 's', ['t'] = 't', ['u'] = 'u', ['v'] = 'v', ['w'] = 'w', ['x'] = 'x', ['y'] = 'y', ['z'] = 'z',
+    ['+'] = SRGAnalyticsAndMarker, ['&'] = SRGAnalyticsAndMarker
+};
+
+// Lowercase letters with their diacritics removed (canonical decomposition), 0 if the result is not an ASCII letter
+// U+00C0 to U+024F
+static const char s_latinFoldTable[0x190] = {
+    /* 00C0 */ 'a', 'a', 'a', 'a', 'a', 'a',   0, 'c', 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',
+    /* 00D0 */   0, 'n', 'o', 'o', 'o', 'o', 'o',   0,   0, 'u', 'u', 'u', 'u', 'y',   0,   0,
+    /* 00E0 */ 'a', 'a', 'a', 'a', 'a', 'a',   0, 'c', 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',
+    /* 00F0 */   0, 'n', 'o', 'o', 'o', 'o', 'o',   0,   0, 'u', 'u', 'u', 'u', 'y',   0, 'y',
+    /* 0100 */ 'a', 'a', 'a', 'a', 'a', 'a', 'c', 'c', 'c', 'c', 'c', 'c', 'c', 'c', 'd', 'd',
+    /* 0110 */   0,   0, 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'g', 'g', 'g', 'g',
+    /* 0120 */ 'g', 'g', 'g', 'g', 'h', 'h',   0,   0, 'i', 'i', 'i', 'i', 'i', 'i', 'i', 'i',
+    /* 0130 */ 'i',   0,   0,   0, 'j', 'j', 'k', 'k',   0, 'l', 'l', 'l', 'l', 'l', 'l',   0,
+    /* 0140 */   0,   0,   0, 'n', 'n', 'n', 'n', 'n', 'n',   0,   0,   0, 'o', 'o', 'o', 'o',
+    /* 0150 */ 'o', 'o',   0,   0, 'r', 'r', 'r', 'r', 'r', 'r', 's', 's', 's', 's', 's', 's',
+    /* 0160 */ 's', 's', 't', 't', 't', 't',   0,   0, 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    /* 0170 */ 'u', 'u', 'u', 'u', 'w', 'w', 'y', 'y', 'y', 'z', 'z', 'z', 'z', 'z', 'z',   0,
+    /* 0180 */   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    /* 0190 */   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    /* 01A0 */ 'o', 'o',   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 'u',
+    /* 01B0 */ 'u',   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    /* 01C0 */   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 'a', 'a', 'i',
+    /* 01D0 */ 'i', 'o', 'o', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',   0, 'a', 'a',
+    /* 01E0 */ 'a', 'a',   0,   0,   0,   0, 'g', 'g', 'k', 'k', 'o', 'o', 'o', 'o',   0,   0,
+    /* 01F0 */ 'j',   0,   0,   0, 'g', 'g',   0,   0, 'n', 'n', 'a', 'a',   0,   0,   0,   0,
+    /* 0200 */ 'a', 'a', 'a', 'a', 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i', 'o', 'o', 'o', 'o',
+    /* 0210 */ 'r', 'r', 'r', 'r', 'u', 'u', 'u', 'u', 's', 's', 't', 't',   0,   0, 'h', 'h',
+    /* 0220 */   0,   0,   0,   0,   0,   0, 'a', 'a', 'e', 'e', 'o', 'o', 'o', 'o', 'o', 'o',
+    /* 0230 */ 'o', 'o', 'y', 'y',   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    /* 0240 */   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+// U+1E00 to U+1EFF
+static const char s_latinExtendedAdditionalFoldTable[0x100] = {
+    /* 1E00 */ 'a', 'a', 'b', 'b', 'b', 'b', 'b', 'b', 'c', 'c', 'd', 'd', 'd', 'd', 'd', 'd',
+    /* 1E10 */ 'd', 'd', 'd', 'd', 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'f', 'f',
+    /* 1E20 */ 'g', 'g', 'h', 'h', 'h', 'h', 'h', 'h', 'h', 'h', 'h', 'h', 'i', 'i', 'i', 'i',
+    /* 1E30 */ 'k', 'k', 'k', 'k', 'k', 'k', 'l', 'l', 'l', 'l', 'l', 'l', 'l', 'l', 'm', 'm',
+    /* 1E40 */ 'm', 'm', 'm', 'm', 'n', 'n', 'n', 'n', 'n', 'n', 'n', 'n', 'o', 'o', 'o', 'o',
+    /* 1E50 */ 'o', 'o', 'o', 'o', 'p', 'p', 'p', 'p', 'r', 'r', 'r', 'r', 'r', 'r', 'r', 'r',
+    /* 1E60 */ 's', 's', 's', 's', 's', 's', 's', 's', 's', 's', 't', 't', 't', 't', 't', 't',
+    /* 1E70 */ 't', 't', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'v', 'v', 'v', 'v',
+    /* 1E80 */ 'w', 'w', 'w', 'w', 'w', 'w', 'w', 'w', 'w', 'w', 'x', 'x', 'x', 'x', 'y', 'y',
+    /* 1E90 */ 'z', 'z', 'z', 'z', 'z', 'z', 'h', 't', 'w', 'y',   0,   0,   0,   0,   0,   0,
+    /* 1EA0 */ 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a',
+    /* 1EB0 */ 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'e',
+    /* 1EC0 */ 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i', 'o', 'o', 'o', 'o',
+    /* 1ED0 */ 'o', 'o', 'o', 'o', 'o', 'o', 'o', 'o', 'o', 'o', 'o', 'o', 'o', 'o', 'o', 'o',
+    /* 1EE0 */ 'o', 'o', 'o', 'o', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    /* 1EF0 */ 'u', 'u', 'y', 'y', 'y', 'y', 'y', 'y', 'y', 'y',   0,   0,   0,   0,   0,   0,
+};
+
+// Clang and GCC vector extensions, compiled to SSE2 or NEON instructions
+typedef uint8_t SRGAnalyticsByteVector __attribute__((vector_size(16)));
+
+typedef struct {
+    char *output;
+    size_t length;
+    bool separatorPending;
+} SRGAnalyticsFormattingWriter;
+
+typedef struct {
+    uint64_t hash;
+    uint64_t lastUse;
+    uint8_t inputLength;
+    uint8_t outputLength;
+    char input[SRGAnalyticsFormattingCacheMaximumLength];
+    char output[SRGAnalyticsFormattingCacheMaximumLength];
+} SRGAnalyticsFormattingCacheEntry;
+
+struct SRGAnalyticsFormattingCache {
+    SRGAnalyticsFormattingCacheEntry entries[SRGAnalyticsFormattingCacheCapacity];
+    size_t count;
+    uint64_t clock;
+};
+
+#pragma mark Vectors
+
+static inline bool SRGAnalyticsByteVectorIsZero(SRGAnalyticsByteVector vector)
+{
+    uint64_t words[2];
+    memcpy(words, &vector, sizeof(words));
+    return (words[0] | words[1]) == 0;
+}
+
+static inline bool SRGAnalyticsByteVectorIsAllOnes(SRGAnalyticsByteVector vector)
+{
+    uint64_t words[2];
+    memcpy(words, &vector, sizeof(words));
+    return (words[0] & words[1]) == UINT64_MAX;
+}
+
+#pragma mark Writer
+
+static inline void SRGAnalyticsFormattingWriterFlushSeparator(SRGAnalyticsFormattingWriter *writer)
+{
+    if (writer->separatorPending) {
+        if (writer->length != 0) {
+            writer->output[writer->length++] = '-';
+        }
+        writer->separatorPending = false;
+    }
+}
+
+static inline void SRGAnalyticsFormattingWriterAppendCharacter(SRGAnalyticsFormattingWriter *writer, char character)
+{
+    SRGAnalyticsFormattingWriterFlushSeparator(writer);
+    writer->output[writer->length++] = character;
+}
+
+// Append 16 ASCII characters. Return `false` (and append nothing) if some of them are not letters or digits.
+static inline bool SRGAnalyticsFormattingWriterAppendAlphanumericVector(SRGAnalyticsFormattingWriter *writer, SRGAnalyticsByteVector vector)
+{
+    SRGAnalyticsByteVector upper = (SRGAnalyticsByteVector)((vector >= 'A') & (vector <= 'Z'));
+    SRGAnalyticsByteVector lower = (SRGAnalyticsByteVector)((vector >= 'a') & (vector <= 'z'));
+    SRGAnalyticsByteVector digit = (SRGAnalyticsByteVector)((vector >= '0') & (vector <= '9'));
+    if (! SRGAnalyticsByteVectorIsAllOnes(upper | lower | digit)) {
+        return false;
+    }
+
+    SRGAnalyticsFormattingWriterFlushSeparator(writer);
+
+    SRGAnalyticsByteVector lowercased = vector | (upper & 0x20);
+    memcpy(writer->output + writer->length, &lowercased, sizeof(lowercased));
+    writer->length += sizeof(lowercased);
+    return true;
+}
+
+static inline void SRGAnalyticsFormattingWriterAppendMapped(SRGAnalyticsFormattingWriter *writer, char mapped)
+{
+    if (mapped == 0) {
+        writer->separatorPending = true;
+    }
+    else if (mapped == SRGAnalyticsAndMarker) {
+        SRGAnalyticsFormattingWriterAppendCharacter(writer, 'a');
+        writer->output[writer->length++] = 'n';
+        writer->output[writer->length++] = 'd';
+    }
+    else {
+        SRGAnalyticsFormattingWriterAppendCharacter(writer, mapped);
+    }
+}
+
+#pragma mark Decoding
+
+// Decode the code point starting at the specified index. Returns the number of bytes consumed (0 if invalid).
+static inline size_t SRGAnalyticsDecodeCodePoint(const uint8_t *input, size_t length, size_t index, uint32_t *codePoint)
+{
+    uint8_t byte = input[index];
+    size_t count = 0;
+    uint32_t value = 0;
+    uint32_t minimum = 0;
+    if (byte >= 0xC2 && byte <= 0xDF) {
+        count = 2;
+        value = byte & 0x1F;
+        minimum = 0x80;
+    }
+    else if (byte >= 0xE0 && byte <= 0xEF) {
+        count = 3;
+        value = byte & 0x0F;
+        minimum = 0x800;
+    }
+    else if (byte >= 0xF0 && byte <= 0xF4) {
+        count = 4;
+        value = byte & 0x07;
+        minimum = 0x10000;
+    }
+    else {
+        return 0;
+    }
+
+    if (length - index < count) {
+        return 0;
+    }
+
+    for (size_t i = 1; i < count; ++i) {
+        uint8_t continuation = input[index + i];
+        if ((continuation & 0xC0) != 0x80) {
+            return 0;
+        }
+        value = (value << 6) | (continuation & 0x3F);
+    }
+
+    if (value < minimum || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
+        return 0;
+    }
+
+    *codePoint = value;
+    return count;
+}
+
+static inline bool SRGAnalyticsIsCombiningMark(uint32_t codePoint)
+{
+    return (codePoint >= 0x0300 && codePoint <= 0x036F)
+        || (codePoint >= 0x1AB0 && codePoint <= 0x1AFF)
+        || (codePoint >= 0x1DC0 && codePoint <= 0x1DFF)
+        || (codePoint >= 0x20D0 && codePoint <= 0x20FF)
+        || (codePoint >= 0xFE20 && codePoint <= 0xFE2F);
+}
+
+static inline void SRGAnalyticsFormattingWriterAppendCodePoint(SRGAnalyticsFormattingWriter *writer, uint32_t codePoint)
+{
+    if (codePoint >= 0xC0 && codePoint <= 0x24F) {
+        SRGAnalyticsFormattingWriterAppendMapped(writer, s_latinFoldTable[codePoint - 0xC0]);
+    }
+    else if (codePoint >= 0x1E00 && codePoint <= 0x1EFF) {
+        SRGAnalyticsFormattingWriterAppendMapped(writer, s_latinExtendedAdditionalFoldTable[codePoint - 0x1E00]);
+    }
+    else if (codePoint == 0x212A) {             // Kelvin sign, lowercased as `k`
+        SRGAnalyticsFormattingWriterAppendCharacter(writer, 'k');
+    }
+    else if (codePoint == 0x212B) {             // Angstrom sign, lowercased as `å`
+        SRGAnalyticsFormattingWriterAppendCharacter(writer, 'a');
+    }
+    else if (! SRGAnalyticsIsCombiningMark(codePoint)) {
+        writer->separatorPending = true;
+    }
+}
+
+#pragma mark Formatting
+
+size_t SRGAnalyticsFormattedStringMaximumLength(size_t inputLength)
+{
+    // Each input byte yields at most 3 bytes (`and`), a hyphen being only written in place of a separator
+    return inputLength * 3;
+}
+
+size_t SRGAnalyticsFormatString(const char *input, size_t inputLength, char *output, size_t outputCapacity)
+{
+    if (outputCapacity < SRGAnalyticsFormattedStringMaximumLength(inputLength)) {
+        return 0;
+    }
+
+    const uint8_t *bytes = (const uint8_t *)input;
+    SRGAnalyticsFormattingWriter writer = { .output = output, .length = 0, .separatorPending = false };
+
+    size_t index = 0;
+    while (index < inputLength) {
+        // ASCII fast paths, 16 bytes at a time. Runs of letters and digits are lowercased and copied with vector
+        // instructions, other ASCII characters are mapped without decoding.
+        if (inputLength - index >= sizeof(SRGAnalyticsByteVector)) {
+            SRGAnalyticsByteVector vector;
+            memcpy(&vector, bytes + index, sizeof(vector));
+
+            if (SRGAnalyticsFormattingWriterAppendAlphanumericVector(&writer, vector)) {
+                index += sizeof(SRGAnalyticsByteVector);
+                continue;
+            }
+
+            if (SRGAnalyticsByteVectorIsZero(vector & 0x80)) {
+                for (size_t i = 0; i < sizeof(SRGAnalyticsByteVector); ++i) {
+                    SRGAnalyticsFormattingWriterAppendMapped(&writer, s_asciiTable[vector[i]]);
+                }
+                index += sizeof(SRGAnalyticsByteVector);
+                continue;
+            }
+        }
+
+        uint8_t byte = bytes[index];
+        if (byte < 0x80) {
+            SRGAnalyticsFormattingWriterAppendMapped(&writer, s_asciiTable[byte]);
+            index++;
+            continue;
+        }
+
+        uint32_t codePoint = 0;
+        size_t count = SRGAnalyticsDecodeCodePoint(bytes, inputLength, index, &codePoint);
+        if (count == 0) {
+            writer.separatorPending = true;
+            index++;
+        }
+        else {
+            SRGAnalyticsFormattingWriterAppendCodePoint(&writer, codePoint);
+            index += count;
+        }
+    }
+    return writer.length;
+}
+
+#pragma mark Cache
+
+SRGAnalyticsFormattingCache *SRGAnalyticsFormattingCacheCreate(void)
+{
+    return calloc(1, sizeof(SRGAnalyticsFormattingCache));
+}
+
+void SRGAnalyticsFormattingCacheDestroy(SRGAnalyticsFormattingCache *cache)
+{
+    free(cache);
+}
+
+static uint64_t SRGAnalyticsFormattingHash(const char *input, size_t inputLength)
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < inputLength; ++i) {
+        hash ^= (uint8_t)input[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+size_t SRGAnalyticsFormattingCacheFormatString(SRGAnalyticsFormattingCache *cache, const char *input, size_t inputLength, char *output, size_t outputCapacity, bool *hit)
+{
+    if (hit) {
+        *hit = false;
+    }
+
+    if (inputLength > SRGAnalyticsFormattingCacheMaximumLength) {
+        return SRGAnalyticsFormatString(input, inputLength, output, outputCapacity);
+    }
+
+    if (outputCapacity < SRGAnalyticsFormattedStringMaximumLength(inputLength)) {
+        return 0;
+    }
+
+    uint64_t hash = SRGAnalyticsFormattingHash(input, inputLength);
+    cache->clock++;
+
+    for (size_t i = 0; i < cache->count; ++i) {
+        SRGAnalyticsFormattingCacheEntry *entry = &cache->entries[i];
+        if (entry->hash == hash && entry->inputLength == inputLength && memcmp(entry->input, input, inputLength) == 0) {
+            entry->lastUse = cache->clock;
+            memcpy(output, entry->output, entry->outputLength);
+            if (hit) {
+                *hit = true;
+            }
+            return entry->outputLength;
+        }
+    }
+
+    size_t outputLength = SRGAnalyticsFormatString(input, inputLength, output, outputCapacity);
+    if (outputLength > SRGAnalyticsFormattingCacheMaximumLength) {
+        return outputLength;
+    }
+
+    // Fill free entries first, then evict the least recently used one
+    SRGAnalyticsFormattingCacheEntry *entry = NULL;
+    if (cache->count < SRGAnalyticsFormattingCacheCapacity) {
+        entry = &cache->entries[cache->count++];
+    }
+    else {
+        entry = &cache->entries[0];
+        for (size_t i = 1; i < SRGAnalyticsFormattingCacheCapacity; ++i) {
+            if (cache->entries[i].lastUse < entry->lastUse) {
+                entry = &cache->entries[i];
+            }
+        }
+    }
+
+    entry->hash = hash;
+    entry->lastUse = cache->clock;
+    entry->inputLength = (uint8_t)inputLength;
+    entry->outputLength = (uint8_t)outputLength;
+    memcpy(entry->input, input, inputLength);
+    memcpy(entry->output, output, outputLength);
+    return outputLength;
+}
@@ -0,0 +1,60 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGAnalyticsStringFormatting_h
+#define SRGAnalyticsStringFormatting_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Return the output capacity (in bytes) sufficient to format an input of the specified length (in bytes).
+ */
+size_t SRGAnalyticsFormattedStringMaximumLength(size_t inputLength);
+
+/**
+ *  Format a UTF-8 string in the standard comScore way: lowercase, fold diacritics (Latin scripts), replace `+` and `&`
+ *  with `and`, squash all other runs of characters outside `[a-z0-9]` as a single hyphen, and trim leading and
+ *  trailing hyphens. Invalid UTF-8 sequences are treated as separators.
+ *
+ *  @param output         The buffer to write the result to, without terminating null character.
+ *  @param outputCapacity Must be at least `SRGAnalyticsFormattedStringMaximumLength(inputLength)`.
+ *  @return The length of the result.
+ */
+size_t SRGAnalyticsFormatString(const char *input, size_t inputLength, char *output, size_t outputCapacity);
+
+/**
+ *  Bounded LRU cache of formatted strings, avoiding formatting the same page titles and levels again and again. Not
+ *  thread-safe.
+ */
+typedef struct SRGAnalyticsFormattingCache SRGAnalyticsFormattingCache;
+
+/**
+ *  Create a cache. Returns `NULL` if memory could not be allocated.
+ */
+SRGAnalyticsFormattingCache *SRGAnalyticsFormattingCacheCreate(void);
+
+/**
+ *  Destroy a cache.
+ */
+void SRGAnalyticsFormattingCacheDestroy(SRGAnalyticsFormattingCache *cache);
+
+/**
+ *  Same as `SRGAnalyticsFormatString`, returning a cached result if available. Short strings only are cached.
+ *
+ *  @param hit Set to `true` iff the result was found in the cache. Optional.
+ */
+size_t SRGAnalyticsFormattingCacheFormatString(SRGAnalyticsFormattingCache *cache, const char *input, size_t inputLength, char *output, size_t outputCapacity, bool *hit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGAnalyticsStringFormatting_h */
@@ -8,11 +8,32 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class SRGAnalyticsDeltaEncoder;
+@class SRGAnalyticsEventQueue;
+@protocol SRGAnalyticsEventSink;
+
 @interface SRGAnalyticsTracker (Private)
 
+/**
+ *  The queue into which events are recorded before being processed. Available once the tracker has been started.
+ */
+@property (nonatomic, readonly, nullable) SRGAnalyticsEventQueue *eventQueue;
+
+/**
+ *  The duration of each startup phase which has been completed, in seconds. Phases are `start` (synchronous part of
+ *  `-startWithConfiguration:dataSource:`), `comscore`, `commanders_act` and `journal`.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *startupPhaseDurations;
+
 @property (nonatomic, nullable) SRGAnalyticsLabels *globalLabels;
 @property (nonatomic, nullable) SRGAnalyticsLabels *dataSourceLabels;
 
+/**
+ *  Start comScore if not already done. Must be called from the main thread before using comScore APIs, as comScore
+ *  might not have been started yet if startup is deferred (@see `SRGAnalyticsConfiguration.startupDeferred`).
+ */
+- (void)startComScoreIfNeeded;
+
 - (void)trackPageViewWithTitle:(NSString *)title
                           type:(NSString *)type
                         levels:(nullable NSArray<NSString *> *)levels
@@ -23,6 +44,34 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)sendCommandersActCustomEventWithName:(NSString *)name
                                       labels:(nullable NSDictionary<NSString *, NSString *> *)labels;
 
+/**
+ *  Same as `-sendCommandersActCustomEventWithName:labels:`, delta-encoding the labels eventually sent with the
+ *  specified encoder (unless the event is a key frame). Event taps still receive full labels.
+ */
+- (void)sendCommandersActCustomEventWithName:(NSString *)name
+                                      labels:(nullable NSDictionary<NSString *, NSString *> *)labels
+                                deltaEncoder:(nullable SRGAnalyticsDeltaEncoder *)deltaEncoder
+                                    keyFrame:(BOOL)keyFrame;
+
+/**
+ *  Attach a sink to which all events delivered afterwards are sent as well, in addition to Commanders Act. Does
+ *  nothing if the tracker has not been started yet or if the sink is already attached.
+ *
+ *  @discussion Can be called from any thread, including from a sink. The sink is attached before the method returns.
+ */
+- (void)addEventSink:(id<SRGAnalyticsEventSink>)eventSink;
+
+/**
+ *  Detach a sink. Can be called from any thread, including from a sink.
+ */
+- (void)removeEventSink:(id<SRGAnalyticsEventSink>)eventSink;
+
+/**
+ *  Record all events sent by the block, on the calling thread, as a single submission to the event queue. Calls
+ *  can be nested.
+ */
+- (void)recordEventsInBatch:(void (NS_NOESCAPE ^)(void))block;
+
 @end
 
 NS_ASSUME_NONNULL_END
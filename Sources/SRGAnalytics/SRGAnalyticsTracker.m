@@ -9,20 +9,40 @@
 #import "NSMutableDictionary+SRGAnalytics.h"
 #import "NSString+SRGAnalytics.h"
 #import "SRGAnalytics.h"
+#import "SRGAnalyticsCommandersActEventSink.h"
+#import "SRGAnalyticsDeltaEncoder.h"
+#import "SRGAnalyticsEvent.h"
+#import "SRGAnalyticsEventBatcher.h"
+#import "SRGAnalyticsEventJournal.h"
+#import "SRGAnalyticsEventTap+Private.h"
+#import "SRGAnalyticsEventQueue.h"
+#import "SRGAnalyticsEventSampler.h"
 #import "SRGAnalyticsLabels+Private.h"
 #import "SRGAnalyticsLogger.h"
+#import "SRGAnalyticsMetrics+Private.h"
 #import "SRGAnalyticsNotifications+Private.h"
 
 @import ComScore;
+@import Network;
 @import TCCore;
 @import TCServerSide_noIDFA;
 
+#import <os/lock.h>
+#import <time.h>
+
 static NSString * s_unitTestingIdentifier = nil;
 
-__attribute__((constructor)) static void SRGAnalyticsTrackerInit(void)
-{
-    [TCDebug setDebugLevel:TCLogLevel_None];
-}
+// Events collected by the current thread while recording a batch
+static _Thread_local CFMutableArrayRef s_batchedEvents = NULL;
+
+// Maximum number of events held in memory while the network is not reachable, or for each durable sink
+static const NSUInteger SRGAnalyticsMaximumUndeliveredRecordCount = 4096;
+
+// Startup phases
+static NSString * const SRGAnalyticsStartupPhaseStart = @"start";
+static NSString * const SRGAnalyticsStartupPhaseComScore = @"comscore";
+static NSString * const SRGAnalyticsStartupPhaseCommandersAct = @"commanders_act";
+static NSString * const SRGAnalyticsStartupPhaseJournal = @"journal";
 
 NSString *SRGAnalyticsUnitTestingIdentifier(void)
 {
@@ -37,18 +57,54 @@ void SRGAnalyticsRenewUnitTestingIdentifier(void)
     s_unitTestingIdentifier = NSUUID.UUID.UUIDString;
 }
 
-@interface SRGAnalyticsTracker ()
+// Records which a durable sink has not delivered yet, in order. Only accessed from the event queue worker thread.
+@interface SRGAnalyticsEventSinkDelivery : NSObject
+
+@property (nonatomic) id<SRGAnalyticsEventSink> eventSink;
+@property (nonatomic) NSMutableArray<SRGAnalyticsEventJournalRecord *> *pendingRecords;
+@property (nonatomic) NSUInteger deliveringCount;           // Number of pending records currently being delivered
+
+@end
+
+@interface SRGAnalyticsTracker () {
+@private
+    os_unfair_lock _startupPhaseDurationsLock;
+    NSMutableDictionary<NSString *, NSNumber *> *_startupPhaseDurations;
+    
+    // Events can be recorded from any thread. Protects the global labels and the labels snapshot.
+    os_unfair_lock _labelsLock;
+    SRGAnalyticsLabels *_globalLabels;
+    SRGAnalyticsLabelsSnapshot *_labelsSnapshot;
+    uint64_t _labelsSnapshotVersion;
+}
 
 @property (nonatomic, copy) SRGAnalyticsConfiguration *configuration;
 @property (nonatomic, weak) id<SRGAnalyticsTrackerDataSource> dataSource;
 
 @property (nonatomic) ServerSide *serverSide;
 @property (nonatomic) SCORStreamingAnalytics *streamSense;
+@property (nonatomic, getter=isComScoreStarted) BOOL comScoreStarted;
+
+@property (nonatomic) SRGAnalyticsEventQueue<SRGAnalyticsEvent *> *eventQueue;
+@property (nonatomic) SRGAnalyticsEventSampler *eventSampler;
+
+// Only accessed from the event queue worker thread
+@property (nonatomic) SRGAnalyticsEventJournal *journal;
+@property (nonatomic) SRGAnalyticsEventBatcher<SRGAnalyticsEventJournalRecord *> *batcher;
+@property (nonatomic) NSMutableArray<SRGAnalyticsEventJournalRecord *> *undeliveredRecords;       // Not handed over to sinks yet
+@property (nonatomic) NSMutableArray<SRGAnalyticsEventSinkDelivery *> *eventSinkDeliveries;
+@property (nonatomic) NSCountedSet<SRGAnalyticsEventJournalRecord *> *pendingRecordCounts;         // Number of durable sinks still delivering each record
+@property (nonatomic) NSMapTable<SRGAnalyticsEventJournalRecord *, SRGAnalyticsDeltaEncoder *> *deltaEncoders;
+@property (nonatomic, copy) NSArray<id<SRGAnalyticsEventSink>> *eventSinks;
+@property (nonatomic, copy) NSArray<SRGAnalyticsEventTap *> *eventTaps;
+@property (nonatomic, getter=isNetworkReachable) BOOL networkReachable;
+@property (nonatomic, getter=isNetworkExpensive) BOOL networkExpensive;
 
-@property (nonatomic) SRGAnalyticsLabels *globalLabels;
+@property (nonatomic) nw_path_monitor_t pathMonitor;
+
+@property (nonatomic, readonly) SRGAnalyticsLabelsSnapshot *labelsSnapshot;
 
 @property (nonatomic, readonly) NSDictionary *defaultComScoreLabels;
-@property (nonatomic, readonly) NSDictionary *defaultLabels;
 
 @end
 
@@ -81,15 +137,116 @@ void SRGAnalyticsRenewUnitTestingIdentifier(void)
         return;
     }
     
-    self.configuration = configuration;
-    self.dataSource = dataSource;
+    uint64_t startTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    
+    // Events can be recorded from any thread as soon as the tracker is considered started (i.e. has a configuration).
+    // Everything needed to record and dispatch them is therefore set up first, and the configuration assigned last.
+    NSString *samplingIdentifier = configuration.samplingIdentifier ?: [SRGAnalyticsEventSampler installationIdentifierWithUserDefaults:NSUserDefaults.standardUserDefaults];
+    self.eventSampler = [[SRGAnalyticsEventSampler alloc] initWithPolicies:configuration.eventSamplingPolicies identifier:samplingIdentifier];
+    
+    // Events are recorded on the calling thread, but labels are built and sent on the queue worker thread
+    SRGAnalyticsEventQueue<SRGAnalyticsEvent *> *eventQueue = [[SRGAnalyticsEventQueue alloc] initWithCapacity:configuration.eventQueueCapacity
+                                                                                                overflowPolicy:configuration.eventQueueOverflowPolicy
+                                                                                                       handler:^(SRGAnalyticsEvent * _Nonnull event) {
+        [self dispatchEvent:event];
+    }];
+    
+    self.batcher = [[SRGAnalyticsEventBatcher alloc] initWithQueue:eventQueue.workerQueue handler:^(NSArray<SRGAnalyticsEventJournalRecord *> * _Nonnull records) {
+        [self.undeliveredRecords addObjectsFromArray:records];
+        [self deliverRecords];
+    }];
+    self.batcher.interval = configuration.eventDeliveryDelay;
+    self.batcher.maximumCount = configuration.eventDeliveryMaximumPendingCount;
+    [self updateBatchingWindow];
+    
+    self.undeliveredRecords = [NSMutableArray array];
+    self.eventSinkDeliveries = [NSMutableArray array];
+    self.pendingRecordCounts = [NSCountedSet set];
+    self.deltaEncoders = [NSMapTable weakToWeakObjectsMapTable];
+    self.networkReachable = YES;
+    
+    SRGAnalyticsMetricsSetEnabled(configuration.metricsEnabled);
 
-    if (configuration.unitTesting) {
+    if (configuration.unitTesting && configuration.requestInterceptionEnabled) {
         SRGAnalyticsEnableRequestInterceptor();
     }
+    
+    // When deferred, the Commanders Act SDK is started on the worker thread before any event is processed. Events
+    // recorded in the meantime are kept in the queue.
+    if (configuration.startupDeferred) {
+        dispatch_async(eventQueue.workerQueue, ^{
+            [self startCommandersActWithConfiguration:configuration];
+        });
+    }
+    else {
+        [self startCommandersActWithConfiguration:configuration];
+    }
+    
+    // Scheduled before any event can be dispatched, so that events which could not be delivered during previous
+    // sessions are replayed first, and so that all events are journaled
+    dispatch_async(eventQueue.workerQueue, ^{
+        [self measureStartupPhase:SRGAnalyticsStartupPhaseJournal withBlock:^{
+            [self openJournalWithConfiguration:configuration];
+        }];
+    });
+    
+    self.dataSource = dataSource;
+    self.eventQueue = eventQueue;
+    self.configuration = configuration;
+    
+    [self startMonitoringNetwork];
+    
+    if (configuration.startupDeferred) {
+        [self startComScoreWhenApplicationIsActive];
+    }
+    else {
+        [self startComScoreIfNeeded];
+    }
+    
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(applicationDidEnterBackground:)
+                                               name:UIApplicationDidEnterBackgroundNotification
+                                             object:nil];
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(applicationWillTerminate:)
+                                               name:UIApplicationWillTerminateNotification
+                                             object:nil];
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(powerStateDidChange:)
+                                               name:NSProcessInfoPowerStateDidChangeNotification
+                                             object:nil];
+    
+    [self recordStartupPhase:SRGAnalyticsStartupPhaseStart withStartTime:startTime];
+}
+
+- (void)startComScoreIfNeeded
+{
+    NSAssert(NSThread.isMainThread, @"Must be called from the main thread");
+    
+    if (! self.configuration || self.comScoreStarted) {
+        return;
+    }
+    
+    [self measureStartupPhase:SRGAnalyticsStartupPhaseComScore withBlock:^{
+        [self startComScoreWithConfiguration:self.configuration];
+    }];
+    self.comScoreStarted = YES;
+}
 
-    [self startComScoreWithConfiguration:configuration];
-    [self startCommandersActWithConfiguration:configuration];
+// Wait until the first frame has been displayed
+- (void)startComScoreWhenApplicationIsActive
+{
+    if (UIApplication.sharedApplication.applicationState == UIApplicationStateActive) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self startComScoreIfNeeded];
+        });
+    }
+    else {
+        [NSNotificationCenter.defaultCenter addObserver:self
+                                               selector:@selector(applicationDidBecomeActive:)
+                                                   name:UIApplicationDidBecomeActiveNotification
+                                                 object:nil];
+    }
 }
 
 - (void)startComScoreWithConfiguration:(SRGAnalyticsConfiguration *)configuration
@@ -117,6 +274,10 @@ void SRGAnalyticsRenewUnitTestingIdentifier(void)
 
 - (void)startCommandersActWithConfiguration:(SRGAnalyticsConfiguration *)configuration
 {
+    uint64_t startTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    
+    [TCDebug setDebugLevel:TCLogLevel_None];
+    
     self.serverSide = [[ServerSide alloc] initWithSiteID:(int)configuration.site andSourceKey:configuration.sourceKey];
     [self.serverSide enableRunningInBackground];
     [self.serverSide waitForUserAgent];
@@ -128,55 +289,107 @@ void SRGAnalyticsRenewUnitTestingIdentifier(void)
     // Use the legacy V4 identifier as unique identifier in V5.
     TCDevice.sharedInstance.sdkID = TCPredefinedVariables.sharedInstance.uniqueIdentifier;
     [TCPredefinedVariables.sharedInstance useLegacyUniqueIDForAnonymousID];
+    
+    // Called on the worker thread, or before events can be processed
+    SRGAnalyticsCommandersActEventSink *commandersActEventSink = [[SRGAnalyticsCommandersActEventSink alloc] initWithServerSide:self.serverSide];
+    self.eventSinks = [@[ commandersActEventSink ] arrayByAddingObjectsFromArray:self.eventSinks ?: @[]];
+    
+    [self recordStartupPhase:SRGAnalyticsStartupPhaseCommandersAct withStartTime:startTime];
 }
 
-#pragma mark Labels
+#pragma mark Startup phases
 
-- (NSDictionary<NSString *, NSString *> *)persistentComScoreLabels
+- (NSDictionary<NSString *, NSNumber *> *)startupPhaseDurations
 {
-    NSMutableDictionary<NSString *, NSString *> *labels = [NSMutableDictionary dictionary];
-    labels[@"mp_v"] = [NSBundle.mainBundle objectForInfoDictionaryKey:@"CFBundleShortVersionString"];
-    labels[@"mp_brand"] = self.configuration.businessUnitIdentifier.uppercaseString;
-    return labels.copy;
+    os_unfair_lock_lock(&_startupPhaseDurationsLock);
+    NSDictionary<NSString *, NSNumber *> *startupPhaseDurations = _startupPhaseDurations.copy;
+    os_unfair_lock_unlock(&_startupPhaseDurationsLock);
+    return startupPhaseDurations ?: @{};
 }
 
-- (NSDictionary<NSString *, NSString *> *)defaultComScoreLabels
+- (void)measureStartupPhase:(NSString *)phase withBlock:(void (NS_NOESCAPE ^)(void))block
 {
-    NSMutableDictionary<NSString *, NSString *> *labels = [NSMutableDictionary dictionary];
+    uint64_t startTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    block();
+    [self recordStartupPhase:phase withStartTime:startTime];
+}
 
-    NSDictionary<NSString *, NSString *> *globalLabels = self.globalLabels.comScoreLabelsDictionary;
-    if (globalLabels) {
-        [labels addEntriesFromDictionary:globalLabels];
+// Phases can complete on any thread
+- (void)recordStartupPhase:(NSString *)phase withStartTime:(uint64_t)startTime
+{
+    NSTimeInterval duration = (clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - startTime) / (double)NSEC_PER_SEC;
+    
+    // The lock is zero-initialized with the object (`OS_UNFAIR_LOCK_INIT`)
+    os_unfair_lock_lock(&_startupPhaseDurationsLock);
+    if (! _startupPhaseDurations) {
+        _startupPhaseDurations = [NSMutableDictionary dictionary];
     }
+    _startupPhaseDurations[phase] = @(duration);
+    os_unfair_lock_unlock(&_startupPhaseDurationsLock);
+    
+    SRGAnalyticsLogInfo(@"tracker", @"Startup phase '%@' completed in %.3f ms", phase, duration * 1000.);
+}
 
-    NSDictionary<NSString *, NSString *> *dataSourceLabels = self.dataSource.srg_globalLabels.comScoreLabelsDictionary;
-    if (dataSourceLabels) {
-        [labels addEntriesFromDictionary:dataSourceLabels];
-    }
+#pragma mark Getters and setters
 
-    return labels.copy;
+- (SRGAnalyticsLabels *)globalLabels
+{
+    os_unfair_lock_lock(&_labelsLock);
+    SRGAnalyticsLabels *globalLabels = _globalLabels;
+    os_unfair_lock_unlock(&_labelsLock);
+    return globalLabels;
+}
+
+- (void)setGlobalLabels:(SRGAnalyticsLabels *)globalLabels
+{
+    SRGAnalyticsLabels *copiedGlobalLabels = globalLabels.copy;
+    
+    os_unfair_lock_lock(&_labelsLock);
+    _globalLabels = copiedGlobalLabels;
+    _labelsSnapshot = nil;
+    os_unfair_lock_unlock(&_labelsLock);
 }
 
-- (NSDictionary<NSString *, NSString *> *)defaultLabels
+#pragma mark Labels
+
+- (NSDictionary<NSString *, NSString *> *)persistentComScoreLabels
 {
     NSMutableDictionary<NSString *, NSString *> *labels = [NSMutableDictionary dictionary];
+    labels[@"mp_v"] = [NSBundle.mainBundle objectForInfoDictionaryKey:@"CFBundleShortVersionString"];
+    labels[@"mp_brand"] = self.configuration.businessUnitIdentifier.uppercaseString;
+    return labels.copy;
+}
 
-    NSDictionary<NSString *, NSString *> *globalLabels = self.globalLabels.labelsDictionary;
-    if (globalLabels) {
-        [labels addEntriesFromDictionary:globalLabels];
-    }
+- (NSDictionary<NSString *, NSString *> *)defaultComScoreLabels
+{
+    return self.labelsSnapshot.comScoreLabelsDictionary;
+}
 
-    NSDictionary<NSString *, NSString *> *dataSourceLabels = self.dataSourceLabels.labelsDictionary;
-    if (dataSourceLabels) {
-        [labels addEntriesFromDictionary:dataSourceLabels];
+- (SRGAnalyticsLabelsSnapshot *)labelsSnapshot
+{
+    // The data source is queried for each event, without holding the lock as its implementation might call the tracker
+    SRGAnalyticsLabels *dataSourceLabels = self.dataSource.srg_globalLabels;
+    
+    os_unfair_lock_lock(&_labelsLock);
+    SRGAnalyticsLabelsSnapshot *labelsSnapshot = _labelsSnapshot;
+    
+    // Share the previous snapshot as long as labels are unchanged
+    SRGAnalyticsLabels *previousDataSourceLabels = labelsSnapshot.dataSourceLabels;
+    BOOL dataSourceLabelsChanged = (previousDataSourceLabels != dataSourceLabels) && ! [previousDataSourceLabels isEqual:dataSourceLabels];
+    if (! labelsSnapshot || dataSourceLabelsChanged) {
+        _labelsSnapshotVersion += 1;
+        labelsSnapshot = [[SRGAnalyticsLabelsSnapshot alloc] initWithGlobalLabels:_globalLabels
+                                                                 dataSourceLabels:dataSourceLabels
+                                                                          version:_labelsSnapshotVersion];
+        _labelsSnapshot = labelsSnapshot;
     }
-
-    return labels.copy;
+    os_unfair_lock_unlock(&_labelsLock);
+    return labelsSnapshot;
 }
 
 - (SRGAnalyticsLabels *)dataSourceLabels
 {
-    return self.dataSource.srg_globalLabels;
+    return self.labelsSnapshot.dataSourceLabels;
 }
 
 - (NSString *)pageIdWithTitle:(NSString *)title levels:(NSArray<NSString *> *)levels
@@ -238,48 +451,486 @@ void SRGAnalyticsRenewUnitTestingIdentifier(void)
 
 #pragma mark General event tracking (internal use only)
 
-- (void)sendCommandersActPageViewEventWithTitle:(NSString *)title
-                                           type:(NSString *)type
-                                         labels:(NSDictionary<NSString *, NSString *> *)labels
+- (void)recordEvent:(SRGAnalyticsEvent *)event
 {
-    NSAssert(title.length != 0 && type.length != 0, @"A title and a type are required");
+    // Shed load before any work is made for the event. Events are sent if no sampler is available.
+    SRGAnalyticsEventSampler *eventSampler = self.eventSampler;
+    if (event.kind == SRGAnalyticsEventKindCustom && eventSampler) {
+        double samplingWeight = 0.;
+        if (! [eventSampler shouldSendEventWithName:event.name time:clock_gettime_nsec_np(CLOCK_UPTIME_RAW) weight:&samplingWeight]) {
+            return;
+        }
+        event.samplingWeight = samplingWeight;
+    }
+    
+    // Capture the context at the time the event is recorded. Labels themselves are built later on the worker thread.
+    event.labelsSnapshot = self.labelsSnapshot;
+    
+    if (self.configuration.unitTesting) {
+        event.unitTestingIdentifier = SRGAnalyticsUnitTestingIdentifier();
+    }
+    
+    if (s_batchedEvents) {
+        CFArrayAppendValue(s_batchedEvents, (__bridge const void *)event);
+        return;
+    }
+    
+    [self.eventQueue enqueueObject:event];
+    
+    if (SRGAnalyticsMetricsEnabled()) {
+        SRGAnalyticsMetricsRecordEventQueueDepth(self.eventQueue.count);
+    }
+}
+
+- (void)recordEventsInBatch:(void (NS_NOESCAPE ^)(void))block
+{
+    if (s_batchedEvents) {
+        block();
+        return;
+    }
+    
+    s_batchedEvents = CFArrayCreateMutable(kCFAllocatorDefault, 0, &kCFTypeArrayCallBacks);
+    block();
+    NSArray<SRGAnalyticsEvent *> *events = CFBridgingRelease(s_batchedEvents);
+    s_batchedEvents = NULL;
+    
+    // Objects enqueued in a row are drained by the worker in a single pass
+    for (SRGAnalyticsEvent *event in events) {
+        [self.eventQueue enqueueObject:event];
+    }
+    
+    if (SRGAnalyticsMetricsEnabled()) {
+        SRGAnalyticsMetricsRecordEventQueueDepth(self.eventQueue.count);
+    }
+}
 
-    TCPageViewEvent *event = [[TCPageViewEvent alloc] initWithType:type];
-    event.pageName = title;
-    [self.defaultLabels enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull value, BOOL * _Nonnull stop) {
-        [event addAdditionalProperty:key withStringValue:value];
+- (void)sendCommandersActCustomEventWithName:(NSString *)name
+                                      labels:(NSDictionary<NSString *, NSString *> *)labels
+{
+    [self sendCommandersActCustomEventWithName:name labels:labels deltaEncoder:nil keyFrame:YES];
+}
+
+- (void)sendCommandersActCustomEventWithName:(NSString *)name
+                                      labels:(NSDictionary<NSString *, NSString *> *)labels
+                                deltaEncoder:(SRGAnalyticsDeltaEncoder *)deltaEncoder
+                                    keyFrame:(BOOL)keyFrame
+{
+    NSAssert(name.length != 0, @"A name is required");
+    
+    SRGAnalyticsEvent *event = [SRGAnalyticsEvent customEventWithName:name labels:nil labelsDictionary:labels];
+    event.deltaEncoder = deltaEncoder;
+    event.deltaKeyFrame = keyFrame;
+    [self recordEvent:event];
+}
+
+#pragma mark Event dispatch (worker thread)
+
+- (void)dispatchEvent:(SRGAnalyticsEvent *)event
+{
+    SRGAnalyticsMetricsRecordEvent(event.name);
+    
+    uint64_t buildStartTime = SRGAnalyticsMetricsStartTime();
+    
+    NSDictionary<NSString *, id> *payload = nil;
+    switch (event.kind) {
+        case SRGAnalyticsEventKindPageView: {
+            payload = [self commandersActPageViewPayloadForEvent:event];
+            break;
+        }
+            
+        case SRGAnalyticsEventKindCustom: {
+            payload = [self commandersActCustomEventPayloadForEvent:event];
+            break;
+        }
+    }
+    
+    SRGAnalyticsMetricsRecordLatency(SRGAnalyticsMetricsLatencyLabelBuild, buildStartTime);
+    
+    [self tapEventWithPayload:payload];
+    
+    // Encoders are only used from the worker thread, where events of a session are dispatched in order
+    if (event.deltaEncoder) {
+        NSMutableDictionary<NSString *, id> *encodedPayload = payload.mutableCopy;
+        encodedPayload[SRGAnalyticsPayloadLabelsKey] = [event.deltaEncoder encodedLabelsWithLabels:payload[SRGAnalyticsPayloadLabelsKey] keyFrame:event.deltaKeyFrame];
+        payload = encodedPayload.copy;
+    }
+    
+    // Persist the event before delivery, so that it can be replayed if the process is killed or if the network is
+    // not reachable.
+    SRGAnalyticsEventJournalRecord *record = self.journal ? [self.journal recordByAppendingPayload:payload] : [[SRGAnalyticsEventJournalRecord alloc] initWithPayload:payload];
+    if (event.deltaEncoder) {
+        [self.deltaEncoders setObject:event.deltaEncoder forKey:record];
+    }
+    [self.batcher addObject:record];
+    
+    // Do not wait until the end of the batching window when playback ends
+    if (event.kind == SRGAnalyticsEventKindCustom && ([event.name isEqualToString:@"stop"] || [event.name isEqualToString:@"eof"])) {
+        [self.batcher flush];
+    }
+}
+
+- (void)deliverRecords
+{
+    NSArray<SRGAnalyticsEventJournalRecord *> *discardedRecords = [self removeExcessRecordsFromArray:self.undeliveredRecords startingAtIndex:0];
+    if (discardedRecords.count != 0) {
+        SRGAnalyticsLogWarning(@"tracker", @"Too many undelivered events. The %@ oldest ones have been discarded", @(discardedRecords.count));
+        [self discardRecords:discardedRecords];
+    }
+    
+    if (! self.networkReachable) {
+        return;
+    }
+    
+    if (self.undeliveredRecords.count != 0) {
+        NSArray<SRGAnalyticsEventJournalRecord *> *records = self.undeliveredRecords.copy;
+        [self.undeliveredRecords removeAllObjects];
+        
+        // Non-durable sinks receive records exactly once. Durable sinks receive them in order, one batch at a time,
+        // and records are kept in the journal until all durable sinks are done with them.
+        uint64_t dispatchStartTime = SRGAnalyticsMetricsStartTime();
+        NSArray<NSDictionary<NSString *, id> *> *payloads = nil;
+        for (id<SRGAnalyticsEventSink> eventSink in self.eventSinks) {
+            BOOL durable = [eventSink respondsToSelector:@selector(isDurable)] && eventSink.durable;
+            if (durable) {
+                SRGAnalyticsEventSinkDelivery *eventSinkDelivery = [self eventSinkDeliveryForEventSink:eventSink];
+                [eventSinkDelivery.pendingRecords addObjectsFromArray:records];
+                for (SRGAnalyticsEventJournalRecord *record in records) {
+                    [self.pendingRecordCounts addObject:record];
+                }
+            }
+            else {
+                payloads = payloads ?: [self payloadsForRecords:records];
+                [eventSink deliverPayloads:payloads completion:^(SRGAnalyticsEventSinkDeliveryResult result) {}];
+            }
+        }
+        SRGAnalyticsMetricsRecordLatency(SRGAnalyticsMetricsLatencyDispatch, dispatchStartTime);
+        
+        [self acknowledgeDeliveredRecords:records];
+    }
+    
+    // Sinks might be removed during delivery
+    for (SRGAnalyticsEventSinkDelivery *eventSinkDelivery in self.eventSinkDeliveries.copy) {
+        [self deliverPendingRecordsWithEventSinkDelivery:eventSinkDelivery];
+    }
+}
+
+- (void)deliverPendingRecordsWithEventSinkDelivery:(SRGAnalyticsEventSinkDelivery *)eventSinkDelivery
+{
+    NSArray<SRGAnalyticsEventJournalRecord *> *discardedRecords = [self removeExcessRecordsFromArray:eventSinkDelivery.pendingRecords
+                                                                                     startingAtIndex:eventSinkDelivery.deliveringCount];
+    if (discardedRecords.count != 0) {
+        SRGAnalyticsLogWarning(@"tracker", @"Too many events pending delivery to %@. The %@ oldest ones have been discarded", eventSinkDelivery.eventSink, @(discardedRecords.count));
+        [self discardRecords:discardedRecords];
+    }
+    
+    if (! self.networkReachable || eventSinkDelivery.deliveringCount != 0 || eventSinkDelivery.pendingRecords.count == 0) {
+        return;
+    }
+    
+    NSArray<SRGAnalyticsEventJournalRecord *> *records = eventSinkDelivery.pendingRecords.copy;
+    eventSinkDelivery.deliveringCount = records.count;
+    
+    // Completion handlers might be called on any thread
+    dispatch_queue_t workerQueue = self.eventQueue.workerQueue;
+    [eventSinkDelivery.eventSink deliverPayloads:[self payloadsForRecords:records] completion:^(SRGAnalyticsEventSinkDeliveryResult result) {
+        dispatch_async(workerQueue, ^{
+            [self completeDeliveryWithEventSinkDelivery:eventSinkDelivery result:result];
+        });
     }];
+}
+
+- (void)completeDeliveryWithEventSinkDelivery:(SRGAnalyticsEventSinkDelivery *)eventSinkDelivery result:(SRGAnalyticsEventSinkDeliveryResult)result
+{
+    // The sink has been removed in the meantime
+    if (eventSinkDelivery.deliveringCount == 0) {
+        return;
+    }
+    
+    NSRange deliveredRange = NSMakeRange(0, eventSinkDelivery.deliveringCount);
+    NSArray<SRGAnalyticsEventJournalRecord *> *records = [eventSinkDelivery.pendingRecords subarrayWithRange:deliveredRange];
+    eventSinkDelivery.deliveringCount = 0;
+    
+    switch (result) {
+        case SRGAnalyticsEventSinkDeliveryResultSuccess: {
+            [eventSinkDelivery.pendingRecords removeObjectsInRange:deliveredRange];
+            [self releaseRecords:records];
+            [self deliverPendingRecordsWithEventSinkDelivery:eventSinkDelivery];
+            break;
+        }
+            
+        case SRGAnalyticsEventSinkDeliveryResultRejection: {
+            SRGAnalyticsLogWarning(@"tracker", @"%@ events have been rejected by %@ and discarded", @(records.count), eventSinkDelivery.eventSink);
+            [eventSinkDelivery.pendingRecords removeObjectsInRange:deliveredRange];
+            [self discardRecords:records];
+            [self deliverPendingRecordsWithEventSinkDelivery:eventSinkDelivery];
+            break;
+        }
+            
+        default: {
+            // Records stay first in line, and are delivered again with the next batch or when the network becomes
+            // reachable again
+            SRGAnalyticsLogWarning(@"tracker", @"%@ events could not be delivered to %@ and will be delivered again later", @(records.count), eventSinkDelivery.eventSink);
+            break;
+        }
+    }
+}
+
+- (SRGAnalyticsEventSinkDelivery *)eventSinkDeliveryForEventSink:(id<SRGAnalyticsEventSink>)eventSink
+{
+    for (SRGAnalyticsEventSinkDelivery *eventSinkDelivery in self.eventSinkDeliveries) {
+        if (eventSinkDelivery.eventSink == eventSink) {
+            return eventSinkDelivery;
+        }
+    }
+    
+    SRGAnalyticsEventSinkDelivery *eventSinkDelivery = [[SRGAnalyticsEventSinkDelivery alloc] init];
+    eventSinkDelivery.eventSink = eventSink;
+    eventSinkDelivery.pendingRecords = [NSMutableArray array];
+    [self.eventSinkDeliveries addObject:eventSinkDelivery];
+    return eventSinkDelivery;
+}
+
+// Remove the oldest records beyond the maximum count, preserving those before the specified index
+- (NSArray<SRGAnalyticsEventJournalRecord *> *)removeExcessRecordsFromArray:(NSMutableArray<SRGAnalyticsEventJournalRecord *> *)records startingAtIndex:(NSUInteger)index
+{
+    if (records.count <= SRGAnalyticsMaximumUndeliveredRecordCount || records.count <= index) {
+        return @[];
+    }
+    
+    NSRange excessRange = NSMakeRange(index, MIN(records.count - SRGAnalyticsMaximumUndeliveredRecordCount, records.count - index));
+    NSArray<SRGAnalyticsEventJournalRecord *> *excessRecords = [records subarrayWithRange:excessRange];
+    [records removeObjectsInRange:excessRange];
+    return excessRecords;
+}
+
+// Records a durable sink is done with, whether delivered or not
+- (void)releaseRecords:(NSArray<SRGAnalyticsEventJournalRecord *> *)records
+{
+    for (SRGAnalyticsEventJournalRecord *record in records) {
+        [self.pendingRecordCounts removeObject:record];
+    }
+    [self acknowledgeDeliveredRecords:records];
+}
+
+// Records lost before delivery. Sessions they belong to continue with a key frame, as later delta-encoded records
+// would otherwise refer to a base which was never received.
+- (void)discardRecords:(NSArray<SRGAnalyticsEventJournalRecord *> *)records
+{
+    for (SRGAnalyticsEventJournalRecord *record in records) {
+        [[self.deltaEncoders objectForKey:record] setNeedsKeyFrame];
+    }
+    [self releaseRecords:records];
+}
+
+// Acknowledge records no durable sink is delivering anymore
+- (void)acknowledgeDeliveredRecords:(NSArray<SRGAnalyticsEventJournalRecord *> *)records
+{
+    for (SRGAnalyticsEventJournalRecord *record in records) {
+        if ([self.pendingRecordCounts countForObject:record] == 0) {
+            [self.journal acknowledgeRecord:record];
+        }
+    }
+}
+
+- (NSArray<NSDictionary<NSString *, id> *> *)payloadsForRecords:(NSArray<SRGAnalyticsEventJournalRecord *> *)records
+{
+    NSMutableArray<NSDictionary<NSString *, id> *> *payloads = [NSMutableArray arrayWithCapacity:records.count];
+    for (SRGAnalyticsEventJournalRecord *record in records) {
+        [payloads addObject:record.payload];
+    }
+    return payloads.copy;
+}
 
-    [labels enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull value, BOOL * _Nonnull stop) {
-        [event addAdditionalProperty:key withStringValue:value];
+- (NSDictionary<NSString *, id> *)commandersActPageViewPayloadForEvent:(SRGAnalyticsEvent *)event
+{
+    NSAssert(event.name.length != 0 && event.pageType.length != 0, @"A title and a type are required");
+    
+    NSMutableDictionary<NSString *, NSString *> *labels = [NSMutableDictionary dictionary];
+    [labels srg_safelySetString:@"app" forKey:@"navigation_property_type"];
+    [labels srg_safelySetString:self.configuration.businessUnitIdentifier.uppercaseString forKey:@"content_bu_owner"];
+    [labels srg_safelySetString:event.fromPushNotification ? @"true" : @"false" forKey:@"accessed_after_push_notification"];
+    
+    [event.levels enumerateObjectsUsingBlock:^(NSString * _Nonnull object, NSUInteger idx, BOOL * _Nonnull stop) {
+        if (idx > 7) {
+            *stop = YES;
+            return;
+        }
+        
+        NSString *levelKey = [NSString stringWithFormat:@"navigation_level_%@", @(idx + 1)];
+        [labels srg_safelySetString:object forKey:levelKey];
     }];
+    
+    [event.labels.labelStore addEntriesToDictionary:labels];
+    
+    return @{ SRGAnalyticsPayloadKindKey : SRGAnalyticsPayloadKindPageView,
+              SRGAnalyticsPayloadNameKey : event.name,
+              SRGAnalyticsPayloadPageTypeKey : event.pageType,
+              SRGAnalyticsPayloadLabelsKey : [self commandersActLabelsWithLabels:labels forEvent:event] };
+}
 
-    if (self.configuration.unitTesting) {
-        [event addAdditionalProperty:@"srg_test_id" withStringValue:SRGAnalyticsUnitTestingIdentifier()];
+- (NSDictionary<NSString *, id> *)commandersActCustomEventPayloadForEvent:(SRGAnalyticsEvent *)event
+{
+    NSAssert(event.name.length != 0, @"A name is required");
+    
+    NSMutableDictionary<NSString *, NSString *> *labels = [NSMutableDictionary dictionary];
+    [event.labels.labelStore addEntriesToDictionary:labels];
+    if (event.labelsDictionary) {
+        [labels addEntriesFromDictionary:event.labelsDictionary];
     }
+    
+    return @{ SRGAnalyticsPayloadKindKey : SRGAnalyticsPayloadKindCustom,
+              SRGAnalyticsPayloadNameKey : event.name,
+              SRGAnalyticsPayloadLabelsKey : [self commandersActLabelsWithLabels:labels forEvent:event] };
+}
 
-    [self.serverSide execute:event];
+// Complete event labels with default ones
+- (NSDictionary<NSString *, NSString *> *)commandersActLabelsWithLabels:(NSDictionary<NSString *, NSString *> *)labels forEvent:(SRGAnalyticsEvent *)event
+{
+    uint64_t mergeStartTime = SRGAnalyticsMetricsStartTime();
+    
+    NSMutableDictionary<NSString *, NSString *> *commandersActLabels = event.labelsSnapshot.labelsDictionary.mutableCopy ?: [NSMutableDictionary dictionary];
+    [commandersActLabels addEntriesFromDictionary:labels];
+    if (event.unitTestingIdentifier) {
+        commandersActLabels[@"srg_test_id"] = event.unitTestingIdentifier;
+    }
+    if (event.samplingWeight != 0.) {
+        commandersActLabels[@"sampling_weight"] = [NSString stringWithFormat:@"%g", event.samplingWeight];
+    }
+    
+    NSDictionary<NSString *, NSString *> *labels = commandersActLabels.copy;
+    SRGAnalyticsMetricsRecordLatency(SRGAnalyticsMetricsLatencyLabelMerge, mergeStartTime);
+    return labels;
 }
 
-- (void)sendCommandersActCustomEventWithName:(NSString *)name
-                                      labels:(NSDictionary<NSString *, NSString *> *)labels
+#pragma mark Event sinks
+
+- (void)addEventSink:(id<SRGAnalyticsEventSink>)eventSink
 {
-    NSAssert(name.length != 0, @"A name is required");
+    if (! self.eventQueue) {
+        SRGAnalyticsLogWarning(@"tracker", @"The tracker has not been started yet");
+        return;
+    }
+    
+    // Synchronous, so that all events recorded afterwards are delivered to the sink. Applied immediately when called
+    // from the worker thread (e.g. from a sink).
+    [self.eventQueue performBlockAndWaitOnWorkerQueue:^{
+        if (! [self.eventSinks containsObject:eventSink]) {
+            self.eventSinks = [self.eventSinks ?: @[] arrayByAddingObject:eventSink];
+        }
+    }];
+}
 
-    TCCustomEvent *event = [[TCCustomEvent alloc] initWithName:name];
-    [self.defaultLabels enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull value, BOOL * _Nonnull stop) {
-        [event addAdditionalProperty:key withStringValue:value];
+- (void)removeEventSink:(id<SRGAnalyticsEventSink>)eventSink
+{
+    if (! self.eventQueue) {
+        return;
+    }
+    
+    [self.eventQueue performBlockAndWaitOnWorkerQueue:^{
+        NSMutableArray<id<SRGAnalyticsEventSink>> *eventSinks = self.eventSinks.mutableCopy;
+        [eventSinks removeObject:eventSink];
+        self.eventSinks = eventSinks.copy;
+        
+        // Records pending delivery to the sink are not needed anymore. A delivery in progress is ignored when complete.
+        for (SRGAnalyticsEventSinkDelivery *eventSinkDelivery in self.eventSinkDeliveries) {
+            if (eventSinkDelivery.eventSink == eventSink) {
+                NSArray<SRGAnalyticsEventJournalRecord *> *records = eventSinkDelivery.pendingRecords.copy;
+                [eventSinkDelivery.pendingRecords removeAllObjects];
+                eventSinkDelivery.deliveringCount = 0;
+                [self.eventSinkDeliveries removeObject:eventSinkDelivery];
+                [self releaseRecords:records];
+                break;
+            }
+        }
     }];
+}
+
+- (void)synchronizeEventSinks
+{
+    for (id<SRGAnalyticsEventSink> eventSink in self.eventSinks) {
+        if ([eventSink respondsToSelector:@selector(synchronize)]) {
+            [eventSink synchronize];
+        }
+    }
+}
+
+#pragma mark Event taps
 
-    [labels enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull value, BOOL * _Nonnull stop) {
-        [event addAdditionalProperty:key withStringValue:value];
+- (void)addEventTap:(SRGAnalyticsEventTap *)eventTap
+{
+    if (! self.eventQueue) {
+        SRGAnalyticsLogWarning(@"tracker", @"The tracker has not been started yet");
+        return;
+    }
+    
+    // Synchronous, so that all events recorded afterwards are received by the tap. Applied immediately when called
+    // from the worker thread (e.g. from a tap handler called without queue).
+    [self.eventQueue performBlockAndWaitOnWorkerQueue:^{
+        if (! [self.eventTaps containsObject:eventTap]) {
+            self.eventTaps = [self.eventTaps ?: @[] arrayByAddingObject:eventTap];
+        }
     }];
+}
 
-    if (self.configuration.unitTesting) {
-        [event addAdditionalProperty:@"srg_test_id" withStringValue:SRGAnalyticsUnitTestingIdentifier()];
+- (void)removeEventTap:(SRGAnalyticsEventTap *)eventTap
+{
+    if (! self.eventQueue) {
+        return;
     }
+    
+    [self.eventQueue performBlockAndWaitOnWorkerQueue:^{
+        NSMutableArray<SRGAnalyticsEventTap *> *eventTaps = self.eventTaps.mutableCopy;
+        [eventTaps removeObject:eventTap];
+        self.eventTaps = eventTaps.copy;
+    }];
+}
+
+// Expose labels as built, before any serialization
+- (void)tapEventWithPayload:(NSDictionary<NSString *, id> *)payload
+{
+    if (self.eventTaps.count == 0) {
+        return;
+    }
+    
+    NSString *name = payload[SRGAnalyticsPayloadNameKey];
+    NSString *pageType = payload[SRGAnalyticsPayloadPageTypeKey];
+    NSDictionary<NSString *, NSString *> *labels = payload[SRGAnalyticsPayloadLabelsKey];
+    for (SRGAnalyticsEventTap *eventTap in self.eventTaps) {
+        [eventTap receiveEventWithName:name pageType:pageType labels:labels];
+    }
+}
 
-    [self.serverSide execute:event];
+#pragma mark Journal and network reachability (worker thread)
+
+- (void)openJournalWithConfiguration:(SRGAnalyticsConfiguration *)configuration
+{
+    self.journal = [[SRGAnalyticsEventJournal alloc] initWithDirectoryURL:configuration.journalDirectoryURL ?: SRGAnalyticsEventJournal.defaultDirectoryURL];
+    
+    NSArray<SRGAnalyticsEventJournalRecord *> *replayedRecords = self.journal.replayedRecords;
+    if (replayedRecords.count != 0) {
+        [self.undeliveredRecords insertObjects:replayedRecords atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, replayedRecords.count)]];
+        [self deliverRecords];
+    }
+}
+
+- (void)startMonitoringNetwork
+{
+    self.pathMonitor = nw_path_monitor_create();
+    nw_path_monitor_set_queue(self.pathMonitor, self.eventQueue.workerQueue);
+    
+    nw_path_monitor_set_update_handler(self.pathMonitor, ^(nw_path_t _Nonnull path) {
+        self.networkReachable = (nw_path_get_status(path) == nw_path_status_satisfied);
+        self.networkExpensive = nw_path_is_expensive(path);
+        [self updateBatchingWindow];
+        [self deliverRecords];
+    });
+    nw_path_monitor_start(self.pathMonitor);
+}
+
+- (void)updateBatchingWindow
+{
+    // Wait longer before waking up the radio when it is costly
+    self.batcher.windowExtended = self.networkExpensive || NSProcessInfo.processInfo.lowPowerModeEnabled;
 }
 
 #pragma mark Page view tracking
@@ -340,31 +991,12 @@ void SRGAnalyticsRenewUnitTestingIdentifier(void)
                                      labels:(SRGAnalyticsPageViewLabels *)labels
                        fromPushNotification:(BOOL)fromPushNotification
 {
-    NSMutableDictionary<NSString *, NSString *> *fullLabels = [NSMutableDictionary dictionary];
-    [fullLabels srg_safelySetString:@"app" forKey:@"navigation_property_type"];
-    [fullLabels srg_safelySetString:self.configuration.businessUnitIdentifier.uppercaseString forKey:@"content_bu_owner"];
-    [fullLabels srg_safelySetString:fromPushNotification ? @"true" : @"false" forKey:@"accessed_after_push_notification"];
-
-    [levels enumerateObjectsUsingBlock:^(NSString * _Nonnull object, NSUInteger idx, BOOL * _Nonnull stop) {
-        if (idx > 7) {
-            *stop = YES;
-            return;
-        }
-
-        NSString *levelKey = [NSString stringWithFormat:@"navigation_level_%@", @(idx + 1)];
-        [fullLabels srg_safelySetString:object forKey:levelKey];
-    }];
-
-    NSDictionary<NSString *, NSString *> *labelsDictionary = [labels labelsDictionary];
-    if (labelsDictionary) {
-        [fullLabels addEntriesFromDictionary:labelsDictionary];
-    }
-
-    if (self.configuration.unitTesting) {
-        [fullLabels srg_safelySetString:SRGAnalyticsUnitTestingIdentifier() forKey:@"srg_test_id"];
-    }
-
-    [self sendCommandersActPageViewEventWithTitle:title type:type labels:fullLabels.copy];
+    SRGAnalyticsEvent *event = [SRGAnalyticsEvent pageViewEventWithTitle:title
+                                                                    type:type
+                                                                  levels:levels
+                                                                  labels:labels
+                                                    fromPushNotification:fromPushNotification];
+    [self recordEvent:event];
 }
 
 #pragma mark Event tracking
@@ -392,20 +1024,52 @@ void SRGAnalyticsRenewUnitTestingIdentifier(void)
 
 - (void)trackCommandersActEventWithName:(NSString *)name labels:(SRGAnalyticsEventLabels *)labels
 {
-    NSAssert(self.configuration != nil, @"The tracker must be started");
+    SRGAnalyticsEvent *event = [SRGAnalyticsEvent customEventWithName:name labels:labels labelsDictionary:nil];
+    [self recordEvent:event];
+}
+
+#pragma mark Metrics
+
+- (SRGAnalyticsMetricsSnapshot *)metricsSnapshotWithReset:(BOOL)reset
+{
+    return SRGAnalyticsMetricsTakeSnapshot(reset);
+}
+
+#pragma mark Notifications
 
-    NSMutableDictionary<NSString *, NSString *> *fullLabels = [NSMutableDictionary dictionary];
+- (void)applicationDidBecomeActive:(NSNotification *)notification
+{
+    [NSNotificationCenter.defaultCenter removeObserver:self name:UIApplicationDidBecomeActiveNotification object:nil];
     
-    NSDictionary<NSString *, NSString *> *labelsDictionary = [labels labelsDictionary];
-    if (labelsDictionary) {
-        [fullLabels addEntriesFromDictionary:labelsDictionary];
-    }
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [self startComScoreIfNeeded];
+    });
+}
 
-    if (self.configuration.unitTesting) {
-        [fullLabels srg_safelySetString:SRGAnalyticsUnitTestingIdentifier() forKey:@"srg_test_id"];
-    }
+- (void)applicationDidEnterBackground:(NSNotification *)notification
+{
+    dispatch_async(self.eventQueue.workerQueue, ^{
+        [self.batcher flush];
+        [self.journal synchronize];
+        [self synchronizeEventSinks];
+    });
+}
+
+- (void)applicationWillTerminate:(NSNotification *)notification
+{
+    // Wait so that the journal is safely written before the process exits
+    dispatch_sync(self.eventQueue.workerQueue, ^{
+        [self.batcher flush];
+        [self.journal synchronize];
+        [self synchronizeEventSinks];
+    });
+}
 
-    [self sendCommandersActCustomEventWithName:name labels:fullLabels.copy];
+- (void)powerStateDidChange:(NSNotification *)notification
+{
+    dispatch_async(self.eventQueue.workerQueue, ^{
+        [self updateBatchingWindow];
+    });
 }
 
 #pragma mark Description
@@ -424,3 +1088,7 @@ void SRGAnalyticsRenewUnitTestingIdentifier(void)
 }
 
 @end
+
+@implementation SRGAnalyticsEventSinkDelivery
+
+@end
@@ -0,0 +1,63 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import UIKit;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Block returning the children to visit for a view controller.
+ */
+typedef NSArray<UIViewController *> * _Nonnull (^SRGAnalyticsChildViewControllersBlock)(UIViewController *viewController);
+
+/**
+ *  Block returning whether a view controller is tracked.
+ */
+typedef BOOL (^SRGAnalyticsTrackedViewControllerBlock)(UIViewController *viewController);
+
+/**
+ *  Index of the tracked view controllers found in a view controller hierarchy, in the order in which automatic page
+ *  views must be sent for them (depth-first, children before their parent).
+ *
+ *  The tracked view controllers found in the subtree of each visited view controller are cached, so that the hierarchy
+ *  is only walked again where it might have changed. When the children of a container might have changed (e.g. when a
+ *  view controller appears, disappears or moves to another parent), `-invalidateViewController:` must be called so that
+ *  the subtrees containing it are updated on next enumeration. Other subtrees are left untouched. View controllers are
+ *  not retained.
+ *
+ *  @discussion Must be used from the main thread.
+ */
+@interface SRGAnalyticsViewControllerIndex : NSObject
+
+/**
+ *  Create an index visiting the children returned by `childViewControllersBlock` and retaining view controllers for
+ *  which `trackedBlock` returns `YES`.
+ */
+- (instancetype)initWithChildViewControllersBlock:(SRGAnalyticsChildViewControllersBlock)childViewControllersBlock
+                                     trackedBlock:(SRGAnalyticsTrackedViewControllerBlock)trackedBlock NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Invalidate the cached subtrees containing the specified view controller, i.e. the one of the view controller itself
+ *  and of all its ancestors.
+ */
+- (void)invalidateViewController:(UIViewController *)viewController;
+
+/**
+ *  Enumerate the tracked view controllers found in the hierarchy rooted at the specified view controller, in order.
+ *  Only invalid subtrees are walked again.
+ */
+- (void)enumerateViewControllersWithRootViewController:(UIViewController *)rootViewController
+                                            usingBlock:(void (NS_NOESCAPE ^)(UIViewController *viewController))block;
+
+@end
+
+@interface SRGAnalyticsViewControllerIndex (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
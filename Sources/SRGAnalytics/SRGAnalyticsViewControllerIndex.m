@@ -0,0 +1,104 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsViewControllerIndex.h"
+
+@interface SRGAnalyticsViewControllerIndex ()
+
+@property (nonatomic, copy) SRGAnalyticsChildViewControllersBlock childViewControllersBlock;
+@property (nonatomic, copy) SRGAnalyticsTrackedViewControllerBlock trackedBlock;
+
+@property (nonatomic) NSMapTable<UIViewController *, NSPointerArray *> *subtrees;
+
+@end
+
+@implementation SRGAnalyticsViewControllerIndex
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithChildViewControllersBlock:(SRGAnalyticsChildViewControllersBlock)childViewControllersBlock
+                                     trackedBlock:(SRGAnalyticsTrackedViewControllerBlock)trackedBlock
+{
+    if (self = [super init]) {
+        self.childViewControllersBlock = childViewControllersBlock;
+        self.trackedBlock = trackedBlock;
+        self.subtrees = [NSMapTable weakToStrongObjectsMapTable];
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithChildViewControllersBlock:^(UIViewController *viewController) { return @[]; }
+                                      trackedBlock:^(UIViewController *viewController) { return NO; }];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Index
+
+- (void)invalidateViewController:(UIViewController *)viewController
+{
+    // Do not stop at the first ancestor without cached subtree, as inactive children (e.g. unselected tabs) are never
+    // visited and thus never cached, while their parent is.
+    UIViewController *ancestorViewController = viewController;
+    while (ancestorViewController) {
+        [self.subtrees removeObjectForKey:ancestorViewController];
+        ancestorViewController = ancestorViewController.parentViewController;
+    }
+}
+
+- (void)enumerateViewControllersWithRootViewController:(UIViewController *)rootViewController
+                                            usingBlock:(void (NS_NOESCAPE ^)(UIViewController * _Nonnull))block
+{
+    // Weak pointers are set to `NULL` when objects are deallocated
+    for (UIViewController *viewController in [self subtreeForViewController:rootViewController]) {
+        if (viewController) {
+            block(viewController);
+        }
+    }
+}
+
+- (NSPointerArray *)subtreeForViewController:(UIViewController *)viewController
+{
+    NSPointerArray *subtree = [self.subtrees objectForKey:viewController];
+    if (subtree) {
+        return subtree;
+    }
+    
+    subtree = [NSPointerArray weakObjectsPointerArray];
+    for (UIViewController *childViewController in self.childViewControllersBlock(viewController)) {
+        for (UIViewController *trackedViewController in [self subtreeForViewController:childViewController]) {
+            if (trackedViewController) {
+                [subtree addPointer:(__bridge void *)trackedViewController];
+            }
+        }
+    }
+    
+    // Not an else-if here: The container itself could be tracked as well.
+    if (self.trackedBlock(viewController)) {
+        [subtree addPointer:(__bridge void *)viewController];
+    }
+    
+    [self.subtrees setObject:subtree forKey:viewController];
+    return subtree;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; count = %@>",
+            self.class,
+            self,
+            @(self.subtrees.count)];
+}
+
+@end
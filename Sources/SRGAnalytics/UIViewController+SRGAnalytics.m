@@ -6,22 +6,43 @@
 
 #import "UIViewController+SRGAnalytics.h"
 
+#import "SRGAnalyticsPageViewCoalescer.h"
 #import "SRGAnalyticsTracker+Private.h"
+#import "SRGAnalyticsViewControllerIndex.h"
 
 #import <objc/runtime.h>
+#import <os/lock.h>
+
+// Protocol conformance and optional methods implemented by a view controller class
+typedef NS_OPTIONS(NSUInteger, SRGAnalyticsViewControllerCapabilities) {
+    SRGAnalyticsViewControllerCapabilityViewTracking = 1 << 0,
+    SRGAnalyticsViewControllerCapabilityContainerViewTracking = 1 << 1,
+    SRGAnalyticsViewControllerCapabilityTrackedAutomatically = 1 << 2,
+    SRGAnalyticsViewControllerCapabilityPageViewLevels = 1 << 3,
+    SRGAnalyticsViewControllerCapabilityPageViewLabels = 1 << 4,
+    SRGAnalyticsViewControllerCapabilityOpenedFromPushNotification = 1 << 5
+};
 
 // Associated object keys
 static void *s_appearedOnce = &s_appearedOnce;
+static void *s_pageViewCoalescer = &s_pageViewCoalescer;
 
 // Functions
+static SRGAnalyticsViewControllerCapabilities UIViewController_SRGAnalyticsCapabilities(UIViewController *viewController);
+static SRGAnalyticsViewControllerIndex *UIViewController_SRGAnalyticsViewControllerIndex(void);
 static void UIViewController_SRGAnalyticsUpdateAnalyticsForWindow(UIWindow *window);
+static SRGAnalyticsPageViewCoalescer *UIViewController_SRGAnalyticsPageViewCoalescer(UIWindow *window);
 
 // Swizzled method original implementations
 static void (*s_UIViewController_viewDidAppear)(id, SEL, BOOL);
+static void (*s_UIViewController_viewDidDisappear)(id, SEL, BOOL);
+static void (*s_UIViewController_willMoveToParentViewController)(id, SEL, id);
 static void (*s_UITabBarController_setSelectedViewController)(id, SEL, id);
 
 // Swizzled method implementations
 static void swizzled_UIViewController_viewDidAppear(UIViewController *self, SEL _cmd, BOOL animated);
+static void swizzled_UIViewController_viewDidDisappear(UIViewController *self, SEL _cmd, BOOL animated);
+static void swizzled_UIViewController_willMoveToParentViewController(UIViewController *self, SEL _cmd, UIViewController *parentViewController);
 static void swizzled_UITabBarController_setSelectedViewController(UITabBarController *self, SEL _cmd, UIViewController *viewController);
 
 @implementation UIViewController (SRGAnalytics)
@@ -33,88 +54,110 @@ static void swizzled_UITabBarController_setSelectedViewController(UITabBarContro
     Method viewDidAppearMethod = class_getInstanceMethod(self, @selector(viewDidAppear:));
     s_UIViewController_viewDidAppear = (__typeof__(s_UIViewController_viewDidAppear))method_getImplementation(viewDidAppearMethod);
     method_setImplementation(viewDidAppearMethod, (IMP)swizzled_UIViewController_viewDidAppear);
+    
+    Method viewDidDisappearMethod = class_getInstanceMethod(self, @selector(viewDidDisappear:));
+    s_UIViewController_viewDidDisappear = (__typeof__(s_UIViewController_viewDidDisappear))method_getImplementation(viewDidDisappearMethod);
+    method_setImplementation(viewDidDisappearMethod, (IMP)swizzled_UIViewController_viewDidDisappear);
+    
+    Method willMoveToParentViewControllerMethod = class_getInstanceMethod(self, @selector(willMoveToParentViewController:));
+    s_UIViewController_willMoveToParentViewController = (__typeof__(s_UIViewController_willMoveToParentViewController))method_getImplementation(willMoveToParentViewControllerMethod);
+    method_setImplementation(willMoveToParentViewControllerMethod, (IMP)swizzled_UIViewController_willMoveToParentViewController);
 }
 
 #pragma mark Tracking
 
 - (void)srg_trackPageView
 {
-    [self srg_trackPageViewAutomatic:NO recursive:NO ignoreApplicationState:NO];
+    [self srg_trackPageViewAutomatic:NO recursive:NO ignoreApplicationState:NO coalescer:nil];
 }
 
 - (void)srg_setNeedsAutomaticPageViewTrackingInChildViewController:(UIViewController *)childViewController
 {
-    if (! [self conformsToProtocol:@protocol(SRGAnalyticsContainerViewTracking)]) {
+    if (! (UIViewController_SRGAnalyticsCapabilities(self) & SRGAnalyticsViewControllerCapabilityContainerViewTracking)) {
         return;
     }
     
-    if (! [self.childViewControllers containsObject:childViewController]) {
+    if (childViewController.parentViewController != self) {
         return;
     }
     
-    [childViewController srg_trackPageViewAutomatic:YES recursive:YES ignoreApplicationState:NO];
+    // The active children of the container might have changed without any appearance. Invalidating the child also
+    // invalidates the container.
+    [UIViewController_SRGAnalyticsViewControllerIndex() invalidateViewController:childViewController];
+    
+    [childViewController srg_trackPageViewAutomatic:YES recursive:YES ignoreApplicationState:NO coalescer:UIViewController_SRGAnalyticsPageViewCoalescer(self.viewIfLoaded.window)];
 }
 
-- (NSArray<UIViewController *> *)srg_childViewControllers
+// Automatic page views are coalesced per window, manual page views are never coalesced
+- (void)srg_trackPageViewAutomatic:(BOOL)automatic
+                         recursive:(BOOL)recursive
+            ignoreApplicationState:(BOOL)ignoreApplicationState
+                         coalescer:(SRGAnalyticsPageViewCoalescer *)coalescer
 {
-    if ([self conformsToProtocol:@protocol(SRGAnalyticsContainerViewTracking)]) {
-        id<SRGAnalyticsContainerViewTracking> containerSelf = (id<SRGAnalyticsContainerViewTracking>)self;
-        return containerSelf.srg_activeChildViewControllers;
+    if (recursive) {
+        [UIViewController_SRGAnalyticsViewControllerIndex() enumerateViewControllersWithRootViewController:self usingBlock:^(UIViewController * _Nonnull viewController) {
+            [viewController srg_sendPageViewAutomatic:automatic propagated:YES ignoreApplicationState:ignoreApplicationState coalescer:coalescer];
+        }];
     }
     else {
-        return self.childViewControllers;
+        [self srg_sendPageViewAutomatic:automatic propagated:NO ignoreApplicationState:ignoreApplicationState coalescer:coalescer];
     }
 }
 
-- (void)srg_trackPageViewAutomatic:(BOOL)automatic recursive:(BOOL)recursive ignoreApplicationState:(BOOL)ignoreApplicationState
+// Send a page view for the receiver only. Propagated page views are those sent when walking the view controller hierarchy
+- (void)srg_sendPageViewAutomatic:(BOOL)automatic
+                       propagated:(BOOL)propagated
+           ignoreApplicationState:(BOOL)ignoreApplicationState
+                        coalescer:(SRGAnalyticsPageViewCoalescer *)coalescer
 {
-    if (recursive) {
-        NSArray<UIViewController *> *childViewControllers = [self srg_childViewControllers];
-        for (UIViewController *viewController in childViewControllers) {
-            [viewController srg_trackPageViewAutomatic:automatic recursive:recursive ignoreApplicationState:ignoreApplicationState];
-        }
+    SRGAnalyticsViewControllerCapabilities capabilities = UIViewController_SRGAnalyticsCapabilities(self);
+    if (! (capabilities & SRGAnalyticsViewControllerCapabilityViewTracking)) {
+        return;
     }
     
-    // Not an else-if here: The container itself could be tracked as well.
-    if ([self conformsToProtocol:@protocol(SRGAnalyticsViewTracking)]) {
-        id<SRGAnalyticsViewTracking> trackedSelf = (id<SRGAnalyticsViewTracking>)self;
-        
-        if (automatic && [trackedSelf respondsToSelector:@selector(srg_isTrackedAutomatically)] && ! [trackedSelf srg_isTrackedAutomatically]) {
-            return;
-        }
-        
-        // Inhibit container-triggered updates until the view controller has been displayed only once. First appearance
-        // is detected by the view controller itself when added as a child.
-        BOOL appearedOnce = [objc_getAssociatedObject(self, s_appearedOnce) boolValue];
-        if (recursive && ! appearedOnce) {
-            return;
-        }
-        
-        NSString *title = [trackedSelf srg_pageViewTitle];
-        NSString *type = [trackedSelf srg_pageViewType];
-
-        NSArray<NSString *> *levels = nil;
-        if ([trackedSelf respondsToSelector:@selector(srg_pageViewLevels)]) {
-            levels = [trackedSelf srg_pageViewLevels];
-        }
-        
-        SRGAnalyticsPageViewLabels *labels = nil;
-        if ([trackedSelf respondsToSelector:@selector(srg_pageViewLabels)]) {
-            labels = [trackedSelf srg_pageViewLabels];
-        }
-        
-        BOOL fromPushNotification = NO;
-        if ([trackedSelf respondsToSelector:@selector(srg_isOpenedFromPushNotification)]) {
-            fromPushNotification = [trackedSelf srg_isOpenedFromPushNotification];
-        }
-        
-        [SRGAnalyticsTracker.sharedTracker trackPageViewWithTitle:title
-                                                             type:type
-                                                           levels:levels
-                                                           labels:labels
-                                             fromPushNotification:fromPushNotification
-                                           ignoreApplicationState:ignoreApplicationState];
+    id<SRGAnalyticsViewTracking> trackedSelf = (id<SRGAnalyticsViewTracking>)self;
+    
+    if (automatic && (capabilities & SRGAnalyticsViewControllerCapabilityTrackedAutomatically) && ! [trackedSelf srg_isTrackedAutomatically]) {
+        return;
     }
+    
+    // Inhibit container-triggered updates until the view controller has been displayed only once. First appearance
+    // is detected by the view controller itself when added as a child.
+    if (propagated && ! objc_getAssociatedObject(self, s_appearedOnce)) {
+        return;
+    }
+    
+    NSString *title = [trackedSelf srg_pageViewTitle];
+    NSString *type = [trackedSelf srg_pageViewType];
+    
+    NSArray<NSString *> *levels = nil;
+    if (capabilities & SRGAnalyticsViewControllerCapabilityPageViewLevels) {
+        levels = [trackedSelf srg_pageViewLevels];
+    }
+    
+    SRGAnalyticsPageViewLabels *labels = nil;
+    if (capabilities & SRGAnalyticsViewControllerCapabilityPageViewLabels) {
+        labels = [trackedSelf srg_pageViewLabels];
+    }
+    
+    BOOL fromPushNotification = NO;
+    if (capabilities & SRGAnalyticsViewControllerCapabilityOpenedFromPushNotification) {
+        fromPushNotification = [trackedSelf srg_isOpenedFromPushNotification];
+    }
+    
+    // Only page views which will actually be sent are coalesced. Page view information is always resolved first, so
+    // that a page view whose title, levels or labels changed is never discarded.
+    BOOL sent = title.length != 0 && type.length != 0 && (ignoreApplicationState || UIApplication.sharedApplication.applicationState != UIApplicationStateBackground);
+    if (coalescer && sent && ! [coalescer shouldTrackPageViewWithTitle:title type:type levels:levels labels:labels fromPushNotification:fromPushNotification]) {
+        return;
+    }
+    
+    [SRGAnalyticsTracker.sharedTracker trackPageViewWithTitle:title
+                                                         type:type
+                                                       levels:levels
+                                                       labels:labels
+                                         fromPushNotification:fromPushNotification
+                                       ignoreApplicationState:ignoreApplicationState];
 }
 
 #pragma mark Notifications
@@ -215,27 +258,144 @@ __attribute__((constructor)) static void UIViewController_SRGAnalyticsInit(void)
     }
 }
 
+// Capabilities are resolved once per class. Use the class as seen by the user (not the one returned by `object_getClass()`,
+// which might be a dynamic subclass, e.g. for KVO), so that cached classes are never disposed of.
+static SRGAnalyticsViewControllerCapabilities UIViewController_SRGAnalyticsCapabilities(UIViewController *viewController)
+{
+    static CFMutableDictionaryRef s_capabilities;
+    static os_unfair_lock s_lock = OS_UNFAIR_LOCK_INIT;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_capabilities = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
+    });
+    
+    Class cls = viewController.class;
+    
+    const void *value = NULL;
+    os_unfair_lock_lock(&s_lock);
+    Boolean found = CFDictionaryGetValueIfPresent(s_capabilities, (__bridge const void *)cls, &value);
+    os_unfair_lock_unlock(&s_lock);
+    
+    if (found) {
+        return (SRGAnalyticsViewControllerCapabilities)(uintptr_t)value;
+    }
+    
+    SRGAnalyticsViewControllerCapabilities capabilities = 0;
+    if ([cls conformsToProtocol:@protocol(SRGAnalyticsViewTracking)]) {
+        capabilities |= SRGAnalyticsViewControllerCapabilityViewTracking;
+        if ([cls instancesRespondToSelector:@selector(srg_isTrackedAutomatically)]) {
+            capabilities |= SRGAnalyticsViewControllerCapabilityTrackedAutomatically;
+        }
+        if ([cls instancesRespondToSelector:@selector(srg_pageViewLevels)]) {
+            capabilities |= SRGAnalyticsViewControllerCapabilityPageViewLevels;
+        }
+        if ([cls instancesRespondToSelector:@selector(srg_pageViewLabels)]) {
+            capabilities |= SRGAnalyticsViewControllerCapabilityPageViewLabels;
+        }
+        if ([cls instancesRespondToSelector:@selector(srg_isOpenedFromPushNotification)]) {
+            capabilities |= SRGAnalyticsViewControllerCapabilityOpenedFromPushNotification;
+        }
+    }
+    if ([cls conformsToProtocol:@protocol(SRGAnalyticsContainerViewTracking)]) {
+        capabilities |= SRGAnalyticsViewControllerCapabilityContainerViewTracking;
+    }
+    
+    os_unfair_lock_lock(&s_lock);
+    CFDictionarySetValue(s_capabilities, (__bridge const void *)cls, (const void *)(uintptr_t)capabilities);
+    os_unfair_lock_unlock(&s_lock);
+    
+    return capabilities;
+}
+
+// Tracked view controllers are collected depth-first, children before their parent. If a view controller does not conform
+// to `SRGAnalyticsContainerViewTracking` but contains children, all children are visited.
+static SRGAnalyticsViewControllerIndex *UIViewController_SRGAnalyticsViewControllerIndex(void)
+{
+    static SRGAnalyticsViewControllerIndex *s_index;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_index = [[SRGAnalyticsViewControllerIndex alloc] initWithChildViewControllersBlock:^NSArray<UIViewController *> * _Nonnull(UIViewController * _Nonnull viewController) {
+            if (UIViewController_SRGAnalyticsCapabilities(viewController) & SRGAnalyticsViewControllerCapabilityContainerViewTracking) {
+                id<SRGAnalyticsContainerViewTracking> containerViewController = (id<SRGAnalyticsContainerViewTracking>)viewController;
+                return containerViewController.srg_activeChildViewControllers;
+            }
+            else {
+                return viewController.childViewControllers;
+            }
+        } trackedBlock:^BOOL(UIViewController * _Nonnull viewController) {
+            return (UIViewController_SRGAnalyticsCapabilities(viewController) & SRGAnalyticsViewControllerCapabilityViewTracking) != 0;
+        }];
+    });
+    return s_index;
+}
+
+// The tracked view controllers are indexed, so that only the parts of the hierarchy which might have changed since the
+// application was last sent to the background are walked again
 static void UIViewController_SRGAnalyticsUpdateAnalyticsForWindow(UIWindow *window)
 {
     UIViewController *topViewController = window.rootViewController;
+    if (! topViewController) {
+        return;
+    }
+    
     while (topViewController.presentedViewController) {
         topViewController = topViewController.presentedViewController;
     }
-    [topViewController srg_trackPageViewAutomatic:YES recursive:YES ignoreApplicationState:YES];
+    
+    SRGAnalyticsPageViewCoalescer *coalescer = UIViewController_SRGAnalyticsPageViewCoalescer(window);
+    [UIViewController_SRGAnalyticsViewControllerIndex() enumerateViewControllersWithRootViewController:topViewController usingBlock:^(UIViewController * _Nonnull viewController) {
+        [viewController srg_sendPageViewAutomatic:YES propagated:YES ignoreApplicationState:YES coalescer:coalescer];
+    }];
+}
+
+static SRGAnalyticsPageViewCoalescer *UIViewController_SRGAnalyticsPageViewCoalescer(UIWindow *window)
+{
+    NSTimeInterval interval = SRGAnalyticsTracker.sharedTracker.configuration.pageViewDebounceInterval;
+    if (! window || interval <= 0.) {
+        return nil;
+    }
+    
+    SRGAnalyticsPageViewCoalescer *coalescer = objc_getAssociatedObject(window, s_pageViewCoalescer);
+    if (! coalescer || coalescer.interval != interval) {
+        coalescer = [[SRGAnalyticsPageViewCoalescer alloc] initWithInterval:interval];
+        objc_setAssociatedObject(window, s_pageViewCoalescer, coalescer, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    return coalescer;
 }
 
 static void swizzled_UIViewController_viewDidAppear(UIViewController *self, SEL _cmd, BOOL animated)
 {
     s_UIViewController_viewDidAppear(self, _cmd, animated);
     
+    [UIViewController_SRGAnalyticsViewControllerIndex() invalidateViewController:self];
+    
     // Track a view controller at most once automatically when appearing. This covers all possible appearance scenarios,
     // e.g.
     //    - Moving to a parent view controller
     //    - Modal presentation
     //    - View controller revealed after having been initially hidden behind a modal view controller
-    if (! [objc_getAssociatedObject(self, s_appearedOnce) boolValue]) {
-        [self srg_trackPageViewAutomatic:YES recursive:NO ignoreApplicationState:NO];
-        objc_setAssociatedObject(self, s_appearedOnce, @YES, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    if (! objc_getAssociatedObject(self, s_appearedOnce)) {
+        [self srg_trackPageViewAutomatic:YES recursive:NO ignoreApplicationState:NO coalescer:UIViewController_SRGAnalyticsPageViewCoalescer(self.viewIfLoaded.window)];
+        objc_setAssociatedObject(self, s_appearedOnce, (__bridge id)kCFBooleanTrue, OBJC_ASSOCIATION_ASSIGN);
+    }
+}
+
+static void swizzled_UIViewController_viewDidDisappear(UIViewController *self, SEL _cmd, BOOL animated)
+{
+    s_UIViewController_viewDidDisappear(self, _cmd, animated);
+    
+    [UIViewController_SRGAnalyticsViewControllerIndex() invalidateViewController:self];
+}
+
+// Both the former and the new parent see their children change
+static void swizzled_UIViewController_willMoveToParentViewController(UIViewController *self, SEL _cmd, UIViewController *parentViewController)
+{
+    s_UIViewController_willMoveToParentViewController(self, _cmd, parentViewController);
+    
+    SRGAnalyticsViewControllerIndex *index = UIViewController_SRGAnalyticsViewControllerIndex();
+    [index invalidateViewController:self];
+    if (parentViewController) {
+        [index invalidateViewController:parentViewController];
     }
 }
 
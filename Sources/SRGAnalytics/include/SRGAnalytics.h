@@ -12,8 +12,11 @@ FOUNDATION_EXPORT NSString * SRGAnalyticsMarketingVersion(void);
 // Public headers.
 #import "SRGAnalyticsConfiguration.h"
 #import "SRGAnalyticsEventLabels.h"
+#import "SRGAnalyticsEventTap.h"
 #import "SRGAnalyticsLabels.h"
+#import "SRGAnalyticsMetrics.h"
 #import "SRGAnalyticsNotifications.h"
 #import "SRGAnalyticsPageViewLabels.h"
+#import "SRGAnalyticsSamplingPolicy.h"
 #import "SRGAnalyticsTracker.h"
 #import "UIViewController+SRGAnalytics.h"
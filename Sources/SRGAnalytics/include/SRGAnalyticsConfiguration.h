@@ -4,6 +4,8 @@
 //  License information is available from the LICENSE file.
 //
 
+#import "SRGAnalyticsSamplingPolicy.h"
+
 @import Foundation;
 
 NS_ASSUME_NONNULL_BEGIN
@@ -20,6 +22,24 @@ OBJC_EXPORT SRGAnalyticsBusinessUnitIdentifier const SRGAnalyticsBusinessUnitIde
 OBJC_EXPORT SRGAnalyticsBusinessUnitIdentifier const SRGAnalyticsBusinessUnitIdentifierSRG;
 OBJC_EXPORT SRGAnalyticsBusinessUnitIdentifier const SRGAnalyticsBusinessUnitIdentifierSWI;
 
+/**
+ *  Policies applied when an event is recorded while the tracker event queue is full.
+ */
+typedef NS_ENUM(NSInteger, SRGAnalyticsEventQueueOverflowPolicy) {
+    /**
+     *  Discard the oldest event waiting in the queue to make room for the new one.
+     */
+    SRGAnalyticsEventQueueOverflowPolicyDropOldest = 0,
+    /**
+     *  Discard the new event.
+     */
+    SRGAnalyticsEventQueueOverflowPolicyDropNewest,
+    /**
+     *  Block the recording thread until room is available in the queue.
+     */
+    SRGAnalyticsEventQueueOverflowPolicyBlock
+};
+
 /**
  *  Analytics configuration.
  */
@@ -56,6 +76,116 @@ OBJC_EXPORT SRGAnalyticsBusinessUnitIdentifier const SRGAnalyticsBusinessUnitIde
  */
 @property (nonatomic, getter=isUnitTesting) BOOL unitTesting;
 
+/**
+ *  When `unitTesting` is enabled, set to `NO` to skip the interception of requests made by the analytics SDKs, in which
+ *  case no notifications are emitted. Interception requires each request to be decoded again, which is costly when many
+ *  events are sent. If only the labels sent by the tracker need to be checked, use an event tap instead (@see
+ *  `SRGAnalyticsEventTap`).
+ *
+ *  Default value is `YES`.
+ */
+@property (nonatomic, getter=isRequestInterceptionEnabled) BOOL requestInterceptionEnabled;
+
+/**
+ *  Events are recorded into a bounded queue and processed in order on a background thread. This property sets the
+ *  maximum number of events which can wait in the queue (rounded up to the next power of two).
+ *
+ *  Default value is 1024.
+ */
+@property (nonatomic) NSUInteger eventQueueCapacity;
+
+/**
+ *  The policy to apply when an event is recorded while the event queue is full.
+ *
+ *  Default value is `SRGAnalyticsEventQueueOverflowPolicyDropOldest`.
+ */
+@property (nonatomic) SRGAnalyticsEventQueueOverflowPolicy eventQueueOverflowPolicy;
+
+/**
+ *  When set to a positive value, events are held back during this time window (starting with the first event) and
+ *  delivered together once it elapses. The window is automatically extended when Low Power Mode is enabled or when
+ *  the network is expensive (e.g. cellular). Pending events are delivered early when the application is sent to the
+ *  background or when media playback ends.
+ *
+ *  @discussion Commanders Act still receives one request per event, so that its requests are only grouped in time.
+ *              Other event destinations receive events held back as a single batch.
+ *
+ *  Default value is 0 (events are delivered as soon as possible).
+ */
+@property (nonatomic) NSTimeInterval eventDeliveryDelay;
+
+/**
+ *  The maximum number of events held back before they are delivered, when delivery is delayed (@see `eventDeliveryDelay`).
+ *
+ *  Default value is 20.
+ */
+@property (nonatomic) NSUInteger eventDeliveryMaximumPendingCount;
+
+/**
+ *  Automatic page views (@see `UIViewController+SRGAnalytics.h`) identical to a page view automatically sent within
+ *  this time interval for the same window are not sent again. Page views are identical if they have the same title,
+ *  type, levels and labels. This avoids bursts of page views when quickly switching between tabs or returning to the
+ *  application repeatedly. Page views sent manually are never discarded.
+ *
+ *  Default value is 0 (no coalescing).
+ */
+@property (nonatomic) NSTimeInterval pageViewDebounceInterval;
+
+/**
+ *  When enabled, the tracker only performs minimal work when started, so that application launch is not delayed.
+ *  Events recorded in the meantime are kept in memory and sent in order once the analytics SDKs are ready. The
+ *  Commanders Act SDK is started on a background queue, comScore when the application becomes active or when
+ *  it is first needed, whichever comes first.
+ *
+ *  Default value is `NO`.
+ */
+@property (nonatomic, getter=isStartupDeferred) BOOL startupDeferred;
+
+/**
+ *  When enabled, media heartbeats (`pos` and `uptime` events) only contain labels which changed since the previous
+ *  event of the same playback, as well as session and sequence labels from which full events can be reconstructed.
+ *  Other media events, sent at the beginning and end of playback or when the state changes, always contain all
+ *  labels. Only enable if events are collected by a service able to expand delta-encoded events.
+ *
+ *  Default value is `NO`.
+ */
+@property (nonatomic, getter=isMediaHeartbeatDeltaEncodingEnabled) BOOL mediaHeartbeatDeltaEncodingEnabled;
+
+/**
+ *  Sampling policies applied to events, by event name (@see `SRGAnalyticsSamplingPolicy`). Policies apply to events
+ *  tracked with `-[SRGAnalyticsTracker trackEventWithName:labels:]` as well as to media events (e.g. `pos` and `uptime`
+ *  for heartbeats). Page views are never sampled.
+ *
+ *  Default value is an empty dictionary.
+ */
+@property (nonatomic, copy) NSDictionary<NSString *, SRGAnalyticsSamplingPolicy *> *eventSamplingPolicies;
+
+/**
+ *  The identifier which sampling decisions are based on, e.g. a user or session identifier. Events of a given name are
+ *  either always or never sent for a given identifier.
+ *
+ *  Default value is `nil`, in which case an identifier is randomly generated once per application installation and
+ *  persisted in the standard user defaults, so that sampling decisions do not change between application launches.
+ */
+@property (nonatomic, copy, nullable) NSString *samplingIdentifier;
+
+/**
+ *  When enabled, the tracker collects metrics about its own work (latencies of its processing stages, number of events
+ *  and bytes produced, etc.), which can be retrieved with `-[SRGAnalyticsTracker metricsSnapshotWithReset:]`. Metrics
+ *  collection has almost no cost when disabled.
+ *
+ *  Default value is `NO`.
+ */
+@property (nonatomic, getter=isMetricsEnabled) BOOL metricsEnabled;
+
+/**
+ *  The directory where events are journaled until they have been sent. Applications should not need to change it,
+ *  except to isolate the journal when several trackers run in the same sandbox (e.g. in tests).
+ *
+ *  Default value is `nil`, in which case a directory in the application support folder (caches folder on tvOS) is used.
+ */
+@property (nonatomic, copy, nullable) NSURL *journalDirectoryURL;
+
 /**
  *  The SRG SSR business unit which measurements are associated with.
  */
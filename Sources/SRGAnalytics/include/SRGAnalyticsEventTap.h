@@ -0,0 +1,62 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Handler called for each event matching a tap.
+ *
+ *  @param name     The page view title or event name.
+ *  @param pageType The page view type, `nil` for events which are not page views.
+ *  @param labels   The labels sent to Commanders Act, without the properties added by the Commanders Act SDK itself.
+ */
+typedef void (^SRGAnalyticsEventTapHandler)(NSString *name, NSString * _Nullable pageType, NSDictionary<NSString *, NSString *> *labels);
+
+/**
+ *  An event tap exposes the Commanders Act labels of events as they are dispatched by the tracker, without the cost of
+ *  intercepting and decoding requests made by the Commanders Act SDK (@see `SRGAnalyticsNotifications.h`). This is
+ *  mostly useful for tests and QA builds which only need to check which labels are sent.
+ *
+ *  Attach taps with `-[SRGAnalyticsTracker addEventTap:]`. Taps can be used whether `unitTesting` is enabled or not.
+ */
+@interface SRGAnalyticsEventTap : NSObject
+
+/**
+ *  Create a tap calling the specified handler for events matching the specified filters.
+ *
+ *  @param eventNames            If not `nil`, only events whose name belongs to the set are received.
+ *  @param unitTestingIdentifier If not `nil`, only events whose `srg_test_id` label matches are received, @see
+ *                               `SRGAnalyticsUnitTestingIdentifier()`.
+ *  @param queue                 The queue on which the handler is called asynchronously. If `nil`, the handler is
+ *                               called synchronously on the tracker worker thread, and must therefore return quickly.
+ */
+- (instancetype)initWithEventNames:(nullable NSSet<NSString *> *)eventNames
+             unitTestingIdentifier:(nullable NSString *)unitTestingIdentifier
+                             queue:(nullable dispatch_queue_t)queue
+                           handler:(SRGAnalyticsEventTapHandler)handler NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Same as `-initWithEventNames:unitTestingIdentifier:queue:handler:`, without filters.
+ */
+- (instancetype)initWithQueue:(nullable dispatch_queue_t)queue handler:(SRGAnalyticsEventTapHandler)handler;
+
+/**
+ *  Filters.
+ */
+@property (nonatomic, readonly, copy, nullable) NSSet<NSString *> *eventNames;
+@property (nonatomic, readonly, copy, nullable) NSString *unitTestingIdentifier;
+
+@end
+
+@interface SRGAnalyticsEventTap (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
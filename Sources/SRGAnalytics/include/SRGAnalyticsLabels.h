@@ -21,14 +21,14 @@ NS_ASSUME_NONNULL_BEGIN
  *
  *  Custom information can be used to override official labels. You should use this ability sparingly, though.
  */
-@property (nonatomic, nullable) NSDictionary<NSString *, NSString *> *customInfo;
+@property (nonatomic, copy, nullable) NSDictionary<NSString *, NSString *> *customInfo;
 
 /**
  *  Additional custom information to be sent to comScore.
  *
  *  Custom information can be used to override official labels. You should use this ability sparingly, though.
  */
-@property (nonatomic, nullable) NSDictionary<NSString *, NSString *> *comScoreCustomInfo;
+@property (nonatomic, copy, nullable) NSDictionary<NSString *, NSString *> *comScoreCustomInfo;
 
 @end
 
@@ -0,0 +1,120 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  @name Tracker pipeline stages
+ */
+typedef NSString * SRGAnalyticsMetricsStage NS_TYPED_ENUM;
+
+/**
+ *  Building the labels of an event, merge with default labels included.
+ */
+OBJC_EXPORT SRGAnalyticsMetricsStage const SRGAnalyticsMetricsStageLabelBuild;
+
+/**
+ *  Merging the labels of an event with default labels.
+ */
+OBJC_EXPORT SRGAnalyticsMetricsStage const SRGAnalyticsMetricsStageLabelMerge;
+
+/**
+ *  Serializing an event for persistence in the event journal. Measured once per event, serialization performed by
+ *  event sinks for delivery is not included.
+ */
+OBJC_EXPORT SRGAnalyticsMetricsStage const SRGAnalyticsMetricsStageSerialization;
+
+/**
+ *  Handing a batch of events over to the analytics SDKs and other event sinks.
+ */
+OBJC_EXPORT SRGAnalyticsMetricsStage const SRGAnalyticsMetricsStageDispatch;
+
+/**
+ *  Name under which events are counted once the maximum number of distinct event names has been reached (@see
+ *  `-[SRGAnalyticsMetricsSnapshot eventCounts]`).
+ */
+OBJC_EXPORT NSString * const SRGAnalyticsMetricsOtherEventsName;
+
+/**
+ *  Distribution of recorded values. Values are approximated with a relative error below 12.5%, except for the
+ *  maximum and mean values, which are exact.
+ */
+@interface SRGAnalyticsMetricsDistribution : NSObject
+
+/**
+ *  The number of recorded values.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ *  The mean and maximum recorded values, 0 if no value has been recorded.
+ */
+@property (nonatomic, readonly) double mean;
+@property (nonatomic, readonly) double maximum;
+
+/**
+ *  Return the value below which the specified percentage (between 0 and 100) of recorded values fall, 0 if no value
+ *  has been recorded.
+ */
+- (double)valueAtPercentile:(double)percentile;
+
+@end
+
+@interface SRGAnalyticsMetricsDistribution (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/**
+ *  Metrics collected by the tracker during some period of time (@see `-[SRGAnalyticsTracker metricsSnapshotWithReset:]`).
+ */
+@interface SRGAnalyticsMetricsSnapshot : NSObject
+
+/**
+ *  The duration of the period during which metrics were collected.
+ */
+@property (nonatomic, readonly) NSTimeInterval duration;
+
+/**
+ *  Latencies of the tracker pipeline stages, in seconds. Stages without recorded values are omitted.
+ */
+@property (nonatomic, readonly) NSDictionary<SRGAnalyticsMetricsStage, SRGAnalyticsMetricsDistribution *> *stageLatencies;
+
+/**
+ *  The number of events processed, by name (page title for page views). At most 64 distinct names are counted,
+ *  events with other names being counted under `SRGAnalyticsMetricsOtherEventsName`.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *eventCounts;
+
+/**
+ *  The number of bytes produced by serialization (@see `SRGAnalyticsMetricsStageSerialization`).
+ */
+@property (nonatomic, readonly) unsigned long long producedByteCount;
+
+/**
+ *  The highest number of events waiting in the tracker queue at once.
+ */
+@property (nonatomic, readonly) NSUInteger eventQueueHighWaterMark;
+
+/**
+ *  The number of times the timer driving media heartbeats woke up, and the number of heartbeats received by each media
+ *  player tracker, recorded when tracking ends (requires the SRGAnalyticsMediaPlayer framework).
+ */
+@property (nonatomic, readonly) NSUInteger heartbeatTimerWakeUpCount;
+@property (nonatomic, readonly) SRGAnalyticsMetricsDistribution *mediaPlayerTrackerHeartbeats;
+
+@end
+
+@interface SRGAnalyticsMetricsSnapshot (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
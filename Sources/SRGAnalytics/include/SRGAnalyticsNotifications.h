@@ -13,7 +13,8 @@ NS_ASSUME_NONNULL_BEGIN
  *  and which information will be sent to these services, for unit testing purposes.
  *
  *  These notifications are only emitted when enabling the `unitTesting` tracker configuration flag, @see
- *  `SRGAnalyticsConfiguration`.
+ *  `SRGAnalyticsConfiguration`. Requests are intercepted and decoded again to extract their labels. If you only need
+ *  the labels sent by the tracker, prefer an event tap (@see `SRGAnalyticsEventTap`), which avoids this overhead.
  *
  *  Notifications may be received on background threads.
  */
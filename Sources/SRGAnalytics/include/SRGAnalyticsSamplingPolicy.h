@@ -0,0 +1,60 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  A sampling policy reduces the number of events sent with a given name (@see `SRGAnalyticsConfiguration`
+ *  `eventSamplingPolicies`).
+ *
+ *  Events are first sampled deterministically: the decision only depends on the sampling identifier and on the event
+ *  name, so that a given user or session is either always or never part of the sample for this name. Events part of
+ *  the sample can then be rate-limited, in which case events are discarded when more than `maximumEventCount` events
+ *  are sent within `interval`.
+ *
+ *  Events sent with a policy contain a `sampling_weight` label, the number of events they stand for (accounting for
+ *  both sampling and rate limiting), so that totals can be scaled back when analyzing data.
+ */
+@interface SRGAnalyticsSamplingPolicy : NSObject <NSCopying>
+
+/**
+ *  Create a policy.
+ *
+ *  @param samplingRate      The fraction of users or sessions for which events are sent, between 0 and 1.
+ *  @param maximumEventCount The maximum number of events sent within the interval (bursts included), or 0 for no limit.
+ *  @param interval          The interval over which events are limited, in seconds.
+ */
+- (instancetype)initWithSamplingRate:(double)samplingRate
+                   maximumEventCount:(NSUInteger)maximumEventCount
+                            interval:(NSTimeInterval)interval NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Same as `-initWithSamplingRate:maximumEventCount:interval:`, without rate limiting.
+ */
+- (instancetype)initWithSamplingRate:(double)samplingRate;
+
+/**
+ *  The sampling rate, between 0 and 1.
+ */
+@property (nonatomic, readonly) double samplingRate;
+
+/**
+ *  The maximum number of events sent within `interval`, 0 if events are not rate-limited.
+ */
+@property (nonatomic, readonly) NSUInteger maximumEventCount;
+@property (nonatomic, readonly) NSTimeInterval interval;
+
+@end
+
+@interface SRGAnalyticsSamplingPolicy (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
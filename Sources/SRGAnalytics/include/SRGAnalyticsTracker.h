@@ -6,6 +6,8 @@
 
 #import "SRGAnalyticsConfiguration.h"
 #import "SRGAnalyticsEventLabels.h"
+#import "SRGAnalyticsEventTap.h"
+#import "SRGAnalyticsMetrics.h"
 #import "SRGAnalyticsPageViewLabels.h"
 #import "SRGAnalyticsTrackerDataSource.h"
 
@@ -86,6 +88,8 @@ NS_EXTENSION_UNAVAILABLE("SRG Analytics does not support application extensions"
  *
  *  @param configuration The configuration to use. This configuration is copied and cannot be changed afterwards.
  *  @param dataSource    The data source for the global labels.
+ *
+ *  @discussion Global labels are requested from the data source each time an event is recorded.
  */
 - (void)startWithConfiguration:(SRGAnalyticsConfiguration *)configuration
                     dataSource:(nullable id<SRGAnalyticsTrackerDataSource>)dataSource;
@@ -203,6 +207,44 @@ NS_EXTENSION_UNAVAILABLE("SRG Analytics does not support application extensions"
 
 @end
 
+/**
+ *  Event taps, @see `SRGAnalyticsEventTap`.
+ *
+ *  Taps can be attached and detached from any thread, including from a tap handler. When called from the tracker worker
+ *  thread (i.e. from the handler of a tap created without queue) the change is applied immediately, otherwise the
+ *  calling thread waits until the tracker worker thread has applied it.
+ */
+@interface SRGAnalyticsTracker (EventTaps)
+
+/**
+ *  Attach a tap, receiving all events dispatched after the method returns. Does nothing if the tracker has not been
+ *  started yet or if the tap is already attached.
+ */
+- (void)addEventTap:(SRGAnalyticsEventTap *)eventTap;
+
+/**
+ *  Detach a tap. Events already dispatched to an asynchronous tap might still be received afterwards. A tap detaching
+ *  itself from its handler receives no other event once the handler returns.
+ */
+- (void)removeEventTap:(SRGAnalyticsEventTap *)eventTap;
+
+@end
+
+/**
+ *  Metrics, @see `SRGAnalyticsConfiguration` `metricsEnabled`.
+ */
+@interface SRGAnalyticsTracker (Metrics)
+
+/**
+ *  Return the metrics collected since the tracker was started or since metrics were last reset, `nil` if metrics
+ *  are disabled.
+ *
+ *  @param reset Set to `YES` to reset metrics once the snapshot has been taken.
+ */
+- (nullable SRGAnalyticsMetricsSnapshot *)metricsSnapshotWithReset:(BOOL)reset;
+
+@end
+
 @interface SRGAnalyticsTracker (Unavailable)
 
 - (instancetype)init NS_UNAVAILABLE;
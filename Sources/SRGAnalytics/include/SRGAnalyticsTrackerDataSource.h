@@ -8,8 +8,14 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ *  Data source supplying labels sent with all events (@see `-[SRGAnalyticsTracker startWithConfiguration:dataSource:]`).
+ */
 @protocol SRGAnalyticsTrackerDataSource <NSObject>
 
+/**
+ *  The labels sent with all events. Requested each time an event is recorded, possibly from a background thread.
+ */
 @property (nonatomic, readonly, copy) SRGAnalyticsLabels *srg_globalLabels;
 
 @end
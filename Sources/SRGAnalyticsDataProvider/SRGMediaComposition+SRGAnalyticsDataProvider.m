@@ -6,47 +6,55 @@
 
 #import "SRGMediaComposition+SRGAnalyticsDataProvider.h"
 
+#import "SRGMediaComposition+SRGAnalyticsDataProvider_Private.h"
 #import "SRGResource+SRGAnalyticsDataProvider.h"
 #import "SRGSegment+SRGAnalyticsDataProvider.h"
+#import "SRGSegmentTimeline.h"
 
-@import libextobjc;
+#import <objc/runtime.h>
+#import <os/lock.h>
+
+// Associated object keys
+static void *s_preferredResources = &s_preferredResources;
+static void *s_analyticsLabels = &s_analyticsLabels;
+
+// Functions
+static BOOL SRGMediaCompositionChapterContainsResource(SRGChapter *chapter, SRGResource *resource);
+static BOOL SRGMediaCompositionHasSameAnalyticsLabelSources(SRGMediaComposition *mediaComposition1, SRGResource *resource1, SRGMediaComposition *mediaComposition2, SRGResource *resource2);
+static SRGAnalyticsStreamLabels *SRGMediaCompositionResolvedAnalyticsLabels(SRGMediaComposition *mediaComposition, SRGResource *resource, NSString *sourceUid);
+static SRGAnalyticsStreamLabels *SRGMediaCompositionCachedAnalyticsLabels(SRGMediaComposition *mediaComposition, SRGResource *resource, NSString *sourceUid);
+static void SRGMediaCompositionCacheAnalyticsLabels(SRGMediaComposition *mediaComposition, SRGResource *resource, NSString *sourceUid, SRGAnalyticsStreamLabels *labels);
+static SRGResource *SRGMediaCompositionPreferredResource(SRGChapter *chapter, SRGStreamingMethod streamingMethod, SRGStreamType streamType, SRGQuality quality);
 
 @implementation SRGMediaComposition (SRGAnalyticsDataProvider)
 
 - (SRGAnalyticsStreamLabels *)analyticsLabelsForResource:(SRGResource *)resource sourceUid:(NSString *)sourceUid
 {
-    NSAssert([self.mainChapter.resources containsObject:resource], @"The specified resource must be associated with the current context");
-    
-    SRGAnalyticsStreamLabels *labels = [[SRGAnalyticsStreamLabels alloc] init];
+    return [self analyticsLabelsForResource:resource sourceUid:sourceUid previousMediaComposition:nil previousResource:nil];
+}
+
+- (SRGAnalyticsStreamLabels *)analyticsLabelsForResource:(SRGResource *)resource
+                                               sourceUid:(NSString *)sourceUid
+                                previousMediaComposition:(SRGMediaComposition *)previousMediaComposition
+                                        previousResource:(SRGResource *)previousResource
+{
+    NSAssert(SRGMediaCompositionChapterContainsResource(self.mainChapter, resource), @"The specified resource must be associated with the current context");
     
-    NSDictionary<NSString *, NSString *> *mainChapterLabels = self.mainChapter.analyticsLabels;
-    if (mainChapterLabels.count != 0) {
-        NSMutableDictionary<NSString *, NSString *> *customInfo = [NSMutableDictionary dictionary];
-        if (self.analyticsLabels) {
-            [customInfo addEntriesFromDictionary:self.analyticsLabels];
-        }
-        [customInfo addEntriesFromDictionary:mainChapterLabels];
-        if (resource.analyticsLabels) {
-            [customInfo addEntriesFromDictionary:resource.analyticsLabels];
+    SRGAnalyticsStreamLabels *labels = SRGMediaCompositionCachedAnalyticsLabels(self, resource, sourceUid);
+    if (! labels && previousMediaComposition && previousResource
+            && SRGMediaCompositionHasSameAnalyticsLabelSources(self, resource, previousMediaComposition, previousResource)) {
+        labels = SRGMediaCompositionCachedAnalyticsLabels(previousMediaComposition, previousResource, sourceUid);
+        if (labels) {
+            SRGMediaCompositionCacheAnalyticsLabels(self, resource, sourceUid, labels);
         }
-        customInfo[@"source_id"] = sourceUid;
-        labels.customInfo = customInfo.copy;
     }
-    
-    NSDictionary<NSString *, NSString *> *mainChapterComScoreLabels = self.mainChapter.comScoreAnalyticsLabels;
-    if (mainChapterComScoreLabels.count != 0) {
-        NSMutableDictionary<NSString *, NSString *> *comScoreCustomInfo = [NSMutableDictionary dictionary];
-        if (self.comScoreAnalyticsLabels) {
-            [comScoreCustomInfo addEntriesFromDictionary:self.comScoreAnalyticsLabels];
-        }
-        [comScoreCustomInfo addEntriesFromDictionary:mainChapterComScoreLabels];
-        if (resource.comScoreAnalyticsLabels) {
-            [comScoreCustomInfo addEntriesFromDictionary:resource.comScoreAnalyticsLabels];
-        }
-        labels.comScoreCustomInfo = comScoreCustomInfo.copy;
+    if (! labels) {
+        labels = SRGMediaCompositionResolvedAnalyticsLabels(self, resource, sourceUid);
+        SRGMediaCompositionCacheAnalyticsLabels(self, resource, sourceUid, labels);
     }
     
-    return labels;
+    // Labels are mutable, callers must not be able to alter the cached instance
+    return labels.copy;
 }
 
 - (BOOL)playbackContextWithPreferredSettings:(SRGPlaybackSettings *)preferredSettings
@@ -63,89 +71,208 @@
         streamingMethod = chapter.recommendedStreamingMethod;
     }
     
-    NSArray<SRGResource *> *resources = [chapter resourcesForStreamingMethod:streamingMethod];
-    if (resources.count == 0) {
-        resources = [chapter resourcesForStreamingMethod:chapter.recommendedStreamingMethod];
+    SRGResource *resource = SRGMediaCompositionPreferredResource(chapter, streamingMethod, preferredSettings.streamType, preferredSettings.quality);
+    if (! resource) {
+        return NO;
     }
     
-    NSSortDescriptor *URLSchemeSortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@keypath(SRGResource.new, URL) ascending:NO comparator:^NSComparisonResult(NSURL * _Nonnull URL1, NSURL * _Nonnull URL2) {
-        // Only declare ordering for important URL schemes. For other schemes the initial order will be preserved
-        NSArray<NSString *> *orderedURLSchemes = @[@"http", @"https"];
-        
-        NSUInteger index1 = [orderedURLSchemes indexOfObject:URL1.scheme];
-        NSUInteger index2 = [orderedURLSchemes indexOfObject:URL2.scheme];
-        if (index1 == index2) {
-            return NSOrderedSame;
-        }
-        // Unknown scheme < known scheme
-        else if (index1 == NSNotFound) {
-            return NSOrderedAscending;
-        }
-        // Known scheme > unknown scheme
-        else if (index2 == NSNotFound) {
-            return NSOrderedDescending;
-        }
-        else if (index1 < index2) {
-            return NSOrderedAscending;
-        }
-        else {
-            return NSOrderedDescending;
-        }
-    }];
+    SRGAnalyticsStreamLabels *labels = [self analyticsLabelsForResource:resource sourceUid:preferredSettings.sourceUid];
+    NSInteger index = [chapter.segments indexOfObject:self.mainSegment];
     
-    // Determine the stream type order to use (start with a default setup, overridden if a preferred value has been set).
-    NSArray<NSNumber *> *orderedStreamTypes = @[@(SRGStreamTypeOnDemand), @(SRGStreamTypeLive), @(SRGStreamTypeDVR)];
-    SRGStreamType streamType = preferredSettings.streamType;
-    if (streamType != SRGStreamTypeNone) {
-        orderedStreamTypes = [[orderedStreamTypes mtl_arrayByRemovingObject:@(streamType)] arrayByAddingObject:@(streamType)];
+    // Segments are queried repeatedly during playback, build their timeline upfront
+    [SRGSegmentTimeline timelineForChapter:chapter];
+    
+    contextBlock(resource.URL, resource, chapter.segments, index, labels);
+    return YES;
+}
+
+@end
+
+#pragma mark Functions
+
+// Return the rank of a value in an ordered list (higher is better), with an optional preferred value ranked first. Values
+// not in the list rank above all others, as they did when resources were sorted by list index.
+static uint32_t SRGMediaCompositionRank(NSInteger value, const NSInteger *orderedValues, size_t count, NSInteger preferredValue, NSInteger noneValue)
+{
+    if (value == preferredValue && preferredValue != noneValue) {
+        return (uint32_t)count;
     }
     
-    NSSortDescriptor *streamTypeSortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@keypath(SRGResource.new, streamType) ascending:NO comparator:^(NSNumber * _Nonnull streamType1, NSNumber * _Nonnull streamType2) {
-        // Don't simply compare enum values as integers since their order might change.
-        NSUInteger index1 = [orderedStreamTypes indexOfObject:streamType1];
-        NSUInteger index2 = [orderedStreamTypes indexOfObject:streamType2];
-        if (index1 == index2) {
-            return NSOrderedSame;
+    uint32_t rank = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (orderedValues[i] == preferredValue) {
+            continue;
         }
-        else if (index1 < index2) {
-            return NSOrderedAscending;
+        if (orderedValues[i] == value) {
+            return rank;
         }
-        else {
-            return NSOrderedDescending;
+        ++rank;
+    }
+    return (uint32_t)count + 1;
+}
+
+// Unknown scheme < http < https
+static uint32_t SRGMediaCompositionURLSchemeRank(NSURL *URL)
+{
+    NSString *scheme = URL.scheme;
+    if ([scheme isEqualToString:@"https"]) {
+        return 2;
+    }
+    else if ([scheme isEqualToString:@"http"]) {
+        return 1;
+    }
+    else {
+        return 0;
+    }
+}
+
+// Pack ranks into a single key, most significant criterium first. Each rank fits in 4 bits.
+static uint32_t SRGMediaCompositionResourceKey(SRGResource *resource, SRGStreamType streamType, SRGQuality quality)
+{
+    static const NSInteger s_orderedStreamTypes[] = { SRGStreamTypeOnDemand, SRGStreamTypeLive, SRGStreamTypeDVR };
+    static const NSInteger s_orderedQualities[] = { SRGQualitySD, SRGQualityHD, SRGQualityHQ };
+    
+    uint32_t URLSchemeRank = SRGMediaCompositionURLSchemeRank(resource.URL);
+    uint32_t streamTypeRank = SRGMediaCompositionRank(resource.streamType, s_orderedStreamTypes, sizeof(s_orderedStreamTypes) / sizeof(s_orderedStreamTypes[0]), streamType, SRGStreamTypeNone);
+    uint32_t qualityRank = SRGMediaCompositionRank(resource.quality, s_orderedQualities, sizeof(s_orderedQualities) / sizeof(s_orderedQualities[0]), quality, SRGQualityNone);
+    return (URLSchemeRank << 8) | (streamTypeRank << 4) | qualityRank;
+}
+
+// Select the resource with the best key in a single pass. On ties the first resource wins, as with a stable sort.
+static SRGResource *SRGMediaCompositionBestResource(NSArray<SRGResource *> *resources, SRGStreamType streamType, SRGQuality quality)
+{
+    SRGResource *bestResource = nil;
+    uint32_t bestKey = 0;
+    for (SRGResource *resource in resources) {
+        uint32_t key = SRGMediaCompositionResourceKey(resource, streamType, quality);
+        if (! bestResource || key > bestKey) {
+            bestResource = resource;
+            bestKey = key;
         }
-    }];
+    }
+    return bestResource;
+}
+
+// Chapters are immutable, selected resources are therefore cached per chapter and settings
+static SRGResource *SRGMediaCompositionPreferredResource(SRGChapter *chapter, SRGStreamingMethod streamingMethod, SRGStreamType streamType, SRGQuality quality)
+{
+    static os_unfair_lock s_lock = OS_UNFAIR_LOCK_INIT;
+    
+    NSNumber *cacheKey = @(((NSUInteger)streamingMethod << 16) | ((NSUInteger)streamType << 8) | (NSUInteger)quality);
     
-    // Determine the quality to use (start with a default setup, overridden if a preferred value has been set).
-    NSArray<NSNumber *> *orderedQualities = @[@(SRGQualitySD), @(SRGQualityHD), @(SRGQualityHQ)];
-    SRGQuality quality = preferredSettings.quality;
-    if (quality != SRGQualityNone) {
-        orderedQualities = [[orderedQualities mtl_arrayByRemovingObject:@(quality)] arrayByAddingObject:@(quality)];
+    os_unfair_lock_lock(&s_lock);
+    NSMutableDictionary<NSNumber *, id> *preferredResources = objc_getAssociatedObject(chapter, s_preferredResources);
+    id cachedResource = preferredResources[cacheKey];
+    os_unfair_lock_unlock(&s_lock);
+    
+    if (cachedResource) {
+        return (cachedResource != NSNull.null) ? cachedResource : nil;
     }
     
-    NSSortDescriptor *qualitySortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@keypath(SRGResource.new, quality) ascending:NO comparator:^(NSNumber * _Nonnull quality1, NSNumber * _Nonnull quality2) {
-        // Don't simply compare enum values as integers since their order might change.
-        NSUInteger index1 = [orderedQualities indexOfObject:quality1];
-        NSUInteger index2 = [orderedQualities indexOfObject:quality2];
-        if (index1 == index2) {
-            return NSOrderedSame;
-        }
-        else if (index1 < index2) {
-            return NSOrderedAscending;
+    NSArray<SRGResource *> *resources = [chapter resourcesForStreamingMethod:streamingMethod];
+    if (resources.count == 0) {
+        resources = [chapter resourcesForStreamingMethod:chapter.recommendedStreamingMethod];
+    }
+    SRGResource *resource = SRGMediaCompositionBestResource(resources, streamType, quality);
+    
+    os_unfair_lock_lock(&s_lock);
+    preferredResources = objc_getAssociatedObject(chapter, s_preferredResources);
+    if (! preferredResources) {
+        preferredResources = [NSMutableDictionary dictionary];
+        objc_setAssociatedObject(chapter, s_preferredResources, preferredResources, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    preferredResources[cacheKey] = resource ?: NSNull.null;
+    os_unfair_lock_unlock(&s_lock);
+    
+    return resource;
+}
+
+#pragma mark Analytics label functions
+
+// Resources are usually looked up from the chapter itself, in which case an identity check suffices
+static BOOL SRGMediaCompositionChapterContainsResource(SRGChapter *chapter, SRGResource *resource)
+{
+    NSArray<SRGResource *> *resources = chapter.resources;
+    return [resources indexOfObjectIdenticalTo:resource] != NSNotFound || [resources containsObject:resource];
+}
+
+static BOOL SRGMediaCompositionLabelsEqual(NSDictionary<NSString *, NSString *> *labels1, NSDictionary<NSString *, NSString *> *labels2)
+{
+    return labels1 == labels2 || [labels1 isEqualToDictionary:labels2];
+}
+
+// Refreshed compositions are new objects, but their labels rarely change
+static BOOL SRGMediaCompositionHasSameAnalyticsLabelSources(SRGMediaComposition *mediaComposition1, SRGResource *resource1, SRGMediaComposition *mediaComposition2, SRGResource *resource2)
+{
+    return SRGMediaCompositionLabelsEqual(mediaComposition1.analyticsLabels, mediaComposition2.analyticsLabels)
+        && SRGMediaCompositionLabelsEqual(mediaComposition1.mainChapter.analyticsLabels, mediaComposition2.mainChapter.analyticsLabels)
+        && SRGMediaCompositionLabelsEqual(resource1.analyticsLabels, resource2.analyticsLabels)
+        && SRGMediaCompositionLabelsEqual(mediaComposition1.comScoreAnalyticsLabels, mediaComposition2.comScoreAnalyticsLabels)
+        && SRGMediaCompositionLabelsEqual(mediaComposition1.mainChapter.comScoreAnalyticsLabels, mediaComposition2.mainChapter.comScoreAnalyticsLabels)
+        && SRGMediaCompositionLabelsEqual(resource1.comScoreAnalyticsLabels, resource2.comScoreAnalyticsLabels);
+}
+
+static SRGAnalyticsStreamLabels *SRGMediaCompositionResolvedAnalyticsLabels(SRGMediaComposition *mediaComposition, SRGResource *resource, NSString *sourceUid)
+{
+    SRGAnalyticsStreamLabels *labels = [[SRGAnalyticsStreamLabels alloc] init];
+    
+    NSDictionary<NSString *, NSString *> *mainChapterLabels = mediaComposition.mainChapter.analyticsLabels;
+    if (mainChapterLabels.count != 0) {
+        NSMutableDictionary<NSString *, NSString *> *customInfo = [NSMutableDictionary dictionary];
+        if (mediaComposition.analyticsLabels) {
+            [customInfo addEntriesFromDictionary:mediaComposition.analyticsLabels];
         }
-        else {
-            return NSOrderedDescending;
+        [customInfo addEntriesFromDictionary:mainChapterLabels];
+        if (resource.analyticsLabels) {
+            [customInfo addEntriesFromDictionary:resource.analyticsLabels];
         }
-    }];
+        customInfo[@"source_id"] = sourceUid;
+        labels.customInfo = customInfo.copy;
+    }
     
-    SRGResource *resource = [resources sortedArrayUsingDescriptors:@[URLSchemeSortDescriptor, streamTypeSortDescriptor, qualitySortDescriptor]].firstObject;
-    if (! resource) {
-        return NO;
+    NSDictionary<NSString *, NSString *> *mainChapterComScoreLabels = mediaComposition.mainChapter.comScoreAnalyticsLabels;
+    if (mainChapterComScoreLabels.count != 0) {
+        NSMutableDictionary<NSString *, NSString *> *comScoreCustomInfo = [NSMutableDictionary dictionary];
+        if (mediaComposition.comScoreAnalyticsLabels) {
+            [comScoreCustomInfo addEntriesFromDictionary:mediaComposition.comScoreAnalyticsLabels];
+        }
+        [comScoreCustomInfo addEntriesFromDictionary:mainChapterComScoreLabels];
+        if (resource.comScoreAnalyticsLabels) {
+            [comScoreCustomInfo addEntriesFromDictionary:resource.comScoreAnalyticsLabels];
+        }
+        labels.comScoreCustomInfo = comScoreCustomInfo.copy;
     }
     
-    SRGAnalyticsStreamLabels *labels = [self analyticsLabelsForResource:resource sourceUid:preferredSettings.sourceUid];
-    NSInteger index = [chapter.segments indexOfObject:self.mainSegment];
-    contextBlock(resource.URL, resource, chapter.segments, index, labels);
-    return YES;
+    return labels;
 }
 
-@end
+// Compositions are immutable, resolved labels are therefore cached per composition, resource (by identity, avoiding
+// costly model equality checks) and source unique id
+static os_unfair_lock s_analyticsLabelsLock = OS_UNFAIR_LOCK_INIT;
+
+static SRGAnalyticsStreamLabels *SRGMediaCompositionCachedAnalyticsLabels(SRGMediaComposition *mediaComposition, SRGResource *resource, NSString *sourceUid)
+{
+    os_unfair_lock_lock(&s_analyticsLabelsLock);
+    NSMapTable<SRGResource *, NSMutableDictionary *> *analyticsLabels = objc_getAssociatedObject(mediaComposition, s_analyticsLabels);
+    SRGAnalyticsStreamLabels *labels = [analyticsLabels objectForKey:resource][sourceUid ?: NSNull.null];
+    os_unfair_lock_unlock(&s_analyticsLabelsLock);
+    return labels;
+}
+
+static void SRGMediaCompositionCacheAnalyticsLabels(SRGMediaComposition *mediaComposition, SRGResource *resource, NSString *sourceUid, SRGAnalyticsStreamLabels *labels)
+{
+    os_unfair_lock_lock(&s_analyticsLabelsLock);
+    NSMapTable<SRGResource *, NSMutableDictionary *> *analyticsLabels = objc_getAssociatedObject(mediaComposition, s_analyticsLabels);
+    if (! analyticsLabels) {
+        analyticsLabels = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                valueOptions:NSPointerFunctionsStrongMemory];
+        objc_setAssociatedObject(mediaComposition, s_analyticsLabels, analyticsLabels, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    NSMutableDictionary *resourceLabels = [analyticsLabels objectForKey:resource];
+    if (! resourceLabels) {
+        resourceLabels = [NSMutableDictionary dictionary];
+        [analyticsLabels setObject:resourceLabels forKey:resource];
+    }
+    resourceLabels[sourceUid ?: NSNull.null] = labels;
+    os_unfair_lock_unlock(&s_analyticsLabelsLock);
+}
@@ -14,10 +14,20 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  *  Return the consolidated analytics stream labels associated with the specified resource of the receiver.
  *
- *  @discussion An exception is thrown in debug builds if the resource is not associated with the receiver.
+ *  @discussion An exception is thrown in debug builds if the resource is not associated with the receiver. Labels are
+ *              resolved once per resource and source unique id, then cached with the receiver.
  */
 - (SRGAnalyticsStreamLabels *)analyticsLabelsForResource:(SRGResource *)resource sourceUid:(nullable NSString *)sourceUid;
 
+/**
+ *  Same as `-analyticsLabelsForResource:sourceUid:`, reusing labels already resolved for a resource of a previous version
+ *  of the same media composition if the labels they are made of have not changed.
+ */
+- (SRGAnalyticsStreamLabels *)analyticsLabelsForResource:(SRGResource *)resource
+                                               sourceUid:(nullable NSString *)sourceUid
+                                previousMediaComposition:(nullable SRGMediaComposition *)previousMediaComposition
+                                        previousResource:(nullable SRGResource *)previousResource;
+
 @end
 
 NS_ASSUME_NONNULL_END
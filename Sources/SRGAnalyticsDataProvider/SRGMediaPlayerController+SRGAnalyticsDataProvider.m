@@ -9,8 +9,8 @@
 #import "SRGMediaComposition+SRGAnalyticsDataProvider.h"
 #import "SRGMediaComposition+SRGAnalyticsDataProvider_Private.h"
 #import "SRGSegment+SRGAnalyticsDataProvider.h"
+#import "SRGSegmentTimeline.h"
 
-@import libextobjc;
 @import SRGContentProtection;
 
 NSString * const SRGAnalyticsDataProviderUserInfoResourceLoaderOptionsKey = @"SRGAnalyticsDataProviderUserInfoResourceLoaderOptions";
@@ -97,18 +97,29 @@ static NSString * const SRGAnalyticsDataProviderSourceUidKey = @"SRGAnalyticsDat
         return;
     }
     
+    SRGResource *currentResource = self.resource;
+    
     NSMutableDictionary *userInfo = self.userInfo.mutableCopy;
     userInfo[SRGAnalyticsDataProviderMediaCompositionKey] = mediaComposition;
     
-    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"%K == %@", @keypath(SRGResource.new, quality), @(self.resource.quality)];
-    SRGResource *resource = [[mediaComposition.mainChapter resourcesForStreamingMethod:self.resource.streamingMethod] filteredArrayUsingPredicate:predicate].firstObject;
+    SRGResource *resource = nil;
+    for (SRGResource *candidateResource in [mediaComposition.mainChapter resourcesForStreamingMethod:currentResource.streamingMethod]) {
+        if (candidateResource.quality == currentResource.quality) {
+            resource = candidateResource;
+            break;
+        }
+    }
     if (resource) {
         userInfo[SRGAnalyticsDataProviderResourceKey] = resource;
     }
     
     self.userInfo = userInfo.copy;
     self.analyticsLabels = [mediaComposition analyticsLabelsForResource:self.userInfo[SRGAnalyticsDataProviderResourceKey]
-                                                              sourceUid:self.userInfo[SRGAnalyticsDataProviderSourceUidKey]];
+                                                              sourceUid:self.userInfo[SRGAnalyticsDataProviderSourceUidKey]
+                                               previousMediaComposition:currentMediaComposition
+                                                       previousResource:currentResource];
+    
+    [SRGSegmentTimeline timelineForChapter:mediaComposition.mainChapter];
     self.segments = mediaComposition.mainChapter.segments;
 }
 
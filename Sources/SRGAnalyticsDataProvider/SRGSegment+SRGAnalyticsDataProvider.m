@@ -6,20 +6,26 @@
 
 #import "SRGSegment+SRGAnalyticsDataProvider.h"
 
+#import "SRGSegmentTimeline.h"
+
 @implementation SRGSegment (SRGAnalyticsDataProvider)
 
 #pragma mark SRGSegment protocol
 
+// Queried repeatedly by the player. Answered from the timeline of the chapter the segment belongs to when available.
+
 - (SRGMarkRange *)srg_markRange
 {
-    SRGMark *markIn = self.markInDate ? [SRGMark markAtDate:self.markInDate] : [SRGMark markAtTime:CMTimeMakeWithSeconds(self.markIn / 1000., NSEC_PER_SEC)];
-    SRGMark *markOut = self.markOutDate ? [SRGMark markAtDate:self.markOutDate] : [SRGMark markAtTime:CMTimeMakeWithSeconds(self.markOut / 1000., NSEC_PER_SEC)];
-    return [SRGMarkRange rangeFromMark:markIn toMark:markOut];
+    NSUInteger index = 0;
+    SRGSegmentTimeline *timeline = [SRGSegmentTimeline timelineForSegment:self index:&index];
+    return timeline ? [timeline markRangeForSegmentAtIndex:index] : SRGSegmentMarkRange(self);
 }
 
 - (BOOL)srg_isBlocked
 {
-    return [self blockingReasonAtDate:NSDate.date] != SRGBlockingReasonNone;
+    NSUInteger index = 0;
+    SRGSegmentTimeline *timeline = [SRGSegmentTimeline timelineForSegment:self index:&index];
+    return timeline ? [timeline isSegmentAtIndexBlocked:index atDate:NSDate.date] : [self blockingReasonAtDate:NSDate.date] != SRGBlockingReasonNone;
 }
 
 - (BOOL)srg_isHidden
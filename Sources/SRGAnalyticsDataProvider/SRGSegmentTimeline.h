@@ -0,0 +1,66 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import CoreMedia;
+@import SRGDataProviderModel;
+@import SRGMediaPlayer;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Return the mark range of a segment.
+ */
+OBJC_EXPORT SRGMarkRange *SRGSegmentMarkRange(SRGSegment *segment);
+
+/**
+ *  Immutable timeline of the segments of a chapter, with precomputed mark ranges and the dates at which segment
+ *  availabilities change. Blocking states of all segments are evaluated at once and reused until the next availability
+ *  change.
+ *
+ *  @discussion Thread-safe.
+ */
+@interface SRGSegmentTimeline : NSObject
+
+/**
+ *  The timeline of the segments of a chapter, built once and associated with the chapter.
+ */
++ (SRGSegmentTimeline *)timelineForChapter:(SRGChapter *)chapter;
+
+/**
+ *  The timeline of a chapter the segment belongs to, provided it has been built and is still alive, `nil` otherwise.
+ *  The index of the segment within the timeline is returned by reference.
+ */
++ (nullable SRGSegmentTimeline *)timelineForSegment:(SRGSegment *)segment index:(NSUInteger *)pIndex;
+
+/**
+ *  Create a timeline for the specified segments, in any order.
+ */
+- (instancetype)initWithSegments:(NSArray<SRGSegment *> *)segments NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The segments of the timeline.
+ */
+@property (nonatomic, readonly) NSArray<SRGSegment *> *segments;
+
+/**
+ *  The mark range of the segment at the specified index.
+ */
+- (SRGMarkRange *)markRangeForSegmentAtIndex:(NSUInteger)index;
+
+/**
+ *  Return `YES` iff the segment at the specified index is blocked at the specified date.
+ */
+- (BOOL)isSegmentAtIndexBlocked:(NSUInteger)index atDate:(NSDate *)date;
+
+@end
+
+@interface SRGSegmentTimeline (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
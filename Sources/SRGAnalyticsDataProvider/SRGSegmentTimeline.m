@@ -0,0 +1,242 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGSegmentTimeline.h"
+
+#import <math.h>
+#import <objc/runtime.h>
+#import <os/lock.h>
+#import <stdlib.h>
+
+// Associated object keys
+static void *s_timelineKey = &s_timelineKey;
+static void *s_entryKey = &s_entryKey;
+
+// Guards timeline associations with chapters and segments
+static os_unfair_lock s_lock = OS_UNFAIR_LOCK_INIT;
+
+// Functions
+static int SRGSegmentTimelineCompareTimes(const void *time1, const void *time2);
+static NSUInteger SRGSegmentTimelineLowerBound(const double *values, NSUInteger count, double value);
+
+// Associates a segment with the timeline of its chapter
+@interface SRGSegmentTimelineEntry : NSObject
+
+@property (nonatomic, weak) SRGSegmentTimeline *timeline;
+@property (nonatomic) NSUInteger index;
+
+@end
+
+@interface SRGSegmentTimeline () {
+@private
+    os_unfair_lock _lock;
+    
+    NSUInteger _count;
+    
+    NSTimeInterval *_boundaryTimes;             // Sorted availability change times (since the reference date), without duplicates
+    NSUInteger _boundaryCount;
+    
+    // Blocking states by segment index, valid for times strictly between both bounds
+    BOOL *_blockedFlags;
+    NSTimeInterval _blockedFlagsLowerBound;
+    NSTimeInterval _blockedFlagsUpperBound;
+}
+
+@property (nonatomic) NSArray<SRGSegment *> *segments;
+@property (nonatomic) NSArray<SRGMarkRange *> *markRanges;
+
+@end
+
+@implementation SRGSegmentTimeline
+
+#pragma mark Class methods
+
+// Chapters are immutable, their timeline is therefore built once
++ (SRGSegmentTimeline *)timelineForChapter:(SRGChapter *)chapter
+{
+    os_unfair_lock_lock(&s_lock);
+    SRGSegmentTimeline *timeline = objc_getAssociatedObject(chapter, s_timelineKey);
+    os_unfair_lock_unlock(&s_lock);
+    
+    if (timeline) {
+        return timeline;
+    }
+    
+    SRGSegmentTimeline *builtTimeline = [[SRGSegmentTimeline alloc] initWithSegments:chapter.segments ?: @[]];
+    
+    os_unfair_lock_lock(&s_lock);
+    timeline = objc_getAssociatedObject(chapter, s_timelineKey);
+    if (! timeline) {
+        timeline = builtTimeline;
+        objc_setAssociatedObject(chapter, s_timelineKey, timeline, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        
+        [timeline.segments enumerateObjectsUsingBlock:^(SRGSegment * _Nonnull segment, NSUInteger idx, BOOL * _Nonnull stop) {
+            SRGSegmentTimelineEntry *entry = [[SRGSegmentTimelineEntry alloc] init];
+            entry.timeline = timeline;
+            entry.index = idx;
+            objc_setAssociatedObject(segment, s_entryKey, entry, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        }];
+    }
+    os_unfair_lock_unlock(&s_lock);
+    
+    return timeline;
+}
+
++ (SRGSegmentTimeline *)timelineForSegment:(SRGSegment *)segment index:(NSUInteger *)pIndex
+{
+    os_unfair_lock_lock(&s_lock);
+    SRGSegmentTimelineEntry *entry = objc_getAssociatedObject(segment, s_entryKey);
+    os_unfair_lock_unlock(&s_lock);
+    
+    SRGSegmentTimeline *timeline = entry.timeline;
+    if (timeline && pIndex) {
+        *pIndex = entry.index;
+    }
+    return timeline;
+}
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithSegments:(NSArray<SRGSegment *> *)segments
+{
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        
+        self.segments = segments.copy;
+        
+        _count = segments.count;
+        size_t allocationCount = MAX(_count, 1);
+        _blockedFlags = calloc(allocationCount, sizeof(BOOL));
+        _boundaryTimes = malloc(2 * allocationCount * sizeof(NSTimeInterval));
+        
+        NSMutableArray<SRGMarkRange *> *markRanges = [NSMutableArray arrayWithCapacity:_count];
+        
+        for (NSUInteger i = 0; i < _count; ++i) {
+            SRGSegment *segment = segments[i];
+            [markRanges addObject:SRGSegmentMarkRange(segment)];
+            
+            if (segment.startDate) {
+                _boundaryTimes[_boundaryCount++] = segment.startDate.timeIntervalSinceReferenceDate;
+            }
+            if (segment.endDate) {
+                _boundaryTimes[_boundaryCount++] = segment.endDate.timeIntervalSinceReferenceDate;
+            }
+        }
+        self.markRanges = markRanges.copy;
+        
+        qsort(_boundaryTimes, _boundaryCount, sizeof(NSTimeInterval), SRGSegmentTimelineCompareTimes);
+        NSUInteger uniqueBoundaryCount = 0;
+        for (NSUInteger i = 0; i < _boundaryCount; ++i) {
+            if (uniqueBoundaryCount == 0 || _boundaryTimes[i] != _boundaryTimes[uniqueBoundaryCount - 1]) {
+                _boundaryTimes[uniqueBoundaryCount++] = _boundaryTimes[i];
+            }
+        }
+        _boundaryCount = uniqueBoundaryCount;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithSegments:@[]];
+}
+
+#pragma clang diagnostic pop
+
+- (void)dealloc
+{
+    free(_blockedFlags);
+    free(_boundaryTimes);
+}
+
+#pragma mark Queries
+
+- (SRGMarkRange *)markRangeForSegmentAtIndex:(NSUInteger)index
+{
+    return self.markRanges[index];
+}
+
+- (BOOL)isSegmentAtIndexBlocked:(NSUInteger)index atDate:(NSDate *)date
+{
+    NSParameterAssert(index < _count);
+    
+    NSTimeInterval time = date.timeIntervalSinceReferenceDate;
+    
+    os_unfair_lock_lock(&_lock);
+    
+    if (! (_blockedFlagsLowerBound < time && time < _blockedFlagsUpperBound)) {
+        NSUInteger position = SRGSegmentTimelineLowerBound(_boundaryTimes, _boundaryCount, time);
+        
+        // Blocking states might change exactly at a boundary, in which case they are not cached
+        if (position < _boundaryCount && _boundaryTimes[position] == time) {
+            os_unfair_lock_unlock(&_lock);
+            return [self.segments[index] blockingReasonAtDate:date] != SRGBlockingReasonNone;
+        }
+        
+        _blockedFlagsLowerBound = (position > 0) ? _boundaryTimes[position - 1] : -INFINITY;
+        _blockedFlagsUpperBound = (position < _boundaryCount) ? _boundaryTimes[position] : INFINITY;
+        for (NSUInteger i = 0; i < _count; ++i) {
+            _blockedFlags[i] = ([self.segments[i] blockingReasonAtDate:date] != SRGBlockingReasonNone);
+        }
+    }
+    
+    BOOL blocked = _blockedFlags[index];
+    os_unfair_lock_unlock(&_lock);
+    return blocked;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; count = %@; boundaryCount = %@>",
+            self.class,
+            self,
+            @(_count),
+            @(_boundaryCount)];
+}
+
+@end
+
+@implementation SRGSegmentTimelineEntry
+
+@end
+
+#pragma mark Functions
+
+SRGMarkRange *SRGSegmentMarkRange(SRGSegment *segment)
+{
+    SRGMark *markIn = segment.markInDate ? [SRGMark markAtDate:segment.markInDate] : [SRGMark markAtTime:CMTimeMakeWithSeconds(segment.markIn / 1000., NSEC_PER_SEC)];
+    SRGMark *markOut = segment.markOutDate ? [SRGMark markAtDate:segment.markOutDate] : [SRGMark markAtTime:CMTimeMakeWithSeconds(segment.markOut / 1000., NSEC_PER_SEC)];
+    return [SRGMarkRange rangeFromMark:markIn toMark:markOut];
+}
+
+static int SRGSegmentTimelineCompareTimes(const void *time1, const void *time2)
+{
+    double value1 = *(const double *)time1;
+    double value2 = *(const double *)time2;
+    return (value1 < value2) ? -1 : (value1 > value2);
+}
+
+// Return the position of the first value greater than or equal to the specified one
+static NSUInteger SRGSegmentTimelineLowerBound(const double *values, NSUInteger count, double value)
+{
+    NSUInteger lowerPosition = 0, upperPosition = count;
+    while (lowerPosition < upperPosition) {
+        NSUInteger middlePosition = lowerPosition + (upperPosition - lowerPosition) / 2;
+        if (values[middlePosition] < value) {
+            lowerPosition = middlePosition + 1;
+        }
+        else {
+            upperPosition = middlePosition;
+        }
+    }
+    return lowerPosition;
+}
@@ -0,0 +1 @@
+../../SRGAnalytics/SRGAnalyticsDeltaEncoder.h
\ No newline at end of file
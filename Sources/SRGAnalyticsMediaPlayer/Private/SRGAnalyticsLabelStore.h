@@ -0,0 +1 @@
+../../SRGAnalytics/SRGAnalyticsLabelStore.h
\ No newline at end of file
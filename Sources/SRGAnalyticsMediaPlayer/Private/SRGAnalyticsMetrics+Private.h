@@ -0,0 +1 @@
+../../SRGAnalytics/SRGAnalyticsMetrics+Private.h
\ No newline at end of file
@@ -4,12 +4,35 @@
 //  License information is available from the LICENSE file.
 //
 
+#import "SRGAnalyticsStreamLabels.h"
+
 @import Foundation;
+@import SRGMediaPlayer;
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface SRGComScoreMediaPlayerTracker : NSObject
 
+/**
+ *  Prepare in the background the streaming session for the next item played by a controller with the specified labels
+ *  (if any), so that it can be used without delay when playback starts. A single session is prepared per controller,
+ *  replacing any previously prepared one. Must be called from the main thread.
+ */
+/**
+ *  The number of players currently playing. Players are counted once, whatever the events they send, and are not
+ *  counted anymore once released.
+ */
+@property (class, nonatomic, readonly) NSUInteger playingPlayerCount;
+
+/**
+ *  The total time spent playing by all players since the application was launched. The time of players playing
+ *  simultaneously is summed.
+ */
+@property (class, nonatomic, readonly) NSTimeInterval playingDuration;
+
++ (void)prewarmStreamingAnalyticsForMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
+                                               withLabels:(nullable SRGAnalyticsStreamLabels *)labels;
+
 @end
 
 NS_ASSUME_NONNULL_END
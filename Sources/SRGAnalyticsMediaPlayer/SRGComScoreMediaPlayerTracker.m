@@ -12,7 +12,9 @@
 #import "SRGAnalyticsStreamLabels.h"
 #import "SRGAnalyticsTracker+Private.h"
 #import "SRGMediaAnalytics.h"
+#import "SRGMediaPlaybackActivityAggregator.h"
 #import "SRGMediaPlayerController+SRGAnalyticsMediaPlayer.h"
+#import "SRGMediaPlayerTrackerRegistry.h"
 
 @import ComScore;
 @import libextobjc;
@@ -20,79 +22,207 @@
 @import SRGAnalytics;
 @import SRGMediaPlayer;
 
-typedef NS_ENUM(NSInteger, ComScoreMediaPlayerTrackerEvent) {
-    ComScoreMediaPlayerTrackerEventPlay = 1,
-    ComScoreMediaPlayerTrackerEventPause,
-    ComScoreMediaPlayerTrackerEventEnd,
-    ComScoreMediaPlayerTrackerEventSeek,
-    ComScoreMediaPlayerTrackerEventBuffer
-};
+#import <objc/runtime.h>
+#import <time.h>
 
-static NSInteger s_playbackActivityCount = 0;
-static NSMutableDictionary<NSValue *, SRGComScoreMediaPlayerTracker *> *s_trackers = nil;
+static void *s_prewarmedSessionKey = &s_prewarmedSessionKey;
 
-@interface SRGComScoreMediaPlayerTracker ()
+static uint64_t SRGComScoreMediaPlayerTrackerCurrentTime(void);
+
+// Identifies identical content metadata
+@interface SRGComScoreStreamingMetadataKey : NSObject <NSCopying>
+
+- (instancetype)initWithLabelStore:(SRGAnalyticsLabelStore *)labelStore
+                  dataSourceLabels:(NSDictionary<NSString *, NSString *> *)dataSourceLabels
+                    testIdentifier:(NSString *)testIdentifier;
+
+@property (nonatomic, readonly) SRGAnalyticsLabelStore *labelStore;
+@property (nonatomic, readonly, copy) NSDictionary<NSString *, NSString *> *dataSourceLabels;
+@property (nonatomic, readonly, copy) NSString *testIdentifier;
+
+@end
+
+// Session prepared in advance for the next item played by a controller. Only accessed from the main thread.
+@interface SRGComScorePrewarmedSession : NSObject
+
+@property (nonatomic) SRGComScoreStreamingMetadataKey *metadataKey;
+@property (nonatomic, copy) NSString *playerName;
+@property (nonatomic, copy) NSString *playerVersion;
+
+@property (nonatomic) SCORStreamingAnalytics *streamingAnalytics;         // Available once prewarmed
+
+@end
+
+@interface SRGComScoreMediaPlayerTracker () {
+@private
+    SRGMediaPlaybackActivityToken _playbackActivityToken;
+}
 
 @property (nonatomic, weak) SRGMediaPlayerController *mediaPlayerController;
 @property (nonatomic) SCORStreamingAnalytics *streamingAnalytics;
 
-@property (nonatomic, getter=isPlaying) BOOL playing;
-
 @end
 
 @implementation SRGComScoreMediaPlayerTracker
 
 #pragma mark Class methods
 
-+ (void)increasePlaybackActivityCount
+// UX activity is reported to comScore as long as at least one player is playing
++ (SRGMediaPlaybackActivityAggregator *)playbackActivityAggregator
 {
-    ++s_playbackActivityCount;
-    if (s_playbackActivityCount == 1) {
-        [SCORAnalytics notifyUxActive];
+    static SRGMediaPlaybackActivityAggregator *s_aggregator;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        dispatch_queue_attr_t attributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        dispatch_queue_t queue = dispatch_queue_create("ch.srgssr.analytics.comscore.activity", attributes);
+        s_aggregator = [[SRGMediaPlaybackActivityAggregator alloc] initWithQueue:queue activityChangeBlock:^(BOOL active) {
+            if (active) {
+                [SCORAnalytics notifyUxActive];
+            }
+            else {
+                [SCORAnalytics notifyUxInactive];
+            }
+        }];
+    });
+    return s_aggregator;
+}
+
++ (NSUInteger)playingPlayerCount
+{
+    return [self playbackActivityAggregator].activeCount;
+}
+
++ (NSTimeInterval)playingDuration
+{
+    return (NSTimeInterval)[[self playbackActivityAggregator] activeDurationAtTime:SRGComScoreMediaPlayerTrackerCurrentTime()] / NSEC_PER_SEC;
+}
+
++ (SRGComScoreStreamingMetadataKey *)streamingMetadataKeyForLabels:(SRGAnalyticsStreamLabels *)labels
+{
+    SRGAnalyticsLabelStore *labelStore = labels.comScoreLabelStore;
+    if (labelStore.count == 0) {
+        return nil;
     }
+    
+    SRGAnalyticsTracker *tracker = SRGAnalyticsTracker.sharedTracker;
+    NSString *testIdentifier = tracker.configuration.unitTesting ? SRGAnalyticsUnitTestingIdentifier() : nil;
+    return [[SRGComScoreStreamingMetadataKey alloc] initWithLabelStore:labelStore
+                                                      dataSourceLabels:tracker.dataSourceLabels.comScoreCustomInfo
+                                                        testIdentifier:testIdentifier];
 }
 
-+ (void)decreasePlaybackActivityCount
+// Metadata is immutable and built once per label set. Can be called from any thread.
++ (SCORStreamingContentMetadata *)streamingMetadataForKey:(SRGComScoreStreamingMetadataKey *)key
 {
-    NSAssert(s_playbackActivityCount != 0, @"Incorrect activity count management");
+    static NSCache<SRGComScoreStreamingMetadataKey *, SCORStreamingContentMetadata *> *s_streamingMetadataCache;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_streamingMetadataCache = [[NSCache alloc] init];
+        s_streamingMetadataCache.countLimit = 20;
+    });
     
-    --s_playbackActivityCount;
-    if (s_playbackActivityCount == 0) {
-        [SCORAnalytics notifyUxInactive];
+    SCORStreamingContentMetadata *streamingMetadata = [s_streamingMetadataCache objectForKey:key];
+    if (streamingMetadata) {
+        return streamingMetadata;
     }
+    
+    streamingMetadata = [SCORStreamingContentMetadata contentMetadataWithBuilderBlock:^(SCORStreamingContentMetadataBuilder *builder) {
+        NSMutableDictionary<NSString *, NSString *> *customLabels = [NSMutableDictionary dictionary];
+        [key.labelStore addEntriesToDictionary:customLabels];
+        
+        if (key.dataSourceLabels) {
+            [customLabels addEntriesFromDictionary:key.dataSourceLabels];
+        }
+        
+        [customLabels srg_safelySetString:key.testIdentifier forKey:@"srg_test_id"];
+        
+        [builder setCustomLabels:customLabels.copy];
+    }];
+    [s_streamingMetadataCache setObject:streamingMetadata forKey:key];
+    return streamingMetadata;
+}
+
++ (SCORStreamingAnalytics *)streamingAnalyticsWithMetadataKey:(SRGComScoreStreamingMetadataKey *)metadataKey
+                                                   playerName:(NSString *)playerName
+                                                playerVersion:(NSString *)playerVersion
+{
+    SCORStreamingAnalytics *streamingAnalytics = [[SCORStreamingAnalytics alloc] init];
+    [streamingAnalytics createPlaybackSession];
+    
+    [streamingAnalytics setMediaPlayerName:playerName];
+    [streamingAnalytics setMediaPlayerVersion:playerVersion];
+    [streamingAnalytics setMetadata:[self streamingMetadataForKey:metadataKey]];
+    
+    return streamingAnalytics;
 }
 
 + (SCORStreamingAnalytics *)streamingAnalyticsForMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
 {
     SRGAnalyticsStreamLabels *labels = mediaPlayerController.userInfo[SRGAnalyticsMediaPlayerLabelsKey];
-    NSDictionary<NSString *, NSString *> *labelsDictionary = labels.comScoreLabelsDictionary;
-    if (labelsDictionary.count == 0) {
+    SRGComScoreStreamingMetadataKey *metadataKey = [self streamingMetadataKeyForLabels:labels];
+    if (! metadataKey) {
         return nil;
     }
     
-    SCORStreamingAnalytics *streamingAnalytics = [[SCORStreamingAnalytics alloc] init];
-    [streamingAnalytics createPlaybackSession];
+    // comScore might not have been started yet if startup is deferred
+    [SRGAnalyticsTracker.sharedTracker startComScoreIfNeeded];
     
-    [streamingAnalytics setMediaPlayerName:mediaPlayerController.analyticsPlayerName];
-    [streamingAnalytics setMediaPlayerVersion:mediaPlayerController.analyticsPlayerVersion];
+    NSString *playerName = mediaPlayerController.analyticsPlayerName;
+    NSString *playerVersion = mediaPlayerController.analyticsPlayerVersion;
     
-    SCORStreamingContentMetadata *streamingMetadata = [SCORStreamingContentMetadata contentMetadataWithBuilderBlock:^(SCORStreamingContentMetadataBuilder *builder) {
-        NSMutableDictionary<NSString *, NSString *> *customLabels = [labelsDictionary mutableCopy];
-
-        NSDictionary<NSString *, NSString *> *dataSourceLabels = SRGAnalyticsTracker.sharedTracker.dataSourceLabels.comScoreCustomInfo;
-        if (dataSourceLabels) {
-            [customLabels addEntriesFromDictionary:dataSourceLabels];
-        }
+    // Use the prewarmed session if it matches (and is ready), otherwise keep it for a later item
+    SRGComScorePrewarmedSession *prewarmedSession = objc_getAssociatedObject(mediaPlayerController, s_prewarmedSessionKey);
+    if (prewarmedSession.streamingAnalytics
+            && [prewarmedSession.metadataKey isEqual:metadataKey]
+            && [prewarmedSession.playerName isEqualToString:playerName]
+            && [prewarmedSession.playerVersion isEqualToString:playerVersion]) {
+        objc_setAssociatedObject(mediaPlayerController, s_prewarmedSessionKey, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        return prewarmedSession.streamingAnalytics;
+    }
+    
+    return [self streamingAnalyticsWithMetadataKey:metadataKey playerName:playerName playerVersion:playerVersion];
+}
 
-        if (SRGAnalyticsTracker.sharedTracker.configuration.unitTesting) {
-            [customLabels srg_safelySetString:SRGAnalyticsUnitTestingIdentifier() forKey:@"srg_test_id"];
-        }
-        
-        [builder setCustomLabels:customLabels.copy];
-    }];
-    [streamingAnalytics setMetadata:streamingMetadata];
++ (void)prewarmStreamingAnalyticsForMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
+                                               withLabels:(SRGAnalyticsStreamLabels *)labels
+{
+    NSAssert(NSThread.isMainThread, @"Must be called from the main thread");
     
-    return streamingAnalytics;
+    if (! SRGAnalyticsTracker.sharedTracker.configuration) {
+        return;
+    }
+    
+    SRGComScoreStreamingMetadataKey *metadataKey = [self streamingMetadataKeyForLabels:labels];
+    if (! metadataKey) {
+        objc_setAssociatedObject(mediaPlayerController, s_prewarmedSessionKey, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        return;
+    }
+    
+    [SRGAnalyticsTracker.sharedTracker startComScoreIfNeeded];
+    
+    SRGComScorePrewarmedSession *prewarmedSession = [[SRGComScorePrewarmedSession alloc] init];
+    prewarmedSession.metadataKey = metadataKey;
+    prewarmedSession.playerName = mediaPlayerController.analyticsPlayerName;
+    prewarmedSession.playerVersion = mediaPlayerController.analyticsPlayerVersion;
+    objc_setAssociatedObject(mediaPlayerController, s_prewarmedSessionKey, prewarmedSession, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    
+    static dispatch_queue_t s_prewarmQueue;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        dispatch_queue_attr_t attributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        s_prewarmQueue = dispatch_queue_create("ch.srgssr.analytics.comscore.prewarm", attributes);
+    });
+    
+    // If the session is not ready in time, or if another session is prewarmed in the meantime, the result is simply
+    // discarded.
+    dispatch_async(s_prewarmQueue, ^{
+        SCORStreamingAnalytics *streamingAnalytics = [self streamingAnalyticsWithMetadataKey:prewarmedSession.metadataKey
+                                                                                  playerName:prewarmedSession.playerName
+                                                                               playerVersion:prewarmedSession.playerVersion];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            prewarmedSession.streamingAnalytics = streamingAnalytics;
+        });
+    });
 }
 
 #pragma mark Object lifecycle
@@ -129,7 +259,7 @@ static NSMutableDictionary<NSValue *, SRGComScoreMediaPlayerTracker *> *s_tracke
                                         timeRange:mediaPlayerController.timeRange];
             }
             else {
-                [self recordEvent:ComScoreMediaPlayerTrackerEventEnd
+                [self recordEvent:SRGMediaPlaybackEventEnd
                    withStreamType:mediaPlayerController.streamType
                              time:mediaPlayerController.currentTime
                         timeRange:mediaPlayerController.timeRange];
@@ -143,6 +273,12 @@ static NSMutableDictionary<NSValue *, SRGComScoreMediaPlayerTracker *> *s_tracke
     return self;
 }
 
+- (void)dealloc
+{
+    // Players released while playing (without a pause or end event) must not keep UX activity reported
+    [[SRGComScoreMediaPlayerTracker playbackActivityAggregator] endActivityWithToken:&_playbackActivityToken atTime:SRGComScoreMediaPlayerTrackerCurrentTime()];
+}
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdeprecated-implementations"
 
@@ -161,43 +297,47 @@ static NSMutableDictionary<NSValue *, SRGComScoreMediaPlayerTracker *> *s_tracke
                                time:(CMTime)time
                           timeRange:(CMTimeRange)timeRange
 {
-    static dispatch_once_t s_onceToken;
-    static NSDictionary<NSNumber *, NSNumber *> *s_events;
-    dispatch_once(&s_onceToken, ^{
-        s_events = @{ @(SRGMediaPlayerPlaybackStateIdle) : @(ComScoreMediaPlayerTrackerEventEnd),
-                      @(SRGMediaPlayerPlaybackStatePreparing) : @(ComScoreMediaPlayerTrackerEventBuffer),
-                      @(SRGMediaPlayerPlaybackStatePlaying) : @(ComScoreMediaPlayerTrackerEventPlay),
-                      @(SRGMediaPlayerPlaybackStateSeeking) : @(ComScoreMediaPlayerTrackerEventSeek),
-                      @(SRGMediaPlayerPlaybackStatePaused) : @(ComScoreMediaPlayerTrackerEventPause),
-                      @(SRGMediaPlayerPlaybackStateEnded) : @(ComScoreMediaPlayerTrackerEventEnd),
-                      @(SRGMediaPlayerPlaybackStateStalled) : @(ComScoreMediaPlayerTrackerEventBuffer) };
-    });
-    
-    NSNumber *event = s_events[@(playbackState)];
-    if (! event) {
+    SRGMediaPlaybackEvent event = SRGMediaAnalyticsEventForPlaybackState(playbackState);
+    if (event == SRGMediaPlaybackEventNone) {
         return;
     }
     
-    [self recordEvent:event.integerValue
+    [self recordEvent:event
        withStreamType:streamType
                  time:time
             timeRange:timeRange];
 }
 
-- (void)recordEvent:(ComScoreMediaPlayerTrackerEvent)event
+- (void)recordEvent:(SRGMediaPlaybackEvent)event
      withStreamType:(SRGMediaPlayerStreamType)streamType
                time:(CMTime)time
           timeRange:(CMTimeRange)timeRange
 {
-    SCORStreamingAnalytics *streamingAnalytics = self.streamingAnalytics;
+    // comScore has no stop event, sessions are simply ended
+    if (event == SRGMediaPlaybackEventStop) {
+        event = SRGMediaPlaybackEventEnd;
+    }
     
-    if (! self.playing && event == ComScoreMediaPlayerTrackerEventPlay) {
-        [SRGComScoreMediaPlayerTracker increasePlaybackActivityCount];
-        self.playing = YES;
+    SRGMediaPlaybackActivityAggregator *playbackActivityAggregator = [SRGComScoreMediaPlayerTracker playbackActivityAggregator];
+    if (event == SRGMediaPlaybackEventPlay) {
+        // comScore must be started before UX activity is reported
+        [SRGAnalyticsTracker.sharedTracker startComScoreIfNeeded];
+        [playbackActivityAggregator beginActivityWithToken:&_playbackActivityToken atTime:SRGComScoreMediaPlayerTrackerCurrentTime()];
     }
-    else if (self.playing && (event == ComScoreMediaPlayerTrackerEventPause || event == ComScoreMediaPlayerTrackerEventEnd)) {
-        [SRGComScoreMediaPlayerTracker decreasePlaybackActivityCount];
-        self.playing = NO;
+    else if (event == SRGMediaPlaybackEventPause || event == SRGMediaPlaybackEventEnd) {
+        [playbackActivityAggregator endActivityWithToken:&_playbackActivityToken atTime:SRGComScoreMediaPlayerTrackerCurrentTime()];
+    }
+    
+    // Sessions are created on demand after a previous one has ended, so that no session is created when the player
+    // is not used afterwards
+    SCORStreamingAnalytics *streamingAnalytics = self.streamingAnalytics;
+    if (! streamingAnalytics) {
+        if (event == SRGMediaPlaybackEventEnd) {
+            return;
+        }
+        
+        streamingAnalytics = [SRGComScoreMediaPlayerTracker streamingAnalyticsForMediaPlayerController:self.mediaPlayerController];
+        self.streamingAnalytics = streamingAnalytics;
     }
     
     if (streamType == SRGMediaPlayerStreamTypeDVR) {
@@ -209,29 +349,29 @@ static NSMutableDictionary<NSValue *, SRGComScoreMediaPlayerTracker *> *s_tracke
     }
     
     switch (event) {
-        case ComScoreMediaPlayerTrackerEventPlay: {
+        case SRGMediaPlaybackEventPlay: {
             [streamingAnalytics notifyChangePlaybackRate:self.mediaPlayerController.effectivePlaybackRate];
             [streamingAnalytics notifyPlay];
             break;
         }
             
-        case ComScoreMediaPlayerTrackerEventPause: {
+        case SRGMediaPlaybackEventPause: {
             [streamingAnalytics notifyPause];
             break;
         }
             
-        case ComScoreMediaPlayerTrackerEventEnd: {
+        case SRGMediaPlaybackEventEnd: {
             [streamingAnalytics notifyEnd];
-            self.streamingAnalytics = [SRGComScoreMediaPlayerTracker streamingAnalyticsForMediaPlayerController:self.mediaPlayerController];
+            self.streamingAnalytics = nil;
             break;
         }
             
-        case ComScoreMediaPlayerTrackerEventSeek: {
+        case SRGMediaPlaybackEventSeek: {
             [streamingAnalytics notifySeekStart];
             break;
         }
         
-        case ComScoreMediaPlayerTrackerEventBuffer: {
+        case SRGMediaPlaybackEventBuffer: {
             [streamingAnalytics notifyBufferStart];
             break;
         }
@@ -246,14 +386,19 @@ static NSMutableDictionary<NSValue *, SRGComScoreMediaPlayerTracker *> *s_tracke
 
 + (void)playbackStateDidChange:(NSNotification *)notification
 {
+    // Trackers are only attached and detached when preparing or returning to idle
+    SRGMediaPlayerPlaybackState playbackState = [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue];
+    if (playbackState != SRGMediaPlayerPlaybackStatePreparing && playbackState != SRGMediaPlayerPlaybackStateIdle) {
+        return;
+    }
+    
     if (! SRGAnalyticsTracker.sharedTracker.configuration) {
         return;
     }
     
     SRGMediaPlayerController *mediaPlayerController = notification.object;
-    NSValue *key = [NSValue valueWithNonretainedObject:mediaPlayerController];
+    SRGMediaPlayerTrackerRegistry *registry = SRGMediaPlayerTrackerRegistry.sharedRegistry;
     
-    SRGMediaPlayerPlaybackState playbackState = [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue];
     SRGMediaPlayerPlaybackState previousPlaybackState = [notification.userInfo[SRGMediaPlayerPreviousPlaybackStateKey] integerValue];
     
     // Always attach a tracker to a the player controller, whether or not it is actually tracked (otherwise we would
@@ -261,31 +406,29 @@ static NSMutableDictionary<NSValue *, SRGComScoreMediaPlayerTracker *> *s_tracke
     if (playbackState == SRGMediaPlayerPlaybackStatePreparing) {
         SRGComScoreMediaPlayerTracker *tracker = [[SRGComScoreMediaPlayerTracker alloc] initWithMediaPlayerController:mediaPlayerController];
         if (tracker) {
-            s_trackers[key] = tracker;
+            [registry setTracker:tracker ofKind:SRGMediaPlayerTrackerKindComScore forMediaPlayerController:mediaPlayerController];
         
-            [tracker recordEvent:ComScoreMediaPlayerTrackerEventBuffer
+            [tracker recordEvent:SRGMediaPlaybackEventBuffer
                   withStreamType:mediaPlayerController.streamType
                             time:mediaPlayerController.currentTime
                        timeRange:mediaPlayerController.timeRange];
             
-            SRGAnalyticsMediaPlayerLogInfo(@"comScoreTracker", @"Started tracking for %@", key);
+            SRGAnalyticsMediaPlayerLogInfo(@"comScoreTracker", @"Started tracking for %p", mediaPlayerController);
         }
     }
     else if (playbackState == SRGMediaPlayerPlaybackStateIdle) {
-        SRGComScoreMediaPlayerTracker *tracker = s_trackers[key];
+        SRGComScoreMediaPlayerTracker *tracker = [registry removeTrackerOfKind:SRGMediaPlayerTrackerKindComScore forMediaPlayerController:mediaPlayerController];
         if (tracker) {
             if (previousPlaybackState != SRGMediaPlayerPlaybackStatePreparing) {
                 SRGMediaPlayerStreamType streamType = [notification.userInfo[SRGMediaPlayerPreviousStreamTypeKey] integerValue];
                 CMTime time = [notification.userInfo[SRGMediaPlayerLastPlaybackTimeKey] CMTimeValue];
                 CMTimeRange timeRange = [notification.userInfo[SRGMediaPlayerPreviousTimeRangeKey] CMTimeRangeValue];
-                [tracker recordEvent:ComScoreMediaPlayerTrackerEventEnd
+                [tracker recordEvent:SRGMediaPlaybackEventEnd
                       withStreamType:streamType
                                 time:time
                            timeRange:timeRange];
             }
-            s_trackers[key] = nil;
-            
-            SRGAnalyticsMediaPlayerLogInfo(@"comScoreTracker", @"Stopped tracking for %@", key);
+            SRGAnalyticsMediaPlayerLogInfo(@"comScoreTracker", @"Stopped tracking for %p", mediaPlayerController);
         }
     }
 }
@@ -310,6 +453,69 @@ static NSMutableDictionary<NSValue *, SRGComScoreMediaPlayerTracker *> *s_tracke
 
 @end
 
+@implementation SRGComScoreStreamingMetadataKey
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithLabelStore:(SRGAnalyticsLabelStore *)labelStore
+                  dataSourceLabels:(NSDictionary<NSString *, NSString *> *)dataSourceLabels
+                    testIdentifier:(NSString *)testIdentifier
+{
+    if (self = [super init]) {
+        _labelStore = labelStore;
+        _dataSourceLabels = dataSourceLabels.copy;
+        _testIdentifier = testIdentifier.copy;
+    }
+    return self;
+}
+
+#pragma mark Equality
+
+- (BOOL)isEqual:(id)object
+{
+    if (! [object isKindOfClass:SRGComScoreStreamingMetadataKey.class]) {
+        return NO;
+    }
+    
+    SRGComScoreStreamingMetadataKey *otherKey = object;
+    return (self.labelStore == otherKey.labelStore || [self.labelStore isEqual:otherKey.labelStore])
+        && (self.dataSourceLabels == otherKey.dataSourceLabels || [self.dataSourceLabels isEqualToDictionary:otherKey.dataSourceLabels])
+        && (self.testIdentifier == otherKey.testIdentifier || [self.testIdentifier isEqualToString:otherKey.testIdentifier]);
+}
+
+- (NSUInteger)hash
+{
+    NSUInteger hash = self.labelStore.hash;
+    hash = hash * 31 + self.dataSourceLabels.count;
+    return hash * 31 + self.testIdentifier.hash;
+}
+
+#pragma mark NSCopying protocol
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // Immutable
+    return self;
+}
+
+@end
+
+@implementation SRGComScorePrewarmedSession
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; playerName = %@; playerVersion = %@; streamingAnalytics = %@>",
+            self.class,
+            self,
+            self.playerName,
+            self.playerVersion,
+            self.streamingAnalytics];
+}
+
+@end
+
 #pragma mark Static functions
 
 __attribute__((constructor)) static void SRGMediaPlayerTrackerInit(void)
@@ -319,6 +525,10 @@ __attribute__((constructor)) static void SRGMediaPlayerTrackerInit(void)
                                            selector:@selector(playbackStateDidChange:)
                                                name:SRGMediaPlayerPlaybackStateDidChangeNotification
                                              object:nil];
-    
-    s_trackers = [NSMutableDictionary dictionary];
+}
+
+// Monotonic, so that wall-clock adjustments do not affect durations
+static uint64_t SRGComScoreMediaPlayerTrackerCurrentTime(void)
+{
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
 }
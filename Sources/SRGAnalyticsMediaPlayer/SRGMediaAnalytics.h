@@ -4,6 +4,8 @@
 //  License information is available from the LICENSE file.
 //
 
+#import "SRGMediaPlaybackStateMachine.h"
+
 @import SRGMediaPlayer;
 
 NS_ASSUME_NONNULL_BEGIN
@@ -37,4 +39,9 @@ OBJC_EXPORT NSNumber * _Nullable SRGMediaAnalyticsTimeshiftInMilliseconds(SRGMed
  */
 OBJC_EXPORT NSNumber * _Nullable  SRGMediaAnalyticsPlayerTimeshiftInMilliseconds(SRGMediaPlayerController *mediaPlayerController);
 
+/**
+ *  Return the event corresponding to a playback state (stop for idle, buffer for preparing and stalled states).
+ */
+OBJC_EXPORT SRGMediaPlaybackEvent SRGMediaAnalyticsEventForPlaybackState(SRGMediaPlayerPlaybackState playbackState);
+
 NS_ASSUME_NONNULL_END
@@ -10,12 +10,16 @@ NSString * const SRGAnalyticsMediaPlayerLabelsKey = @"SRGAnalyticsMediaPlayerLab
 
 NSInteger SRGMediaAnalyticsCMTimeToMilliseconds(CMTime time)
 {
-    if (CMTIME_IS_INDEFINITE(time) || CMTIME_IS_INVALID(time)) {
+    if (! CMTIME_IS_NUMERIC(time)) {
         return 0;
     }
-    else {
-        return (NSInteger)fmax(floorf(CMTimeGetSeconds(time) * 1000.), 0.);
+    
+    // Convert with integer arithmetic, avoiding precision loss for large values (e.g. long livestream times)
+    CMTime milliseconds = CMTimeConvertScale(time, 1000, kCMTimeRoundingMethod_RoundTowardNegativeInfinity);
+    if (! CMTIME_IS_NUMERIC(milliseconds)) {
+        return 0;
     }
+    return (NSInteger)MAX(milliseconds.value, 0);
 }
 
 BOOL SRGMediaAnalyticsIsLiveStreamType(SRGMediaPlayerStreamType streamType)
@@ -53,3 +57,34 @@ NSNumber *SRGMediaAnalyticsPlayerTimeshiftInMilliseconds(SRGMediaPlayerControlle
                                                     mediaPlayerController.currentTime,
                                                     mediaPlayerController.liveTolerance);
 }
+
+SRGMediaPlaybackEvent SRGMediaAnalyticsEventForPlaybackState(SRGMediaPlayerPlaybackState playbackState)
+{
+    switch (playbackState) {
+        case SRGMediaPlayerPlaybackStateIdle: {
+            return SRGMediaPlaybackEventStop;
+        }
+            
+        case SRGMediaPlayerPlaybackStatePreparing:
+        case SRGMediaPlayerPlaybackStateStalled: {
+            return SRGMediaPlaybackEventBuffer;
+        }
+            
+        case SRGMediaPlayerPlaybackStatePlaying: {
+            return SRGMediaPlaybackEventPlay;
+        }
+            
+        case SRGMediaPlayerPlaybackStateSeeking: {
+            return SRGMediaPlaybackEventSeek;
+        }
+            
+        case SRGMediaPlayerPlaybackStatePaused: {
+            return SRGMediaPlaybackEventPause;
+        }
+            
+        case SRGMediaPlayerPlaybackStateEnded: {
+            return SRGMediaPlaybackEventEnd;
+        }
+    }
+    return SRGMediaPlaybackEventNone;
+}
@@ -0,0 +1,75 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+#import <stdatomic.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Per-player activity state, storing the time at which the player became active, or 0 if inactive. Must be
+ *  zero-initialized (as object instance variables are).
+ */
+typedef _Atomic(uint64_t) SRGMediaPlaybackActivityToken;
+
+/**
+ *  Block called when the aggregate activity changes, i.e. when a first player becomes active or when the last
+ *  active player becomes inactive.
+ */
+typedef void (^SRGMediaPlaybackActivityChangeBlock)(BOOL active);
+
+/**
+ *  Aggregate the activity of any number of players, each identified by its token. Transitions are idempotent:
+ *  beginning the activity of an already active player or ending the activity of an inactive one has no effect,
+ *  so that the number of active players remains correct whatever the sequence of events received. Players must
+ *  end their activity when released, which is always safe.
+ *
+ *  Times are expressed in nanoseconds and must be read from a monotonic clock (e.g. `clock_gettime_nsec_np(CLOCK_UPTIME_RAW)`).
+ *
+ *  @discussion Thread-safe. Transitions are serialized, and changes are submitted to a serial queue in the order of
+ *              the transitions which triggered them, so that they are always reported in order. The change block is
+ *              never called while the aggregator is locked and can therefore safely call the aggregator.
+ */
+@interface SRGMediaPlaybackActivityAggregator : NSObject
+
+/**
+ *  Create an aggregator, calling the specified block asynchronously on a serial queue when the aggregate activity
+ *  changes.
+ */
+- (instancetype)initWithQueue:(dispatch_queue_t)queue
+          activityChangeBlock:(nullable SRGMediaPlaybackActivityChangeBlock)activityChangeBlock NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Mark the player identified by the token as active at the specified time. Return `YES` iff the player was inactive.
+ */
+- (BOOL)beginActivityWithToken:(SRGMediaPlaybackActivityToken *)token atTime:(uint64_t)time;
+
+/**
+ *  Mark the player identified by the token as inactive at the specified time. Return `YES` iff the player was active.
+ */
+- (BOOL)endActivityWithToken:(SRGMediaPlaybackActivityToken *)token atTime:(uint64_t)time;
+
+/**
+ *  The number of active players.
+ */
+@property (nonatomic, readonly) NSUInteger activeCount;
+
+/**
+ *  The total time during which players have been active up to the specified time, in nanoseconds. The time of
+ *  players active simultaneously is summed.
+ */
+- (uint64_t)activeDurationAtTime:(uint64_t)time;
+
+@end
+
+@interface SRGMediaPlaybackActivityAggregator (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
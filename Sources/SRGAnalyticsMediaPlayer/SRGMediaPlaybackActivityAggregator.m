@@ -0,0 +1,145 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlaybackActivityAggregator.h"
+
+#import <os/lock.h>
+
+@interface SRGMediaPlaybackActivityAggregator () {
+@private
+    os_unfair_lock _lock;
+    
+    // The active duration at some time t is `_accumulatedDuration + _activeCount * t - _startTimeSum`, which can be
+    // maintained in constant time per transition
+    NSUInteger _activeCount;
+    uint64_t _startTimeSum;
+    uint64_t _accumulatedDuration;
+}
+
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic, copy) SRGMediaPlaybackActivityChangeBlock activityChangeBlock;
+
+@end
+
+@implementation SRGMediaPlaybackActivityAggregator
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue activityChangeBlock:(SRGMediaPlaybackActivityChangeBlock)activityChangeBlock
+{
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        self.queue = queue;
+        self.activityChangeBlock = activityChangeBlock;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithQueue:dispatch_get_main_queue() activityChangeBlock:nil];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Getters and setters
+
+- (NSUInteger)activeCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger activeCount = _activeCount;
+    os_unfair_lock_unlock(&_lock);
+    return activeCount;
+}
+
+#pragma mark Transitions
+
+- (BOOL)beginActivityWithToken:(SRGMediaPlaybackActivityToken *)token atTime:(uint64_t)time
+{
+    // 0 is reserved for inactive tokens
+    uint64_t startTime = MAX(time, 1);
+    
+    os_unfair_lock_lock(&_lock);
+    
+    uint64_t expectedTime = 0;
+    BOOL began = atomic_compare_exchange_strong_explicit(token, &expectedTime, startTime, memory_order_relaxed, memory_order_relaxed);
+    if (began) {
+        _startTimeSum += startTime;
+        if (++_activeCount == 1) {
+            [self reportActivityChange:YES];
+        }
+    }
+    
+    os_unfair_lock_unlock(&_lock);
+    return began;
+}
+
+- (BOOL)endActivityWithToken:(SRGMediaPlaybackActivityToken *)token atTime:(uint64_t)time
+{
+    // Fast path for inactive players, e.g. when released
+    if (atomic_load_explicit(token, memory_order_relaxed) == 0) {
+        return NO;
+    }
+    
+    os_unfair_lock_lock(&_lock);
+    
+    uint64_t startTime = atomic_exchange_explicit(token, 0, memory_order_relaxed);
+    BOOL ended = (startTime != 0);
+    if (ended) {
+        _startTimeSum -= startTime;
+        _accumulatedDuration += (time > startTime) ? time - startTime : 0;
+        if (--_activeCount == 0) {
+            [self reportActivityChange:NO];
+        }
+    }
+    
+    os_unfair_lock_unlock(&_lock);
+    return ended;
+}
+
+// Must be called with the lock held. Only submitting the change to the queue happens under the lock, which
+// preserves the order of transitions without running the change block while the lock is held.
+- (void)reportActivityChange:(BOOL)active
+{
+    SRGMediaPlaybackActivityChangeBlock activityChangeBlock = self.activityChangeBlock;
+    if (! activityChangeBlock) {
+        return;
+    }
+    
+    dispatch_async(self.queue, ^{
+        activityChangeBlock(active);
+    });
+}
+
+#pragma mark Durations
+
+- (uint64_t)activeDurationAtTime:(uint64_t)time
+{
+    os_unfair_lock_lock(&_lock);
+    
+    // Guards against times earlier than some start time
+    uint64_t activeTime = (uint64_t)_activeCount * time;
+    uint64_t activeDuration = _accumulatedDuration + ((activeTime > _startTimeSum) ? activeTime - _startTimeSum : 0);
+    
+    os_unfair_lock_unlock(&_lock);
+    return activeDuration;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; activeCount = %@>",
+            self.class,
+            self,
+            @(self.activeCount)];
+}
+
+@end
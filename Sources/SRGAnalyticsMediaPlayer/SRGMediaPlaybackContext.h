@@ -0,0 +1,62 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import SRGMediaPlayer;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  The maximum age of the bandwidth read from the access log, in seconds. Events recorded in a row, e.g. for a state
+ *  transition, share the same value, while heartbeats, sent at larger intervals, always read the current one.
+ */
+OBJC_EXPORT const NSTimeInterval SRGMediaPlaybackContextBandwidthMaximumAge;
+
+/**
+ *  Playback information attached to media player events, maintained incrementally from player notifications and
+ *  key-value observation so that it can be read cheaply each time an event is recorded.
+ *
+ *  @discussion Must be used from the main thread.
+ */
+@interface SRGMediaPlaybackContext : NSObject
+
+/**
+ *  Create a context for the specified controller.
+ */
+- (instancetype)initWithMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The subtitles and audio track currently selected. Resolved again only after the current item or the selection
+ *  changes.
+ */
+@property (nonatomic, readonly, nullable) AVMediaSelectionOption *subtitlesMediaOption;
+@property (nonatomic, readonly, nullable) AVMediaSelectionOption *audioTrackMediaOption;
+
+/**
+ *  The bitrate observed for the current access log entry, `nil` if unknown. The value read from the access log is shared
+ *  by events recorded within `SRGMediaPlaybackContextBandwidthMaximumAge`, unless a new entry has been added or
+ *  `-invalidateBandwidth` has been called in the meantime.
+ */
+@property (nonatomic, readonly, nullable) NSNumber *bandwidthInBitsPerSecond;
+
+/**
+ *  The player volume in percent, `nil` if there is no player or if it is muted.
+ */
+@property (nonatomic, readonly, nullable) NSNumber *volumeInPercent;
+
+/**
+ *  Read the observed bitrate from the access log when next needed.
+ */
+- (void)invalidateBandwidth;
+
+@end
+
+@interface SRGMediaPlaybackContext (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,221 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlaybackContext.h"
+
+@import libextobjc;
+@import MAKVONotificationCenter;
+
+#import <math.h>
+
+const NSTimeInterval SRGMediaPlaybackContextBandwidthMaximumAge = 1.;
+
+@interface SRGMediaPlaybackContext ()
+
+@property (nonatomic, weak) SRGMediaPlayerController *mediaPlayerController;
+
+// Player items for which cached values have been resolved. Weak, so that an item deallocated and replaced by another
+// one at the same address is never mistaken for the cached one.
+@property (nonatomic, weak) AVPlayerItem *mediaSelectionPlayerItem;
+@property (nonatomic, weak) AVPlayerItem *bandwidthPlayerItem;
+
+@property (nonatomic) AVMediaSelectionOption *cachedSubtitlesMediaOption;
+@property (nonatomic) AVMediaSelectionOption *cachedAudioTrackMediaOption;
+@property (nonatomic) NSNumber *cachedBandwidthInBitsPerSecond;
+@property (nonatomic) uint64_t bandwidthReadTime;
+
+@property (nonatomic) NSInteger outputVolumeInPercent;
+
+@end
+
+@implementation SRGMediaPlaybackContext
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
+{
+    if (self = [super init]) {
+        self.mediaPlayerController = mediaPlayerController;
+
+        [NSNotificationCenter.defaultCenter addObserver:self
+                                               selector:@selector(mediaSelectionDidChange:)
+                                                   name:SRGMediaPlayerAudioTrackDidChangeNotification
+                                                 object:mediaPlayerController];
+        [NSNotificationCenter.defaultCenter addObserver:self
+                                               selector:@selector(mediaSelectionDidChange:)
+                                                   name:SRGMediaPlayerSubtitleTrackDidChangeNotification
+                                                 object:mediaPlayerController];
+
+        // Player items are replaced over time, observe all of them and filter by current item
+        [NSNotificationCenter.defaultCenter addObserver:self
+                                               selector:@selector(newAccessLogEntry:)
+                                                   name:AVPlayerItemNewAccessLogEntryNotification
+                                                 object:nil];
+
+        // The system volume is an IPC call, keep it up to date instead of querying it for each event
+        AVAudioSession *audioSession = [AVAudioSession sharedInstance];
+        self.outputVolumeInPercent = audioSession.outputVolume * 100;
+
+        @weakify(self)
+        [audioSession addObserver:self keyPath:@keypath(audioSession.outputVolume) options:NSKeyValueObservingOptionNew block:^(MAKVONotification *notification) {
+            float outputVolume = [notification.newValue floatValue];
+            dispatch_async(dispatch_get_main_queue(), ^{
+                @strongify(self)
+                self.outputVolumeInPercent = outputVolume * 100;
+            });
+        }];
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithMediaPlayerController:SRGMediaPlayerController.new];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Getters and setters
+
+- (AVMediaSelectionOption *)subtitlesMediaOption
+{
+    [self updateMediaSelectionIfNeeded];
+    return self.cachedSubtitlesMediaOption;
+}
+
+- (AVMediaSelectionOption *)audioTrackMediaOption
+{
+    [self updateMediaSelectionIfNeeded];
+    return self.cachedAudioTrackMediaOption;
+}
+
+- (NSNumber *)bandwidthInBitsPerSecond
+{
+    AVPlayerItem *currentItem = self.currentPlayerItem;
+    if (! currentItem) {
+        return nil;
+    }
+
+    // The observed bitrate of the current entry changes over time, but the access log only provides snapshots of it
+    uint64_t currentTime = self.currentTime;
+    if (currentItem != self.bandwidthPlayerItem || currentTime - self.bandwidthReadTime > SRGMediaPlaybackContextBandwidthMaximumAge * NSEC_PER_SEC) {
+        self.cachedBandwidthInBitsPerSecond = [self observedBitrateForPlayerItem:currentItem];
+        self.bandwidthPlayerItem = currentItem;
+        self.bandwidthReadTime = currentTime;
+    }
+    return self.cachedBandwidthInBitsPerSecond;
+}
+
+- (AVPlayerItem *)currentPlayerItem
+{
+    return self.mediaPlayerController.player.currentItem;
+}
+
+- (uint64_t)currentTime
+{
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+- (NSNumber *)volumeInPercent
+{
+    // AVPlayer has a volume property, but its purpose is NOT end-user volume control (see documentation). This volume is
+    // therefore not relevant for our calculations.
+    AVPlayer *player = self.mediaPlayerController.player;
+    if (! player || player.muted) {
+        return nil;
+    }
+    // When we have a non-muted player, its volume is simply the system volume (note that this volume does not take
+    // into account the ringer status).
+    else {
+        return @(self.outputVolumeInPercent);
+    }
+}
+
+#pragma mark Media selection
+
+- (void)updateMediaSelectionIfNeeded
+{
+    AVPlayerItem *playerItem = self.mediaPlayerController.player.currentItem;
+    if (playerItem && playerItem == self.mediaSelectionPlayerItem) {
+        return;
+    }
+
+    AVAsset *asset = playerItem.asset;
+    if ([asset statusOfValueForKey:@keypath(asset.availableMediaCharacteristicsWithMediaSelectionOptions) error:NULL] == AVKeyValueStatusLoaded) {
+        self.cachedSubtitlesMediaOption = [self selectedMediaOptionForMediaCharacteristic:AVMediaCharacteristicLegible inPlayerItem:playerItem];
+        self.cachedAudioTrackMediaOption = [self selectedMediaOptionForMediaCharacteristic:AVMediaCharacteristicAudible inPlayerItem:playerItem];
+        self.mediaSelectionPlayerItem = playerItem;
+    }
+    // Not resolved yet. Try again next time.
+    else {
+        self.cachedSubtitlesMediaOption = nil;
+        self.cachedAudioTrackMediaOption = nil;
+        self.mediaSelectionPlayerItem = nil;
+    }
+}
+
+- (AVMediaSelectionOption *)selectedMediaOptionForMediaCharacteristic:(AVMediaCharacteristic)mediaCharacteristic inPlayerItem:(AVPlayerItem *)playerItem
+{
+    AVMediaSelectionGroup *group = [playerItem.asset mediaSelectionGroupForMediaCharacteristic:mediaCharacteristic];
+    return [playerItem.currentMediaSelection selectedMediaOptionInMediaSelectionGroup:group];
+}
+
+#pragma mark Bandwidth
+
+- (void)invalidateBandwidth
+{
+    self.bandwidthPlayerItem = nil;
+}
+
+// The access log only exposes its entries as an array, only read the last one
+- (NSNumber *)observedBitrateForPlayerItem:(AVPlayerItem *)playerItem
+{
+    AVPlayerItemAccessLogEvent *event = playerItem.accessLog.events.lastObject;
+    if (! event) {
+        return nil;
+    }
+
+    double observedBitrate = event.observedBitrate;
+    if (isnan(observedBitrate) || observedBitrate < 0.) {
+        return nil;
+    }
+
+    return @(observedBitrate);
+}
+
+#pragma mark Notifications
+
+- (void)mediaSelectionDidChange:(NSNotification *)notification
+{
+    self.mediaSelectionPlayerItem = nil;
+}
+
+- (void)newAccessLogEntry:(NSNotification *)notification
+{
+    // Can be received on any thread
+    AVPlayerItem *playerItem = notification.object;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (playerItem == self.currentPlayerItem) {
+            [self invalidateBandwidth];
+        }
+    });
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; mediaPlayerController = %@>",
+            self.class,
+            self,
+            self.mediaPlayerController];
+}
+
+@end
@@ -0,0 +1,100 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGMediaPlaybackDurationAccumulator.h"
+
+#include <string.h>
+
+SRGMediaPlaybackActivity SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEvent event, SRGMediaPlaybackActivity activity)
+{
+    switch (event) {
+        case SRGMediaPlaybackEventPlay: {
+            return SRGMediaPlaybackActivityPlaying;
+        }
+            
+        case SRGMediaPlaybackEventPause: {
+            return SRGMediaPlaybackActivityPaused;
+        }
+            
+        case SRGMediaPlaybackEventSeek:
+        case SRGMediaPlaybackEventBuffer: {
+            return SRGMediaPlaybackActivityBuffering;
+        }
+            
+        case SRGMediaPlaybackEventEnd:
+        case SRGMediaPlaybackEventStop: {
+            return SRGMediaPlaybackActivityIdle;
+        }
+            
+        default: {
+            return activity;
+        }
+    }
+}
+
+// Time elapsed in the current activity since it started or was last accumulated. Guards against times going backwards.
+static uint64_t SRGMediaPlaybackDurationAccumulatorElapsedTime(const SRGMediaPlaybackDurationAccumulator *accumulator, uint64_t time)
+{
+    if (accumulator->suspended || accumulator->activity == SRGMediaPlaybackActivityIdle || time < accumulator->activityStartTime) {
+        return 0;
+    }
+    return time - accumulator->activityStartTime;
+}
+
+static void SRGMediaPlaybackDurationAccumulatorAccumulate(SRGMediaPlaybackDurationAccumulator *accumulator, uint64_t time)
+{
+    accumulator->durations[accumulator->activity] += SRGMediaPlaybackDurationAccumulatorElapsedTime(accumulator, time);
+    accumulator->activityStartTime = time;
+}
+
+void SRGMediaPlaybackDurationAccumulatorInit(SRGMediaPlaybackDurationAccumulator *accumulator)
+{
+    memset(accumulator, 0, sizeof(*accumulator));
+    accumulator->activity = SRGMediaPlaybackActivityIdle;
+}
+
+SRGMediaPlaybackActivity SRGMediaPlaybackDurationAccumulatorActivity(const SRGMediaPlaybackDurationAccumulator *accumulator)
+{
+    return (SRGMediaPlaybackActivity)accumulator->activity;
+}
+
+void SRGMediaPlaybackDurationAccumulatorSetActivity(SRGMediaPlaybackDurationAccumulator *accumulator, SRGMediaPlaybackActivity activity, uint64_t time)
+{
+    SRGMediaPlaybackDurationAccumulatorAccumulate(accumulator, time);
+    accumulator->activity = (uint8_t)activity;
+    accumulator->suspended = false;
+}
+
+void SRGMediaPlaybackDurationAccumulatorSuspend(SRGMediaPlaybackDurationAccumulator *accumulator, uint64_t time)
+{
+    SRGMediaPlaybackDurationAccumulatorAccumulate(accumulator, time);
+    accumulator->suspended = true;
+}
+
+void SRGMediaPlaybackDurationAccumulatorResume(SRGMediaPlaybackDurationAccumulator *accumulator, uint64_t time)
+{
+    if (! accumulator->suspended) {
+        return;
+    }
+    
+    accumulator->suspended = false;
+    accumulator->activityStartTime = time;
+}
+
+uint64_t SRGMediaPlaybackDurationAccumulatorDuration(const SRGMediaPlaybackDurationAccumulator *accumulator, SRGMediaPlaybackActivity activity, uint64_t time)
+{
+    uint64_t duration = accumulator->durations[activity];
+    if (activity == accumulator->activity) {
+        duration += SRGMediaPlaybackDurationAccumulatorElapsedTime(accumulator, time);
+    }
+    return duration;
+}
+
+void SRGMediaPlaybackDurationAccumulatorReset(SRGMediaPlaybackDurationAccumulator *accumulator, uint64_t time)
+{
+    memset(accumulator->durations, 0, sizeof(accumulator->durations));
+    accumulator->activityStartTime = time;
+}
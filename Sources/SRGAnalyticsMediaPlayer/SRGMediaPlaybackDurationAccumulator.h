@@ -0,0 +1,87 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGMediaPlaybackDurationAccumulator_h
+#define SRGMediaPlaybackDurationAccumulator_h
+
+#include "SRGMediaPlaybackStateMachine.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Playback activities for which time is accounted.
+ */
+typedef enum {
+    SRGMediaPlaybackActivityIdle = 0,
+    SRGMediaPlaybackActivityPlaying,
+    SRGMediaPlaybackActivityBuffering,
+    SRGMediaPlaybackActivityPaused,
+    SRGMediaPlaybackActivityCount
+} SRGMediaPlaybackActivity;
+
+/**
+ *  Return the activity following a playback event, given the current activity. Events which do not affect the
+ *  playback state (position, uptime, segment) leave the activity unchanged.
+ */
+SRGMediaPlaybackActivity SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEvent event, SRGMediaPlaybackActivity activity);
+
+/**
+ *  Accumulate the time spent in each playback activity, in nanoseconds. Times are supplied by the caller and must be
+ *  read from a monotonic clock (e.g. `clock_gettime_nsec_np(CLOCK_UPTIME_RAW)`), so that wall-clock adjustments
+ *  have no effect on measured durations.
+ *
+ *  @discussion Plain value, which can be embedded in another structure or object without allocation. Not thread-safe.
+ */
+typedef struct {
+    uint8_t activity;
+    bool suspended;
+    uint64_t activityStartTime;
+    uint64_t durations[SRGMediaPlaybackActivityCount];
+} SRGMediaPlaybackDurationAccumulator;
+
+/**
+ *  Initialize an accumulator, idle with all durations set to zero.
+ */
+void SRGMediaPlaybackDurationAccumulatorInit(SRGMediaPlaybackDurationAccumulator *accumulator);
+
+/**
+ *  The current activity.
+ */
+SRGMediaPlaybackActivity SRGMediaPlaybackDurationAccumulatorActivity(const SRGMediaPlaybackDurationAccumulator *accumulator);
+
+/**
+ *  Switch to another activity at the specified time. Time spent in the previous activity is accumulated. Resumes
+ *  a suspended accumulator.
+ */
+void SRGMediaPlaybackDurationAccumulatorSetActivity(SRGMediaPlaybackDurationAccumulator *accumulator, SRGMediaPlaybackActivity activity, uint64_t time);
+
+/**
+ *  Stop accumulating time for the current activity at the specified time (e.g. when the application is suspended),
+ *  until the accumulator is resumed or the activity changes.
+ */
+void SRGMediaPlaybackDurationAccumulatorSuspend(SRGMediaPlaybackDurationAccumulator *accumulator, uint64_t time);
+void SRGMediaPlaybackDurationAccumulatorResume(SRGMediaPlaybackDurationAccumulator *accumulator, uint64_t time);
+
+/**
+ *  The total time spent in an activity at the specified time, in nanoseconds (always 0 for the idle activity).
+ */
+uint64_t SRGMediaPlaybackDurationAccumulatorDuration(const SRGMediaPlaybackDurationAccumulator *accumulator, SRGMediaPlaybackActivity activity, uint64_t time);
+
+/**
+ *  Reset all durations to zero at the specified time, keeping the current activity.
+ */
+void SRGMediaPlaybackDurationAccumulatorReset(SRGMediaPlaybackDurationAccumulator *accumulator, uint64_t time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGMediaPlaybackDurationAccumulator_h */
@@ -0,0 +1,80 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGMediaPlaybackStateMachine.h"
+
+typedef enum {
+    SRGMediaPlaybackActionDiscard = 0,
+    SRGMediaPlaybackActionAccept,               // Emit the event, which becomes the new state
+    SRGMediaPlaybackActionOpenAndAccept,        // Emit a play, then the event, which becomes the new state
+    SRGMediaPlaybackActionForward               // Emit the event, leaving the state unchanged
+} SRGMediaPlaybackAction;
+
+#define A SRGMediaPlaybackActionAccept
+#define O SRGMediaPlaybackActionOpenAndAccept
+#define F SRGMediaPlaybackActionForward
+#define _ SRGMediaPlaybackActionDiscard
+
+// Actions indexed by state (last state event) and input event. Rows for events which cannot be states are never used.
+static const uint8_t s_actions[SRGMediaPlaybackEventCount][SRGMediaPlaybackEventCount] = {
+    //                              none   play   pause  seek   buffer eof    stop   pos    uptime segment
+    [SRGMediaPlaybackEventPlay]  = { _,     _,     A,     A,     _,     A,     A,     F,     F,     F },
+    [SRGMediaPlaybackEventPause] = { _,     A,     _,     A,     _,     A,     A,     F,     F,     F },
+    [SRGMediaPlaybackEventSeek]  = { _,     A,     A,     _,     _,     A,     A,     F,     F,     F },
+    [SRGMediaPlaybackEventEnd]   = { _,     A,     _,     _,     _,     _,     _,     F,     F,     F },
+    [SRGMediaPlaybackEventStop]  = { _,     A,     O,     O,     _,     _,     _,     F,     F,     F }
+};
+
+#undef A
+#undef O
+#undef F
+#undef _
+
+#pragma mark State machine
+
+void SRGMediaPlaybackStateMachineInit(SRGMediaPlaybackStateMachine *stateMachine)
+{
+    stateMachine->lastEvent = SRGMediaPlaybackEventStop;
+}
+
+SRGMediaPlaybackEvent SRGMediaPlaybackStateMachineLastEvent(const SRGMediaPlaybackStateMachine *stateMachine)
+{
+    return (SRGMediaPlaybackEvent)stateMachine->lastEvent;
+}
+
+size_t SRGMediaPlaybackStateMachineProcessEvent(SRGMediaPlaybackStateMachine *stateMachine,
+                                                SRGMediaPlaybackEvent event,
+                                                SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount])
+{
+    if ((unsigned)event >= SRGMediaPlaybackEventCount) {
+        return 0;
+    }
+    
+    switch ((SRGMediaPlaybackAction)s_actions[stateMachine->lastEvent][event]) {
+        case SRGMediaPlaybackActionAccept: {
+            stateMachine->lastEvent = event;
+            events[0] = event;
+            return 1;
+        }
+            
+        case SRGMediaPlaybackActionOpenAndAccept: {
+            stateMachine->lastEvent = event;
+            events[0] = SRGMediaPlaybackEventPlay;
+            events[1] = event;
+            return 2;
+        }
+            
+        case SRGMediaPlaybackActionForward: {
+            events[0] = event;
+            return 1;
+        }
+            
+        case SRGMediaPlaybackActionDiscard: {
+            return 0;
+        }
+    }
+    return 0;
+}
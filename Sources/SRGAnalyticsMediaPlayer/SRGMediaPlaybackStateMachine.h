@@ -0,0 +1,89 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGMediaPlaybackStateMachine_h
+#define SRGMediaPlaybackStateMachine_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Playback events.
+ */
+typedef enum {
+    SRGMediaPlaybackEventNone = 0,
+    // State events.
+    SRGMediaPlaybackEventPlay,
+    SRGMediaPlaybackEventPause,
+    SRGMediaPlaybackEventSeek,
+    SRGMediaPlaybackEventBuffer,
+    SRGMediaPlaybackEventEnd,
+    SRGMediaPlaybackEventStop,
+    // Events emitted while a session is open, not affecting the state.
+    SRGMediaPlaybackEventPosition,
+    SRGMediaPlaybackEventUptime,
+    SRGMediaPlaybackEventSegment,
+    SRGMediaPlaybackEventCount
+} SRGMediaPlaybackEvent;
+
+/**
+ *  The maximum number of events emitted for a single input event.
+ */
+#define SRGMediaPlaybackStateMachineMaximumEventCount 2
+
+/**
+ *  State machine filtering playback events sent to Commanders Act, driven by a constant transition table. The state
+ *  is the last state event emitted, initially `SRGMediaPlaybackEventStop`:
+ *
+ *    - A session is opened with `play`, from which `pause`, `seek`, `eof` and `stop` are accepted.
+ *    - `pause` and `seek` received while no session is open (after `stop`) are preceded by a synthesized `play`.
+ *    - After `eof` or `stop`, only `play` is accepted.
+ *    - `buffer` is never emitted, position, uptime and segment events are always emitted as is.
+ *
+ *  @discussion Plain value, which can be embedded in another structure or object without allocation. Not thread-safe.
+ */
+typedef struct {
+    uint8_t lastEvent;
+} SRGMediaPlaybackStateMachine;
+
+/**
+ *  Initialize a state machine.
+ */
+void SRGMediaPlaybackStateMachineInit(SRGMediaPlaybackStateMachine *stateMachine);
+
+/**
+ *  The last state event emitted.
+ */
+SRGMediaPlaybackEvent SRGMediaPlaybackStateMachineLastEvent(const SRGMediaPlaybackStateMachine *stateMachine);
+
+/**
+ *  Process an input event, filling `events` with the events to emit, in order.
+ *
+ *  @return The number of events to emit (0 if the input event must be discarded), at most
+ *          `SRGMediaPlaybackStateMachineMaximumEventCount`.
+ */
+size_t SRGMediaPlaybackStateMachineProcessEvent(SRGMediaPlaybackStateMachine *stateMachine,
+                                                SRGMediaPlaybackEvent event,
+                                                SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount]);
+
+/**
+ *  Return `true` iff the event opens or closes a session, or changes its state.
+ */
+static inline bool SRGMediaPlaybackEventIsStateEvent(SRGMediaPlaybackEvent event)
+{
+    return event >= SRGMediaPlaybackEventPlay && event <= SRGMediaPlaybackEventStop;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGMediaPlaybackStateMachine_h */
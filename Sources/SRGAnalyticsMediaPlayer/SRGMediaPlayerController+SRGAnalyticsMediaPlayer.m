@@ -6,6 +6,7 @@
 
 #import "SRGMediaPlayerController+SRGAnalyticsMediaPlayer.h"
 
+#import "SRGComScoreMediaPlayerTracker.h"
 #import "SRGMediaAnalytics.h"
 #import "SRGMediaPlayerTracker.h"
 
@@ -120,6 +121,13 @@ withAnalyticsLabels:(SRGAnalyticsStreamLabels *)analyticsLabels
     [self playURLAsset:URLAsset atIndex:index position:position inSegments:segments withUserInfo:fullUserInfo];
 }
 
+#pragma mark Measurement preparation
+
+- (void)prepareAnalyticsForNextItemWithLabels:(SRGAnalyticsStreamLabels *)analyticsLabels
+{
+    [SRGComScoreMediaPlayerTracker prewarmStreamingAnalyticsForMediaPlayerController:self withLabels:analyticsLabels];
+}
+
 #pragma mark Getters and setters
 
 - (BOOL)isTracked
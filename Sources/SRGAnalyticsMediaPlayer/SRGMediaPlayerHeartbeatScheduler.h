@@ -0,0 +1,75 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Number of slots in the heartbeat timing wheel. Heartbeat phases are quantized to `interval / slot count`.
+ */
+OBJC_EXPORT const NSUInteger SRGMediaPlayerHeartbeatSchedulerSlotCount;
+
+/**
+ *  Protocol for objects receiving heartbeats.
+ */
+@protocol SRGMediaPlayerHeartbeatTarget <NSObject>
+
+- (void)heartbeat;
+
+@end
+
+/**
+ *  Timing wheel driving the heartbeats of any number of targets from a single timer. The interval is split into
+ *  `SRGMediaPlayerHeartbeatSchedulerSlotCount` slots, and each target is assigned to the slot following the time at
+ *  which it was added. Targets sharing a slot receive their heartbeats together, with all events they record submitted
+ *  as a single batch. The timer only wakes up for occupied slots and is stopped when no target remains.
+ *
+ *  @discussion Targets are weakly referenced. A target first receives a heartbeat at least `interval` after being
+ *              added, then every `interval` with no drift. Must be used from the main thread, on which heartbeats
+ *              are delivered.
+ */
+@interface SRGMediaPlayerHeartbeatScheduler : NSObject
+
+/**
+ *  Create a scheduler with the specified heartbeat interval.
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The heartbeat interval.
+ */
+@property (nonatomic, readonly) NSTimeInterval interval;
+
+/**
+ *  Add a target. Does nothing if the target has already been added.
+ */
+- (void)addTarget:(id<SRGMediaPlayerHeartbeatTarget>)target;
+
+/**
+ *  Remove a target. Safe to call from the target `-dealloc`.
+ */
+- (void)removeTarget:(id<SRGMediaPlayerHeartbeatTarget>)target;
+
+/**
+ *  Return `YES` iff the target has been added.
+ */
+- (BOOL)containsTarget:(id<SRGMediaPlayerHeartbeatTarget>)target;
+
+/**
+ *  The number of targets currently scheduled.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+@end
+
+@interface SRGMediaPlayerHeartbeatScheduler (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
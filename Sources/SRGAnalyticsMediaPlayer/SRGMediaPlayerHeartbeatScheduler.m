@@ -0,0 +1,273 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerHeartbeatScheduler.h"
+
+#import "SRGAnalyticsMetrics+Private.h"
+#import "SRGAnalyticsTracker+Private.h"
+
+#import <time.h>
+
+#define SLOT_COUNT 10
+
+const NSUInteger SRGMediaPlayerHeartbeatSchedulerSlotCount = SLOT_COUNT;
+
+_Static_assert(SLOT_COUNT <= 32, "Occupied slots are stored as a 32-bit mask");
+
+@interface SRGMediaPlayerHeartbeatEntry : NSObject
+
+@property (nonatomic, weak) id<SRGMediaPlayerHeartbeatTarget> target;
+@property (nonatomic) const void *targetAddress;            // Identity only, never dereferenced
+@property (nonatomic) uint64_t dueTick;
+
+@end
+
+@implementation SRGMediaPlayerHeartbeatEntry
+
+@end
+
+@interface SRGMediaPlayerHeartbeatScheduler () {
+@private
+    NSMutableArray<SRGMediaPlayerHeartbeatEntry *> *_slots[SLOT_COUNT];
+    uint32_t _occupiedSlotsMask;
+    NSUInteger _count;
+
+    uint64_t _originTime;
+    uint64_t _tickDuration;
+    uint64_t _armedTick;
+}
+
+@property (nonatomic) NSTimeInterval interval;
+@property (nonatomic) dispatch_source_t timer;
+
+@end
+
+@implementation SRGMediaPlayerHeartbeatScheduler
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+{
+    NSParameterAssert(interval > 0.);
+
+    if (self = [super init]) {
+        self.interval = interval;
+        for (NSUInteger i = 0; i < SLOT_COUNT; ++i) {
+            _slots[i] = [NSMutableArray array];
+        }
+        _originTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+        _tickDuration = MAX((uint64_t)(interval * NSEC_PER_SEC) / SLOT_COUNT, 1);
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return [self initWithInterval:1.];
+}
+
+#pragma clang diagnostic pop
+
+- (void)dealloc
+{
+    self.timer = nil;
+}
+
+#pragma mark Getters and setters
+
+- (void)setTimer:(dispatch_source_t)timer
+{
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+    }
+    _timer = timer;
+}
+
+- (NSUInteger)count
+{
+    return _count;
+}
+
+#pragma mark Targets
+
+- (void)addTarget:(id<SRGMediaPlayerHeartbeatTarget>)target
+{
+    NSParameterAssert(target);
+    NSAssert(NSThread.isMainThread, @"Must be called from the main thread");
+
+    if ([self entryForTarget:target]) {
+        return;
+    }
+
+    // Start at the next slot boundary, so that the first heartbeat is never received earlier than one interval later
+    SRGMediaPlayerHeartbeatEntry *entry = [[SRGMediaPlayerHeartbeatEntry alloc] init];
+    entry.target = target;
+    entry.targetAddress = (__bridge const void *)target;
+    entry.dueTick = [self currentTick] + 1 + SLOT_COUNT;
+
+    NSUInteger slot = entry.dueTick % SLOT_COUNT;
+    [_slots[slot] addObject:entry];
+    _occupiedSlotsMask |= (1U << slot);
+
+    _count += 1;
+    [self updateTimer];
+}
+
+- (void)removeTarget:(id<SRGMediaPlayerHeartbeatTarget>)target
+{
+    NSParameterAssert(target);
+    NSAssert(NSThread.isMainThread, @"Must be called from the main thread");
+
+    SRGMediaPlayerHeartbeatEntry *entry = [self entryForTarget:target];
+    if (! entry) {
+        return;
+    }
+
+    [self removeEntry:entry];
+    [self updateTimer];
+}
+
+- (BOOL)containsTarget:(id<SRGMediaPlayerHeartbeatTarget>)target
+{
+    return [self entryForTarget:target] != nil;
+}
+
+// Match by address, since weak references are already cleared when a target is removed during deallocation. Only
+// a few players are usually active at the same time, a linear search is therefore sufficient.
+- (SRGMediaPlayerHeartbeatEntry *)entryForTarget:(id<SRGMediaPlayerHeartbeatTarget>)target
+{
+    const void *targetAddress = (__bridge const void *)target;
+    uint32_t mask = _occupiedSlotsMask;
+    while (mask != 0) {
+        NSUInteger slot = __builtin_ctz(mask);
+        for (SRGMediaPlayerHeartbeatEntry *entry in _slots[slot]) {
+            if (entry.targetAddress == targetAddress) {
+                return entry;
+            }
+        }
+        mask &= mask - 1;
+    }
+    return nil;
+}
+
+- (void)removeEntry:(SRGMediaPlayerHeartbeatEntry *)entry
+{
+    NSUInteger slot = entry.dueTick % SLOT_COUNT;
+    [_slots[slot] removeObjectIdenticalTo:entry];
+    _count -= 1;
+    if (_slots[slot].count == 0) {
+        _occupiedSlotsMask &= ~(1U << slot);
+    }
+}
+
+#pragma mark Timer
+
+- (uint64_t)currentTick
+{
+    return (clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - _originTime) / _tickDuration;
+}
+
+- (void)updateTimer
+{
+    if (_occupiedSlotsMask == 0) {
+        self.timer = nil;
+        return;
+    }
+
+    uint64_t nextTick = UINT64_MAX;
+    uint32_t mask = _occupiedSlotsMask;
+    while (mask != 0) {
+        NSUInteger slot = __builtin_ctz(mask);
+        for (SRGMediaPlayerHeartbeatEntry *entry in _slots[slot]) {
+            nextTick = MIN(nextTick, entry.dueTick);
+        }
+        mask &= mask - 1;
+    }
+
+    if (self.timer && nextTick == _armedTick) {
+        return;
+    }
+
+    if (! self.timer) {
+        self.timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_main_queue());
+
+        __weak __typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(self.timer, ^{
+            [weakSelf fire];
+        });
+        dispatch_resume(self.timer);
+    }
+
+    // The leeway is kept small with respect to the slot duration so that heartbeat phases remain accurate
+    uint64_t now = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    uint64_t fireTime = _originTime + nextTick * _tickDuration;
+    int64_t delay = (fireTime > now) ? (int64_t)(fireTime - now) : 0;
+    dispatch_source_set_timer(self.timer, dispatch_time(DISPATCH_TIME_NOW, delay), DISPATCH_TIME_FOREVER, _tickDuration / 10);
+    _armedTick = nextTick;
+}
+
+- (void)fire
+{
+    SRGAnalyticsMetricsRecordHeartbeatTimerWakeUp();
+    
+    uint64_t tick = [self currentTick];
+
+    NSMutableArray<id<SRGMediaPlayerHeartbeatTarget>> *targets = [NSMutableArray array];
+    uint32_t mask = _occupiedSlotsMask;
+    while (mask != 0) {
+        NSUInteger slot = __builtin_ctz(mask);
+        for (SRGMediaPlayerHeartbeatEntry *entry in _slots[slot].copy) {
+            if (entry.dueTick > tick) {
+                continue;
+            }
+
+            // Purge entries whose target vanished without being removed
+            id<SRGMediaPlayerHeartbeatTarget> target = entry.target;
+            if (! target) {
+                [self removeEntry:entry];
+                continue;
+            }
+
+            [targets addObject:target];
+
+            // Skip heartbeats missed while the timer could not fire (e.g. device asleep), keeping the same phase
+            entry.dueTick += SLOT_COUNT * ((tick - entry.dueTick) / SLOT_COUNT + 1);
+        }
+        mask &= mask - 1;
+    }
+
+    if (targets.count != 0) {
+        [SRGAnalyticsTracker.sharedTracker recordEventsInBatch:^{
+            for (id<SRGMediaPlayerHeartbeatTarget> target in targets) {
+                // A heartbeat might remove other targets
+                if ([self containsTarget:target]) {
+                    [target heartbeat];
+                }
+            }
+        }];
+    }
+
+    // Ensures the timer is re-armed
+    _armedTick = UINT64_MAX;
+    [self updateTimer];
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; interval = %@; count = %@>",
+            self.class,
+            self,
+            @(self.interval),
+            @(self.count)];
+}
+
+@end
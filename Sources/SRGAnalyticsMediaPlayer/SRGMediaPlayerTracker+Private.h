@@ -0,0 +1,27 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerTracker.h"
+
+@import SRGMediaPlayer;
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SRGMediaPlayerTracker (Private)
+
+/**
+ *  Record the event corresponding to a playback state, provided the transition from the last recorded event is valid.
+ */
+- (void)recordEventForPlaybackState:(SRGMediaPlayerPlaybackState)playbackState
+                     withStreamType:(SRGMediaPlayerStreamType)streamType
+                               time:(CMTime)time
+                          timeshift:(nullable NSNumber *)timeshift
+                    analyticsLabels:(nullable NSDictionary<NSString *, NSString *> *)analyticsLabels
+                           userInfo:(nullable NSDictionary *)userInfo;
+
+@end
+
+NS_ASSUME_NONNULL_END
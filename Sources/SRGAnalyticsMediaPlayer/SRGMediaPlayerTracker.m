@@ -4,51 +4,60 @@
 //  License information is available from the LICENSE file.
 //
 
-#import "SRGMediaPlayerTracker.h"
+#import "SRGMediaPlayerTracker+Private.h"
 
 #import "NSMutableDictionary+SRGAnalytics.h"
+#import "SRGAnalyticsDeltaEncoder.h"
 #import "SRGAnalyticsLabels+Private.h"
 #import "SRGAnalyticsMediaPlayerLogger.h"
+#import "SRGAnalyticsMetrics+Private.h"
 #import "SRGAnalyticsTracker+Private.h"
 #import "SRGMediaAnalytics.h"
+#import "SRGMediaPlaybackContext.h"
+#import "SRGMediaPlaybackDurationAccumulator.h"
 #import "SRGMediaPlayerController+SRGAnalyticsMediaPlayer.h"
+#import "SRGMediaPlayerHeartbeatScheduler.h"
+#import "SRGMediaPlayerTrackerRegistry.h"
 
 @import libextobjc;
 @import MAKVONotificationCenter;
 
 #import <math.h>
-
-typedef NSString * MediaPlayerTrackerEvent NS_TYPED_ENUM;
-
-static MediaPlayerTrackerEvent const MediaPlayerTrackerEventPlay = @"play";
-static MediaPlayerTrackerEvent const MediaPlayerTrackerEventPause = @"pause";
-static MediaPlayerTrackerEvent const MediaPlayerTrackerEventSeek = @"seek";
-static MediaPlayerTrackerEvent const MediaPlayerTrackerEventEnd = @"eof";
-static MediaPlayerTrackerEvent const MediaPlayerTrackerEventStop = @"stop";
-static MediaPlayerTrackerEvent const MediaPlayerTrackerEventPosition = @"pos";
-static MediaPlayerTrackerEvent const MediaPlayerTrackerEventUptime = @"uptime";
-static MediaPlayerTrackerEvent const MediaPlayerTrackerEventSegment = @"segment";
-
-static NSMutableDictionary<NSValue *, SRGMediaPlayerTracker *> *s_trackers = nil;
+#import <time.h>
+
+// Names under which events are sent to Commanders Act
+static NSString * const SRGMediaPlayerTrackerEventNames[SRGMediaPlaybackEventCount] = {
+    [SRGMediaPlaybackEventPlay] = @"play",
+    [SRGMediaPlaybackEventPause] = @"pause",
+    [SRGMediaPlaybackEventSeek] = @"seek",
+    [SRGMediaPlaybackEventEnd] = @"eof",
+    [SRGMediaPlaybackEventStop] = @"stop",
+    [SRGMediaPlaybackEventPosition] = @"pos",
+    [SRGMediaPlaybackEventUptime] = @"uptime",
+    [SRGMediaPlaybackEventSegment] = @"segment"
+};
 
 static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSelectionReason reason);
+static uint64_t SRGMediaPlayerTrackerCurrentTime(void);
+static SRGMediaPlayerHeartbeatScheduler *SRGMediaPlayerTrackerHeartbeatScheduler(void);
 
-@interface SRGMediaPlayerTracker ()
+@interface SRGMediaPlayerTracker () <SRGMediaPlayerHeartbeatTarget> {
+@private
+    SRGMediaPlaybackStateMachine _stateMachine;
+    SRGMediaPlaybackDurationAccumulator _durationAccumulator;
+}
 
 @property (nonatomic, weak) SRGMediaPlayerController *mediaPlayerController;
+@property (nonatomic) SRGMediaPlaybackContext *playbackContext;
 
-@property (nonatomic) NSTimeInterval playbackDuration;
-@property (nonatomic) NSDate *previousPlaybackDurationUpdateDate;
-
-@property (nonatomic) NSTimer *heartbeatTimer;
 @property (nonatomic) NSUInteger heartbeatCount;
-
-@property (nonatomic, copy) MediaPlayerTrackerEvent lastEvent;
+@property (nonatomic) NSUInteger totalHeartbeatCount;           // Over the whole tracker lifetime
 
 @property (nonatomic) AVMediaSelectionOption *lastSubtitlesMediaOption;
 @property (nonatomic) AVMediaSelectionOption *lastAudioTrackMediaOption;
 
 @property (nonatomic, copy) NSString *unitTestingIdentifier;
+@property (nonatomic) SRGAnalyticsDeltaEncoder *deltaEncoder;
 
 @end
 
@@ -60,14 +69,20 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
 {
     if (self = [super init]) {
         SRGAnalyticsStreamLabels *mainLabels = mediaPlayerController.userInfo[SRGAnalyticsMediaPlayerLabelsKey];
-        if (mainLabels.labelsDictionary.count == 0) {
+        if (mainLabels.labelStore.count == 0) {
             return nil;
         }
         
         self.mediaPlayerController = mediaPlayerController;
-        self.lastEvent = MediaPlayerTrackerEventStop;
+        self.playbackContext = [[SRGMediaPlaybackContext alloc] initWithMediaPlayerController:mediaPlayerController];
+        SRGMediaPlaybackStateMachineInit(&_stateMachine);
+        SRGMediaPlaybackDurationAccumulatorInit(&_durationAccumulator);
         self.unitTestingIdentifier = SRGAnalyticsUnitTestingIdentifier();
         
+        if (SRGAnalyticsTracker.sharedTracker.configuration.mediaHeartbeatDeltaEncodingEnabled) {
+            self.deltaEncoder = [[SRGAnalyticsDeltaEncoder alloc] init];
+        }
+        
         [NSNotificationCenter.defaultCenter addObserver:self
                                                selector:@selector(playbackStateDidChange:)
                                                    name:SRGMediaPlayerPlaybackStateDidChangeNotification
@@ -76,6 +91,14 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
                                                selector:@selector(segmentDidStart:)
                                                    name:SRGMediaPlayerSegmentDidStartNotification
                                                  object:mediaPlayerController];
+        [NSNotificationCenter.defaultCenter addObserver:self
+                                               selector:@selector(applicationDidEnterBackground:)
+                                                   name:UIApplicationDidEnterBackgroundNotification
+                                                 object:nil];
+        [NSNotificationCenter.defaultCenter addObserver:self
+                                               selector:@selector(applicationWillEnterForeground:)
+                                                   name:UIApplicationWillEnterForegroundNotification
+                                                 object:nil];
         
         @weakify(self)
         [mediaPlayerController addObserver:self keyPath:@keypath(SRGMediaPlayerController.new, tracked) options:0 block:^(MAKVONotification *notification) {
@@ -91,7 +114,7 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
                                          userInfo:mediaPlayerController.userInfo];
             }
             else {
-                [self recordEvent:MediaPlayerTrackerEventStop
+                [self recordEvent:SRGMediaPlaybackEventStop
                    withStreamType:mediaPlayerController.streamType
                              time:mediaPlayerController.currentTime
                         timeshift:SRGMediaAnalyticsPlayerTimeshiftInMilliseconds(mediaPlayerController)
@@ -114,19 +137,12 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
 
 - (void)dealloc
 {
-    self.heartbeatTimer = nil;      // Invalidate timer
+    [SRGMediaPlayerTrackerHeartbeatScheduler() removeTarget:self];
+    SRGAnalyticsMetricsRecordMediaPlayerTrackerHeartbeats(_totalHeartbeatCount);
 }
 
 #pragma clang diagnostic pop
 
-#pragma mark Getters and setters
-
-- (void)setHeartbeatTimer:(NSTimer *)heartbeatTimer
-{
-    [_heartbeatTimer invalidate];
-    _heartbeatTimer = heartbeatTimer;
-}
-
 #pragma mark Tracking
 
 - (void)recordEventForPlaybackState:(SRGMediaPlayerPlaybackState)playbackState
@@ -136,75 +152,56 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
                     analyticsLabels:(NSDictionary<NSString *, NSString *> *)analyticsLabels
                            userInfo:(NSDictionary *)userInfo
 {
-    static dispatch_once_t s_onceToken;
-    static NSDictionary<NSNumber *, NSString *> *s_events;
-    dispatch_once(&s_onceToken, ^{
-        s_events = @{ @(SRGMediaPlayerPlaybackStateIdle) : MediaPlayerTrackerEventStop,
-                      @(SRGMediaPlayerPlaybackStatePlaying) : MediaPlayerTrackerEventPlay,
-                      @(SRGMediaPlayerPlaybackStateSeeking) : MediaPlayerTrackerEventSeek,
-                      @(SRGMediaPlayerPlaybackStatePaused) : MediaPlayerTrackerEventPause,
-                      @(SRGMediaPlayerPlaybackStateEnded) : MediaPlayerTrackerEventEnd };
-    });
-    
-    NSString *event = s_events[@(playbackState)];
-    if (! event) {
+    SRGMediaPlaybackEvent event = SRGMediaAnalyticsEventForPlaybackState(playbackState);
+    if (event == SRGMediaPlaybackEventNone) {
         return;
     }
     
     [self recordEvent:event withStreamType:streamType time:time timeshift:timeshift analyticsLabels:analyticsLabels userInfo:userInfo];
 }
 
-- (void)recordEvent:(MediaPlayerTrackerEvent)event
+- (void)recordEvent:(SRGMediaPlaybackEvent)event
      withStreamType:(SRGMediaPlayerStreamType)streamType
                time:(CMTime)time
           timeshift:(NSNumber *)timeshift
     analyticsLabels:(NSDictionary<NSString *, NSString *> *)analyticsLabels
            userInfo:(NSDictionary *)userInfo
 {
-    NSAssert(event.length != 0, @"An event is required");
-    
-    // Ensure a play is emitted before events requiring a session to be opened (the Commanders Act SDK does not open sessions
-    // automatically)
-    if ([self.lastEvent isEqualToString:MediaPlayerTrackerEventStop] && ([event isEqualToString:MediaPlayerTrackerEventPause] || [event isEqualToString:MediaPlayerTrackerEventSeek])) {
-        [self recordEvent:MediaPlayerTrackerEventPlay withStreamType:streamType time:time timeshift:timeshift analyticsLabels:analyticsLabels userInfo:userInfo];
+    NSAssert(event != SRGMediaPlaybackEventNone, @"An event is required");
+    
+    // All input events are accounted for, including those discarded by the state machine (e.g. stalls)
+    SRGMediaPlaybackActivity activity = SRGMediaPlaybackActivityForEvent(event, SRGMediaPlaybackDurationAccumulatorActivity(&_durationAccumulator));
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&_durationAccumulator, activity, SRGMediaPlayerTrackerCurrentTime());
+    
+    // The state machine discards invalid transitions and emits a play before events requiring a session to be opened
+    // (the Commanders Act SDK does not open sessions automatically)
+    SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+    size_t eventCount = SRGMediaPlaybackStateMachineProcessEvent(&_stateMachine, event, events);
+    for (size_t i = 0; i < eventCount; ++i) {
+        [self sendEvent:events[i] withStreamType:streamType time:time timeshift:timeshift analyticsLabels:analyticsLabels userInfo:userInfo];
     }
-    
-    if (! [event isEqualToString:MediaPlayerTrackerEventPosition] && ! [event isEqualToString:MediaPlayerTrackerEventUptime] && ! [event isEqualToString:MediaPlayerTrackerEventSegment]) {
-        static dispatch_once_t s_onceToken;
-        static NSDictionary<NSString *, NSArray<NSString *> *> *s_transitions;
-        dispatch_once(&s_onceToken, ^{
-            s_transitions = @{ MediaPlayerTrackerEventPlay : @[ MediaPlayerTrackerEventPause, MediaPlayerTrackerEventSeek, MediaPlayerTrackerEventStop, MediaPlayerTrackerEventEnd ],
-                               MediaPlayerTrackerEventPause : @[ MediaPlayerTrackerEventPlay, MediaPlayerTrackerEventSeek, MediaPlayerTrackerEventStop, MediaPlayerTrackerEventEnd ],
-                               MediaPlayerTrackerEventSeek : @[ MediaPlayerTrackerEventPlay, MediaPlayerTrackerEventPause, MediaPlayerTrackerEventStop, MediaPlayerTrackerEventEnd ],
-                               MediaPlayerTrackerEventStop : @[ MediaPlayerTrackerEventPlay ],
-                               MediaPlayerTrackerEventEnd : @[ MediaPlayerTrackerEventPlay ] };
-        });
-        
-        if (! [s_transitions[self.lastEvent] containsObject:event]) {
-            return;
-        }
-        
-        self.lastEvent = event;
-        
-        // Restore the heartbeat timer when transitioning to play again. We can use a simple `NSTimer` here since
-        // it needs to run while playing content (even in background), but will otherwise be inactive.
-        if ([event isEqualToString:MediaPlayerTrackerEventPlay]) {
-            if (! self.heartbeatTimer) {
-                SRGAnalyticsConfiguration *configuration = SRGAnalyticsTracker.sharedTracker.configuration;
-                NSTimeInterval heartbeatInterval = configuration.unitTesting ? 3. : 30.;
-                self.heartbeatTimer = [NSTimer scheduledTimerWithTimeInterval:heartbeatInterval
-                                                                       target:self
-                                                                     selector:@selector(heartbeat:)
-                                                                     userInfo:nil
-                                                                      repeats:YES];
-                // Use the recommended 10% tolerance as default, see `tolerance` documentation
-                self.heartbeatTimer.tolerance = heartbeatInterval / 10.;
+}
+
+- (void)sendEvent:(SRGMediaPlaybackEvent)event
+   withStreamType:(SRGMediaPlayerStreamType)streamType
+             time:(CMTime)time
+        timeshift:(NSNumber *)timeshift
+  analyticsLabels:(NSDictionary<NSString *, NSString *> *)analyticsLabels
+         userInfo:(NSDictionary *)userInfo
+{
+    // Restore heartbeats when transitioning to play again. Heartbeats of all trackers are driven by a shared
+    // scheduler, so that concurrent players do not each wake up the main thread.
+    if (SRGMediaPlaybackEventIsStateEvent(event)) {
+        SRGMediaPlayerHeartbeatScheduler *heartbeatScheduler = SRGMediaPlayerTrackerHeartbeatScheduler();
+        if (event == SRGMediaPlaybackEventPlay) {
+            if (! [heartbeatScheduler containsTarget:self]) {
+                [heartbeatScheduler addTarget:self];
                 self.heartbeatCount = 0;
             }
         }
         // Remove the heartbeat when not playing
         else {
-            self.heartbeatTimer = nil;
+            [heartbeatScheduler removeTarget:self];
         }
     }
     
@@ -213,14 +210,26 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
     [labels srg_safelySetString:self.mediaPlayerController.analyticsPlayerName forKey:@"media_player_display"];
     [labels srg_safelySetString:self.mediaPlayerController.analyticsPlayerVersion forKey:@"media_player_version"];
     
-    // Use current duration as media position for livestreams, raw position otherwise
-    NSTimeInterval mediaPosition = SRGMediaAnalyticsIsLiveStreamType(streamType) ? [self updatedPlaybackDurationWithEvent:event] : SRGMediaAnalyticsCMTimeToMilliseconds(time);
-    [labels srg_safelySetString:@(round(mediaPosition / 1000)).stringValue forKey:@"media_position"];
+    // Use time played since the session was opened as media position for livestreams, raw position otherwise
+    NSInteger mediaPosition = 0;
+    if (SRGMediaAnalyticsIsLiveStreamType(streamType)) {
+        uint64_t playedDuration = SRGMediaPlaybackDurationAccumulatorDuration(&_durationAccumulator, SRGMediaPlaybackActivityPlaying, SRGMediaPlayerTrackerCurrentTime());
+        mediaPosition = (NSInteger)round((double)playedDuration / NSEC_PER_SEC);
+    }
+    else {
+        mediaPosition = (NSInteger)round(SRGMediaAnalyticsCMTimeToMilliseconds(time) / 1000.);
+    }
+    [labels srg_safelySetString:@(mediaPosition).stringValue forKey:@"media_position"];
+    
+    if (event == SRGMediaPlaybackEventStop || event == SRGMediaPlaybackEventEnd) {
+        SRGMediaPlaybackDurationAccumulatorReset(&_durationAccumulator, SRGMediaPlayerTrackerCurrentTime());
+    }
     
-    [labels srg_safelySetString:self.playerVolumeInPercent.stringValue ?: @"0" forKey:@"media_volume"];
+    SRGMediaPlaybackContext *playbackContext = self.playbackContext;
+    [labels srg_safelySetString:playbackContext.volumeInPercent.stringValue ?: @"0" forKey:@"media_volume"];
     
-    if (! [event isEqualToString:MediaPlayerTrackerEventStop]) {
-        self.lastSubtitlesMediaOption = [self selectedMediaOptionForMediaCharacteristic:AVMediaCharacteristicLegible];
+    if (event != SRGMediaPlaybackEventStop) {
+        self.lastSubtitlesMediaOption = playbackContext.subtitlesMediaOption;
     }
     [labels srg_safelySetString:self.lastSubtitlesMediaOption != nil ? @"true" : @"false" forKey:@"media_subtitles_on"];
     if (self.lastSubtitlesMediaOption) {
@@ -228,8 +237,8 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
         [labels srg_safelySetString:subtitlesLanguageCode.uppercaseString forKey:@"media_subtitle_selection"];
     }
     
-    if (! [event isEqualToString:MediaPlayerTrackerEventStop]) {
-        self.lastAudioTrackMediaOption = [self selectedMediaOptionForMediaCharacteristic:AVMediaCharacteristicAudible];
+    if (event != SRGMediaPlaybackEventStop) {
+        self.lastAudioTrackMediaOption = playbackContext.audioTrackMediaOption;
     }
     if (self.lastAudioTrackMediaOption) {
         NSString *audioTrackLanguageCode = [self.lastAudioTrackMediaOption.locale objectForKey:NSLocaleLanguageCode] ?: @"und";
@@ -239,7 +248,7 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
         [labels srg_safelySetString:audioDescribed ? @"true" : @"false" forKey:@"media_audiodescription_on"];
     }
     
-    [labels srg_safelySetString:self.bandwidthInBitsPerSecond.stringValue forKey:@"media_bandwidth"];
+    [labels srg_safelySetString:playbackContext.bandwidthInBitsPerSecond.stringValue forKey:@"media_bandwidth"];
     [labels srg_safelySetString:self.playbackRate.stringValue forKey:@"media_playback_rate"];
     
     if (timeshift) {
@@ -251,90 +260,23 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
     }
     
     SRGAnalyticsStreamLabels *mainLabels = userInfo[SRGAnalyticsMediaPlayerLabelsKey];
-    [labels addEntriesFromDictionary:mainLabels.labelsDictionary];
+    [mainLabels.labelStore addEntriesToDictionary:labels];
     
     if (SRGAnalyticsTracker.sharedTracker.configuration.unitTesting) {
         [labels srg_safelySetString:self.unitTestingIdentifier forKey:@"srg_test_id"];
     }
     
-    [SRGAnalyticsTracker.sharedTracker sendCommandersActCustomEventWithName:event labels:labels.copy];
-}
-
-#pragma mark Heartbeats
-
-- (NSTimeInterval)updatedPlaybackDurationWithEvent:(MediaPlayerTrackerEvent)event
-{
-    if (self.previousPlaybackDurationUpdateDate) {
-        self.playbackDuration -= [self.previousPlaybackDurationUpdateDate timeIntervalSinceNow] * 1000.;
-    }
-    
-    if ([event isEqualToString:MediaPlayerTrackerEventPlay] || [event isEqualToString:MediaPlayerTrackerEventPosition] || [event isEqualToString:MediaPlayerTrackerEventUptime]) {
-        self.previousPlaybackDurationUpdateDate = NSDate.date;
-    }
-    else {
-        self.previousPlaybackDurationUpdateDate = nil;
-    }
-    
-    NSTimeInterval playbackDuration = self.playbackDuration;
-    
-    if ([event isEqualToString:MediaPlayerTrackerEventStop] || [event isEqualToString:MediaPlayerTrackerEventEnd]) {
-        self.playbackDuration = 0;
-    }
-    
-    return playbackDuration;
+    // Only heartbeats are delta-encoded (when enabled), so that session boundaries and state changes are always
+    // received with all labels
+    BOOL heartbeat = (event == SRGMediaPlaybackEventPosition || event == SRGMediaPlaybackEventUptime);
+    [SRGAnalyticsTracker.sharedTracker sendCommandersActCustomEventWithName:SRGMediaPlayerTrackerEventNames[event]
+                                                                     labels:labels.copy
+                                                               deltaEncoder:self.deltaEncoder
+                                                                   keyFrame:! heartbeat];
 }
 
 #pragma mark Playback information
 
-- (NSNumber *)bandwidthInBitsPerSecond
-{
-    AVPlayerItem *currentItem = self.mediaPlayerController.player.currentItem;
-    if (! currentItem) {
-        return nil;
-    }
-    
-    NSArray<AVPlayerItemAccessLogEvent *> *events = currentItem.accessLog.events;
-    if (! events.lastObject) {
-        return nil;
-    }
-    
-    double observedBitrate = events.lastObject.observedBitrate;
-    if (isnan(observedBitrate) || observedBitrate < 0.) {
-        return nil;
-    }
-    
-    return @(observedBitrate);
-}
-
-- (NSNumber *)playerVolumeInPercent
-{
-    // AVPlayer has a volume property, but its purpose is NOT end-user volume control (see documentation). This volume is
-    // therefore not relevant for our calculations.
-    AVPlayer *player = self.mediaPlayerController.player;
-    if (! player || player.muted) {
-        return nil;
-    }
-    // When we have a non-muted player, its volume is simply the system volume (note that this volume does not take
-    // into account the ringer status).
-    else {
-        NSInteger volume = [AVAudioSession sharedInstance].outputVolume * 100;
-        return @(volume);
-    }
-}
-
-- (AVMediaSelectionOption *)selectedMediaOptionForMediaCharacteristic:(AVMediaCharacteristic)mediaCharacteristic
-{
-    AVPlayerItem *playerItem = self.mediaPlayerController.player.currentItem;
-    AVAsset *asset = playerItem.asset;
-    if ([asset statusOfValueForKey:@keypath(asset.availableMediaCharacteristicsWithMediaSelectionOptions) error:NULL] == AVKeyValueStatusLoaded) {
-        AVMediaSelectionGroup *legibleGroup = [playerItem.asset mediaSelectionGroupForMediaCharacteristic:mediaCharacteristic];
-        return [playerItem.currentMediaSelection selectedMediaOptionInMediaSelectionGroup:legibleGroup];
-    }
-    else {
-        return nil;
-    }
-}
-
 - (NSNumber *)playbackRate
 {
     return @(self.mediaPlayerController.effectivePlaybackRate);
@@ -344,14 +286,19 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
 
 + (void)playbackStateDidChange:(NSNotification *)notification
 {
+    // Trackers are only attached and detached when preparing or returning to idle
+    SRGMediaPlayerPlaybackState playbackState = [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue];
+    if (playbackState != SRGMediaPlayerPlaybackStatePreparing && playbackState != SRGMediaPlayerPlaybackStateIdle) {
+        return;
+    }
+    
     if (! SRGAnalyticsTracker.sharedTracker.configuration) {
         return;
     }
     
     SRGMediaPlayerController *mediaPlayerController = notification.object;
-    NSValue *key = [NSValue valueWithNonretainedObject:mediaPlayerController];
+    SRGMediaPlayerTrackerRegistry *registry = SRGMediaPlayerTrackerRegistry.sharedRegistry;
     
-    SRGMediaPlayerPlaybackState playbackState = [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue];
     SRGMediaPlayerPlaybackState previousPlaybackState = [notification.userInfo[SRGMediaPlayerPreviousPlaybackStateKey] integerValue];
     
     // Always attach a tracker to a the player controller, whether or not it is actually tracked (otherwise we would
@@ -359,13 +306,13 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
     if (playbackState == SRGMediaPlayerPlaybackStatePreparing) {
         SRGMediaPlayerTracker *tracker = [[SRGMediaPlayerTracker alloc] initWithMediaPlayerController:mediaPlayerController];
         if (tracker) {
-            s_trackers[key] = tracker;
+            [registry setTracker:tracker ofKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
         
-            SRGAnalyticsMediaPlayerLogInfo(@"tracker", @"Started tracking for %@", key);
+            SRGAnalyticsMediaPlayerLogInfo(@"tracker", @"Started tracking for %p", mediaPlayerController);
         }
     }
     else if (playbackState == SRGMediaPlayerPlaybackStateIdle) {
-        SRGMediaPlayerTracker *tracker = s_trackers[key];
+        SRGMediaPlayerTracker *tracker = [registry removeTrackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
         if (tracker) {
             if (previousPlaybackState != SRGMediaPlayerPlaybackStatePreparing) {
                 SRGMediaPlayerStreamType streamType = [notification.userInfo[SRGMediaPlayerPreviousStreamTypeKey] integerValue];
@@ -374,16 +321,14 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
                                                                                [notification.userInfo[SRGMediaPlayerPreviousTimeRangeKey] CMTimeRangeValue],
                                                                                [notification.userInfo[SRGMediaPlayerLastPlaybackTimeKey] CMTimeValue],
                                                                                mediaPlayerController.liveTolerance);
-                [tracker recordEvent:MediaPlayerTrackerEventStop
+                [tracker recordEvent:SRGMediaPlaybackEventStop
                       withStreamType:streamType
                                 time:time
                            timeshift:timeshift
                      analyticsLabels:nil
                             userInfo:notification.userInfo[SRGMediaPlayerPreviousUserInfoKey]];
             }
-            s_trackers[key] = nil;
-            
-            SRGAnalyticsMediaPlayerLogInfo(@"tracker", @"Stopped tracking for %@", key);
+            SRGAnalyticsMediaPlayerLogInfo(@"tracker", @"Stopped tracking for %p", mediaPlayerController);
         }
     }
 }
@@ -408,6 +353,19 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
                              userInfo:mediaPlayerController.userInfo];
 }
 
+- (void)applicationDidEnterBackground:(NSNotification *)notification
+{
+    // Playback can continue in the background (e.g. audio), in which case time must still be accounted for
+    if (SRGMediaPlaybackDurationAccumulatorActivity(&_durationAccumulator) != SRGMediaPlaybackActivityPlaying) {
+        SRGMediaPlaybackDurationAccumulatorSuspend(&_durationAccumulator, SRGMediaPlayerTrackerCurrentTime());
+    }
+}
+
+- (void)applicationWillEnterForeground:(NSNotification *)notification
+{
+    SRGMediaPlaybackDurationAccumulatorResume(&_durationAccumulator, SRGMediaPlayerTrackerCurrentTime());
+}
+
 - (void)segmentDidStart:(NSNotification *)notification
 {
     SRGMediaPlayerController *mediaPlayerController = notification.object;
@@ -422,7 +380,7 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
         NSString *selectionReasonLabel = SRGMediaPlayerTrackerLabelForSelectionReason(selectionReason);
         analyticsLabels[@"segment_change_origin"] = selectionReasonLabel;
         
-        [self recordEvent:MediaPlayerTrackerEventSegment
+        [self recordEvent:SRGMediaPlaybackEventSegment
            withStreamType:mediaPlayerController.streamType
                      time:mediaPlayerController.currentTime
                 timeshift:SRGMediaAnalyticsPlayerTimeshiftInMilliseconds(mediaPlayerController)
@@ -431,10 +389,12 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
     }
 }
 
-#pragma mark Timers
+#pragma mark SRGMediaPlayerHeartbeatTarget protocol
 
-- (void)heartbeat:(NSTimer *)timer
+- (void)heartbeat
 {
+    self.totalHeartbeatCount += 1;
+    
     SRGMediaPlayerController *mediaPlayerController = self.mediaPlayerController;
     if (! mediaPlayerController.tracked) {
         return;
@@ -443,7 +403,7 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
     SRGMediaPlayerStreamType streamType = mediaPlayerController.streamType;
     NSNumber *timeshift = SRGMediaAnalyticsPlayerTimeshiftInMilliseconds(mediaPlayerController);
     
-    [self recordEvent:MediaPlayerTrackerEventPosition
+    [self recordEvent:SRGMediaPlaybackEventPosition
        withStreamType:streamType
                  time:mediaPlayerController.currentTime
             timeshift:timeshift
@@ -452,7 +412,7 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
     
     // Send a live heartbeat each minute
     if (self.mediaPlayerController.live && self.heartbeatCount % 2 != 0) {
-        [self recordEvent:MediaPlayerTrackerEventUptime
+        [self recordEvent:SRGMediaPlaybackEventUptime
            withStreamType:streamType
                      time:mediaPlayerController.currentTime
                 timeshift:timeshift
@@ -474,8 +434,6 @@ __attribute__((constructor)) static void SRGMediaPlayerTrackerInit(void)
                                            selector:@selector(playbackStateDidChange:)
                                                name:SRGMediaPlayerPlaybackStateDidChangeNotification
                                              object:nil];
-    
-    s_trackers = [NSMutableDictionary dictionary];
 }
 
 static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSelectionReason reason)
@@ -488,3 +446,22 @@ static NSString *SRGMediaPlayerTrackerLabelForSelectionReason(SRGMediaPlayerSele
     });
     return s_labels[@(reason)];
 }
+
+static SRGMediaPlayerHeartbeatScheduler *SRGMediaPlayerTrackerHeartbeatScheduler(void)
+{
+    static dispatch_once_t s_onceToken;
+    static SRGMediaPlayerHeartbeatScheduler *s_heartbeatScheduler;
+    dispatch_once(&s_onceToken, ^{
+        // Trackers are only created once the tracker has been started, the configuration is therefore available
+        SRGAnalyticsConfiguration *configuration = SRGAnalyticsTracker.sharedTracker.configuration;
+        NSTimeInterval heartbeatInterval = configuration.unitTesting ? 3. : 30.;
+        s_heartbeatScheduler = [[SRGMediaPlayerHeartbeatScheduler alloc] initWithInterval:heartbeatInterval];
+    });
+    return s_heartbeatScheduler;
+}
+
+// Monotonic, so that wall-clock adjustments do not affect durations
+static uint64_t SRGMediaPlayerTrackerCurrentTime(void)
+{
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
@@ -0,0 +1,66 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+@import SRGMediaPlayer;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Tracker families which can be attached to a player controller.
+ */
+typedef NS_ENUM(NSInteger, SRGMediaPlayerTrackerKind) {
+    SRGMediaPlayerTrackerKindCommandersAct = 0,
+    SRGMediaPlayerTrackerKindComScore,
+    SRGMediaPlayerTrackerKindCount
+};
+
+/**
+ *  Registry associating trackers with player controllers, keyed by controller address.
+ *
+ *  @discussion Thread-safe. Controllers are looked up in an open-addressing table which can be probed without locking,
+ *              so that rejecting a controller without trackers is cheap. Trackers themselves are read and written under
+ *              a lock. Each registration weakly references its controller, so that a stale registration is never
+ *              returned for another controller allocated at the same address. Registrations of deallocated controllers
+ *              are discarded when found or when the table is resized.
+ */
+@interface SRGMediaPlayerTrackerRegistry : NSObject
+
+/**
+ *  The registry shared by all tracker families.
+ */
+@property (class, nonatomic, readonly) SRGMediaPlayerTrackerRegistry *sharedRegistry;
+
+/**
+ *  Return `NO` if no tracker is attached to the controller. Lock-free.
+ *
+ *  @discussion A `YES` result is only a hint, trackers must still be retrieved with `-trackerOfKind:forMediaPlayerController:`.
+ */
+- (BOOL)containsMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController;
+
+/**
+ *  Return the tracker of the specified kind attached to a controller, if any.
+ */
+- (nullable id)trackerOfKind:(SRGMediaPlayerTrackerKind)kind forMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController;
+
+/**
+ *  Attach a tracker of the specified kind to a controller, replacing any existing one (removing it if `nil`).
+ */
+- (void)setTracker:(nullable id)tracker ofKind:(SRGMediaPlayerTrackerKind)kind forMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController;
+
+/**
+ *  Detach the tracker of the specified kind from a controller, returning it.
+ */
+- (nullable id)removeTrackerOfKind:(SRGMediaPlayerTrackerKind)kind forMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController;
+
+/**
+ *  The number of controllers with at least one tracker attached.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+@end
+
+NS_ASSUME_NONNULL_END
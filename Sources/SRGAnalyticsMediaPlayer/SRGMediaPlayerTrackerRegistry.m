@@ -0,0 +1,379 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerTrackerRegistry.h"
+
+#import <os/lock.h>
+#import <stdatomic.h>
+
+// Reserved slot keys (controller addresses are never 0 or 1)
+static const uintptr_t SRGMediaPlayerTrackerRegistryEmptyKey = 0;
+static const uintptr_t SRGMediaPlayerTrackerRegistryDeletedKey = 1;
+
+static const NSUInteger SRGMediaPlayerTrackerRegistryMinimumCapacity = 16;
+
+typedef struct {
+    _Atomic(uintptr_t) key;
+} SRGMediaPlayerTrackerRegistrySlot;
+
+typedef struct SRGMediaPlayerTrackerRegistryTable {
+    NSUInteger capacity;                                        // Power of two
+    NSUInteger usedCount;                                       // Live and deleted slots
+    SRGMediaPlayerTrackerRegistrySlot *slots;
+    void **entries;                                             // Retained entries, only accessed with the lock held
+    struct SRGMediaPlayerTrackerRegistryTable *retiredTable;    // Previous table, kept alive for concurrent readers
+} SRGMediaPlayerTrackerRegistryTable;
+
+static SRGMediaPlayerTrackerRegistryTable *SRGMediaPlayerTrackerRegistryTableCreate(NSUInteger capacity);
+static void SRGMediaPlayerTrackerRegistryTableDestroy(SRGMediaPlayerTrackerRegistryTable *table);
+static NSUInteger SRGMediaPlayerTrackerRegistryTableFind(SRGMediaPlayerTrackerRegistryTable *table, uintptr_t key);
+
+static inline NSUInteger SRGMediaPlayerTrackerRegistryHash(uintptr_t key, NSUInteger mask)
+{
+    // Fibonacci hashing, taking high bits since low address bits are mostly zero
+    return (NSUInteger)(((uint64_t)key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+@interface SRGMediaPlayerTrackerRegistryEntry : NSObject {
+@public
+    id _trackers[SRGMediaPlayerTrackerKindCount];
+}
+
+@property (nonatomic, weak) SRGMediaPlayerController *mediaPlayerController;
+
+@property (nonatomic, readonly, getter=isEmpty) BOOL empty;
+
+@end
+
+@interface SRGMediaPlayerTrackerRegistry () {
+@private
+    _Atomic(SRGMediaPlayerTrackerRegistryTable *) _table;
+    os_unfair_lock _lock;
+    NSUInteger _count;
+
+    // Entries removed with the lock held, released once it has been relinquished
+    NSMutableArray<SRGMediaPlayerTrackerRegistryEntry *> *_discardedEntries;
+}
+
+@end
+
+@implementation SRGMediaPlayerTrackerRegistry
+
+#pragma mark Class methods
+
++ (SRGMediaPlayerTrackerRegistry *)sharedRegistry
+{
+    static SRGMediaPlayerTrackerRegistry *s_sharedRegistry;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_sharedRegistry = [[SRGMediaPlayerTrackerRegistry alloc] init];
+    });
+    return s_sharedRegistry;
+}
+
+#pragma mark Object lifecycle
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        atomic_init(&_table, SRGMediaPlayerTrackerRegistryTableCreate(SRGMediaPlayerTrackerRegistryMinimumCapacity));
+        _lock = OS_UNFAIR_LOCK_INIT;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    SRGMediaPlayerTrackerRegistryTableDestroy(atomic_load(&_table));
+}
+
+#pragma mark Getters and setters
+
+- (NSUInteger)count
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = _count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+#pragma mark Lookup
+
+- (BOOL)containsMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
+{
+    SRGMediaPlayerTrackerRegistryTable *table = atomic_load_explicit(&_table, memory_order_acquire);
+    return SRGMediaPlayerTrackerRegistryTableFind(table, (uintptr_t)mediaPlayerController) != NSNotFound;
+}
+
+- (id)trackerOfKind:(SRGMediaPlayerTrackerKind)kind forMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
+{
+    NSParameterAssert(kind >= 0 && kind < SRGMediaPlayerTrackerKindCount);
+
+    if (! [self containsMediaPlayerController:mediaPlayerController]) {
+        return nil;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    SRGMediaPlayerTrackerRegistryEntry *entry = [self lockedEntryForMediaPlayerController:mediaPlayerController];
+    id tracker = entry ? entry->_trackers[kind] : nil;
+    NSArray<SRGMediaPlayerTrackerRegistryEntry *> *discardedEntries = [self lockedTakeDiscardedEntries];
+    os_unfair_lock_unlock(&_lock);
+
+    discardedEntries = nil;
+    return tracker;
+}
+
+#pragma mark Registration
+
+- (void)setTracker:(id)tracker ofKind:(SRGMediaPlayerTrackerKind)kind forMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
+{
+    // Release the replaced tracker outside the lock, since its deallocation might trigger arbitrary code
+    id replacedTracker = [self exchangeTracker:tracker ofKind:kind forMediaPlayerController:mediaPlayerController];
+    replacedTracker = nil;
+}
+
+- (id)removeTrackerOfKind:(SRGMediaPlayerTrackerKind)kind forMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
+{
+    if (! [self containsMediaPlayerController:mediaPlayerController]) {
+        return nil;
+    }
+
+    return [self exchangeTracker:nil ofKind:kind forMediaPlayerController:mediaPlayerController];
+}
+
+- (id)exchangeTracker:(id)tracker ofKind:(SRGMediaPlayerTrackerKind)kind forMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
+{
+    NSParameterAssert(kind >= 0 && kind < SRGMediaPlayerTrackerKindCount);
+    NSParameterAssert(mediaPlayerController);
+
+    id replacedTracker = nil;
+
+    os_unfair_lock_lock(&_lock);
+    SRGMediaPlayerTrackerRegistryEntry *entry = [self lockedEntryForMediaPlayerController:mediaPlayerController];
+    if (tracker) {
+        if (! entry) {
+            entry = [[SRGMediaPlayerTrackerRegistryEntry alloc] init];
+            entry.mediaPlayerController = mediaPlayerController;
+            [self lockedInsertEntry:entry forKey:(uintptr_t)mediaPlayerController];
+        }
+        replacedTracker = entry->_trackers[kind];
+        entry->_trackers[kind] = tracker;
+    }
+    else if (entry) {
+        replacedTracker = entry->_trackers[kind];
+        entry->_trackers[kind] = nil;
+        if (entry.empty) {
+            [self lockedRemoveEntryForKey:(uintptr_t)mediaPlayerController];
+        }
+    }
+    NSArray<SRGMediaPlayerTrackerRegistryEntry *> *discardedEntries = [self lockedTakeDiscardedEntries];
+    os_unfair_lock_unlock(&_lock);
+
+    discardedEntries = nil;
+    return replacedTracker;
+}
+
+#pragma mark Table management (lock held)
+
+- (SRGMediaPlayerTrackerRegistryEntry *)lockedEntryForMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
+{
+    os_unfair_lock_assert_owner(&_lock);
+
+    uintptr_t key = (uintptr_t)mediaPlayerController;
+    SRGMediaPlayerTrackerRegistryTable *table = atomic_load_explicit(&_table, memory_order_relaxed);
+    NSUInteger index = SRGMediaPlayerTrackerRegistryTableFind(table, key);
+    if (index == NSNotFound) {
+        return nil;
+    }
+
+    SRGMediaPlayerTrackerRegistryEntry *entry = (__bridge SRGMediaPlayerTrackerRegistryEntry *)table->entries[index];
+
+    // The registered controller has been deallocated (its weak reference is therefore nil) and another one now lives
+    // at the same address. Discard the stale registration.
+    if (entry.mediaPlayerController != mediaPlayerController) {
+        [self lockedRemoveEntryForKey:key];
+        return nil;
+    }
+    return entry;
+}
+
+- (void)lockedInsertEntry:(SRGMediaPlayerTrackerRegistryEntry *)entry forKey:(uintptr_t)key
+{
+    os_unfair_lock_assert_owner(&_lock);
+
+    SRGMediaPlayerTrackerRegistryTable *table = atomic_load_explicit(&_table, memory_order_relaxed);
+    if ((table->usedCount + 1) * 4 > table->capacity * 3) {
+        table = [self lockedRehashedTable:table];
+    }
+
+    NSUInteger mask = table->capacity - 1;
+    NSUInteger index = SRGMediaPlayerTrackerRegistryHash(key, mask);
+    while (YES) {
+        uintptr_t slotKey = atomic_load_explicit(&table->slots[index].key, memory_order_relaxed);
+        if (slotKey == SRGMediaPlayerTrackerRegistryEmptyKey || slotKey == SRGMediaPlayerTrackerRegistryDeletedKey) {
+            if (slotKey == SRGMediaPlayerTrackerRegistryEmptyKey) {
+                table->usedCount++;
+            }
+            break;
+        }
+        index = (index + 1) & mask;
+    }
+
+    // Publish the key last, so that lock-free readers never see a key before its slot is complete
+    table->entries[index] = (void *)CFBridgingRetain(entry);
+    atomic_store_explicit(&table->slots[index].key, key, memory_order_release);
+    _count++;
+}
+
+- (void)lockedRemoveEntryForKey:(uintptr_t)key
+{
+    os_unfair_lock_assert_owner(&_lock);
+
+    SRGMediaPlayerTrackerRegistryTable *table = atomic_load_explicit(&_table, memory_order_relaxed);
+    NSUInteger index = SRGMediaPlayerTrackerRegistryTableFind(table, key);
+    if (index == NSNotFound) {
+        return;
+    }
+
+    atomic_store_explicit(&table->slots[index].key, SRGMediaPlayerTrackerRegistryDeletedKey, memory_order_release);
+
+    if (! _discardedEntries) {
+        _discardedEntries = [NSMutableArray array];
+    }
+    [_discardedEntries addObject:CFBridgingRelease(table->entries[index])];
+    table->entries[index] = NULL;
+    _count--;
+}
+
+- (NSArray<SRGMediaPlayerTrackerRegistryEntry *> *)lockedTakeDiscardedEntries
+{
+    os_unfair_lock_assert_owner(&_lock);
+
+    NSArray<SRGMediaPlayerTrackerRegistryEntry *> *discardedEntries = _discardedEntries;
+    _discardedEntries = nil;
+    return discardedEntries;
+}
+
+// Move live entries to a new table, dropping deleted slots and entries of deallocated controllers, and growing if
+// needed, then publish it
+- (SRGMediaPlayerTrackerRegistryTable *)lockedRehashedTable:(SRGMediaPlayerTrackerRegistryTable *)table
+{
+    NSUInteger capacity = table->capacity;
+    while ((_count + 1) * 2 > capacity) {
+        capacity *= 2;
+    }
+
+    SRGMediaPlayerTrackerRegistryTable *newTable = SRGMediaPlayerTrackerRegistryTableCreate(capacity);
+    NSUInteger mask = capacity - 1;
+    for (NSUInteger i = 0; i < table->capacity; ++i) {
+        uintptr_t key = atomic_load_explicit(&table->slots[i].key, memory_order_relaxed);
+        if (key == SRGMediaPlayerTrackerRegistryEmptyKey || key == SRGMediaPlayerTrackerRegistryDeletedKey) {
+            continue;
+        }
+
+        SRGMediaPlayerTrackerRegistryEntry *entry = (__bridge SRGMediaPlayerTrackerRegistryEntry *)table->entries[i];
+        if (! entry.mediaPlayerController) {
+            if (! _discardedEntries) {
+                _discardedEntries = [NSMutableArray array];
+            }
+            [_discardedEntries addObject:CFBridgingRelease(table->entries[i])];
+            table->entries[i] = NULL;
+            _count--;
+            continue;
+        }
+
+        NSUInteger index = SRGMediaPlayerTrackerRegistryHash(key, mask);
+        while (atomic_load_explicit(&newTable->slots[index].key, memory_order_relaxed) != SRGMediaPlayerTrackerRegistryEmptyKey) {
+            index = (index + 1) & mask;
+        }
+
+        // Entries are moved, not retained again
+        newTable->entries[index] = table->entries[i];
+        table->entries[i] = NULL;
+        atomic_store_explicit(&newTable->slots[index].key, key, memory_order_relaxed);
+        newTable->usedCount++;
+    }
+
+    // Readers might still be probing the previous table, which is therefore never freed while the registry is alive.
+    // Only a few tables are ever created since the number of players alive at the same time is small.
+    newTable->retiredTable = table;
+    atomic_store_explicit(&_table, newTable, memory_order_release);
+    return newTable;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; count = %@>",
+            self.class,
+            self,
+            @(self.count)];
+}
+
+@end
+
+@implementation SRGMediaPlayerTrackerRegistryEntry
+
+- (BOOL)isEmpty
+{
+    for (NSInteger kind = 0; kind < SRGMediaPlayerTrackerKindCount; ++kind) {
+        if (_trackers[kind]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+@end
+
+#pragma mark Static functions
+
+static SRGMediaPlayerTrackerRegistryTable *SRGMediaPlayerTrackerRegistryTableCreate(NSUInteger capacity)
+{
+    NSCParameterAssert((capacity & (capacity - 1)) == 0);
+
+    SRGMediaPlayerTrackerRegistryTable *table = calloc(1, sizeof(SRGMediaPlayerTrackerRegistryTable));
+    table->capacity = capacity;
+    table->slots = calloc(capacity, sizeof(SRGMediaPlayerTrackerRegistrySlot));
+    table->entries = calloc(capacity, sizeof(void *));
+    return table;
+}
+
+static void SRGMediaPlayerTrackerRegistryTableDestroy(SRGMediaPlayerTrackerRegistryTable *table)
+{
+    while (table) {
+        for (NSUInteger i = 0; i < table->capacity; ++i) {
+            if (table->entries[i]) {
+                CFRelease(table->entries[i]);
+            }
+        }
+
+        SRGMediaPlayerTrackerRegistryTable *retiredTable = table->retiredTable;
+        free(table->slots);
+        free(table->entries);
+        free(table);
+        table = retiredTable;
+    }
+}
+
+// Lock-free probe. Return the index of the slot containing the key, or `NSNotFound`
+static NSUInteger SRGMediaPlayerTrackerRegistryTableFind(SRGMediaPlayerTrackerRegistryTable *table, uintptr_t key)
+{
+    NSUInteger mask = table->capacity - 1;
+    NSUInteger index = SRGMediaPlayerTrackerRegistryHash(key, mask);
+    for (NSUInteger i = 0; i < table->capacity; ++i) {
+        uintptr_t slotKey = atomic_load_explicit(&table->slots[index].key, memory_order_acquire);
+        if (slotKey == key) {
+            return index;
+        }
+        else if (slotKey == SRGMediaPlayerTrackerRegistryEmptyKey) {
+            return NSNotFound;
+        }
+        index = (index + 1) & mask;
+    }
+    return NSNotFound;
+}
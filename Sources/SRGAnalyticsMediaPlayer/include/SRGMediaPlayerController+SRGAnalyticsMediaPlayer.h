@@ -153,6 +153,16 @@ withAnalyticsLabels:(nullable SRGAnalyticsStreamLabels *)analyticsLabels
  withAnalyticsLabels:(nullable SRGAnalyticsStreamLabels *)analyticsLabels
             userInfo:(nullable NSDictionary *)userInfo;
 
+/**
+ *  Prepare measurements for the item expected to be played next by the receiver (e.g. the next item of a playlist),
+ *  so that they start without delay when this item is played. Preparation is made in the background.
+ *
+ *  @param analyticsLabels The analytics labels the next item is expected to be played with. Preparation is only used
+ *                         if the next item is played with equal labels, and is discarded when this method is called
+ *                         again.
+ */
+- (void)prepareAnalyticsForNextItemWithLabels:(nullable SRGAnalyticsStreamLabels *)analyticsLabels;
+
 /**
  *  Set to `NO` to disable automatic player controller tracking. The default value is `YES`.
  *
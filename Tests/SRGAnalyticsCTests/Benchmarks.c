@@ -0,0 +1,395 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+// Benchmarks for the portable C kernels, runnable on any platform with a C11 compiler (see `make benchmark-c`). Each
+// benchmark prints a machine-readable line in the same format as the XCTest benchmarks, with the mean time, number of
+// heap allocations and number of allocated bytes per operation:
+//
+//   SRGAnalyticsBenchmark {"name":"<name>","operations":<count>,"ns_per_op":<value>,"allocations_per_op":<value>,"bytes_per_op":<value>}
+//
+// Allocations are counted by interposing the allocator on glibc and with the malloc logger on Apple platforms. They
+// are reported as -1 when they cannot be counted (or when built with sanitizers, which replace the allocator).
+
+#include "SRGAnalyticsHistogram.h"
+#include "SRGAnalyticsJournal.h"
+#include "SRGAnalyticsLabelsDelta.h"
+#include "SRGAnalyticsRingBuffer.h"
+#include "SRGAnalyticsSampling.h"
+#include "SRGAnalyticsStringFormatting.h"
+#include "SRGMediaPlaybackDurationAccumulator.h"
+#include "SRGMediaPlaybackStateMachine.h"
+
+#include <dirent.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SRG_ANALYTICS_SANITIZED 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+#define SRG_ANALYTICS_SANITIZED 1
+#endif
+
+static _Atomic uint64_t s_allocationCount;
+static _Atomic uint64_t s_allocatedBytes;
+
+typedef void (*SRGAnalyticsBenchmarkBlock)(size_t index, void *context);
+
+static bool SRGAnalyticsAllocationCountingEnabled(void);
+static void SRGAnalyticsCountAllocation(size_t size);
+static uint64_t SRGAnalyticsBenchmarkCurrentTime(void);
+static void SRGAnalyticsRemoveDirectory(const char *directoryPath);
+
+#pragma mark Allocation counting
+
+#if defined(__APPLE__) && ! defined(SRG_ANALYTICS_SANITIZED)
+
+// Private but stable hook, used by malloc stack logging and by Instruments
+typedef void (SRGAnalyticsMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t frameCount);
+extern SRGAnalyticsMallocLogger *malloc_logger;
+
+static const uint32_t SRGAnalyticsMallocLogTypeAllocate = 2;
+static const uint32_t SRGAnalyticsMallocLogTypeDeallocate = 4;
+
+static void SRGAnalyticsBenchmarkMallocLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t frameCount)
+{
+    (void)arg1;
+    (void)result;
+    (void)frameCount;
+
+    if (type & SRGAnalyticsMallocLogTypeAllocate) {
+        // Reallocations provide the new size as third argument
+        SRGAnalyticsCountAllocation((type & SRGAnalyticsMallocLogTypeDeallocate) ? arg3 : arg2);
+    }
+}
+
+static void SRGAnalyticsInstallAllocationCounter(void)
+{
+    malloc_logger = SRGAnalyticsBenchmarkMallocLogger;
+}
+
+static bool SRGAnalyticsAllocationCountingEnabled(void)
+{
+    return true;
+}
+
+#elif defined(__GLIBC__) && ! defined(SRG_ANALYTICS_SANITIZED)
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+void *malloc(size_t size)
+{
+    SRGAnalyticsCountAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    SRGAnalyticsCountAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    SRGAnalyticsCountAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+
+static void SRGAnalyticsInstallAllocationCounter(void)
+{}
+
+static bool SRGAnalyticsAllocationCountingEnabled(void)
+{
+    return true;
+}
+
+#else
+
+static void SRGAnalyticsInstallAllocationCounter(void)
+{}
+
+static bool SRGAnalyticsAllocationCountingEnabled(void)
+{
+    return false;
+}
+
+#endif
+
+#pragma mark Harness
+
+static void SRGAnalyticsBenchmarkRun(const char *name, size_t count, SRGAnalyticsBenchmarkBlock block, void *context)
+{
+    // Warm up caches first, then time a single run
+    for (size_t i = 0; i < count; ++i) {
+        block(i, context);
+    }
+
+    uint64_t allocationCount = atomic_load_explicit(&s_allocationCount, memory_order_relaxed);
+    uint64_t allocatedBytes = atomic_load_explicit(&s_allocatedBytes, memory_order_relaxed);
+    uint64_t startTime = SRGAnalyticsBenchmarkCurrentTime();
+    for (size_t i = 0; i < count; ++i) {
+        block(i, context);
+    }
+    uint64_t duration = SRGAnalyticsBenchmarkCurrentTime() - startTime;
+    allocationCount = atomic_load_explicit(&s_allocationCount, memory_order_relaxed) - allocationCount;
+    allocatedBytes = atomic_load_explicit(&s_allocatedBytes, memory_order_relaxed) - allocatedBytes;
+
+    if (SRGAnalyticsAllocationCountingEnabled()) {
+        printf("SRGAnalyticsBenchmark {\"name\":\"%s\",\"operations\":%zu,\"ns_per_op\":%.1f,\"allocations_per_op\":%.2f,\"bytes_per_op\":%.1f}\n",
+               name, count, (double)duration / count, (double)allocationCount / count, (double)allocatedBytes / count);
+    }
+    else {
+        printf("SRGAnalyticsBenchmark {\"name\":\"%s\",\"operations\":%zu,\"ns_per_op\":%.1f,\"allocations_per_op\":-1,\"bytes_per_op\":-1}\n",
+               name, count, (double)duration / count);
+    }
+}
+
+#pragma mark Fixtures
+
+static const char *s_pageTitles[] = {
+    "Home", "Vid\xc3\xa9os \xc3\xa0 la une", "\xc3\x89missions: Temps Pr\xc3\xa9sent", "Sport + M\xc3\xa9t\xc3\xa9o",
+    "Tagesschau vom 17.10.2026", "Rh\xc3\xb4ne-Alpes: l'\xc3\xa9t\xc3\xa9 en 4K", "Radio & Podcasts", "Live"
+};
+static const size_t s_pageTitleCount = sizeof(s_pageTitles) / sizeof(s_pageTitles[0]);
+
+// Heartbeat records of a single session: a key frame followed by deltas where only the position changes
+typedef struct {
+    SRGAnalyticsLabelsDeltaExpander *expander;
+    SRGAnalyticsLabel keyFrame[8];
+    SRGAnalyticsLabel delta[4];
+    char sequence[24];
+    char base[24];
+    char position[24];
+    size_t labelCount;
+} SRGAnalyticsDeltaBenchmarkContext;
+
+typedef struct {
+    SRGAnalyticsJournal *journal;
+    char payload[256];
+    size_t payloadLength;
+} SRGAnalyticsJournalBenchmarkContext;
+
+#pragma mark Benchmarks
+
+static void SRGAnalyticsStringFormattingBenchmark(size_t index, void *context)
+{
+    (void)context;
+
+    const char *title = s_pageTitles[index % s_pageTitleCount];
+    char output[128];
+    SRGAnalyticsFormatString(title, strlen(title), output, sizeof(output));
+}
+
+static void SRGAnalyticsFormattingCacheBenchmark(size_t index, void *context)
+{
+    const char *title = s_pageTitles[index % s_pageTitleCount];
+    char output[128];
+    SRGAnalyticsFormattingCacheFormatString(context, title, strlen(title), output, sizeof(output), NULL);
+}
+
+static void SRGAnalyticsHistogramBenchmark(size_t index, void *context)
+{
+    SRGAnalyticsHistogramRecord(context, (uint64_t)index * 7919);
+}
+
+static void SRGAnalyticsRingBufferBenchmark(size_t index, void *context)
+{
+    // Keep the buffer full so that wraparound is exercised
+    void *item = NULL;
+    SRGAnalyticsRingBufferPop(context, &item);
+    SRGAnalyticsRingBufferPush(context, (void *)(uintptr_t)(index + 1));
+}
+
+static void SRGAnalyticsSamplingPositionBenchmark(size_t index, void *context)
+{
+    (void)context;
+
+    const char *name = s_pageTitles[index % s_pageTitleCount];
+    volatile double position = SRGAnalyticsSamplingPosition("6f1ed002-ab5d-42e3-a8d5-1ec5a6d2c9d6", name);
+    (void)position;
+}
+
+static void SRGAnalyticsTokenBucketBenchmark(size_t index, void *context)
+{
+    SRGAnalyticsTokenBucketConsume(context, (uint64_t)index * 1000);
+}
+
+static void SRGAnalyticsDeltaExpansionCallback(const char *key, const char *value, void *context)
+{
+    (void)key;
+    (void)value;
+    ++*(size_t *)context;
+}
+
+static void SRGAnalyticsDeltaExpansionBenchmark(size_t index, void *context)
+{
+    SRGAnalyticsDeltaBenchmarkContext *deltaContext = context;
+
+    size_t labelCount = 0;
+    if (index == 0) {
+        snprintf(deltaContext->sequence, sizeof(deltaContext->sequence), "0");
+        SRGAnalyticsLabelsDeltaExpanderExpand(deltaContext->expander, deltaContext->keyFrame, sizeof(deltaContext->keyFrame) / sizeof(deltaContext->keyFrame[0]), SRGAnalyticsDeltaExpansionCallback, &labelCount);
+    }
+    else {
+        snprintf(deltaContext->sequence, sizeof(deltaContext->sequence), "%zu", index);
+        snprintf(deltaContext->base, sizeof(deltaContext->base), "%zu", index - 1);
+        snprintf(deltaContext->position, sizeof(deltaContext->position), "%zu", index * 30);
+        SRGAnalyticsLabelsDeltaExpanderExpand(deltaContext->expander, deltaContext->delta, sizeof(deltaContext->delta) / sizeof(deltaContext->delta[0]), SRGAnalyticsDeltaExpansionCallback, &labelCount);
+    }
+    deltaContext->labelCount += labelCount;
+}
+
+static void SRGAnalyticsJournalBenchmark(size_t index, void *context)
+{
+    (void)index;
+
+    SRGAnalyticsJournalBenchmarkContext *journalContext = context;
+    SRGAnalyticsJournalToken token = SRGAnalyticsJournalAppend(journalContext->journal, journalContext->payload, journalContext->payloadLength);
+    SRGAnalyticsJournalAcknowledge(journalContext->journal, token);
+}
+
+static void SRGAnalyticsStateMachineBenchmark(size_t index, void *context)
+{
+    (void)context;
+
+    static const SRGMediaPlaybackEvent kEvents[] = {
+        SRGMediaPlaybackEventPlay,
+        SRGMediaPlaybackEventPosition,
+        SRGMediaPlaybackEventSeek,
+        SRGMediaPlaybackEventPlay,
+        SRGMediaPlaybackEventPause,
+        SRGMediaPlaybackEventPlay,
+        SRGMediaPlaybackEventUptime,
+        SRGMediaPlaybackEventEnd
+    };
+    static SRGMediaPlaybackStateMachine s_stateMachine;
+    static SRGMediaPlaybackDurationAccumulator s_durationAccumulator;
+
+    // Same steps as the media player tracker
+    SRGMediaPlaybackEvent event = kEvents[index % (sizeof(kEvents) / sizeof(kEvents[0]))];
+    SRGMediaPlaybackActivity activity = SRGMediaPlaybackActivityForEvent(event, SRGMediaPlaybackDurationAccumulatorActivity(&s_durationAccumulator));
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&s_durationAccumulator, activity, (uint64_t)index * 1000000);
+
+    SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+    SRGMediaPlaybackStateMachineProcessEvent(&s_stateMachine, event, events);
+}
+
+#pragma mark Main
+
+int main(void)
+{
+    SRGAnalyticsInstallAllocationCounter();
+
+    SRGAnalyticsBenchmarkRun("c_string_formatting", 100000, SRGAnalyticsStringFormattingBenchmark, NULL);
+
+    SRGAnalyticsFormattingCache *cache = SRGAnalyticsFormattingCacheCreate();
+    SRGAnalyticsBenchmarkRun("c_string_formatting_cache", 100000, SRGAnalyticsFormattingCacheBenchmark, cache);
+    SRGAnalyticsFormattingCacheDestroy(cache);
+
+    SRGAnalyticsHistogram *histogram = calloc(1, sizeof(SRGAnalyticsHistogram));
+    SRGAnalyticsBenchmarkRun("c_histogram_record", 1000000, SRGAnalyticsHistogramBenchmark, histogram);
+    free(histogram);
+
+    SRGAnalyticsRingBuffer *ringBuffer = SRGAnalyticsRingBufferCreate(1024);
+    for (size_t i = 0; i < SRGAnalyticsRingBufferCapacity(ringBuffer); ++i) {
+        SRGAnalyticsRingBufferPush(ringBuffer, (void *)(uintptr_t)(i + 1));
+    }
+    SRGAnalyticsBenchmarkRun("c_ring_buffer_push_pop", 1000000, SRGAnalyticsRingBufferBenchmark, ringBuffer);
+    SRGAnalyticsRingBufferDestroy(ringBuffer);
+
+    SRGAnalyticsBenchmarkRun("c_sampling_position", 100000, SRGAnalyticsSamplingPositionBenchmark, NULL);
+
+    SRGAnalyticsTokenBucket tokenBucket;
+    SRGAnalyticsTokenBucketInit(&tokenBucket, 100, 1000000000, 0);
+    SRGAnalyticsBenchmarkRun("c_token_bucket_consume", 1000000, SRGAnalyticsTokenBucketBenchmark, &tokenBucket);
+
+    SRGAnalyticsDeltaBenchmarkContext deltaContext = {
+        .expander = SRGAnalyticsLabelsDeltaExpanderCreate(16),
+        .keyFrame = {
+            { "app_version", "1.0" },
+            { "media_bandwidth", "3000000" },
+            { "media_position", "0" },
+            { "media_subtitles_on", "false" },
+            { "media_urn", "urn:rts:video:8414077" },
+            { "media_volume", "100" },
+            { SRGAnalyticsLabelsDeltaSessionKey, "session" },
+            { SRGAnalyticsLabelsDeltaSequenceKey, deltaContext.sequence }
+        },
+        .delta = {
+            { "media_position", deltaContext.position },
+            { SRGAnalyticsLabelsDeltaSessionKey, "session" },
+            { SRGAnalyticsLabelsDeltaSequenceKey, deltaContext.sequence },
+            { SRGAnalyticsLabelsDeltaBaseKey, deltaContext.base }
+        }
+    };
+    // Each run starts a new session with a key frame
+    SRGAnalyticsBenchmarkRun("c_labels_delta_expansion", 100000, SRGAnalyticsDeltaExpansionBenchmark, &deltaContext);
+    SRGAnalyticsLabelsDeltaExpanderDestroy(deltaContext.expander);
+    if (deltaContext.labelCount == 0) {
+        fprintf(stderr, "No labels expanded\n");
+        return 1;
+    }
+
+    char directoryPath[] = "/tmp/srganalytics-benchmarks-XXXXXX";
+    if (! mkdtemp(directoryPath)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    SRGAnalyticsJournalBenchmarkContext journalContext = { .journal = SRGAnalyticsJournalOpen(directoryPath, SRGAnalyticsJournalOptionsDefault()) };
+    journalContext.payloadLength = (size_t)snprintf(journalContext.payload, sizeof(journalContext.payload),
+                                                    "{\"kind\":\"custom\",\"name\":\"event\",\"labels\":{\"event_type\":\"toggle\",\"event_value\":\"value\",\"app_version\":\"1.0\"}}");
+    SRGAnalyticsBenchmarkRun("c_journal_append_acknowledge", 10000, SRGAnalyticsJournalBenchmark, &journalContext);
+    SRGAnalyticsJournalClose(journalContext.journal);
+
+    SRGAnalyticsRemoveDirectory(directoryPath);
+
+    SRGAnalyticsBenchmarkRun("c_state_machine_transition", 1000000, SRGAnalyticsStateMachineBenchmark, NULL);
+    return 0;
+}
+
+#pragma mark Static functions
+
+static void SRGAnalyticsCountAllocation(size_t size)
+{
+    atomic_fetch_add_explicit(&s_allocationCount, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s_allocatedBytes, size, memory_order_relaxed);
+}
+
+static uint64_t SRGAnalyticsBenchmarkCurrentTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+}
+
+// Journal directories only contain segment files
+static void SRGAnalyticsRemoveDirectory(const char *directoryPath)
+{
+    DIR *directory = opendir(directoryPath);
+    if (directory) {
+        struct dirent *entry = NULL;
+        while ((entry = readdir(directory))) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+                continue;
+            }
+
+            char filePath[1024];
+            snprintf(filePath, sizeof(filePath), "%s/%s", directoryPath, entry->d_name);
+            unlink(filePath);
+        }
+        closedir(directory);
+    }
+    rmdir(directoryPath);
+}
@@ -0,0 +1,131 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsCTests.h"
+#include "SRGAnalyticsHistogram.h"
+
+#include <pthread.h>
+
+#define HistogramThreadCount 8
+#define HistogramValueCountPerThread 10000
+
+static uint64_t HistogramRandomValue(void)
+{
+    uint64_t value = ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ (uint64_t)rand();
+    return value >> (rand() % 64);
+}
+
+static void *HistogramRecorder(void *context)
+{
+    for (uint64_t value = 0; value < HistogramValueCountPerThread; ++value) {
+        SRGAnalyticsHistogramRecord(context, value);
+    }
+    return NULL;
+}
+
+#pragma mark Tests
+
+static void TestBuckets(void)
+{
+    for (size_t i = 0; i < SRGAnalyticsHistogramBucketCount; ++i) {
+        uint64_t upperBound = SRGAnalyticsHistogramBucketUpperBound(i);
+        SRGAnalyticsTestAssertEqual(SRGAnalyticsHistogramBucketIndex(upperBound), i);
+        if (i + 1 < SRGAnalyticsHistogramBucketCount) {
+            SRGAnalyticsTestAssertEqual(SRGAnalyticsHistogramBucketIndex(upperBound + 1), i + 1);
+        }
+    }
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsHistogramBucketUpperBound(SRGAnalyticsHistogramBucketCount - 1), UINT64_MAX);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsHistogramBucketIndex(UINT64_MAX), SRGAnalyticsHistogramBucketCount - 1);
+
+    // Small values have their own bucket
+    for (uint64_t value = 0; value < 16; ++value) {
+        SRGAnalyticsTestAssertEqual(SRGAnalyticsHistogramBucketIndex(value), value);
+    }
+}
+
+static void TestRelativeError(void)
+{
+    srand(1);
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t value = HistogramRandomValue();
+        uint64_t upperBound = SRGAnalyticsHistogramBucketUpperBound(SRGAnalyticsHistogramBucketIndex(value));
+        SRGAnalyticsTestAssert(upperBound >= value);
+        if (value >= 16) {
+            SRGAnalyticsTestAssert((double)(upperBound - value) / (double)value < 0.125);
+        }
+    }
+}
+
+static void TestQuantiles(void)
+{
+    SRGAnalyticsHistogram *histogram = calloc(1, sizeof(SRGAnalyticsHistogram));
+    SRGAnalyticsHistogramSnapshot *snapshot = calloc(1, sizeof(SRGAnalyticsHistogramSnapshot));
+
+    SRGAnalyticsHistogramCopy(histogram, snapshot, false);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsHistogramSnapshotValueAtQuantile(snapshot, 0.5), 0);
+
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        SRGAnalyticsHistogramRecord(histogram, value * 1000);
+    }
+
+    SRGAnalyticsHistogramCopy(histogram, snapshot, true);
+    SRGAnalyticsTestAssertEqual(snapshot->count, 1000);
+    SRGAnalyticsTestAssertEqual(snapshot->sum, 500500000);
+    SRGAnalyticsTestAssertEqual(snapshot->maximum, 1000000);
+
+    uint64_t median = SRGAnalyticsHistogramSnapshotValueAtQuantile(snapshot, 0.5);
+    SRGAnalyticsTestAssert(median >= 500000 * 0.875 && median <= 500000 * 1.125);
+    uint64_t ninetiethPercentile = SRGAnalyticsHistogramSnapshotValueAtQuantile(snapshot, 0.9);
+    SRGAnalyticsTestAssert(ninetiethPercentile >= 900000 * 0.875 && ninetiethPercentile <= 900000 * 1.125);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsHistogramSnapshotValueAtQuantile(snapshot, 1.), 1000000);
+
+    // Reset by the previous copy
+    SRGAnalyticsHistogramCopy(histogram, snapshot, false);
+    SRGAnalyticsTestAssertEqual(snapshot->count, 0);
+    SRGAnalyticsTestAssertEqual(snapshot->sum, 0);
+    SRGAnalyticsTestAssertEqual(snapshot->maximum, 0);
+
+    free(snapshot);
+    free(histogram);
+}
+
+static void TestConcurrentRecording(void)
+{
+    SRGAnalyticsHistogram *histogram = calloc(1, sizeof(SRGAnalyticsHistogram));
+
+    pthread_t threads[HistogramThreadCount];
+    for (size_t i = 0; i < HistogramThreadCount; ++i) {
+        pthread_create(&threads[i], NULL, HistogramRecorder, histogram);
+    }
+    for (size_t i = 0; i < HistogramThreadCount; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    SRGAnalyticsHistogramSnapshot *snapshot = calloc(1, sizeof(SRGAnalyticsHistogramSnapshot));
+    SRGAnalyticsHistogramCopy(histogram, snapshot, false);
+    SRGAnalyticsTestAssertEqual(snapshot->count, HistogramThreadCount * HistogramValueCountPerThread);
+    SRGAnalyticsTestAssertEqual(snapshot->maximum, HistogramValueCountPerThread - 1);
+
+    uint64_t bucketCountSum = 0;
+    for (size_t i = 0; i < SRGAnalyticsHistogramBucketCount; ++i) {
+        bucketCountSum += snapshot->counts[i];
+    }
+    SRGAnalyticsTestAssertEqual(bucketCountSum, snapshot->count);
+
+    free(snapshot);
+    free(histogram);
+}
+
+#pragma mark Main
+
+int main(void)
+{
+    SRGAnalyticsTestRun(TestBuckets);
+    SRGAnalyticsTestRun(TestRelativeError);
+    SRGAnalyticsTestRun(TestQuantiles);
+    SRGAnalyticsTestRun(TestConcurrentRecording);
+    return SRGAnalyticsTestResult();
+}
@@ -0,0 +1,253 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsCTests.h"
+#include "SRGAnalyticsJournal.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define JournalMaximumRecordCount 64
+
+// Records received during an enumeration
+typedef struct {
+    SRGAnalyticsJournalToken tokens[JournalMaximumRecordCount];
+    char payloads[JournalMaximumRecordCount][64];
+    size_t count;
+} JournalRecords;
+
+static void JournalRecordCallback(SRGAnalyticsJournalToken token, const void *bytes, size_t length, void *context)
+{
+    JournalRecords *records = context;
+    if (records->count == JournalMaximumRecordCount || length >= sizeof(records->payloads[0])) {
+        fprintf(stderr, "Unexpected record\n");
+        abort();
+    }
+
+    records->tokens[records->count] = token;
+    memcpy(records->payloads[records->count], bytes, length);
+    records->payloads[records->count][length] = '\0';
+    records->count += 1;
+}
+
+static void JournalEnumerate(const SRGAnalyticsJournal *journal, JournalRecords *records)
+{
+    memset(records, 0, sizeof(*records));
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalEnumeratePendingRecords(journal, JournalRecordCallback, records), records->count);
+}
+
+static SRGAnalyticsJournalToken JournalAppendString(SRGAnalyticsJournal *journal, const char *string)
+{
+    return SRGAnalyticsJournalAppend(journal, string, strlen(string));
+}
+
+static size_t JournalFileCount(const char *directoryPath)
+{
+    size_t count = 0;
+    DIR *directory = opendir(directoryPath);
+    struct dirent *entry = NULL;
+    while ((entry = readdir(directory))) {
+        if (entry->d_name[0] != '.') {
+            ++count;
+        }
+    }
+    closedir(directory);
+    return count;
+}
+
+static void JournalCreateDirectory(char *directoryPath)
+{
+    if (! mkdtemp(directoryPath)) {
+        perror("mkdtemp");
+        abort();
+    }
+}
+
+static void JournalRemoveDirectory(const char *directoryPath)
+{
+    DIR *directory = opendir(directoryPath);
+    struct dirent *entry = NULL;
+    while ((entry = readdir(directory))) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        char filePath[1024];
+        snprintf(filePath, sizeof(filePath), "%s/%s", directoryPath, entry->d_name);
+        unlink(filePath);
+    }
+    closedir(directory);
+    rmdir(directoryPath);
+}
+
+#pragma mark Tests
+
+static void TestCRC32(void)
+{
+    // Standard check value
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalCRC32(0, "123456789", 9), 0xCBF43926);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalCRC32(SRGAnalyticsJournalCRC32(0, "1234", 4), "56789", 5), 0xCBF43926);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalCRC32(0, "", 0), 0);
+}
+
+static void TestAppendAndAcknowledge(void)
+{
+    char directoryPath[] = "/tmp/srganalytics-journal-tests-XXXXXX";
+    JournalCreateDirectory(directoryPath);
+
+    SRGAnalyticsJournal *journal = SRGAnalyticsJournalOpen(directoryPath, SRGAnalyticsJournalOptionsDefault());
+    SRGAnalyticsTestAssert(journal != NULL);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalPendingCount(journal), 0);
+
+    SRGAnalyticsJournalToken token1 = JournalAppendString(journal, "event1");
+    SRGAnalyticsJournalToken token2 = JournalAppendString(journal, "event2");
+    SRGAnalyticsTestAssert(token1 != SRGAnalyticsJournalTokenInvalid);
+    SRGAnalyticsTestAssert(token2 != SRGAnalyticsJournalTokenInvalid);
+    SRGAnalyticsTestAssert(token1 != token2);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalPendingCount(journal), 2);
+
+    SRGAnalyticsTestAssert(SRGAnalyticsJournalAcknowledge(journal, token1));
+    SRGAnalyticsTestAssert(! SRGAnalyticsJournalAcknowledge(journal, token1));
+    SRGAnalyticsTestAssert(! SRGAnalyticsJournalAcknowledge(journal, SRGAnalyticsJournalTokenInvalid));
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalPendingCount(journal), 1);
+
+    JournalRecords records;
+    JournalEnumerate(journal, &records);
+    SRGAnalyticsTestAssertEqual(records.count, 1);
+    SRGAnalyticsTestAssertEqual(records.tokens[0], token2);
+    SRGAnalyticsTestAssertEqualStrings(records.payloads[0], "event2");
+
+    // Records larger than a segment cannot be appended
+    size_t maximumLength = SRGAnalyticsJournalMaximumRecordLength(journal);
+    char *largePayload = calloc(maximumLength + 1, 1);
+    SRGAnalyticsTestAssert(SRGAnalyticsJournalAppend(journal, largePayload, maximumLength) != SRGAnalyticsJournalTokenInvalid);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalAppend(journal, largePayload, maximumLength + 1), SRGAnalyticsJournalTokenInvalid);
+    free(largePayload);
+
+    SRGAnalyticsJournalClose(journal);
+    JournalRemoveDirectory(directoryPath);
+}
+
+static void TestReplay(void)
+{
+    char directoryPath[] = "/tmp/srganalytics-journal-tests-XXXXXX";
+    JournalCreateDirectory(directoryPath);
+
+    SRGAnalyticsJournal *journal = SRGAnalyticsJournalOpen(directoryPath, SRGAnalyticsJournalOptionsDefault());
+    char payload[32];
+    for (int i = 0; i < 10; ++i) {
+        snprintf(payload, sizeof(payload), "event%d", i);
+        SRGAnalyticsJournalToken token = JournalAppendString(journal, payload);
+        if (i % 2 == 0) {
+            SRGAnalyticsJournalAcknowledge(journal, token);
+        }
+    }
+    SRGAnalyticsJournalClose(journal);
+
+    // Pending records are replayed in order, and can be acknowledged after replay
+    journal = SRGAnalyticsJournalOpen(directoryPath, SRGAnalyticsJournalOptionsDefault());
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalPendingCount(journal), 5);
+
+    JournalRecords records;
+    JournalEnumerate(journal, &records);
+    SRGAnalyticsTestAssertEqual(records.count, 5);
+    for (size_t i = 0; i < records.count; ++i) {
+        snprintf(payload, sizeof(payload), "event%zu", 2 * i + 1);
+        SRGAnalyticsTestAssertEqualStrings(records.payloads[i], payload);
+        SRGAnalyticsTestAssert(SRGAnalyticsJournalAcknowledge(journal, records.tokens[i]));
+    }
+    SRGAnalyticsJournalClose(journal);
+
+    journal = SRGAnalyticsJournalOpen(directoryPath, SRGAnalyticsJournalOptionsDefault());
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalPendingCount(journal), 0);
+    SRGAnalyticsJournalClose(journal);
+
+    JournalRemoveDirectory(directoryPath);
+}
+
+static void TestCorruptedRecordIsSkipped(void)
+{
+    char directoryPath[] = "/tmp/srganalytics-journal-tests-XXXXXX";
+    JournalCreateDirectory(directoryPath);
+
+    SRGAnalyticsJournal *journal = SRGAnalyticsJournalOpen(directoryPath, SRGAnalyticsJournalOptionsDefault());
+    JournalAppendString(journal, "event1");
+    JournalAppendString(journal, "event2");
+    SRGAnalyticsJournalClose(journal);
+
+    // Alter the payload of the first record (located after the segment header frame and the record header)
+    DIR *directory = opendir(directoryPath);
+    struct dirent *entry = NULL;
+    while ((entry = readdir(directory)) && entry->d_name[0] == '.') {}
+    char filePath[1024];
+    snprintf(filePath, sizeof(filePath), "%s/%s", directoryPath, entry->d_name);
+    closedir(directory);
+
+    int fd = open(filePath, O_WRONLY);
+    SRGAnalyticsTestAssertEqual(pwrite(fd, "X", 1, 256 + 32 + 4), 1);
+    close(fd);
+
+    journal = SRGAnalyticsJournalOpen(directoryPath, SRGAnalyticsJournalOptionsDefault());
+    JournalRecords records;
+    JournalEnumerate(journal, &records);
+    SRGAnalyticsTestAssertEqual(records.count, 1);
+    SRGAnalyticsTestAssertEqualStrings(records.payloads[0], "event2");
+    SRGAnalyticsJournalClose(journal);
+
+    JournalRemoveDirectory(directoryPath);
+}
+
+static void TestSegments(void)
+{
+    char directoryPath[] = "/tmp/srganalytics-journal-tests-XXXXXX";
+    JournalCreateDirectory(directoryPath);
+
+    // Segments of 3 single-frame records, at most 2 segments
+    SRGAnalyticsJournalOptions options = SRGAnalyticsJournalOptionsDefault();
+    options.segmentSize = 4 * 256;
+    options.maximumSegmentCount = 2;
+
+    SRGAnalyticsJournal *journal = SRGAnalyticsJournalOpen(directoryPath, options);
+    char payload[32];
+    for (int i = 0; i < 9; ++i) {
+        snprintf(payload, sizeof(payload), "event%d", i);
+        SRGAnalyticsTestAssert(JournalAppendString(journal, payload) != SRGAnalyticsJournalTokenInvalid);
+    }
+
+    // The oldest segment is discarded when a new one is needed
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalEvictedCount(journal), 3);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalPendingCount(journal), 6);
+    SRGAnalyticsTestAssertEqual(JournalFileCount(directoryPath), 2);
+
+    JournalRecords records;
+    JournalEnumerate(journal, &records);
+    SRGAnalyticsTestAssertEqual(records.count, 6);
+    SRGAnalyticsTestAssertEqualStrings(records.payloads[0], "event3");
+    SRGAnalyticsTestAssertEqualStrings(records.payloads[5], "event8");
+
+    // Fully acknowledged segments are deleted
+    for (size_t i = 0; i < records.count; ++i) {
+        SRGAnalyticsTestAssert(SRGAnalyticsJournalAcknowledge(journal, records.tokens[i]));
+    }
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsJournalPendingCount(journal), 0);
+    SRGAnalyticsTestAssert(JournalFileCount(directoryPath) <= 1);
+
+    SRGAnalyticsJournalClose(journal);
+    JournalRemoveDirectory(directoryPath);
+}
+
+#pragma mark Main
+
+int main(void)
+{
+    SRGAnalyticsTestRun(TestCRC32);
+    SRGAnalyticsTestRun(TestAppendAndAcknowledge);
+    SRGAnalyticsTestRun(TestReplay);
+    SRGAnalyticsTestRun(TestCorruptedRecordIsSkipped);
+    SRGAnalyticsTestRun(TestSegments);
+    return SRGAnalyticsTestResult();
+}
@@ -0,0 +1,356 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsCTests.h"
+#include "SRGAnalyticsLabelsDelta.h"
+
+#include <stdbool.h>
+
+// Keys in ascending order, values are `NULL` when a label is absent
+#define LabelsDeltaKeyCount 7
+#define LabelsDeltaSessionCount 3
+
+static const char *s_keys[LabelsDeltaKeyCount] = { "app_version", "media_audio_track", "media_bandwidth", "media_position", "media_subtitles_on", "media_volume", "s\xc3\xbc" "d" };
+static const char *s_values[] = { "0", "1", "true", "false", "", "FR", "\xc3\xa4" "nderung" };
+static const size_t s_valueCount = sizeof(s_values) / sizeof(s_values[0]);
+
+// Reference encoder, following the format documented in SRGAnalyticsLabelsDelta.h
+typedef struct {
+    char sessionIdentifier[32];
+    unsigned long sequence;
+    bool hasPreviousValues;
+    const char *previousValues[LabelsDeltaKeyCount];
+
+    SRGAnalyticsLabel labels[LabelsDeltaKeyCount + 4];
+    size_t labelCount;
+    char sequenceString[24];
+    char baseString[24];
+    char removedString[256];
+} LabelsDeltaEncoder;
+
+// Labels received from an expander
+typedef struct {
+    char *keys[LabelsDeltaKeyCount];
+    char *values[LabelsDeltaKeyCount];
+    size_t count;
+    bool sorted;
+} LabelsDeltaRecord;
+
+static void LabelsDeltaEncoderInit(LabelsDeltaEncoder *encoder, const char *sessionIdentifier)
+{
+    memset(encoder, 0, sizeof(*encoder));
+    snprintf(encoder->sessionIdentifier, sizeof(encoder->sessionIdentifier), "%s", sessionIdentifier);
+}
+
+static void LabelsDeltaEncoderAppend(LabelsDeltaEncoder *encoder, const char *key, const char *value)
+{
+    encoder->labels[encoder->labelCount++] = (SRGAnalyticsLabel){ key, value };
+}
+
+static void LabelsDeltaEncoderEncode(LabelsDeltaEncoder *encoder, const char *values[LabelsDeltaKeyCount], bool keyFrame)
+{
+    encoder->labelCount = 0;
+
+    if (keyFrame || ! encoder->hasPreviousValues) {
+        for (size_t i = 0; i < LabelsDeltaKeyCount; ++i) {
+            if (values[i]) {
+                LabelsDeltaEncoderAppend(encoder, s_keys[i], values[i]);
+            }
+        }
+    }
+    else {
+        encoder->removedString[0] = '\0';
+        for (size_t i = 0; i < LabelsDeltaKeyCount; ++i) {
+            const char *previousValue = encoder->previousValues[i];
+            if (values[i] && (! previousValue || strcmp(values[i], previousValue) != 0)) {
+                LabelsDeltaEncoderAppend(encoder, s_keys[i], values[i]);
+            }
+            else if (! values[i] && previousValue) {
+                if (encoder->removedString[0] != '\0') {
+                    strcat(encoder->removedString, ",");
+                }
+                strcat(encoder->removedString, s_keys[i]);
+            }
+        }
+        if (encoder->removedString[0] != '\0') {
+            LabelsDeltaEncoderAppend(encoder, SRGAnalyticsLabelsDeltaRemovedKey, encoder->removedString);
+        }
+
+        snprintf(encoder->baseString, sizeof(encoder->baseString), "%lu", encoder->sequence - 1);
+        LabelsDeltaEncoderAppend(encoder, SRGAnalyticsLabelsDeltaBaseKey, encoder->baseString);
+    }
+
+    snprintf(encoder->sequenceString, sizeof(encoder->sequenceString), "%lu", encoder->sequence);
+    LabelsDeltaEncoderAppend(encoder, SRGAnalyticsLabelsDeltaSessionKey, encoder->sessionIdentifier);
+    LabelsDeltaEncoderAppend(encoder, SRGAnalyticsLabelsDeltaSequenceKey, encoder->sequenceString);
+
+    // Labels can be provided in any order
+    for (size_t i = encoder->labelCount; i > 1; --i) {
+        size_t j = (size_t)rand() % i;
+        SRGAnalyticsLabel label = encoder->labels[i - 1];
+        encoder->labels[i - 1] = encoder->labels[j];
+        encoder->labels[j] = label;
+    }
+
+    memcpy(encoder->previousValues, values, sizeof(encoder->previousValues));
+    encoder->hasPreviousValues = true;
+    encoder->sequence += 1;
+}
+
+static void LabelsDeltaRecordClear(LabelsDeltaRecord *record)
+{
+    for (size_t i = 0; i < record->count; ++i) {
+        free(record->keys[i]);
+        free(record->values[i]);
+    }
+    memset(record, 0, sizeof(*record));
+    record->sorted = true;
+}
+
+static void LabelsDeltaRecordCallback(const char *key, const char *value, void *context)
+{
+    LabelsDeltaRecord *record = context;
+    if (record->count == LabelsDeltaKeyCount) {
+        fprintf(stderr, "Too many labels received\n");
+        abort();
+    }
+
+    if (record->count != 0 && strcmp(record->keys[record->count - 1], key) >= 0) {
+        record->sorted = false;
+    }
+    record->keys[record->count] = strdup(key);
+    record->values[record->count] = strdup(value);
+    record->count += 1;
+}
+
+static SRGAnalyticsLabelsDeltaStatus LabelsDeltaExpand(SRGAnalyticsLabelsDeltaExpander *expander, const SRGAnalyticsLabel *labels, size_t count, LabelsDeltaRecord *record)
+{
+    LabelsDeltaRecordClear(record);
+    return SRGAnalyticsLabelsDeltaExpanderExpand(expander, labels, count, LabelsDeltaRecordCallback, record);
+}
+
+static bool LabelsDeltaRecordMatchesValues(const LabelsDeltaRecord *record, const char *values[LabelsDeltaKeyCount])
+{
+    size_t index = 0;
+    for (size_t i = 0; i < LabelsDeltaKeyCount; ++i) {
+        if (! values[i]) {
+            continue;
+        }
+        if (index == record->count || strcmp(record->keys[index], s_keys[i]) != 0 || strcmp(record->values[index], values[i]) != 0) {
+            return false;
+        }
+        ++index;
+    }
+    return record->sorted && index == record->count;
+}
+
+static void LabelsDeltaRandomValues(const char *values[LabelsDeltaKeyCount], const char *previousValues[LabelsDeltaKeyCount])
+{
+    for (size_t i = 0; i < LabelsDeltaKeyCount; ++i) {
+        if (previousValues && rand() % 4 != 0) {
+            values[i] = previousValues[i];
+        }
+        else if (rand() % 4 != 0) {
+            values[i] = s_values[(size_t)rand() % s_valueCount];
+        }
+        else {
+            values[i] = NULL;
+        }
+    }
+}
+
+#pragma mark Tests
+
+static void TestUnencodedLabels(void)
+{
+    SRGAnalyticsLabelsDeltaExpander *expander = SRGAnalyticsLabelsDeltaExpanderCreate(1);
+    LabelsDeltaRecord record = { .sorted = true };
+
+    SRGAnalyticsLabel labels[] = { { "media_volume", "1" }, { "app_version", "0" } };
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, labels, 2, &record), SRGAnalyticsLabelsDeltaStatusUnencoded);
+    const char *values[LabelsDeltaKeyCount] = { "0", NULL, NULL, NULL, NULL, "1", NULL };
+    SRGAnalyticsTestAssert(LabelsDeltaRecordMatchesValues(&record, values));
+
+    LabelsDeltaRecordClear(&record);
+    SRGAnalyticsLabelsDeltaExpanderDestroy(expander);
+}
+
+static void TestKeyFrameAndDelta(void)
+{
+    SRGAnalyticsLabelsDeltaExpander *expander = SRGAnalyticsLabelsDeltaExpanderCreate(1);
+    LabelsDeltaRecord record = { .sorted = true };
+
+    SRGAnalyticsLabel keyFrame[] = {
+        { "media_position", "0" },
+        { "media_volume", "100" },
+        { "app_version", "1.0" },
+        { SRGAnalyticsLabelsDeltaSessionKey, "session" },
+        { SRGAnalyticsLabelsDeltaSequenceKey, "0" }
+    };
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, keyFrame, sizeof(keyFrame) / sizeof(keyFrame[0]), &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+    SRGAnalyticsTestAssertEqual(record.count, 3);
+
+    SRGAnalyticsLabel delta[] = {
+        { SRGAnalyticsLabelsDeltaSessionKey, "session" },
+        { SRGAnalyticsLabelsDeltaSequenceKey, "1" },
+        { SRGAnalyticsLabelsDeltaBaseKey, "0" },
+        { SRGAnalyticsLabelsDeltaRemovedKey, "app_version" },
+        { "media_position", "30" }
+    };
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, delta, sizeof(delta) / sizeof(delta[0]), &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+    const char *values[LabelsDeltaKeyCount] = { NULL, NULL, NULL, "30", NULL, "100", NULL };
+    SRGAnalyticsTestAssert(LabelsDeltaRecordMatchesValues(&record, values));
+
+    LabelsDeltaRecordClear(&record);
+    SRGAnalyticsLabelsDeltaExpanderDestroy(expander);
+}
+
+static void TestMissingBase(void)
+{
+    SRGAnalyticsLabelsDeltaExpander *expander = SRGAnalyticsLabelsDeltaExpanderCreate(1);
+    LabelsDeltaRecord record = { .sorted = true };
+
+    LabelsDeltaEncoder encoder;
+    LabelsDeltaEncoderInit(&encoder, "session");
+
+    const char *values1[LabelsDeltaKeyCount] = { "1", NULL, NULL, NULL, NULL, NULL, NULL };
+    LabelsDeltaEncoderEncode(&encoder, values1, true);
+    SRGAnalyticsLabel keyFrame[LabelsDeltaKeyCount + 4];
+    size_t keyFrameCount = encoder.labelCount;
+    memcpy(keyFrame, encoder.labels, sizeof(keyFrame));
+    char keyFrameSequence[24];
+    snprintf(keyFrameSequence, sizeof(keyFrameSequence), "%s", encoder.sequenceString);
+    for (size_t i = 0; i < keyFrameCount; ++i) {
+        if (strcmp(keyFrame[i].key, SRGAnalyticsLabelsDeltaSequenceKey) == 0) {
+            keyFrame[i].value = keyFrameSequence;
+        }
+    }
+
+    // Lost record
+    const char *values2[LabelsDeltaKeyCount] = { "2", NULL, NULL, NULL, NULL, NULL, NULL };
+    LabelsDeltaEncoderEncode(&encoder, values2, false);
+
+    const char *values3[LabelsDeltaKeyCount] = { "3", NULL, NULL, "30", NULL, NULL, NULL };
+    LabelsDeltaEncoderEncode(&encoder, values3, false);
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder.labels, encoder.labelCount, &record), SRGAnalyticsLabelsDeltaStatusMissingBase);
+    SRGAnalyticsTestAssertEqual(record.count, 0);
+
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, keyFrame, keyFrameCount, &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+    SRGAnalyticsTestAssert(LabelsDeltaRecordMatchesValues(&record, values1));
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder.labels, encoder.labelCount, &record), SRGAnalyticsLabelsDeltaStatusMissingBase);
+
+    LabelsDeltaRecordClear(&record);
+    SRGAnalyticsLabelsDeltaExpanderDestroy(expander);
+}
+
+static void TestMalformedLabels(void)
+{
+    SRGAnalyticsLabelsDeltaExpander *expander = SRGAnalyticsLabelsDeltaExpanderCreate(1);
+    LabelsDeltaRecord record = { .sorted = true };
+
+    SRGAnalyticsLabel withoutSequence[] = { { SRGAnalyticsLabelsDeltaSessionKey, "session" } };
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, withoutSequence, 1, &record), SRGAnalyticsLabelsDeltaStatusInvalid);
+
+    SRGAnalyticsLabel negativeSequence[] = { { SRGAnalyticsLabelsDeltaSessionKey, "session" }, { SRGAnalyticsLabelsDeltaSequenceKey, "-1" } };
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, negativeSequence, 2, &record), SRGAnalyticsLabelsDeltaStatusInvalid);
+
+    SRGAnalyticsLabel invalidBase[] = { { SRGAnalyticsLabelsDeltaSessionKey, "session" }, { SRGAnalyticsLabelsDeltaSequenceKey, "1" }, { SRGAnalyticsLabelsDeltaBaseKey, "zero" } };
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, invalidBase, 3, &record), SRGAnalyticsLabelsDeltaStatusInvalid);
+
+    SRGAnalyticsLabel duplicateKeys[] = { { SRGAnalyticsLabelsDeltaSessionKey, "session" }, { SRGAnalyticsLabelsDeltaSequenceKey, "0" }, { "key", "1" }, { "key", "2" } };
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, duplicateKeys, 4, &record), SRGAnalyticsLabelsDeltaStatusInvalid);
+
+    SRGAnalyticsLabel keyFrameWithRemovedKeys[] = { { SRGAnalyticsLabelsDeltaSessionKey, "session" }, { SRGAnalyticsLabelsDeltaSequenceKey, "0" }, { SRGAnalyticsLabelsDeltaRemovedKey, "key" } };
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, keyFrameWithRemovedKeys, 3, &record), SRGAnalyticsLabelsDeltaStatusInvalid);
+    SRGAnalyticsTestAssertEqual(record.count, 0);
+
+    LabelsDeltaRecordClear(&record);
+    SRGAnalyticsLabelsDeltaExpanderDestroy(expander);
+}
+
+static void TestSessionEvictionAndEnd(void)
+{
+    SRGAnalyticsLabelsDeltaExpander *expander = SRGAnalyticsLabelsDeltaExpanderCreate(2);
+    LabelsDeltaRecord record = { .sorted = true };
+
+    LabelsDeltaEncoder encoder1, encoder2, encoder3;
+    LabelsDeltaEncoderInit(&encoder1, "session1");
+    LabelsDeltaEncoderInit(&encoder2, "session2");
+    LabelsDeltaEncoderInit(&encoder3, "session3");
+
+    const char *values[LabelsDeltaKeyCount] = { "1", NULL, NULL, NULL, NULL, NULL, NULL };
+    LabelsDeltaEncoderEncode(&encoder1, values, true);
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder1.labels, encoder1.labelCount, &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+    LabelsDeltaEncoderEncode(&encoder2, values, true);
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder2.labels, encoder2.labelCount, &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+    LabelsDeltaEncoderEncode(&encoder1, values, false);
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder1.labels, encoder1.labelCount, &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+
+    // The least recently used session is evicted
+    LabelsDeltaEncoderEncode(&encoder3, values, true);
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder3.labels, encoder3.labelCount, &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+    LabelsDeltaEncoderEncode(&encoder2, values, false);
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder2.labels, encoder2.labelCount, &record), SRGAnalyticsLabelsDeltaStatusMissingBase);
+    LabelsDeltaEncoderEncode(&encoder1, values, false);
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder1.labels, encoder1.labelCount, &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+    SRGAnalyticsTestAssert(LabelsDeltaRecordMatchesValues(&record, values));
+
+    // Ended sessions are forgotten
+    SRGAnalyticsLabelsDeltaExpanderEndSession(expander, "session1");
+    LabelsDeltaEncoderEncode(&encoder1, values, false);
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder1.labels, encoder1.labelCount, &record), SRGAnalyticsLabelsDeltaStatusMissingBase);
+    LabelsDeltaEncoderEncode(&encoder3, values, false);
+    SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder3.labels, encoder3.labelCount, &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+
+    LabelsDeltaRecordClear(&record);
+    SRGAnalyticsLabelsDeltaExpanderDestroy(expander);
+}
+
+// Encode random label changes for interleaved sessions, and check each record is expanded into the original labels
+static void TestRoundTrip(void)
+{
+    srand(1);
+
+    SRGAnalyticsLabelsDeltaExpander *expander = SRGAnalyticsLabelsDeltaExpanderCreate(4);
+    LabelsDeltaRecord record = { .sorted = true };
+
+    LabelsDeltaEncoder encoders[LabelsDeltaSessionCount];
+    const char *previousValues[LabelsDeltaSessionCount][LabelsDeltaKeyCount];
+    for (size_t i = 0; i < LabelsDeltaSessionCount; ++i) {
+        char sessionIdentifier[32];
+        snprintf(sessionIdentifier, sizeof(sessionIdentifier), "session%zu", i);
+        LabelsDeltaEncoderInit(&encoders[i], sessionIdentifier);
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        size_t index = (size_t)rand() % LabelsDeltaSessionCount;
+        LabelsDeltaEncoder *encoder = &encoders[index];
+
+        const char *values[LabelsDeltaKeyCount];
+        LabelsDeltaRandomValues(values, encoder->hasPreviousValues ? previousValues[index] : NULL);
+        LabelsDeltaEncoderEncode(encoder, values, rand() % 20 == 0);
+
+        SRGAnalyticsTestAssertEqual(LabelsDeltaExpand(expander, encoder->labels, encoder->labelCount, &record), SRGAnalyticsLabelsDeltaStatusExpanded);
+        SRGAnalyticsTestAssert(LabelsDeltaRecordMatchesValues(&record, values));
+        memcpy(previousValues[index], values, sizeof(values));
+    }
+
+    LabelsDeltaRecordClear(&record);
+    SRGAnalyticsLabelsDeltaExpanderDestroy(expander);
+}
+
+#pragma mark Main
+
+int main(void)
+{
+    SRGAnalyticsTestRun(TestUnencodedLabels);
+    SRGAnalyticsTestRun(TestKeyFrameAndDelta);
+    SRGAnalyticsTestRun(TestMissingBase);
+    SRGAnalyticsTestRun(TestMalformedLabels);
+    SRGAnalyticsTestRun(TestSessionEvictionAndEnd);
+    SRGAnalyticsTestRun(TestRoundTrip);
+    return SRGAnalyticsTestResult();
+}
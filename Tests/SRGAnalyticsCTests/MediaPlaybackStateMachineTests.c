@@ -0,0 +1,164 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsCTests.h"
+#include "SRGMediaPlaybackStateMachine.h"
+
+#include <stdbool.h>
+
+static SRGMediaPlaybackStateMachine StateMachineWithLastEvent(SRGMediaPlaybackEvent lastEvent)
+{
+    SRGMediaPlaybackStateMachine stateMachine;
+    SRGMediaPlaybackStateMachineInit(&stateMachine);
+
+    if (lastEvent != SRGMediaPlaybackEventStop) {
+        SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+        SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPlay, events);
+        if (lastEvent != SRGMediaPlaybackEventPlay) {
+            SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, lastEvent, events);
+        }
+    }
+    return stateMachine;
+}
+
+#pragma mark Tests
+
+static void TestInitialState(void)
+{
+    SRGMediaPlaybackStateMachine stateMachine;
+    SRGMediaPlaybackStateMachineInit(&stateMachine);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), SRGMediaPlaybackEventStop);
+}
+
+// Check all transitions against the documented behavior, expressed as accepted transitions between states
+static void TestAllTransitions(void)
+{
+    static const SRGMediaPlaybackEvent kStates[] = {
+        SRGMediaPlaybackEventPlay,
+        SRGMediaPlaybackEventPause,
+        SRGMediaPlaybackEventSeek,
+        SRGMediaPlaybackEventEnd,
+        SRGMediaPlaybackEventStop
+    };
+
+    bool accepted[SRGMediaPlaybackEventCount][SRGMediaPlaybackEventCount] = { false };
+    accepted[SRGMediaPlaybackEventPlay][SRGMediaPlaybackEventPause] = true;
+    accepted[SRGMediaPlaybackEventPlay][SRGMediaPlaybackEventSeek] = true;
+    accepted[SRGMediaPlaybackEventPlay][SRGMediaPlaybackEventEnd] = true;
+    accepted[SRGMediaPlaybackEventPlay][SRGMediaPlaybackEventStop] = true;
+    accepted[SRGMediaPlaybackEventPause][SRGMediaPlaybackEventPlay] = true;
+    accepted[SRGMediaPlaybackEventPause][SRGMediaPlaybackEventSeek] = true;
+    accepted[SRGMediaPlaybackEventPause][SRGMediaPlaybackEventEnd] = true;
+    accepted[SRGMediaPlaybackEventPause][SRGMediaPlaybackEventStop] = true;
+    accepted[SRGMediaPlaybackEventSeek][SRGMediaPlaybackEventPlay] = true;
+    accepted[SRGMediaPlaybackEventSeek][SRGMediaPlaybackEventPause] = true;
+    accepted[SRGMediaPlaybackEventSeek][SRGMediaPlaybackEventEnd] = true;
+    accepted[SRGMediaPlaybackEventSeek][SRGMediaPlaybackEventStop] = true;
+    accepted[SRGMediaPlaybackEventEnd][SRGMediaPlaybackEventPlay] = true;
+    accepted[SRGMediaPlaybackEventStop][SRGMediaPlaybackEventPlay] = true;
+
+    for (size_t i = 0; i < sizeof(kStates) / sizeof(kStates[0]); ++i) {
+        SRGMediaPlaybackEvent state = kStates[i];
+        for (int event = SRGMediaPlaybackEventNone; event < SRGMediaPlaybackEventCount; ++event) {
+            SRGMediaPlaybackStateMachine stateMachine = StateMachineWithLastEvent(state);
+            SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), state);
+
+            SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+            size_t eventCount = SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, (SRGMediaPlaybackEvent)event, events);
+
+            if (event == SRGMediaPlaybackEventNone) {
+                SRGAnalyticsTestAssertEqual(eventCount, 0);
+                SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), state);
+            }
+            else if (! SRGMediaPlaybackEventIsStateEvent((SRGMediaPlaybackEvent)event)) {
+                SRGAnalyticsTestAssertEqual(eventCount, 1);
+                SRGAnalyticsTestAssertEqual(events[0], event);
+                SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), state);
+            }
+            else if (state == SRGMediaPlaybackEventStop && (event == SRGMediaPlaybackEventPause || event == SRGMediaPlaybackEventSeek)) {
+                SRGAnalyticsTestAssertEqual(eventCount, 2);
+                SRGAnalyticsTestAssertEqual(events[0], SRGMediaPlaybackEventPlay);
+                SRGAnalyticsTestAssertEqual(events[1], event);
+                SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), event);
+            }
+            else if (accepted[state][event]) {
+                SRGAnalyticsTestAssertEqual(eventCount, 1);
+                SRGAnalyticsTestAssertEqual(events[0], event);
+                SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), event);
+            }
+            else {
+                SRGAnalyticsTestAssertEqual(eventCount, 0);
+                SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), state);
+            }
+        }
+    }
+}
+
+static void TestInvalidEvent(void)
+{
+    SRGMediaPlaybackStateMachine stateMachine;
+    SRGMediaPlaybackStateMachineInit(&stateMachine);
+
+    SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventCount, events), 0);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, (SRGMediaPlaybackEvent)-1, events), 0);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), SRGMediaPlaybackEventStop);
+}
+
+static void TestSession(void)
+{
+    SRGMediaPlaybackStateMachine stateMachine;
+    SRGMediaPlaybackStateMachineInit(&stateMachine);
+
+    SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventBuffer, events), 0);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPlay, events), 1);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPosition, events), 1);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPlay, events), 0);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventEnd, events), 1);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventStop, events), 0);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPause, events), 0);
+    SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), SRGMediaPlaybackEventEnd);
+}
+
+// Emitted events never exceed the documented maximum, whatever the input sequence
+static void TestRandomSequences(void)
+{
+    srand(1);
+    for (int sequence = 0; sequence < 1000; ++sequence) {
+        SRGMediaPlaybackStateMachine stateMachine;
+        SRGMediaPlaybackStateMachineInit(&stateMachine);
+
+        for (int i = 0; i < 50; ++i) {
+            SRGMediaPlaybackEvent event = (SRGMediaPlaybackEvent)(rand() % SRGMediaPlaybackEventCount);
+            SRGMediaPlaybackEvent lastEvent = SRGMediaPlaybackStateMachineLastEvent(&stateMachine);
+
+            SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+            size_t eventCount = SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, event, events);
+            SRGAnalyticsTestAssert(eventCount <= SRGMediaPlaybackStateMachineMaximumEventCount);
+            SRGAnalyticsTestAssert(SRGMediaPlaybackEventIsStateEvent(SRGMediaPlaybackStateMachineLastEvent(&stateMachine)));
+            SRGAnalyticsTestAssert(SRGMediaPlaybackStateMachineLastEvent(&stateMachine) != SRGMediaPlaybackEventBuffer);
+            if (eventCount != 0) {
+                SRGAnalyticsTestAssertEqual(events[eventCount - 1], event);
+            }
+            if (! SRGMediaPlaybackEventIsStateEvent(event)) {
+                SRGAnalyticsTestAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), lastEvent);
+            }
+        }
+    }
+}
+
+#pragma mark Main
+
+int main(void)
+{
+    SRGAnalyticsTestRun(TestInitialState);
+    SRGAnalyticsTestRun(TestAllTransitions);
+    SRGAnalyticsTestRun(TestInvalidEvent);
+    SRGAnalyticsTestRun(TestSession);
+    SRGAnalyticsTestRun(TestRandomSequences);
+    return SRGAnalyticsTestResult();
+}
@@ -0,0 +1,173 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsCTests.h"
+#include "SRGAnalyticsRingBuffer.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RingBufferThreadCount 4
+#define RingBufferItemCountPerThread 100000
+
+typedef struct {
+    SRGAnalyticsRingBuffer *ringBuffer;
+    size_t index;
+    _Atomic size_t *poppedCount;
+    unsigned char *received;
+} RingBufferThreadContext;
+
+static void *RingBufferProducer(void *context)
+{
+    RingBufferThreadContext *threadContext = context;
+    for (size_t i = 0; i < RingBufferItemCountPerThread; ++i) {
+        uintptr_t item = threadContext->index * RingBufferItemCountPerThread + i + 1;
+        while (! SRGAnalyticsRingBufferPush(threadContext->ringBuffer, (void *)item)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *RingBufferConsumer(void *context)
+{
+    RingBufferThreadContext *threadContext = context;
+    size_t lastItems[RingBufferThreadCount] = { 0 };
+    while (atomic_load(threadContext->poppedCount) < RingBufferThreadCount * RingBufferItemCountPerThread) {
+        void *item = NULL;
+        if (! SRGAnalyticsRingBufferPop(threadContext->ringBuffer, &item)) {
+            sched_yield();
+            continue;
+        }
+
+        // Items pushed by a producer are popped in order
+        size_t value = (uintptr_t)item - 1;
+        size_t producerIndex = value / RingBufferItemCountPerThread;
+        SRGAnalyticsTestAssert(value + 1 > lastItems[producerIndex]);
+        lastItems[producerIndex] = value + 1;
+
+        threadContext->received[value] += 1;
+        atomic_fetch_add(threadContext->poppedCount, 1);
+    }
+    return NULL;
+}
+
+#pragma mark Tests
+
+static void TestCapacity(void)
+{
+    static const size_t kCapacities[][2] = { { 0, 2 }, { 1, 2 }, { 2, 2 }, { 3, 4 }, { 100, 128 }, { 1024, 1024 } };
+    for (size_t i = 0; i < sizeof(kCapacities) / sizeof(kCapacities[0]); ++i) {
+        SRGAnalyticsRingBuffer *ringBuffer = SRGAnalyticsRingBufferCreate(kCapacities[i][0]);
+        SRGAnalyticsTestAssertEqual(SRGAnalyticsRingBufferCapacity(ringBuffer), kCapacities[i][1]);
+        SRGAnalyticsTestAssertEqual(SRGAnalyticsRingBufferCount(ringBuffer), 0);
+        SRGAnalyticsRingBufferDestroy(ringBuffer);
+    }
+
+    SRGAnalyticsTestAssert(SRGAnalyticsRingBufferCreate(SIZE_MAX) == NULL);
+}
+
+static void TestFullAndEmpty(void)
+{
+    SRGAnalyticsRingBuffer *ringBuffer = SRGAnalyticsRingBufferCreate(4);
+
+    void *item = NULL;
+    SRGAnalyticsTestAssert(! SRGAnalyticsRingBufferPop(ringBuffer, &item));
+
+    for (uintptr_t i = 1; i <= 4; ++i) {
+        SRGAnalyticsTestAssert(SRGAnalyticsRingBufferPush(ringBuffer, (void *)i));
+    }
+    SRGAnalyticsTestAssert(! SRGAnalyticsRingBufferPush(ringBuffer, (void *)5));
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsRingBufferCount(ringBuffer), 4);
+
+    for (uintptr_t i = 1; i <= 4; ++i) {
+        SRGAnalyticsTestAssert(SRGAnalyticsRingBufferPop(ringBuffer, &item));
+        SRGAnalyticsTestAssertEqual((uintptr_t)item, i);
+    }
+    SRGAnalyticsTestAssert(! SRGAnalyticsRingBufferPop(ringBuffer, &item));
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsRingBufferCount(ringBuffer), 0);
+
+    SRGAnalyticsRingBufferDestroy(ringBuffer);
+}
+
+// Positions grow beyond the capacity many times, with all possible fill levels
+static void TestWraparound(void)
+{
+    SRGAnalyticsRingBuffer *ringBuffer = SRGAnalyticsRingBufferCreate(8);
+
+    uintptr_t nextPushedItem = 1, nextPoppedItem = 1;
+    for (size_t round = 0; round < 1000; ++round) {
+        size_t pushCount = round % 9;
+        for (size_t i = 0; i < pushCount; ++i) {
+            bool full = (nextPushedItem - nextPoppedItem == 8);
+            SRGAnalyticsTestAssertEqual(SRGAnalyticsRingBufferPush(ringBuffer, (void *)nextPushedItem), ! full);
+            if (! full) {
+                ++nextPushedItem;
+            }
+        }
+        SRGAnalyticsTestAssertEqual(SRGAnalyticsRingBufferCount(ringBuffer), nextPushedItem - nextPoppedItem);
+
+        size_t popCount = (round * 7) % 9;
+        for (size_t i = 0; i < popCount; ++i) {
+            void *item = NULL;
+            bool empty = (nextPushedItem == nextPoppedItem);
+            SRGAnalyticsTestAssertEqual(SRGAnalyticsRingBufferPop(ringBuffer, &item), ! empty);
+            if (! empty) {
+                SRGAnalyticsTestAssertEqual((uintptr_t)item, nextPoppedItem);
+                ++nextPoppedItem;
+            }
+        }
+        SRGAnalyticsTestAssertEqual(SRGAnalyticsRingBufferCount(ringBuffer), nextPushedItem - nextPoppedItem);
+    }
+    SRGAnalyticsTestAssert(nextPoppedItem > 100 * SRGAnalyticsRingBufferCapacity(ringBuffer));
+
+    SRGAnalyticsRingBufferDestroy(ringBuffer);
+}
+
+// Items are received exactly once by concurrent consumers, in order for each producer
+static void TestConcurrentProducersAndConsumers(void)
+{
+    SRGAnalyticsRingBuffer *ringBuffer = SRGAnalyticsRingBufferCreate(64);
+    _Atomic size_t poppedCount = 0;
+    unsigned char *received = calloc(RingBufferThreadCount * RingBufferItemCountPerThread, 1);
+
+    pthread_t producers[RingBufferThreadCount], consumers[RingBufferThreadCount];
+    RingBufferThreadContext contexts[RingBufferThreadCount];
+    for (size_t i = 0; i < RingBufferThreadCount; ++i) {
+        contexts[i] = (RingBufferThreadContext){ .ringBuffer = ringBuffer, .index = i, .poppedCount = &poppedCount, .received = received };
+        pthread_create(&producers[i], NULL, RingBufferProducer, &contexts[i]);
+        pthread_create(&consumers[i], NULL, RingBufferConsumer, &contexts[i]);
+    }
+    for (size_t i = 0; i < RingBufferThreadCount; ++i) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+
+    size_t missingCount = 0;
+    for (size_t i = 0; i < RingBufferThreadCount * RingBufferItemCountPerThread; ++i) {
+        if (received[i] != 1) {
+            ++missingCount;
+        }
+    }
+    SRGAnalyticsTestAssertEqual(missingCount, 0);
+    SRGAnalyticsTestAssertEqual(SRGAnalyticsRingBufferCount(ringBuffer), 0);
+
+    free(received);
+    SRGAnalyticsRingBufferDestroy(ringBuffer);
+}
+
+#pragma mark Main
+
+int main(void)
+{
+    SRGAnalyticsTestRun(TestCapacity);
+    SRGAnalyticsTestRun(TestFullAndEmpty);
+    SRGAnalyticsTestRun(TestWraparound);
+    SRGAnalyticsTestRun(TestConcurrentProducersAndConsumers);
+    return SRGAnalyticsTestResult();
+}
@@ -0,0 +1,60 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGAnalyticsCTests_h
+#define SRGAnalyticsCTests_h
+
+// Minimal harness for plain C unit tests of the portable kernels, built and run with the host compiler (see
+// `make test-c`). Each test executable runs its test functions with `SRGAnalyticsTestRun` and returns the result of
+// `SRGAnalyticsTestResult` from `main`. Failed assertions are reported without interrupting the current test.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned int s_testFailureCount;
+
+#define SRGAnalyticsTestAssert(condition)                                                                                    \
+    do {                                                                                                                     \
+        if (! (condition)) {                                                                                                 \
+            fprintf(stderr, "%s:%d: assertion failed: %s\n", __FILE__, __LINE__, #condition);                               \
+            ++s_testFailureCount;                                                                                            \
+        }                                                                                                                    \
+    } while (0)
+
+#define SRGAnalyticsTestAssertEqual(value, expectedValue)                                                                    \
+    do {                                                                                                                     \
+        uintmax_t _value = (uintmax_t)(value);                                                                               \
+        uintmax_t _expectedValue = (uintmax_t)(expectedValue);                                                               \
+        if (_value != _expectedValue) {                                                                                      \
+            fprintf(stderr, "%s:%d: %s (%" PRIuMAX ") is not equal to %s (%" PRIuMAX ")\n", __FILE__, __LINE__, #value,     \
+                    _value, #expectedValue, _expectedValue);                                                                 \
+            ++s_testFailureCount;                                                                                            \
+        }                                                                                                                    \
+    } while (0)
+
+#define SRGAnalyticsTestAssertEqualStrings(string, expectedString)                                                           \
+    do {                                                                                                                     \
+        const char *_string = (string);                                                                                      \
+        const char *_expectedString = (expectedString);                                                                      \
+        if (! _string || ! _expectedString || strcmp(_string, _expectedString) != 0) {                                       \
+            fprintf(stderr, "%s:%d: %s (\"%s\") is not equal to %s (\"%s\")\n", __FILE__, __LINE__, #string,                 \
+                    _string ?: "(null)", #expectedString, _expectedString ?: "(null)");                                      \
+            ++s_testFailureCount;                                                                                            \
+        }                                                                                                                    \
+    } while (0)
+
+#define SRGAnalyticsTestRun(test)                                                                                            \
+    do {                                                                                                                     \
+        unsigned int _failureCount = s_testFailureCount;                                                                     \
+        test();                                                                                                              \
+        printf("%s %s\n", (s_testFailureCount == _failureCount) ? "Passed" : "Failed", #test);                              \
+    } while (0)
+
+#define SRGAnalyticsTestResult() ((s_testFailureCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif /* SRGAnalyticsCTests_h */
@@ -0,0 +1,87 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGAnalyticsCTests.h"
+#include "SRGAnalyticsSampling.h"
+
+#define SamplingNanosecondsPerMillisecond 1000000ull
+#define SamplingNanosecondsPerSecond 1000000000ull
+
+#pragma mark Tests
+
+static void TestSamplingPositionStability(void)
+{
+    SRGAnalyticsTestAssert(SRGAnalyticsSamplingPosition("user", "scroll") == SRGAnalyticsSamplingPosition("user", "scroll"));
+    SRGAnalyticsTestAssert(SRGAnalyticsSamplingPosition("user", "scroll") != SRGAnalyticsSamplingPosition("user", "carousel"));
+    SRGAnalyticsTestAssert(SRGAnalyticsSamplingPosition("ab", "c") != SRGAnalyticsSamplingPosition("a", "bc"));
+    SRGAnalyticsTestAssert(SRGAnalyticsSamplingPosition("", "") >= 0. && SRGAnalyticsSamplingPosition("", "") < 1.);
+}
+
+static void TestSamplingPositionDistribution(void)
+{
+    // Ten buckets, each expected to receive a tenth of the identifiers
+    size_t counts[10] = { 0 };
+    for (int i = 0; i < 100000; ++i) {
+        char identifier[32];
+        snprintf(identifier, sizeof(identifier), "user-%d", i);
+        double position = SRGAnalyticsSamplingPosition(identifier, "scroll");
+        SRGAnalyticsTestAssert(position >= 0. && position < 1.);
+        counts[(size_t)(position * 10)] += 1;
+    }
+    for (size_t i = 0; i < 10; ++i) {
+        SRGAnalyticsTestAssert(counts[i] > 9500 && counts[i] < 10500);
+    }
+}
+
+static void TestTokenBucket(void)
+{
+    SRGAnalyticsTokenBucket bucket;
+    SRGAnalyticsTokenBucketInit(&bucket, 3, SamplingNanosecondsPerSecond, 0);
+
+    SRGAnalyticsTestAssert(SRGAnalyticsTokenBucketConsume(&bucket, 0));
+    SRGAnalyticsTestAssert(SRGAnalyticsTokenBucketConsume(&bucket, 0));
+    SRGAnalyticsTestAssert(SRGAnalyticsTokenBucketConsume(&bucket, 0));
+    SRGAnalyticsTestAssert(! SRGAnalyticsTokenBucketConsume(&bucket, 0));
+
+    // One token every third of a second
+    SRGAnalyticsTestAssert(! SRGAnalyticsTokenBucketConsume(&bucket, 300 * SamplingNanosecondsPerMillisecond));
+    SRGAnalyticsTestAssert(SRGAnalyticsTokenBucketConsume(&bucket, 340 * SamplingNanosecondsPerMillisecond));
+
+    // Tokens do not accumulate beyond capacity
+    size_t consumedCount = 0;
+    for (int i = 0; i < 10; ++i) {
+        if (SRGAnalyticsTokenBucketConsume(&bucket, 100 * SamplingNanosecondsPerSecond)) {
+            ++consumedCount;
+        }
+    }
+    SRGAnalyticsTestAssertEqual(consumedCount, 3);
+}
+
+// Over a long period, the number of consumed tokens matches the refill rate
+static void TestTokenBucketRate(void)
+{
+    SRGAnalyticsTokenBucket bucket;
+    SRGAnalyticsTokenBucketInit(&bucket, 10, SamplingNanosecondsPerSecond, 0);
+
+    size_t consumedCount = 0;
+    for (uint64_t time = 0; time < 100 * SamplingNanosecondsPerSecond; time += 10 * SamplingNanosecondsPerMillisecond) {
+        if (SRGAnalyticsTokenBucketConsume(&bucket, time)) {
+            ++consumedCount;
+        }
+    }
+    SRGAnalyticsTestAssert(consumedCount >= 1000 && consumedCount <= 1010);
+}
+
+#pragma mark Main
+
+int main(void)
+{
+    SRGAnalyticsTestRun(TestSamplingPositionStability);
+    SRGAnalyticsTestRun(TestSamplingPositionDistribution);
+    SRGAnalyticsTestRun(TestTokenBucket);
+    SRGAnalyticsTestRun(TestTokenBucketRate);
+    return SRGAnalyticsTestResult();
+}
@@ -0,0 +1,220 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+// Fuzzer for the comScore string formatting kernel. Built as a standalone executable generating random inputs (see
+// `make fuzz-string-formatting`), or as a libFuzzer target when compiled with `-DSRG_ANALYTICS_LIBFUZZER
+// -fsanitize=fuzzer`. Inputs are checked against a naive reference implementation for ASCII, and against invariants
+// of the format for arbitrary bytes.
+
+#include "SRGAnalyticsStringFormatting.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static SRGAnalyticsFormattingCache *s_cache;
+
+static void SRGAnalyticsFuzzerFail(const char *reason, const uint8_t *data, size_t size);
+static size_t SRGAnalyticsReferenceFormatASCIIString(const uint8_t *data, size_t size, char *output);
+
+#pragma mark Checks
+
+static size_t SRGAnalyticsFuzzerFormat(const uint8_t *data, size_t size, char **output)
+{
+    size_t capacity = SRGAnalyticsFormattedStringMaximumLength(size);
+    *output = malloc(capacity + 1);
+    size_t length = SRGAnalyticsFormatString((const char *)data, size, *output, capacity);
+    if (length > capacity) {
+        SRGAnalyticsFuzzerFail("output exceeds its capacity", data, size);
+    }
+    return length;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    char *output = NULL;
+    size_t length = SRGAnalyticsFuzzerFormat(data, size, &output);
+
+    // Only lowercase letters, digits and single inner hyphens
+    for (size_t i = 0; i < length; ++i) {
+        char character = output[i];
+        if (! ((character >= 'a' && character <= 'z') || (character >= '0' && character <= '9') || character == '-')) {
+            SRGAnalyticsFuzzerFail("unexpected output character", data, size);
+        }
+        if (character == '-' && (i == 0 || i == length - 1 || output[i - 1] == '-')) {
+            SRGAnalyticsFuzzerFail("misplaced hyphen", data, size);
+        }
+    }
+
+    // Formatting is idempotent
+    char *formattedOutput = NULL;
+    size_t formattedLength = SRGAnalyticsFuzzerFormat((const uint8_t *)output, length, &formattedOutput);
+    if (formattedLength != length || memcmp(formattedOutput, output, length) != 0) {
+        SRGAnalyticsFuzzerFail("formatting is not idempotent", data, size);
+    }
+    free(formattedOutput);
+
+    // Leading separators are trimmed. Shifting the input changes which bytes are processed with vector instructions.
+    for (size_t shift = 1; shift < 16; shift += 5) {
+        uint8_t *shiftedData = malloc(size + shift);
+        memset(shiftedData, ' ', shift);
+        memcpy(shiftedData + shift, data, size);
+
+        char *shiftedOutput = NULL;
+        size_t shiftedLength = SRGAnalyticsFuzzerFormat(shiftedData, size + shift, &shiftedOutput);
+        if (shiftedLength != length || memcmp(shiftedOutput, output, length) != 0) {
+            SRGAnalyticsFuzzerFail("result depends on the input alignment", data, size);
+        }
+        free(shiftedOutput);
+        free(shiftedData);
+    }
+
+    // Same result from the cache, whether the entry is found or not
+    char *cachedOutput = malloc(SRGAnalyticsFormattedStringMaximumLength(size) + 1);
+    for (int pass = 0; pass < 2; ++pass) {
+        size_t cachedLength = SRGAnalyticsFormattingCacheFormatString(s_cache, (const char *)data, size, cachedOutput, SRGAnalyticsFormattedStringMaximumLength(size), NULL);
+        if (cachedLength != length || memcmp(cachedOutput, output, length) != 0) {
+            SRGAnalyticsFuzzerFail("cached result differs", data, size);
+        }
+    }
+    free(cachedOutput);
+
+    // Same result as the reference implementation for ASCII
+    bool ascii = true;
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] >= 0x80) {
+            ascii = false;
+            break;
+        }
+    }
+    if (ascii) {
+        char *referenceOutput = malloc(SRGAnalyticsFormattedStringMaximumLength(size) + 1);
+        size_t referenceLength = SRGAnalyticsReferenceFormatASCIIString(data, size, referenceOutput);
+        if (referenceLength != length || memcmp(referenceOutput, output, length) != 0) {
+            SRGAnalyticsFuzzerFail("result differs from the reference", data, size);
+        }
+        free(referenceOutput);
+    }
+
+    free(output);
+    return 0;
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    (void)argc;
+    (void)argv;
+
+    s_cache = SRGAnalyticsFormattingCacheCreate();
+    return 0;
+}
+
+#pragma mark Standalone driver
+
+#ifndef SRG_ANALYTICS_LIBFUZZER
+
+// Titles are mostly made of letters and spaces, with some punctuation and accented letters
+static size_t SRGAnalyticsFuzzerRandomInput(uint8_t *data, size_t capacity)
+{
+    static const char *s_fragments[] = { "a", "Z", "0", " ", "-", "+", "&", "'", "!", "\xc3\xa9", "\xc3\x89", "\xc3\x9f", "e\xcc\x81", "\xe1\xba\xa1", "\xe2\x84\xaa", "\xf0\x9f\x98\x80", "\0" };
+    static const size_t s_fragmentCount = sizeof(s_fragments) / sizeof(s_fragments[0]);
+
+    size_t targetSize = (size_t)rand() % capacity;
+    size_t size = 0;
+    while (size < targetSize) {
+        // Random bytes, including invalid UTF-8
+        if (rand() % 16 == 0) {
+            data[size++] = (uint8_t)rand();
+            continue;
+        }
+
+        size_t fragmentIndex = (size_t)rand() % s_fragmentCount;
+        const char *fragment = s_fragments[fragmentIndex];
+        size_t fragmentLength = (fragmentIndex == s_fragmentCount - 1) ? 1 : strlen(fragment);
+        if (size + fragmentLength > capacity) {
+            break;
+        }
+
+        // Long alphanumeric runs are the common case for the vector path
+        size_t repeatCount = (rand() % 4 == 0) ? (size_t)rand() % 20 + 1 : 1;
+        for (size_t i = 0; i < repeatCount && size + fragmentLength <= capacity; ++i) {
+            memcpy(data + size, fragment, fragmentLength);
+            size += fragmentLength;
+        }
+    }
+    return size;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int seed = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 10) : 1;
+    unsigned long iterationCount = (argc > 2) ? strtoul(argv[2], NULL, 10) : 100000;
+
+    LLVMFuzzerInitialize(&argc, &argv);
+    srand(seed);
+
+    uint8_t data[256];
+    for (unsigned long iteration = 0; iteration < iterationCount; ++iteration) {
+        size_t size = SRGAnalyticsFuzzerRandomInput(data, sizeof(data));
+        LLVMFuzzerTestOneInput(data, size);
+    }
+
+    SRGAnalyticsFormattingCacheDestroy(s_cache);
+    printf("%lu inputs checked (seed %u)\n", iterationCount, seed);
+    return 0;
+}
+
+#endif
+
+#pragma mark Static functions
+
+static void SRGAnalyticsFuzzerFail(const char *reason, const uint8_t *data, size_t size)
+{
+    fprintf(stderr, "Failure: %s. Input (%zu bytes):", reason, size);
+    for (size_t i = 0; i < size; ++i) {
+        fprintf(stderr, " %02x", data[i]);
+    }
+    fprintf(stderr, "\n");
+    abort();
+}
+
+static size_t SRGAnalyticsReferenceFormatASCIIString(const uint8_t *data, size_t size, char *output)
+{
+    size_t length = 0;
+    bool separatorPending = false;
+    for (size_t i = 0; i < size; ++i) {
+        char character = (char)data[i];
+        const char *replacement = NULL;
+        char lowercaseCharacter[2] = { 0, 0 };
+        if (character >= 'A' && character <= 'Z') {
+            lowercaseCharacter[0] = character - 'A' + 'a';
+            replacement = lowercaseCharacter;
+        }
+        else if ((character >= 'a' && character <= 'z') || (character >= '0' && character <= '9')) {
+            lowercaseCharacter[0] = character;
+            replacement = lowercaseCharacter;
+        }
+        else if (character == '+' || character == '&') {
+            replacement = "and";
+        }
+
+        if (! replacement) {
+            separatorPending = true;
+            continue;
+        }
+
+        if (separatorPending && length != 0) {
+            output[length++] = '-';
+        }
+        separatorPending = false;
+
+        size_t replacementLength = strlen(replacement);
+        memcpy(output + length, replacement, replacementLength);
+        length += replacementLength;
+    }
+    return length;
+}
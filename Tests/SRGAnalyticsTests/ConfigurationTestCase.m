@@ -74,4 +74,122 @@
     XCTAssertEqualObjects(configuration.siteName, configurationCopy.siteName);
 }
 
+- (void)testEventPipelineSettings
+{
+    SRGAnalyticsConfiguration *configuration = [[SRGAnalyticsConfiguration alloc] initWithBusinessUnitIdentifier:SRGAnalyticsBusinessUnitIdentifierSRF
+                                                                                                       sourceKey:@"source-key"
+                                                                                                        siteName:@"site-name"];
+    XCTAssertEqual(configuration.eventQueueCapacity, 1024);
+    XCTAssertEqual(configuration.eventQueueOverflowPolicy, SRGAnalyticsEventQueueOverflowPolicyDropOldest);
+    XCTAssertEqual(configuration.eventDeliveryDelay, 0.);
+    XCTAssertEqual(configuration.eventDeliveryMaximumPendingCount, 20);
+    
+    configuration.eventQueueCapacity = 256;
+    configuration.eventQueueOverflowPolicy = SRGAnalyticsEventQueueOverflowPolicyBlock;
+    configuration.eventDeliveryDelay = 30.;
+    configuration.eventDeliveryMaximumPendingCount = 10;
+    
+    SRGAnalyticsConfiguration *configurationCopy = configuration.copy;
+    XCTAssertEqual(configurationCopy.eventQueueCapacity, 256);
+    XCTAssertEqual(configurationCopy.eventQueueOverflowPolicy, SRGAnalyticsEventQueueOverflowPolicyBlock);
+    XCTAssertEqual(configurationCopy.eventDeliveryDelay, 30.);
+    XCTAssertEqual(configurationCopy.eventDeliveryMaximumPendingCount, 10);
+}
+
+- (void)testPageViewDebounceInterval
+{
+    SRGAnalyticsConfiguration *configuration = [[SRGAnalyticsConfiguration alloc] initWithBusinessUnitIdentifier:SRGAnalyticsBusinessUnitIdentifierSRF
+                                                                                                       sourceKey:@"source-key"
+                                                                                                        siteName:@"site-name"];
+    XCTAssertEqual(configuration.pageViewDebounceInterval, 0.);
+    
+    configuration.pageViewDebounceInterval = 1.;
+    
+    SRGAnalyticsConfiguration *configurationCopy = configuration.copy;
+    XCTAssertEqual(configurationCopy.pageViewDebounceInterval, 1.);
+}
+
+- (void)testRequestInterceptionEnabled
+{
+    SRGAnalyticsConfiguration *configuration = [[SRGAnalyticsConfiguration alloc] initWithBusinessUnitIdentifier:SRGAnalyticsBusinessUnitIdentifierSRF
+                                                                                                       sourceKey:@"source-key"
+                                                                                                        siteName:@"site-name"];
+    XCTAssertTrue(configuration.requestInterceptionEnabled);
+    
+    configuration.requestInterceptionEnabled = NO;
+    
+    SRGAnalyticsConfiguration *configurationCopy = configuration.copy;
+    XCTAssertFalse(configurationCopy.requestInterceptionEnabled);
+}
+
+- (void)testStartupDeferred
+{
+    SRGAnalyticsConfiguration *configuration = [[SRGAnalyticsConfiguration alloc] initWithBusinessUnitIdentifier:SRGAnalyticsBusinessUnitIdentifierSRF
+                                                                                                       sourceKey:@"source-key"
+                                                                                                        siteName:@"site-name"];
+    XCTAssertFalse(configuration.startupDeferred);
+    
+    configuration.startupDeferred = YES;
+    
+    SRGAnalyticsConfiguration *configurationCopy = configuration.copy;
+    XCTAssertTrue(configurationCopy.startupDeferred);
+}
+
+- (void)testMediaHeartbeatDeltaEncodingEnabled
+{
+    SRGAnalyticsConfiguration *configuration = [[SRGAnalyticsConfiguration alloc] initWithBusinessUnitIdentifier:SRGAnalyticsBusinessUnitIdentifierSRF
+                                                                                                       sourceKey:@"source-key"
+                                                                                                        siteName:@"site-name"];
+    XCTAssertFalse(configuration.mediaHeartbeatDeltaEncodingEnabled);
+    
+    configuration.mediaHeartbeatDeltaEncodingEnabled = YES;
+    
+    SRGAnalyticsConfiguration *configurationCopy = configuration.copy;
+    XCTAssertTrue(configurationCopy.mediaHeartbeatDeltaEncodingEnabled);
+}
+
+- (void)testEventSampling
+{
+    SRGAnalyticsConfiguration *configuration = [[SRGAnalyticsConfiguration alloc] initWithBusinessUnitIdentifier:SRGAnalyticsBusinessUnitIdentifierSRF
+                                                                                                       sourceKey:@"source-key"
+                                                                                                        siteName:@"site-name"];
+    XCTAssertEqualObjects(configuration.eventSamplingPolicies, @{});
+    XCTAssertNil(configuration.samplingIdentifier);
+    
+    SRGAnalyticsSamplingPolicy *policy = [[SRGAnalyticsSamplingPolicy alloc] initWithSamplingRate:0.1 maximumEventCount:10 interval:60.];
+    configuration.eventSamplingPolicies = @{ @"scroll" : policy };
+    configuration.samplingIdentifier = @"user";
+    
+    SRGAnalyticsConfiguration *configurationCopy = configuration.copy;
+    XCTAssertEqualObjects(configurationCopy.eventSamplingPolicies, @{ @"scroll" : policy });
+    XCTAssertEqualObjects(configurationCopy.samplingIdentifier, @"user");
+}
+
+- (void)testMetricsEnabled
+{
+    SRGAnalyticsConfiguration *configuration = [[SRGAnalyticsConfiguration alloc] initWithBusinessUnitIdentifier:SRGAnalyticsBusinessUnitIdentifierSRF
+                                                                                                       sourceKey:@"source-key"
+                                                                                                        siteName:@"site-name"];
+    XCTAssertFalse(configuration.metricsEnabled);
+    
+    configuration.metricsEnabled = YES;
+    
+    SRGAnalyticsConfiguration *configurationCopy = configuration.copy;
+    XCTAssertTrue(configurationCopy.metricsEnabled);
+}
+
+- (void)testJournalDirectoryURL
+{
+    SRGAnalyticsConfiguration *configuration = [[SRGAnalyticsConfiguration alloc] initWithBusinessUnitIdentifier:SRGAnalyticsBusinessUnitIdentifierSRF
+                                                                                                       sourceKey:@"source-key"
+                                                                                                        siteName:@"site-name"];
+    XCTAssertNil(configuration.journalDirectoryURL);
+    
+    NSURL *journalDirectoryURL = [NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES];
+    configuration.journalDirectoryURL = journalDirectoryURL;
+    
+    SRGAnalyticsConfiguration *configurationCopy = configuration.copy;
+    XCTAssertEqualObjects(configurationCopy.journalDirectoryURL, journalDirectoryURL);
+}
+
 @end
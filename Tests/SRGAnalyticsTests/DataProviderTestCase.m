@@ -8,10 +8,13 @@
 
 // Private header
 #import "SRGAnalyticsLabels+Private.h"
+#import "SRGMediaComposition+SRGAnalyticsDataProvider_Private.h"
 #import "SRGResource+SRGAnalyticsDataProvider.h"
+#import "SRGSegmentTimeline.h"
 #import "TrackerSingletonSetup.h"
 
 @import libextobjc;
+@import Mantle;
 @import SRGAnalyticsDataProvider;
 @import SRGDataProviderNetwork;
 
@@ -25,6 +28,110 @@ static NSURL *MMFTestURL(void)
     return [NSURL URLWithString:@"https://play-mmf.herokuapp.com"];
 }
 
+static NSDictionary *MediaCompositionFixtureJSONDictionary(void)
+{
+    NSURL *fixtureURL = [SWIFTPM_MODULE_BUNDLE URLForResource:@"MediaComposition" withExtension:@"json" subdirectory:@"Resources"];
+    return [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfURL:fixtureURL] options:0 error:NULL];
+}
+
+// Build a media composition from the fixture, replacing the resources of its main chapter
+static SRGMediaComposition *MediaCompositionWithResourceJSONDictionaries(NSArray<NSDictionary *> *resourceJSONDictionaries)
+{
+    NSMutableDictionary *JSONDictionary = MediaCompositionFixtureJSONDictionary().mutableCopy;
+    NSMutableDictionary *chapterJSONDictionary = [JSONDictionary[@"chapterList"] firstObject].mutableCopy;
+    chapterJSONDictionary[@"resourceList"] = resourceJSONDictionaries;
+    JSONDictionary[@"chapterList"] = @[ chapterJSONDictionary ];
+    return [MTLJSONAdapter modelOfClass:SRGMediaComposition.class fromJSONDictionary:JSONDictionary error:NULL];
+}
+
+// One HLS resource for each URL scheme, stream type and quality combination (including unknown and missing values)
+static NSArray<NSDictionary *> *ResourceJSONDictionariesForAllCombinations(void)
+{
+    NSDictionary *templateJSONDictionary = [[MediaCompositionFixtureJSONDictionary()[@"chapterList"] firstObject][@"resourceList"] firstObject];
+    
+    NSMutableArray<NSDictionary *> *resourceJSONDictionaries = [NSMutableArray array];
+    for (NSString *scheme in @[ @"https", @"rtmp", @"http", @"ftp" ]) {
+        for (NSString *streamType in @[ @"", @"DVR", @"ON_DEMAND", @"LIVE" ]) {
+            for (NSString *quality in @[ @"HD", @"", @"HQ", @"SD" ]) {
+                NSMutableDictionary *resourceJSONDictionary = templateJSONDictionary.mutableCopy;
+                NSString *URLString = [NSString stringWithFormat:@"%@://localhost/%@/%@/%@.m3u8", scheme, @(resourceJSONDictionaries.count), streamType, quality];
+                resourceJSONDictionary[@"url"] = URLString;
+                resourceJSONDictionary[@"analyticsMetadata"] = @{ @"media_url" : URLString };
+                resourceJSONDictionary[@"streaming"] = @"HLS";
+                resourceJSONDictionary[@"streamType"] = (streamType.length != 0) ? streamType : nil;
+                resourceJSONDictionary[@"quality"] = (quality.length != 0) ? quality : nil;
+                [resourceJSONDictionaries addObject:resourceJSONDictionary.copy];
+            }
+        }
+    }
+    return resourceJSONDictionaries.copy;
+}
+
+static SRGResource *PreferredResource(SRGMediaComposition *mediaComposition, SRGPlaybackSettings *settings)
+{
+    __block SRGResource *preferredResource = nil;
+    [mediaComposition playbackContextWithPreferredSettings:settings contextBlock:^(NSURL * _Nonnull streamURL, SRGResource * _Nonnull resource, NSArray<id<SRGSegment>> * _Nullable segments, NSInteger index, SRGAnalyticsStreamLabels * _Nullable analyticsLabels) {
+        preferredResource = resource;
+    }];
+    return preferredResource;
+}
+
+// Ordered value comparator, as formerly used to sort resources (preferred value last, unknown values after all others)
+static NSComparator OrderedValueComparator(NSArray<NSNumber *> *orderedValues, NSInteger preferredValue, NSInteger noneValue)
+{
+    if (preferredValue != noneValue) {
+        NSMutableArray<NSNumber *> *values = orderedValues.mutableCopy;
+        [values removeObject:@(preferredValue)];
+        [values addObject:@(preferredValue)];
+        orderedValues = values.copy;
+    }
+    
+    return ^(NSNumber * _Nonnull value1, NSNumber * _Nonnull value2) {
+        NSUInteger index1 = [orderedValues indexOfObject:value1];
+        NSUInteger index2 = [orderedValues indexOfObject:value2];
+        if (index1 == index2) {
+            return NSOrderedSame;
+        }
+        else if (index1 < index2) {
+            return NSOrderedAscending;
+        }
+        else {
+            return NSOrderedDescending;
+        }
+    };
+}
+
+// Resource ordering formerly implemented with sort descriptors, kept as reference
+static NSArray<SRGResource *> *ReferenceSortedResources(NSArray<SRGResource *> *resources, SRGStreamType streamType, SRGQuality quality)
+{
+    NSSortDescriptor *URLSchemeSortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@keypath(SRGResource.new, URL) ascending:NO comparator:^NSComparisonResult(NSURL * _Nonnull URL1, NSURL * _Nonnull URL2) {
+        NSArray<NSString *> *orderedURLSchemes = @[ @"http", @"https" ];
+        
+        NSUInteger index1 = [orderedURLSchemes indexOfObject:URL1.scheme];
+        NSUInteger index2 = [orderedURLSchemes indexOfObject:URL2.scheme];
+        if (index1 == index2) {
+            return NSOrderedSame;
+        }
+        else if (index1 == NSNotFound) {
+            return NSOrderedAscending;
+        }
+        else if (index2 == NSNotFound) {
+            return NSOrderedDescending;
+        }
+        else if (index1 < index2) {
+            return NSOrderedAscending;
+        }
+        else {
+            return NSOrderedDescending;
+        }
+    }];
+    NSSortDescriptor *streamTypeSortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@keypath(SRGResource.new, streamType) ascending:NO
+                                                                              comparator:OrderedValueComparator(@[ @(SRGStreamTypeOnDemand), @(SRGStreamTypeLive), @(SRGStreamTypeDVR) ], streamType, SRGStreamTypeNone)];
+    NSSortDescriptor *qualitySortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@keypath(SRGResource.new, quality) ascending:NO
+                                                                           comparator:OrderedValueComparator(@[ @(SRGQualitySD), @(SRGQualityHD), @(SRGQualityHQ) ], quality, SRGQualityNone)];
+    return [resources sortedArrayUsingDescriptors:@[ URLSchemeSortDescriptor, streamTypeSortDescriptor, qualitySortDescriptor ]];
+}
+
 @interface DataProviderTestCase : XCTestCase
 
 @property (nonatomic) SRGMediaPlayerController *mediaPlayerController;
@@ -809,6 +916,113 @@ static NSURL *MMFTestURL(void)
     [self waitForExpectationsWithTimeout:20. handler:nil];
 }
 
+// The complete ordering is compared by repeatedly selecting the preferred resource among the remaining ones
+- (void)testResourceOrderingMatchesReferenceSort
+{
+    NSArray<NSDictionary *> *allResourceJSONDictionaries = ResourceJSONDictionariesForAllCombinations();
+    
+    for (NSNumber *streamType in @[ @(SRGStreamTypeNone), @(SRGStreamTypeOnDemand), @(SRGStreamTypeLive), @(SRGStreamTypeDVR) ]) {
+        for (NSNumber *quality in @[ @(SRGQualityNone), @(SRGQualitySD), @(SRGQualityHD), @(SRGQualityHQ) ]) {
+            SRGPlaybackSettings *settings = [[SRGPlaybackSettings alloc] init];
+            settings.streamingMethod = SRGStreamingMethodHLS;
+            settings.streamType = streamType.integerValue;
+            settings.quality = quality.integerValue;
+            
+            NSArray<SRGResource *> *allResources = MediaCompositionWithResourceJSONDictionaries(allResourceJSONDictionaries).mainChapter.resources;
+            XCTAssertEqual(allResources.count, allResourceJSONDictionaries.count);
+            NSArray<NSURL *> *expectedURLs = [ReferenceSortedResources(allResources, settings.streamType, settings.quality) valueForKey:@keypath(SRGResource.new, URL)];
+            
+            NSMutableArray<NSURL *> *URLs = [NSMutableArray array];
+            NSMutableArray<NSDictionary *> *resourceJSONDictionaries = allResourceJSONDictionaries.mutableCopy;
+            while (resourceJSONDictionaries.count != 0) {
+                SRGMediaComposition *mediaComposition = MediaCompositionWithResourceJSONDictionaries(resourceJSONDictionaries);
+                SRGResource *resource = PreferredResource(mediaComposition, settings);
+                XCTAssertNotNil(resource);
+                
+                NSUInteger index = [mediaComposition.mainChapter.resources indexOfObjectIdenticalTo:resource];
+                [URLs addObject:resource.URL];
+                [resourceJSONDictionaries removeObjectAtIndex:index];
+            }
+            
+            XCTAssertEqualObjects(URLs, expectedURLs, @"Stream type %@, quality %@", streamType, quality);
+        }
+    }
+}
+
+- (void)testPreferredResourceCache
+{
+    SRGMediaComposition *mediaComposition = MediaCompositionWithResourceJSONDictionaries(ResourceJSONDictionariesForAllCombinations());
+    
+    SRGPlaybackSettings *settings = [[SRGPlaybackSettings alloc] init];
+    settings.streamingMethod = SRGStreamingMethodHLS;
+    
+    // Cached per chapter
+    SRGResource *resource = PreferredResource(mediaComposition, settings);
+    XCTAssertNotNil(resource);
+    XCTAssertEqual(PreferredResource(mediaComposition, settings), resource);
+    
+    // And per settings
+    SRGPlaybackSettings *otherSettings = [[SRGPlaybackSettings alloc] init];
+    otherSettings.streamingMethod = SRGStreamingMethodHLS;
+    otherSettings.streamType = SRGStreamTypeDVR;
+    otherSettings.quality = SRGQualitySD;
+    
+    SRGResource *otherResource = PreferredResource(mediaComposition, otherSettings);
+    XCTAssertEqual(otherResource.streamType, SRGStreamTypeDVR);
+    XCTAssertEqual(otherResource.quality, SRGQualitySD);
+    XCTAssertEqual(PreferredResource(mediaComposition, otherSettings), otherResource);
+    XCTAssertEqual(PreferredResource(mediaComposition, settings), resource);
+    
+    // Another chapter is resolved on its own
+    SRGMediaComposition *otherMediaComposition = MediaCompositionWithResourceJSONDictionaries(@[ ResourceJSONDictionariesForAllCombinations().lastObject ]);
+    SRGResource *otherChapterResource = PreferredResource(otherMediaComposition, settings);
+    XCTAssertEqualObjects(otherChapterResource.URL, otherMediaComposition.mainChapter.resources.firstObject.URL);
+    XCTAssertEqual(PreferredResource(mediaComposition, settings), resource);
+}
+
+- (void)testAnalyticsLabelsCache
+{
+    SRGMediaComposition *mediaComposition = MediaCompositionWithResourceJSONDictionaries(ResourceJSONDictionariesForAllCombinations());
+    NSArray<SRGResource *> *resources = mediaComposition.mainChapter.resources;
+    
+    // Cached per resource and source unique id
+    SRGAnalyticsStreamLabels *labels = [mediaComposition analyticsLabelsForResource:resources[0] sourceUid:nil];
+    XCTAssertEqualObjects([mediaComposition analyticsLabelsForResource:resources[0] sourceUid:nil], labels);
+    XCTAssertEqualObjects(labels.customInfo[@"media_url"], resources[0].URL.absoluteString);
+    XCTAssertEqualObjects([mediaComposition analyticsLabelsForResource:resources[1] sourceUid:nil].customInfo[@"media_url"], resources[1].URL.absoluteString);
+    XCTAssertEqualObjects([mediaComposition analyticsLabelsForResource:resources[0] sourceUid:@"source"].customInfo[@"source_id"], @"source");
+    XCTAssertNil([mediaComposition analyticsLabelsForResource:resources[0] sourceUid:nil].customInfo[@"source_id"]);
+    
+    // Altering returned labels must not affect cached ones
+    labels.customInfo = @{ @"key" : @"value" };
+    XCTAssertEqualObjects([mediaComposition analyticsLabelsForResource:resources[0] sourceUid:nil].customInfo[@"media_url"], resources[0].URL.absoluteString);
+}
+
+- (void)testAnalyticsLabelsCacheWithPreviousMediaComposition
+{
+    NSArray<NSDictionary *> *resourceJSONDictionaries = ResourceJSONDictionariesForAllCombinations();
+    SRGMediaComposition *previousMediaComposition = MediaCompositionWithResourceJSONDictionaries(resourceJSONDictionaries);
+    SRGResource *previousResource = previousMediaComposition.mainChapter.resources.firstObject;
+    SRGAnalyticsStreamLabels *previousLabels = [previousMediaComposition analyticsLabelsForResource:previousResource sourceUid:nil];
+    
+    // Labels of an identical composition are reused
+    SRGMediaComposition *mediaComposition = MediaCompositionWithResourceJSONDictionaries(resourceJSONDictionaries);
+    SRGResource *resource = mediaComposition.mainChapter.resources.firstObject;
+    XCTAssertEqualObjects([mediaComposition analyticsLabelsForResource:resource sourceUid:nil previousMediaComposition:previousMediaComposition previousResource:previousResource], previousLabels);
+    
+    // Labels of a composition whose labels changed are resolved again
+    NSMutableDictionary *changedResourceJSONDictionary = resourceJSONDictionaries.firstObject.mutableCopy;
+    changedResourceJSONDictionary[@"analyticsMetadata"] = @{ @"media_url" : @"changed" };
+    NSMutableArray<NSDictionary *> *changedResourceJSONDictionaries = resourceJSONDictionaries.mutableCopy;
+    changedResourceJSONDictionaries[0] = changedResourceJSONDictionary.copy;
+    
+    SRGMediaComposition *changedMediaComposition = MediaCompositionWithResourceJSONDictionaries(changedResourceJSONDictionaries);
+    SRGResource *changedResource = changedMediaComposition.mainChapter.resources.firstObject;
+    SRGAnalyticsStreamLabels *changedLabels = [changedMediaComposition analyticsLabelsForResource:changedResource sourceUid:nil previousMediaComposition:previousMediaComposition previousResource:previousResource];
+    XCTAssertEqualObjects(changedLabels.customInfo[@"media_url"], @"changed");
+    XCTAssertEqualObjects([changedMediaComposition analyticsLabelsForResource:changedResource sourceUid:nil], changedLabels);
+}
+
 - (void)testVideoAnalyticsLabels
 {
     __weak XCTestExpectation *expectation = [self expectationWithDescription:@"Media composition retrieved"];
@@ -843,6 +1057,40 @@ static NSURL *MMFTestURL(void)
     [self waitForExpectationsWithTimeout:20. handler:nil];
 }
 
+- (void)testCachedAnalyticsLabels
+{
+    __weak XCTestExpectation *expectation = [self expectationWithDescription:@"Media composition retrieved"];
+    
+    SRGDataProvider *dataProvider = [[SRGDataProvider alloc] initWithServiceURL:ServiceTestURL()];
+    [[dataProvider mediaCompositionForURN:@"urn:swi:video:42297626" standalone:NO withCompletionBlock:^(SRGMediaComposition * _Nullable mediaComposition, NSHTTPURLResponse * _Nullable HTTPResponse, NSError * _Nullable error) {
+        XCTAssertNotNil(mediaComposition);
+        
+        SRGResource *resource = mediaComposition.mainChapter.resources.firstObject;
+        SRGAnalyticsStreamLabels *labels1 = [mediaComposition analyticsLabelsForResource:resource sourceUid:nil];
+        SRGAnalyticsStreamLabels *labels2 = [mediaComposition analyticsLabelsForResource:resource sourceUid:nil];
+        XCTAssertEqualObjects(labels1, labels2);
+        XCTAssertNotEqual(labels1, labels2);
+        
+        // Altering returned labels must not affect cached ones
+        labels1.customInfo = @{ @"key" : @"value" };
+        XCTAssertEqualObjects([mediaComposition analyticsLabelsForResource:resource sourceUid:nil], labels2);
+        
+        SRGAnalyticsStreamLabels *sourceLabels = [mediaComposition analyticsLabelsForResource:resource sourceUid:@"source"];
+        XCTAssertEqualObjects(sourceLabels.customInfo[@"source_id"], @"source");
+        XCTAssertNil(labels2.customInfo[@"source_id"]);
+        
+        // Labels of an identical composition are reused
+        SRGMediaComposition *mediaCompositionCopy = mediaComposition.copy;
+        SRGResource *resourceCopy = mediaCompositionCopy.mainChapter.resources.firstObject;
+        SRGAnalyticsStreamLabels *copyLabels = [mediaCompositionCopy analyticsLabelsForResource:resourceCopy sourceUid:nil previousMediaComposition:mediaComposition previousResource:resource];
+        XCTAssertEqualObjects(copyLabels, labels2);
+        
+        [expectation fulfill];
+    }] resume];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+}
+
 - (void)testPlayMediaCompositionWithSourceUid
 {
     [self expectationForPlayerEventNotificationWithHandler:^BOOL(NSString *event, NSDictionary *labels) {
@@ -1046,4 +1294,49 @@ static NSURL *MMFTestURL(void)
     [self waitForExpectationsWithTimeout:20. handler:nil];
 }
 
+- (void)testSegmentTimeline
+{
+    SRGDataProvider *dataProvider = [[SRGDataProvider alloc] initWithServiceURL:ServiceTestURL()];
+    
+    __weak XCTestExpectation *expectation = [self expectationWithDescription:@"Media composition retrieved"];
+    
+    __block SRGMediaComposition *fetchedMediaComposition = nil;
+    [[dataProvider mediaCompositionForURN:@"urn:srf:video:84043ead-6e5a-4a05-875c-c1aa2998aa43" standalone:NO withCompletionBlock:^(SRGMediaComposition * _Nullable mediaComposition, NSHTTPURLResponse * _Nullable HTTPResponse, NSError * _Nullable error) {
+        XCTAssertNotNil(mediaComposition);
+        fetchedMediaComposition = mediaComposition;
+        [expectation fulfill];
+    }] resume];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    SRGChapter *chapter = fetchedMediaComposition.mainChapter;
+    XCTAssertNotEqual(chapter.segments.count, 0);
+    
+    SRGSegmentTimeline *timeline = [SRGSegmentTimeline timelineForChapter:chapter];
+    XCTAssertEqual([SRGSegmentTimeline timelineForChapter:chapter], timeline);
+    XCTAssertEqualObjects(timeline.segments, chapter.segments);
+    
+    NSDate *pastDate = [NSDate dateWithTimeIntervalSince1970:0.];
+    NSDate *futureDate = [NSDate.date dateByAddingTimeInterval:10. * 365. * 24. * 60. * 60.];
+    
+    [chapter.segments enumerateObjectsUsingBlock:^(SRGSegment * _Nonnull segment, NSUInteger idx, BOOL * _Nonnull stop) {
+        NSUInteger index = NSNotFound;
+        XCTAssertEqual([SRGSegmentTimeline timelineForSegment:segment index:&index], timeline);
+        XCTAssertEqual(index, idx);
+        
+        XCTAssertEqual(segment.srg_markRange, [timeline markRangeForSegmentAtIndex:idx]);
+        XCTAssertEqual(segment.srg_isBlocked, [segment blockingReasonAtDate:NSDate.date] != SRGBlockingReasonNone);
+        
+        for (NSDate *date in @[ pastDate, NSDate.date, futureDate ]) {
+            XCTAssertEqual([timeline isSegmentAtIndexBlocked:idx atDate:date], [segment blockingReasonAtDate:date] != SRGBlockingReasonNone);
+        }
+    }];
+}
+
+- (void)testSegmentTimelineWithoutSegments
+{
+    SRGSegmentTimeline *timeline = [[SRGSegmentTimeline alloc] initWithSegments:@[]];
+    XCTAssertEqualObjects(timeline.segments, @[]);
+}
+
 @end
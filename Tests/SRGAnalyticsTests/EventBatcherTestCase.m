@@ -0,0 +1,122 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventBatcher.h"
+
+@import XCTest;
+
+@interface EventBatcherTestCase : XCTestCase
+
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic) NSMutableArray<NSArray<NSNumber *> *> *batches;
+@property (nonatomic) SRGAnalyticsEventBatcher<NSNumber *> *batcher;
+
+@end
+
+@implementation EventBatcherTestCase
+
+#pragma mark Setup and teardown
+
+- (void)setUp
+{
+    self.queue = dispatch_queue_create("ch.srgssr.analytics.tests.batcher", DISPATCH_QUEUE_SERIAL);
+    self.batches = [NSMutableArray array];
+    self.batcher = [[SRGAnalyticsEventBatcher alloc] initWithQueue:self.queue handler:^(NSArray<NSNumber *> * _Nonnull objects) {
+        [self.batches addObject:objects];
+    }];
+}
+
+- (void)tearDown
+{
+    self.batcher = nil;
+}
+
+#pragma mark Helpers
+
+- (void)addNumbersFrom:(NSInteger)from to:(NSInteger)to
+{
+    dispatch_sync(self.queue, ^{
+        for (NSInteger i = from; i <= to; ++i) {
+            [self.batcher addObject:@(i)];
+        }
+    });
+}
+
+- (NSArray<NSArray<NSNumber *> *> *)receivedBatches
+{
+    __block NSArray<NSArray<NSNumber *> *> *batches = nil;
+    dispatch_sync(self.queue, ^{
+        batches = self.batches.copy;
+    });
+    return batches;
+}
+
+#pragma mark Tests
+
+- (void)testWithoutBatching
+{
+    [self addNumbersFrom:1 to:3];
+    XCTAssertEqualObjects([self receivedBatches], (@[ @[ @1 ], @[ @2 ], @[ @3 ] ]));
+}
+
+- (void)testMaximumCount
+{
+    self.batcher.interval = 60.;
+    self.batcher.maximumCount = 3;
+
+    [self addNumbersFrom:1 to:7];
+    XCTAssertEqualObjects([self receivedBatches], (@[ @[ @1, @2, @3 ], @[ @4, @5, @6 ] ]));
+    XCTAssertEqual(self.batcher.count, 1);
+}
+
+- (void)testTimeWindow
+{
+    self.batcher.interval = 1.;
+
+    [self addNumbersFrom:1 to:3];
+    XCTAssertEqualObjects([self receivedBatches], @[]);
+
+    [self expectationForPredicate:[NSPredicate predicateWithBlock:^BOOL(id  _Nullable evaluatedObject, NSDictionary<NSString *,id> * _Nullable bindings) {
+        return [self receivedBatches].count == 1;
+    }] evaluatedWithObject:self handler:nil];
+
+    [self waitForExpectationsWithTimeout:5. handler:nil];
+
+    XCTAssertEqualObjects([self receivedBatches], (@[ @[ @1, @2, @3 ] ]));
+}
+
+- (void)testExtendedTimeWindow
+{
+    self.batcher.interval = 1.;
+    self.batcher.windowExtended = YES;
+
+    [self addNumbersFrom:1 to:3];
+
+    // The regular window has elapsed, but not the extended one
+    [NSThread sleepForTimeInterval:2.];
+    XCTAssertEqualObjects([self receivedBatches], @[]);
+
+    [self expectationForPredicate:[NSPredicate predicateWithBlock:^BOOL(id  _Nullable evaluatedObject, NSDictionary<NSString *,id> * _Nullable bindings) {
+        return [self receivedBatches].count == 1;
+    }] evaluatedWithObject:self handler:nil];
+
+    [self waitForExpectationsWithTimeout:10. handler:nil];
+}
+
+- (void)testFlush
+{
+    self.batcher.interval = 60.;
+
+    [self addNumbersFrom:1 to:2];
+    dispatch_sync(self.queue, ^{
+        [self.batcher flush];
+        [self.batcher flush];
+    });
+    XCTAssertEqualObjects([self receivedBatches], (@[ @[ @1, @2 ] ]));
+    XCTAssertEqual(self.batcher.count, 0);
+}
+
+@end
@@ -0,0 +1,128 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventJournal.h"
+
+@import XCTest;
+
+@interface EventJournalTestCase : XCTestCase
+
+@property (nonatomic) NSURL *directoryURL;
+
+@end
+
+@implementation EventJournalTestCase
+
+#pragma mark Setup and teardown
+
+- (void)setUp
+{
+    self.directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+}
+
+- (void)tearDown
+{
+    [NSFileManager.defaultManager removeItemAtURL:self.directoryURL error:NULL];
+}
+
+#pragma mark Tests
+
+- (void)testEmptyJournal
+{
+    SRGAnalyticsEventJournal *journal = [[SRGAnalyticsEventJournal alloc] initWithDirectoryURL:self.directoryURL];
+    XCTAssertNotNil(journal);
+    XCTAssertEqual(journal.replayedRecords.count, 0);
+    XCTAssertEqual(journal.pendingCount, 0);
+}
+
+- (void)testAppendAndAcknowledge
+{
+    SRGAnalyticsEventJournal *journal = [[SRGAnalyticsEventJournal alloc] initWithDirectoryURL:self.directoryURL];
+
+    SRGAnalyticsEventJournalRecord *record1 = [journal recordByAppendingPayload:@{ @"name" : @"event1" }];
+    XCTAssertTrue(record1.persisted);
+    XCTAssertEqualObjects(record1.payload, @{ @"name" : @"event1" });
+
+    SRGAnalyticsEventJournalRecord *record2 = [journal recordByAppendingPayload:@{ @"name" : @"event2" }];
+    XCTAssertTrue(record2.persisted);
+    XCTAssertEqual(journal.pendingCount, 2);
+
+    [journal acknowledgeRecord:record1];
+    XCTAssertFalse(record1.persisted);
+    XCTAssertEqual(journal.pendingCount, 1);
+
+    // Acknowledging twice has no effect
+    [journal acknowledgeRecord:record1];
+    XCTAssertEqual(journal.pendingCount, 1);
+
+    [journal acknowledgeRecord:record2];
+    XCTAssertEqual(journal.pendingCount, 0);
+}
+
+- (void)testReplay
+{
+    @autoreleasepool {
+        SRGAnalyticsEventJournal *journal = [[SRGAnalyticsEventJournal alloc] initWithDirectoryURL:self.directoryURL];
+        for (NSInteger i = 0; i < 1000; ++i) {
+            SRGAnalyticsEventJournalRecord *record = [journal recordByAppendingPayload:@{ @"index" : @(i) }];
+            if (i % 2 == 0) {
+                [journal acknowledgeRecord:record];
+            }
+        }
+        XCTAssertEqual(journal.pendingCount, 500);
+    }
+
+    SRGAnalyticsEventJournal *journal = [[SRGAnalyticsEventJournal alloc] initWithDirectoryURL:self.directoryURL];
+    XCTAssertEqual(journal.pendingCount, 500);
+    XCTAssertEqual(journal.replayedRecords.count, 500);
+
+    [journal.replayedRecords enumerateObjectsUsingBlock:^(SRGAnalyticsEventJournalRecord * _Nonnull record, NSUInteger idx, BOOL * _Nonnull stop) {
+        XCTAssertTrue(record.persisted);
+        XCTAssertEqualObjects(record.payload, @{ @"index" : @(2 * idx + 1) });
+    }];
+
+    for (SRGAnalyticsEventJournalRecord *record in journal.replayedRecords) {
+        [journal acknowledgeRecord:record];
+    }
+    XCTAssertEqual(journal.pendingCount, 0);
+
+    // All segments have been acknowledged and are therefore deleted
+    NSArray<NSString *> *fileNames = [NSFileManager.defaultManager contentsOfDirectoryAtPath:self.directoryURL.path error:NULL];
+    XCTAssertEqual(fileNames.count, 0);
+}
+
+- (void)testCorruptedRecordIsSkipped
+{
+    @autoreleasepool {
+        SRGAnalyticsEventJournal *journal = [[SRGAnalyticsEventJournal alloc] initWithDirectoryURL:self.directoryURL];
+        [journal recordByAppendingPayload:@{ @"name" : @"event1" }];
+        [journal recordByAppendingPayload:@{ @"name" : @"event2" }];
+    }
+
+    // Alter the payload of the first record (located after the segment header and record header)
+    NSString *fileName = [NSFileManager.defaultManager contentsOfDirectoryAtPath:self.directoryURL.path error:NULL].firstObject;
+    NSURL *fileURL = [self.directoryURL URLByAppendingPathComponent:fileName];
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForUpdatingURL:fileURL error:NULL];
+    [fileHandle seekToFileOffset:256 + 32 + 4];
+    [fileHandle writeData:[@"X" dataUsingEncoding:NSUTF8StringEncoding]];
+    [fileHandle closeFile];
+
+    SRGAnalyticsEventJournal *journal = [[SRGAnalyticsEventJournal alloc] initWithDirectoryURL:self.directoryURL];
+    XCTAssertEqual(journal.replayedRecords.count, 1);
+    XCTAssertEqualObjects(journal.replayedRecords.firstObject.payload, @{ @"name" : @"event2" });
+}
+
+- (void)testUnpersistedRecord
+{
+    SRGAnalyticsEventJournalRecord *record = [[SRGAnalyticsEventJournalRecord alloc] initWithPayload:@{ @"name" : @"event" }];
+    XCTAssertFalse(record.persisted);
+
+    SRGAnalyticsEventJournal *journal = [[SRGAnalyticsEventJournal alloc] initWithDirectoryURL:self.directoryURL];
+    [journal acknowledgeRecord:record];
+    XCTAssertEqual(journal.pendingCount, 0);
+}
+
+@end
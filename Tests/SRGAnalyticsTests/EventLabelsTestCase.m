@@ -128,6 +128,27 @@
     XCTAssertEqualObjects(labels, labelsCopy);
 }
 
+- (void)testCustomInfoIsCopied
+{
+    NSMutableDictionary<NSString *, NSString *> *customInfo = [@{ @"key" : @"value" } mutableCopy];
+    NSMutableDictionary<NSString *, NSString *> *comScoreCustomInfo = [@{ @"cs_key" : @"value" } mutableCopy];
+    
+    SRGAnalyticsEventLabels *labels = [[SRGAnalyticsEventLabels alloc] init];
+    labels.customInfo = customInfo;
+    labels.comScoreCustomInfo = comScoreCustomInfo;
+    
+    SRGAnalyticsEventLabels *labelsCopy = labels.copy;
+    
+    customInfo[@"key"] = @"other_value";
+    comScoreCustomInfo[@"cs_key"] = @"other_value";
+    
+    XCTAssertEqualObjects(labels.customInfo, @{ @"key" : @"value" });
+    XCTAssertEqualObjects(labels.comScoreCustomInfo, @{ @"cs_key" : @"value" });
+    XCTAssertEqualObjects(labels.labelsDictionary[@"key"], @"value");
+    XCTAssertEqualObjects(labelsCopy.customInfo, @{ @"key" : @"value" });
+    XCTAssertEqualObjects(labelsCopy.comScoreCustomInfo, @{ @"cs_key" : @"value" });
+}
+
 - (void)testCustomInfoOverrides
 {
     SRGAnalyticsEventLabels *labels = [[SRGAnalyticsEventLabels alloc] init];
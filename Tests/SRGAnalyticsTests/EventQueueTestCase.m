@@ -0,0 +1,218 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventQueue.h"
+
+@import XCTest;
+
+@interface EventQueueTestCase : XCTestCase
+
+@end
+
+@implementation EventQueueTestCase
+
+#pragma mark Helpers
+
+// Return a queue whose worker is stuck processing a first object until the returned semaphore is signaled. Objects
+// received by the handler are added to the provided array.
+- (SRGAnalyticsEventQueue<NSNumber *> *)blockedQueueWithCapacity:(NSUInteger)capacity
+                                                  overflowPolicy:(SRGAnalyticsEventQueueOverflowPolicy)overflowPolicy
+                                                 receivedNumbers:(NSMutableArray<NSNumber *> *)receivedNumbers
+                                                 resumeSemaphore:(dispatch_semaphore_t)resumeSemaphore
+{
+    dispatch_semaphore_t startedSemaphore = dispatch_semaphore_create(0);
+    SRGAnalyticsEventQueue<NSNumber *> *queue = [[SRGAnalyticsEventQueue alloc] initWithCapacity:capacity overflowPolicy:overflowPolicy handler:^(NSNumber * _Nonnull number) {
+        if (number.integerValue == 0) {
+            dispatch_semaphore_signal(startedSemaphore);
+            dispatch_semaphore_wait(resumeSemaphore, DISPATCH_TIME_FOREVER);
+        }
+        @synchronized (receivedNumbers) {
+            [receivedNumbers addObject:number];
+        }
+    }];
+
+    [queue enqueueObject:@0];
+    dispatch_semaphore_wait(startedSemaphore, DISPATCH_TIME_FOREVER);
+    return queue;
+}
+
+- (void)waitUntilQueueIsEmpty:(SRGAnalyticsEventQueue *)queue
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Queue empty"];
+    dispatch_async(queue.workerQueue, ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:10. handler:nil];
+}
+
+#pragma mark Tests
+
+- (void)testCapacity
+{
+    SRGAnalyticsEventQueue *queue = [[SRGAnalyticsEventQueue alloc] initWithCapacity:100 overflowPolicy:SRGAnalyticsEventQueueOverflowPolicyDropOldest handler:^(id  _Nonnull object) {}];
+    XCTAssertEqual(queue.capacity, 128);
+    XCTAssertEqual(queue.count, 0);
+}
+
+- (void)testOrderedDelivery
+{
+    NSMutableArray<NSNumber *> *receivedNumbers = [NSMutableArray array];
+    SRGAnalyticsEventQueue<NSNumber *> *queue = [[SRGAnalyticsEventQueue alloc] initWithCapacity:16 overflowPolicy:SRGAnalyticsEventQueueOverflowPolicyBlock handler:^(NSNumber * _Nonnull number) {
+        [receivedNumbers addObject:number];
+    }];
+
+    NSMutableArray<NSNumber *> *expectedNumbers = [NSMutableArray array];
+    for (NSInteger i = 0; i < 1000; ++i) {
+        XCTAssertTrue([queue enqueueObject:@(i)]);
+        [expectedNumbers addObject:@(i)];
+    }
+
+    [self waitUntilQueueIsEmpty:queue];
+
+    XCTAssertEqualObjects(receivedNumbers, expectedNumbers);
+    XCTAssertEqual(queue.enqueuedCount, 1000);
+    XCTAssertEqual(queue.droppedCount, 0);
+    XCTAssertEqual(queue.dispatchedCount, 1000);
+}
+
+- (void)testConcurrentProducers
+{
+    NSMutableArray<NSNumber *> *receivedNumbers = [NSMutableArray array];
+    SRGAnalyticsEventQueue<NSNumber *> *queue = [[SRGAnalyticsEventQueue alloc] initWithCapacity:8 overflowPolicy:SRGAnalyticsEventQueueOverflowPolicyBlock handler:^(NSNumber * _Nonnull number) {
+        [receivedNumbers addObject:number];
+    }];
+
+    dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t producer) {
+        for (NSInteger i = 0; i < 100; ++i) {
+            [queue enqueueObject:@(producer * 1000 + i)];
+        }
+    });
+
+    [self waitUntilQueueIsEmpty:queue];
+
+    XCTAssertEqual(receivedNumbers.count, 800);
+    XCTAssertEqual(queue.droppedCount, 0);
+    XCTAssertEqual(queue.dispatchedCount, 800);
+
+    // Order must be preserved for each producer
+    for (NSInteger producer = 0; producer < 8; ++producer) {
+        NSPredicate *predicate = [NSPredicate predicateWithFormat:@"self >= %@ AND self < %@", @(producer * 1000), @((producer + 1) * 1000)];
+        NSArray<NSNumber *> *producerNumbers = [receivedNumbers filteredArrayUsingPredicate:predicate];
+        XCTAssertEqualObjects(producerNumbers, [producerNumbers sortedArrayUsingSelector:@selector(compare:)]);
+        XCTAssertEqual(producerNumbers.count, 100);
+    }
+}
+
+- (void)testDropNewestPolicy
+{
+    NSMutableArray<NSNumber *> *receivedNumbers = [NSMutableArray array];
+    dispatch_semaphore_t resumeSemaphore = dispatch_semaphore_create(0);
+    SRGAnalyticsEventQueue<NSNumber *> *queue = [self blockedQueueWithCapacity:4
+                                                                overflowPolicy:SRGAnalyticsEventQueueOverflowPolicyDropNewest
+                                                               receivedNumbers:receivedNumbers
+                                                               resumeSemaphore:resumeSemaphore];
+
+    for (NSInteger i = 1; i <= 4; ++i) {
+        XCTAssertTrue([queue enqueueObject:@(i)]);
+    }
+    XCTAssertFalse([queue enqueueObject:@5]);
+    XCTAssertFalse([queue enqueueObject:@6]);
+    XCTAssertEqual(queue.count, 4);
+
+    dispatch_semaphore_signal(resumeSemaphore);
+    [self waitUntilQueueIsEmpty:queue];
+
+    XCTAssertEqualObjects(receivedNumbers, (@[ @0, @1, @2, @3, @4 ]));
+    XCTAssertEqual(queue.enqueuedCount, 5);
+    XCTAssertEqual(queue.droppedCount, 2);
+    XCTAssertEqual(queue.dispatchedCount, 5);
+}
+
+- (void)testDropOldestPolicy
+{
+    NSMutableArray<NSNumber *> *receivedNumbers = [NSMutableArray array];
+    dispatch_semaphore_t resumeSemaphore = dispatch_semaphore_create(0);
+    SRGAnalyticsEventQueue<NSNumber *> *queue = [self blockedQueueWithCapacity:4
+                                                                overflowPolicy:SRGAnalyticsEventQueueOverflowPolicyDropOldest
+                                                               receivedNumbers:receivedNumbers
+                                                               resumeSemaphore:resumeSemaphore];
+
+    for (NSInteger i = 1; i <= 6; ++i) {
+        XCTAssertTrue([queue enqueueObject:@(i)]);
+    }
+    XCTAssertEqual(queue.count, 4);
+
+    dispatch_semaphore_signal(resumeSemaphore);
+    [self waitUntilQueueIsEmpty:queue];
+
+    XCTAssertEqualObjects(receivedNumbers, (@[ @0, @3, @4, @5, @6 ]));
+    XCTAssertEqual(queue.enqueuedCount, 7);
+    XCTAssertEqual(queue.droppedCount, 2);
+    XCTAssertEqual(queue.dispatchedCount, 5);
+}
+
+- (void)testBlockPolicy
+{
+    NSMutableArray<NSNumber *> *receivedNumbers = [NSMutableArray array];
+    dispatch_semaphore_t resumeSemaphore = dispatch_semaphore_create(0);
+    SRGAnalyticsEventQueue<NSNumber *> *queue = [self blockedQueueWithCapacity:4
+                                                                overflowPolicy:SRGAnalyticsEventQueueOverflowPolicyBlock
+                                                               receivedNumbers:receivedNumbers
+                                                               resumeSemaphore:resumeSemaphore];
+
+    for (NSInteger i = 1; i <= 4; ++i) {
+        XCTAssertTrue([queue enqueueObject:@(i)]);
+    }
+
+    XCTestExpectation *producerExpectation = [self expectationWithDescription:@"Producer resumed"];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [queue enqueueObject:@5];
+        [producerExpectation fulfill];
+    });
+
+    // The producer must be blocked as long as the worker does not make room
+    [NSThread sleepForTimeInterval:0.5];
+    XCTAssertEqual(queue.enqueuedCount, 5);
+
+    dispatch_semaphore_signal(resumeSemaphore);
+    [self waitForExpectationsWithTimeout:10. handler:nil];
+    [self waitUntilQueueIsEmpty:queue];
+
+    XCTAssertEqualObjects(receivedNumbers, (@[ @0, @1, @2, @3, @4, @5 ]));
+    XCTAssertEqual(queue.droppedCount, 0);
+    XCTAssertEqual(queue.dispatchedCount, 6);
+}
+
+- (void)testPerformBlockAndWaitOnWorkerQueue
+{
+    __block SRGAnalyticsEventQueue<NSNumber *> *queue = nil;
+    NSMutableArray<NSNumber *> *performedNumbers = [NSMutableArray array];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Block performed from the handler"];
+    queue = [[SRGAnalyticsEventQueue alloc] initWithCapacity:4 overflowPolicy:SRGAnalyticsEventQueueOverflowPolicyDropNewest handler:^(NSNumber * _Nonnull number) {
+        // Must not deadlock when called from the worker queue
+        [queue performBlockAndWaitOnWorkerQueue:^{
+            [performedNumbers addObject:number];
+        }];
+        [expectation fulfill];
+    }];
+    
+    [queue performBlockAndWaitOnWorkerQueue:^{
+        [performedNumbers addObject:@0];
+    }];
+    XCTAssertEqualObjects(performedNumbers, @[ @0 ]);
+    
+    [queue enqueueObject:@1];
+    [self waitForExpectationsWithTimeout:10. handler:nil];
+    [self waitUntilQueueIsEmpty:queue];
+    
+    XCTAssertEqualObjects(performedNumbers, (@[ @0, @1 ]));
+    
+    // Break the retain cycle between the queue and its handler
+    queue = nil;
+}
+
+@end
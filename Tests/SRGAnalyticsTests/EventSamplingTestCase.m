@@ -0,0 +1,161 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsEventSampler.h"
+#import "SRGAnalyticsSampling.h"
+
+@import SRGAnalytics;
+@import XCTest;
+
+@interface EventSamplingTestCase : XCTestCase
+
+@end
+
+@implementation EventSamplingTestCase
+
+#pragma mark Tests
+
+- (void)testSamplingPositionStability
+{
+    XCTAssertEqual(SRGAnalyticsSamplingPosition("user", "scroll"), SRGAnalyticsSamplingPosition("user", "scroll"));
+    XCTAssertNotEqual(SRGAnalyticsSamplingPosition("user", "scroll"), SRGAnalyticsSamplingPosition("user", "carousel"));
+    XCTAssertNotEqual(SRGAnalyticsSamplingPosition("ab", "c"), SRGAnalyticsSamplingPosition("a", "bc"));
+}
+
+- (void)testSamplingPositionDistribution
+{
+    NSUInteger sampledCount = 0;
+    for (NSUInteger i = 0; i < 100000; i++) {
+        NSString *identifier = [NSString stringWithFormat:@"user-%@", @(i)];
+        double position = SRGAnalyticsSamplingPosition(identifier.UTF8String, "scroll");
+        XCTAssertGreaterThanOrEqual(position, 0.);
+        XCTAssertLessThan(position, 1.);
+        if (position < 0.1) {
+            sampledCount++;
+        }
+    }
+    XCTAssertEqualWithAccuracy(sampledCount, 10000, 500);
+}
+
+- (void)testTokenBucket
+{
+    SRGAnalyticsTokenBucket bucket;
+    SRGAnalyticsTokenBucketInit(&bucket, 3, NSEC_PER_SEC, 0);
+    
+    XCTAssertTrue(SRGAnalyticsTokenBucketConsume(&bucket, 0));
+    XCTAssertTrue(SRGAnalyticsTokenBucketConsume(&bucket, 0));
+    XCTAssertTrue(SRGAnalyticsTokenBucketConsume(&bucket, 0));
+    XCTAssertFalse(SRGAnalyticsTokenBucketConsume(&bucket, 0));
+    
+    // One token every third of a second
+    XCTAssertFalse(SRGAnalyticsTokenBucketConsume(&bucket, 300 * NSEC_PER_MSEC));
+    XCTAssertTrue(SRGAnalyticsTokenBucketConsume(&bucket, 340 * NSEC_PER_MSEC));
+    
+    // Tokens do not accumulate beyond capacity
+    NSUInteger consumedCount = 0;
+    for (NSUInteger i = 0; i < 10; i++) {
+        if (SRGAnalyticsTokenBucketConsume(&bucket, 100 * NSEC_PER_SEC)) {
+            consumedCount++;
+        }
+    }
+    XCTAssertEqual(consumedCount, 3);
+}
+
+- (void)testSamplingPolicy
+{
+    SRGAnalyticsSamplingPolicy *policy1 = [[SRGAnalyticsSamplingPolicy alloc] initWithSamplingRate:2.];
+    XCTAssertEqual(policy1.samplingRate, 1.);
+    XCTAssertEqual(policy1.maximumEventCount, 0);
+    
+    SRGAnalyticsSamplingPolicy *policy2 = [[SRGAnalyticsSamplingPolicy alloc] initWithSamplingRate:0.5 maximumEventCount:10 interval:0.];
+    XCTAssertEqual(policy2.samplingRate, 0.5);
+    XCTAssertEqual(policy2.maximumEventCount, 0);
+    
+    SRGAnalyticsSamplingPolicy *policy3 = [[SRGAnalyticsSamplingPolicy alloc] initWithSamplingRate:0.5 maximumEventCount:10 interval:60.];
+    XCTAssertEqual(policy3.maximumEventCount, 10);
+    XCTAssertEqual(policy3.interval, 60.);
+}
+
+- (void)testEventsWithoutPolicy
+{
+    SRGAnalyticsEventSampler *sampler = [[SRGAnalyticsEventSampler alloc] initWithPolicies:@{} identifier:@"user"];
+    
+    double weight = -1.;
+    XCTAssertTrue([sampler shouldSendEventWithName:@"scroll" time:0 weight:&weight]);
+    XCTAssertEqual(weight, 0.);
+}
+
+- (void)testDeterministicSampling
+{
+    NSDictionary<NSString *, SRGAnalyticsSamplingPolicy *> *policies = @{ @"scroll" : [[SRGAnalyticsSamplingPolicy alloc] initWithSamplingRate:0.25] };
+    
+    NSUInteger sampledCount = 0;
+    for (NSUInteger i = 0; i < 1000; i++) {
+        NSString *identifier = [NSString stringWithFormat:@"user-%@", @(i)];
+        SRGAnalyticsEventSampler *sampler = [[SRGAnalyticsEventSampler alloc] initWithPolicies:policies identifier:identifier];
+        
+        double weight = 0.;
+        BOOL sampled = [sampler shouldSendEventWithName:@"scroll" time:0 weight:&weight];
+        if (sampled) {
+            XCTAssertEqual(weight, 4.);
+            sampledCount++;
+        }
+        
+        // Decisions are consistent for a given identifier
+        for (NSUInteger j = 0; j < 5; j++) {
+            XCTAssertEqual([sampler shouldSendEventWithName:@"scroll" time:0 weight:&weight], sampled);
+        }
+        
+        SRGAnalyticsEventSampler *otherSampler = [[SRGAnalyticsEventSampler alloc] initWithPolicies:policies identifier:identifier];
+        XCTAssertEqual([otherSampler shouldSendEventWithName:@"scroll" time:0 weight:&weight], sampled);
+    }
+    XCTAssertEqualWithAccuracy(sampledCount, 250, 50);
+}
+
+- (void)testRateLimiting
+{
+    NSDictionary<NSString *, SRGAnalyticsSamplingPolicy *> *policies = @{ @"scroll" : [[SRGAnalyticsSamplingPolicy alloc] initWithSamplingRate:1. maximumEventCount:2 interval:1.] };
+    SRGAnalyticsEventSampler *sampler = [[SRGAnalyticsEventSampler alloc] initWithPolicies:policies identifier:@"user"];
+    
+    uint64_t time = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    
+    double weight = 0.;
+    XCTAssertTrue([sampler shouldSendEventWithName:@"scroll" time:time weight:&weight]);
+    XCTAssertEqual(weight, 1.);
+    XCTAssertTrue([sampler shouldSendEventWithName:@"scroll" time:time weight:&weight]);
+    XCTAssertEqual(weight, 1.);
+    XCTAssertFalse([sampler shouldSendEventWithName:@"scroll" time:time weight:&weight]);
+    XCTAssertFalse([sampler shouldSendEventWithName:@"scroll" time:time weight:&weight]);
+    XCTAssertFalse([sampler shouldSendEventWithName:@"scroll" time:time weight:&weight]);
+    
+    // The next event sent stands for the discarded ones
+    XCTAssertTrue([sampler shouldSendEventWithName:@"scroll" time:time + NSEC_PER_SEC weight:&weight]);
+    XCTAssertEqual(weight, 4.);
+    
+    // Other events are not limited
+    XCTAssertTrue([sampler shouldSendEventWithName:@"click" time:time weight:&weight]);
+    XCTAssertEqual(weight, 0.);
+}
+
+- (void)testInstallationIdentifier
+{
+    NSString *suiteName = [NSString stringWithFormat:@"ch.srgssr.analytics.tests.%@", NSUUID.UUID.UUIDString];
+    NSUserDefaults *userDefaults = [[NSUserDefaults alloc] initWithSuiteName:suiteName];
+    
+    NSString *installationIdentifier = [SRGAnalyticsEventSampler installationIdentifierWithUserDefaults:userDefaults];
+    XCTAssertNotEqual(installationIdentifier.length, 0);
+    XCTAssertEqualObjects([SRGAnalyticsEventSampler installationIdentifierWithUserDefaults:userDefaults], installationIdentifier);
+    
+    // Persisted across launches
+    NSUserDefaults *otherUserDefaults = [[NSUserDefaults alloc] initWithSuiteName:suiteName];
+    XCTAssertEqualObjects([SRGAnalyticsEventSampler installationIdentifierWithUserDefaults:otherUserDefaults], installationIdentifier);
+    
+    [userDefaults removePersistentDomainForName:suiteName];
+    XCTAssertNotEqualObjects([SRGAnalyticsEventSampler installationIdentifierWithUserDefaults:userDefaults], installationIdentifier);
+    [userDefaults removePersistentDomainForName:suiteName];
+}
+
+@end
@@ -0,0 +1,426 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "LoopbackCollector.h"
+#import "SRGAnalyticsEventBatcher.h"
+#import "SRGAnalyticsFileEventSink.h"
+#import "SRGAnalyticsHTTPEventSink.h"
+#import "SRGAnalyticsMemoryEventSink.h"
+#import "SRGAnalyticsTracker+Private.h"
+#import "TrackerSingletonSetup.h"
+#import "XCTestCase+Tests.h"
+
+@import XCTest;
+
+static NSArray<NSDictionary<NSString *, id> *> *TestPayloads(NSUInteger count)
+{
+    NSMutableArray<NSDictionary<NSString *, id> *> *payloads = [NSMutableArray array];
+    for (NSUInteger i = 0; i < count; i++) {
+        [payloads addObject:@{ SRGAnalyticsPayloadKindKey : SRGAnalyticsPayloadKindCustom,
+                               SRGAnalyticsPayloadNameKey : [NSString stringWithFormat:@"event%@", @(i)],
+                               SRGAnalyticsPayloadLabelsKey : @{ @"index" : @(i).stringValue } }];
+    }
+    return payloads.copy;
+}
+
+// Number of occurrences of a name
+static NSUInteger NameCount(NSArray<NSString *> *names, NSString *name)
+{
+    return [names indexesOfObjectsPassingTest:^BOOL(NSString * _Nonnull otherName, NSUInteger idx, BOOL * _Nonnull stop) {
+        return [otherName isEqualToString:name];
+    }].count;
+}
+
+// Names of all events received by a collector
+static NSArray<NSString *> *CollectedNames(LoopbackCollector *collector)
+{
+    NSMutableArray<NSString *> *names = [NSMutableArray array];
+    for (NSArray<NSDictionary<NSString *, id> *> *batch in collector.batches) {
+        [names addObjectsFromArray:[batch valueForKey:SRGAnalyticsPayloadNameKey]];
+    }
+    return names.copy;
+}
+
+// Deliver payloads and wait until delivery is complete, returning its result
+static SRGAnalyticsEventSinkDeliveryResult DeliverPayloads(id<SRGAnalyticsEventSink> eventSink, NSArray<NSDictionary<NSString *, id> *> *payloads)
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block SRGAnalyticsEventSinkDeliveryResult deliveryResult = SRGAnalyticsEventSinkDeliveryResultFailure;
+    [eventSink deliverPayloads:payloads completion:^(SRGAnalyticsEventSinkDeliveryResult result) {
+        deliveryResult = result;
+        dispatch_semaphore_signal(semaphore);
+    }];
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    return deliveryResult;
+}
+
+// Durable sink failing until `failing` is set to `NO`, optionally detaching itself from the tracker when delivering
+@interface FailingEventSink : NSObject <SRGAnalyticsEventSink>
+
+@property (atomic, getter=isFailing) BOOL failing;
+@property (atomic, getter=isDetachingItself) BOOL detachingItself;
+@property (atomic, readonly) NSArray<NSDictionary<NSString *, id> *> *payloads;
+
+@end
+
+@interface EventSinkTestCase : XCTestCase
+
+@property (nonatomic) NSURL *fileURL;
+
+@end
+
+@implementation EventSinkTestCase
+
+#pragma mark Setup and teardown
+
++ (void)setUp
+{
+    SetupTestSingletonTracker();
+}
+
+- (void)setUp
+{
+    self.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.jsonl", NSUUID.UUID.UUIDString]]];
+}
+
+- (void)tearDown
+{
+    [NSFileManager.defaultManager removeItemAtURL:self.fileURL error:NULL];
+}
+
+#pragma mark Tests
+
+- (void)testMemorySink
+{
+    SRGAnalyticsMemoryEventSink *eventSink = [[SRGAnalyticsMemoryEventSink alloc] initWithCapacity:3];
+    XCTAssertEqual(eventSink.capacity, 3);
+    XCTAssertEqualObjects(eventSink.payloads, @[]);
+    XCTAssertEqual(eventSink.deliveredCount, 0);
+    
+    NSArray<NSDictionary<NSString *, id> *> *payloads = TestPayloads(5);
+    XCTAssertEqual(DeliverPayloads(eventSink, [payloads subarrayWithRange:NSMakeRange(0, 2)]), SRGAnalyticsEventSinkDeliveryResultSuccess);
+    XCTAssertEqualObjects(eventSink.payloads, [payloads subarrayWithRange:NSMakeRange(0, 2)]);
+    XCTAssertEqual(eventSink.deliveredCount, 2);
+    
+    // Oldest payloads are discarded
+    XCTAssertEqual(DeliverPayloads(eventSink, [payloads subarrayWithRange:NSMakeRange(2, 3)]), SRGAnalyticsEventSinkDeliveryResultSuccess);
+    XCTAssertEqualObjects(eventSink.payloads, [payloads subarrayWithRange:NSMakeRange(2, 3)]);
+    XCTAssertEqual(eventSink.deliveredCount, 5);
+    
+    [eventSink reset];
+    XCTAssertEqualObjects(eventSink.payloads, @[]);
+    XCTAssertEqual(eventSink.deliveredCount, 0);
+}
+
+- (void)testFileSink
+{
+    SRGAnalyticsFileEventSink *eventSink = [[SRGAnalyticsFileEventSink alloc] initWithFileURL:self.fileURL];
+    XCTAssertNotNil(eventSink);
+    
+    NSArray<NSDictionary<NSString *, id> *> *payloads = TestPayloads(3);
+    XCTAssertEqual(DeliverPayloads(eventSink, [payloads subarrayWithRange:NSMakeRange(0, 1)]), SRGAnalyticsEventSinkDeliveryResultSuccess);
+    XCTAssertEqual(DeliverPayloads(eventSink, [payloads subarrayWithRange:NSMakeRange(1, 2)]), SRGAnalyticsEventSinkDeliveryResultSuccess);
+    [eventSink synchronize];
+    
+    NSString *contents = [NSString stringWithContentsOfURL:self.fileURL encoding:NSUTF8StringEncoding error:NULL];
+    NSArray<NSString *> *lines = [contents componentsSeparatedByString:@"\n"];
+    XCTAssertEqual(lines.count, 4);
+    XCTAssertEqualObjects(lines.lastObject, @"");
+    
+    for (NSUInteger i = 0; i < payloads.count; i++) {
+        NSData *lineData = [lines[i] dataUsingEncoding:NSUTF8StringEncoding];
+        XCTAssertEqualObjects([NSJSONSerialization JSONObjectWithData:lineData options:0 error:NULL], payloads[i]);
+    }
+    
+    // Lines are appended when the file is opened again
+    SRGAnalyticsFileEventSink *otherEventSink = [[SRGAnalyticsFileEventSink alloc] initWithFileURL:self.fileURL];
+    XCTAssertEqual(DeliverPayloads(otherEventSink, [payloads subarrayWithRange:NSMakeRange(0, 1)]), SRGAnalyticsEventSinkDeliveryResultSuccess);
+    
+    NSString *otherContents = [NSString stringWithContentsOfURL:self.fileURL encoding:NSUTF8StringEncoding error:NULL];
+    XCTAssertEqual([otherContents componentsSeparatedByString:@"\n"].count, 5);
+}
+
+- (void)testDurability
+{
+    SRGAnalyticsMemoryEventSink *memoryEventSink = [[SRGAnalyticsMemoryEventSink alloc] initWithCapacity:1];
+    XCTAssertFalse([memoryEventSink respondsToSelector:@selector(isDurable)]);
+    
+    SRGAnalyticsFileEventSink *fileEventSink = [[SRGAnalyticsFileEventSink alloc] initWithFileURL:self.fileURL];
+    XCTAssertTrue(fileEventSink.durable);
+    
+    SRGAnalyticsHTTPEventSink *HTTPEventSink = [[SRGAnalyticsHTTPEventSink alloc] initWithURL:[NSURL URLWithString:@"http://localhost"]];
+    XCTAssertTrue(HTTPEventSink.durable);
+}
+
+- (void)testFileSinkWithInvalidLocation
+{
+    NSURL *fileURL = [NSURL fileURLWithPath:@"/nonexistent/directory/events.jsonl"];
+    XCTAssertNil([[SRGAnalyticsFileEventSink alloc] initWithFileURL:fileURL]);
+}
+
+- (void)testHTTPSinkWithLoopbackCollector
+{
+    LoopbackCollector *collector = [[LoopbackCollector alloc] init];
+    XCTAssertNotNil(collector);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Batches received"];
+    expectation.expectedFulfillmentCount = 2;
+    collector.batchHandler = ^(NSArray<NSDictionary<NSString *, id> *> *batch) {
+        [expectation fulfill];
+    };
+    
+    NSArray<NSDictionary<NSString *, id> *> *payloads = TestPayloads(10);
+    SRGAnalyticsHTTPEventSink *eventSink = [[SRGAnalyticsHTTPEventSink alloc] initWithURL:collector.URL];
+    XCTAssertEqual(DeliverPayloads(eventSink, [payloads subarrayWithRange:NSMakeRange(0, 4)]), SRGAnalyticsEventSinkDeliveryResultSuccess);
+    XCTAssertEqual(DeliverPayloads(eventSink, [payloads subarrayWithRange:NSMakeRange(4, 6)]), SRGAnalyticsEventSinkDeliveryResultSuccess);
+    
+    [self waitForExpectationsWithTimeout:10. handler:nil];
+    
+    // Requests might be received in any order
+    NSArray<NSArray<NSDictionary<NSString *, id> *> *> *batches = [collector.batches sortedArrayUsingComparator:^NSComparisonResult(NSArray * _Nonnull batch1, NSArray * _Nonnull batch2) {
+        return [@(batch1.count) compare:@(batch2.count)];
+    }];
+    XCTAssertEqualObjects(batches, (@[ [payloads subarrayWithRange:NSMakeRange(0, 4)], [payloads subarrayWithRange:NSMakeRange(4, 6)] ]));
+    
+    [collector stop];
+}
+
+// Events held back by the batcher are posted in a single compressed request when the batch is flushed
+- (void)testHTTPSinkWithEventBatcher
+{
+    LoopbackCollector *collector = [[LoopbackCollector alloc] init];
+    XCTAssertNotNil(collector);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Batch received"];
+    collector.batchHandler = ^(NSArray<NSDictionary<NSString *, id> *> *batch) {
+        [expectation fulfill];
+    };
+    
+    SRGAnalyticsHTTPEventSink *eventSink = [[SRGAnalyticsHTTPEventSink alloc] initWithURL:collector.URL];
+    dispatch_queue_t queue = dispatch_queue_create("ch.srgssr.analytics.tests.batcher", DISPATCH_QUEUE_SERIAL);
+    SRGAnalyticsEventBatcher<NSDictionary<NSString *, id> *> *batcher = [[SRGAnalyticsEventBatcher alloc] initWithQueue:queue handler:^(NSArray<NSDictionary<NSString *, id> *> * _Nonnull payloads) {
+        [eventSink deliverPayloads:payloads completion:^(SRGAnalyticsEventSinkDeliveryResult result) {}];
+    }];
+    
+    NSArray<NSDictionary<NSString *, id> *> *payloads = TestPayloads(15);
+    dispatch_sync(queue, ^{
+        batcher.interval = 60.;
+        for (NSDictionary<NSString *, id> *payload in payloads) {
+            [batcher addObject:payload];
+        }
+        [batcher flush];
+    });
+    
+    [self waitForExpectationsWithTimeout:10. handler:nil];
+    
+    // No other request must be received
+    [self expectationForElapsedTimeInterval:1. withHandler:nil];
+    [self waitForExpectationsWithTimeout:10. handler:nil];
+    
+    XCTAssertEqualObjects(collector.batches, @[ payloads ]);
+    XCTAssertEqualObjects(collector.contentEncodings, @[ @"gzip" ]);
+    
+    [collector stop];
+}
+
+- (void)testHTTPSinkFailure
+{
+    LoopbackCollector *collector = [[LoopbackCollector alloc] init];
+    XCTAssertNotNil(collector);
+    
+    NSURL *URL = collector.URL;
+    [collector stop];
+    
+    // Nothing listens anymore
+    SRGAnalyticsHTTPEventSink *eventSink = [[SRGAnalyticsHTTPEventSink alloc] initWithURL:URL];
+    XCTAssertEqual(DeliverPayloads(eventSink, TestPayloads(1)), SRGAnalyticsEventSinkDeliveryResultFailure);
+}
+
+- (void)testHTTPSinkStatusCodes
+{
+    LoopbackCollector *collector = [[LoopbackCollector alloc] init];
+    XCTAssertNotNil(collector);
+    
+    SRGAnalyticsHTTPEventSink *eventSink = [[SRGAnalyticsHTTPEventSink alloc] initWithURL:collector.URL];
+    
+    // Client errors are permanent, except timeouts and rate limiting
+    collector.statusCode = 400;
+    XCTAssertEqual(DeliverPayloads(eventSink, TestPayloads(1)), SRGAnalyticsEventSinkDeliveryResultRejection);
+    collector.statusCode = 408;
+    XCTAssertEqual(DeliverPayloads(eventSink, TestPayloads(1)), SRGAnalyticsEventSinkDeliveryResultFailure);
+    collector.statusCode = 429;
+    XCTAssertEqual(DeliverPayloads(eventSink, TestPayloads(1)), SRGAnalyticsEventSinkDeliveryResultFailure);
+    collector.statusCode = 503;
+    XCTAssertEqual(DeliverPayloads(eventSink, TestPayloads(1)), SRGAnalyticsEventSinkDeliveryResultFailure);
+    collector.statusCode = 200;
+    XCTAssertEqual(DeliverPayloads(eventSink, TestPayloads(1)), SRGAnalyticsEventSinkDeliveryResultSuccess);
+    
+    [collector stop];
+}
+
+- (void)testTrackerDeliveryToSink
+{
+    SRGAnalyticsMemoryEventSink *eventSink = [[SRGAnalyticsMemoryEventSink alloc] initWithCapacity:100];
+    [SRGAnalyticsTracker.sharedTracker addEventSink:eventSink];
+    
+    NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(SRGAnalyticsMemoryEventSink * _Nullable eventSink, NSDictionary<NSString *, id> * _Nullable bindings) {
+        for (NSDictionary<NSString *, id> *payload in eventSink.payloads) {
+            if ([payload[SRGAnalyticsPayloadNameKey] isEqualToString:@"sink_event"]) {
+                return YES;
+            }
+        }
+        return NO;
+    }];
+    [self expectationForPredicate:predicate evaluatedWithObject:eventSink handler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"sink_event"];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker removeEventSink:eventSink];
+    
+    NSDictionary<NSString *, id> *payload = [eventSink.payloads filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"%K == %@", SRGAnalyticsPayloadNameKey, @"sink_event"]].firstObject;
+    XCTAssertEqualObjects(payload[SRGAnalyticsPayloadKindKey], SRGAnalyticsPayloadKindCustom);
+    XCTAssertEqualObjects(payload[SRGAnalyticsPayloadLabelsKey][@"srg_test_id"], SRGAnalyticsUnitTestingIdentifier());
+    
+    // Events recorded after the sink has been removed are not delivered to it anymore
+    NSUInteger deliveredCount = eventSink.deliveredCount;
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"sink_event"];
+    [self expectationForElapsedTimeInterval:2. withHandler:nil];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    XCTAssertEqual(eventSink.deliveredCount, deliveredCount);
+}
+
+// Events are kept until durable sinks have delivered them, and delivered again to failing sinks only
+- (void)testTrackerRedeliveryToFailingSink
+{
+    FailingEventSink *eventSink = [[FailingEventSink alloc] init];
+    eventSink.failing = YES;
+    [SRGAnalyticsTracker.sharedTracker addEventSink:eventSink];
+    
+    FailingEventSink *otherEventSink = [[FailingEventSink alloc] init];
+    [SRGAnalyticsTracker.sharedTracker addEventSink:otherEventSink];
+    
+    SRGAnalyticsMemoryEventSink *memoryEventSink = [[SRGAnalyticsMemoryEventSink alloc] initWithCapacity:1000];
+    [SRGAnalyticsTracker.sharedTracker addEventSink:memoryEventSink];
+    
+    [self expectationForPredicate:[NSPredicate predicateWithFormat:@"ANY payloads.%K == %@", SRGAnalyticsPayloadNameKey, @"failed_event"] evaluatedWithObject:eventSink handler:nil];
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"failed_event"];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    eventSink.failing = NO;
+    
+    // The failed event is delivered again with the next one
+    [self expectationForPredicate:[NSPredicate predicateWithFormat:@"ANY payloads.%K == %@", SRGAnalyticsPayloadNameKey, @"next_event"] evaluatedWithObject:eventSink handler:nil];
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"next_event"];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker removeEventSink:eventSink];
+    [SRGAnalyticsTracker.sharedTracker removeEventSink:otherEventSink];
+    [SRGAnalyticsTracker.sharedTracker removeEventSink:memoryEventSink];
+    
+    NSArray<NSString *> *names = [eventSink.payloads valueForKey:SRGAnalyticsPayloadNameKey];
+    XCTAssertEqual(NameCount(names, @"failed_event"), 2);
+    XCTAssertTrue([names indexOfObject:@"failed_event"] < [names indexOfObject:@"next_event"]);
+    
+    // The failed event is delivered again before the next one
+    NSUInteger retryLocation = [names indexOfObject:@"failed_event"] + 1;
+    XCTAssertTrue([names indexOfObject:@"failed_event" inRange:NSMakeRange(retryLocation, names.count - retryLocation)] < [names indexOfObject:@"next_event"]);
+    
+    // Other sinks received each event once
+    NSArray<NSString *> *otherNames = [otherEventSink.payloads valueForKey:SRGAnalyticsPayloadNameKey];
+    XCTAssertEqual(NameCount(otherNames, @"failed_event"), 1);
+    XCTAssertEqual(NameCount(otherNames, @"next_event"), 1);
+    
+    NSArray<NSString *> *memoryNames = [memoryEventSink.payloads valueForKey:SRGAnalyticsPayloadNameKey];
+    XCTAssertEqual(NameCount(memoryNames, @"failed_event"), 1);
+    XCTAssertEqual(NameCount(memoryNames, @"next_event"), 1);
+}
+
+// Events rejected by a durable sink are not delivered again
+- (void)testTrackerDeliveryToRejectingSink
+{
+    LoopbackCollector *collector = [[LoopbackCollector alloc] init];
+    XCTAssertNotNil(collector);
+    collector.statusCode = 400;
+    
+    SRGAnalyticsHTTPEventSink *eventSink = [[SRGAnalyticsHTTPEventSink alloc] initWithURL:collector.URL];
+    [SRGAnalyticsTracker.sharedTracker addEventSink:eventSink];
+    
+    [self expectationForPredicate:[NSPredicate predicateWithBlock:^BOOL(LoopbackCollector * _Nullable collector, NSDictionary<NSString *, id> * _Nullable bindings) {
+        return [CollectedNames(collector) containsObject:@"rejected_event"];
+    }] evaluatedWithObject:collector handler:nil];
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"rejected_event"];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    collector.statusCode = 204;
+    
+    [self expectationForPredicate:[NSPredicate predicateWithBlock:^BOOL(LoopbackCollector * _Nullable collector, NSDictionary<NSString *, id> * _Nullable bindings) {
+        return [CollectedNames(collector) containsObject:@"accepted_event"];
+    }] evaluatedWithObject:collector handler:nil];
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"accepted_event"];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker removeEventSink:eventSink];
+    [collector stop];
+    
+    NSArray<NSString *> *names = CollectedNames(collector);
+    XCTAssertEqual(NameCount(names, @"rejected_event"), 1);
+    XCTAssertEqual(NameCount(names, @"accepted_event"), 1);
+}
+
+- (void)testSinkDetachingItself
+{
+    FailingEventSink *eventSink = [[FailingEventSink alloc] init];
+    eventSink.detachingItself = YES;
+    [SRGAnalyticsTracker.sharedTracker addEventSink:eventSink];
+    
+    [self expectationForPredicate:[NSPredicate predicateWithFormat:@"ANY payloads.%K == %@", SRGAnalyticsPayloadNameKey, @"detach_event"] evaluatedWithObject:eventSink handler:nil];
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"detach_event"];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    // Removal from the worker thread must not deadlock, and must be effective
+    NSUInteger payloadCount = eventSink.payloads.count;
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"detach_event"];
+    [self expectationForElapsedTimeInterval:2. withHandler:nil];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    XCTAssertEqual(eventSink.payloads.count, payloadCount);
+}
+
+@end
+
+@implementation FailingEventSink
+
+@synthesize payloads = _payloads;
+
+#pragma mark Getters and setters
+
+- (NSArray<NSDictionary<NSString *,id> *> *)payloads
+{
+    @synchronized (self) {
+        return _payloads ?: @[];
+    }
+}
+
+#pragma mark SRGAnalyticsEventSink protocol
+
+- (BOOL)isDurable
+{
+    return YES;
+}
+
+- (void)deliverPayloads:(NSArray<NSDictionary<NSString *, id> *> *)payloads completion:(void (^)(SRGAnalyticsEventSinkDeliveryResult))completion
+{
+    @synchronized (self) {
+        _payloads = [self.payloads arrayByAddingObjectsFromArray:payloads];
+    }
+    if (self.detachingItself) {
+        [SRGAnalyticsTracker.sharedTracker removeEventSink:self];
+    }
+    completion(self.failing ? SRGAnalyticsEventSinkDeliveryResultFailure : SRGAnalyticsEventSinkDeliveryResultSuccess);
+}
+
+@end
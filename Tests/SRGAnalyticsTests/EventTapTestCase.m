@@ -0,0 +1,156 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "TrackerSingletonSetup.h"
+#import "XCTestCase+Tests.h"
+
+@interface EventTapTestCase : XCTestCase
+
+@end
+
+@implementation EventTapTestCase
+
+#pragma mark Setup and teardown
+
++ (void)setUp
+{
+    SetupTestSingletonTracker();
+}
+
+- (void)setUp
+{
+    SRGAnalyticsRenewUnitTestingIdentifier();
+}
+
+#pragma mark Tests
+
+- (void)testEvent
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Event received"];
+    
+    SRGAnalyticsEventTap *eventTap = [[SRGAnalyticsEventTap alloc] initWithEventNames:nil unitTestingIdentifier:SRGAnalyticsUnitTestingIdentifier() queue:nil handler:^(NSString * _Nonnull name, NSString * _Nullable pageType, NSDictionary<NSString *, NSString *> * _Nonnull labels) {
+        XCTAssertEqualObjects(name, @"Event");
+        XCTAssertNil(pageType);
+        XCTAssertEqualObjects(labels[@"event_source"], @"Source");
+        XCTAssertEqualObjects(labels[@"navigation_app_site_name"], nil);
+        [expectation fulfill];
+    }];
+    [SRGAnalyticsTracker.sharedTracker addEventTap:eventTap];
+    
+    SRGAnalyticsEventLabels *labels = [[SRGAnalyticsEventLabels alloc] init];
+    labels.source = @"Source";
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Event" labels:labels];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker removeEventTap:eventTap];
+}
+
+- (void)testPageView
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Page view received"];
+    
+    SRGAnalyticsEventTap *eventTap = [[SRGAnalyticsEventTap alloc] initWithEventNames:nil unitTestingIdentifier:SRGAnalyticsUnitTestingIdentifier() queue:nil handler:^(NSString * _Nonnull name, NSString * _Nullable pageType, NSDictionary<NSString *, NSString *> * _Nonnull labels) {
+        XCTAssertEqualObjects(name, @"Title");
+        XCTAssertEqualObjects(pageType, @"Type");
+        XCTAssertEqualObjects(labels[@"navigation_level_1"], @"level1");
+        XCTAssertEqualObjects(labels[@"srg_test_id"], SRGAnalyticsUnitTestingIdentifier());
+        [expectation fulfill];
+    }];
+    [SRGAnalyticsTracker.sharedTracker addEventTap:eventTap];
+    
+    [SRGAnalyticsTracker.sharedTracker uncheckedTrackPageViewWithTitle:@"Title" type:@"Type" levels:@[ @"level1" ]];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker removeEventTap:eventTap];
+}
+
+- (void)testEventNameFilter
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Event received"];
+    
+    NSSet<NSString *> *eventNames = [NSSet setWithObject:@"Tapped"];
+    SRGAnalyticsEventTap *eventTap = [[SRGAnalyticsEventTap alloc] initWithEventNames:eventNames unitTestingIdentifier:SRGAnalyticsUnitTestingIdentifier() queue:nil handler:^(NSString * _Nonnull name, NSString * _Nullable pageType, NSDictionary<NSString *, NSString *> * _Nonnull labels) {
+        XCTAssertEqualObjects(name, @"Tapped");
+        [expectation fulfill];
+    }];
+    [SRGAnalyticsTracker.sharedTracker addEventTap:eventTap];
+    
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Ignored"];
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Tapped"];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker removeEventTap:eventTap];
+}
+
+- (void)testUnitTestingIdentifierFilter
+{
+    SRGAnalyticsEventTap *eventTap = [[SRGAnalyticsEventTap alloc] initWithEventNames:nil unitTestingIdentifier:NSUUID.UUID.UUIDString queue:nil handler:^(NSString * _Nonnull name, NSString * _Nullable pageType, NSDictionary<NSString *, NSString *> * _Nonnull labels) {
+        XCTFail(@"Events with another test identifier must not be received");
+    }];
+    [SRGAnalyticsTracker.sharedTracker addEventTap:eventTap];
+    
+    [self expectationForElapsedTimeInterval:3. withHandler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Event"];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker removeEventTap:eventTap];
+}
+
+- (void)testAsynchronousDelivery
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Event received"];
+    
+    SRGAnalyticsEventTap *eventTap = [[SRGAnalyticsEventTap alloc] initWithEventNames:nil unitTestingIdentifier:SRGAnalyticsUnitTestingIdentifier() queue:dispatch_get_main_queue() handler:^(NSString * _Nonnull name, NSString * _Nullable pageType, NSDictionary<NSString *, NSString *> * _Nonnull labels) {
+        XCTAssertTrue(NSThread.isMainThread);
+        [expectation fulfill];
+    }];
+    [SRGAnalyticsTracker.sharedTracker addEventTap:eventTap];
+    
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Event"];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [SRGAnalyticsTracker.sharedTracker removeEventTap:eventTap];
+}
+
+// Must not deadlock when called from the tracker worker thread
+- (void)testTapChangesFromHandler
+{
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Event received by the other tap"];
+    
+    SRGAnalyticsEventTap *otherEventTap = [[SRGAnalyticsEventTap alloc] initWithEventNames:[NSSet setWithObject:@"Other event"] unitTestingIdentifier:SRGAnalyticsUnitTestingIdentifier() queue:nil handler:^(NSString * _Nonnull name, NSString * _Nullable pageType, NSDictionary<NSString *, NSString *> * _Nonnull labels) {
+        [expectation fulfill];
+    }];
+    
+    __block NSUInteger eventCount = 0;
+    __block SRGAnalyticsEventTap *eventTap = [[SRGAnalyticsEventTap alloc] initWithEventNames:[NSSet setWithObject:@"Event"] unitTestingIdentifier:SRGAnalyticsUnitTestingIdentifier() queue:nil handler:^(NSString * _Nonnull name, NSString * _Nullable pageType, NSDictionary<NSString *, NSString *> * _Nonnull labels) {
+        eventCount++;
+        [SRGAnalyticsTracker.sharedTracker addEventTap:otherEventTap];
+        [SRGAnalyticsTracker.sharedTracker removeEventTap:eventTap];
+        [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Other event"];
+    }];
+    [SRGAnalyticsTracker.sharedTracker addEventTap:eventTap];
+    
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Event"];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    // The tap detached itself
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Event"];
+    [self expectationForElapsedTimeInterval:2. withHandler:nil];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    XCTAssertEqual(eventCount, 1);
+    
+    [SRGAnalyticsTracker.sharedTracker removeEventTap:otherEventTap];
+    eventTap = nil;
+}
+
+@end
@@ -0,0 +1,120 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerHeartbeatScheduler.h"
+#import "XCTestCase+Tests.h"
+
+@interface HeartbeatTarget : NSObject <SRGMediaPlayerHeartbeatTarget>
+
+@property (nonatomic) NSMutableArray<NSDate *> *heartbeatDates;
+
+@end
+
+@implementation HeartbeatTarget
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        self.heartbeatDates = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)heartbeat
+{
+    [self.heartbeatDates addObject:NSDate.date];
+}
+
+@end
+
+@interface HeartbeatSchedulerTestCase : XCTestCase
+
+@end
+
+@implementation HeartbeatSchedulerTestCase
+
+#pragma mark Tests
+
+- (void)testHeartbeats
+{
+    SRGMediaPlayerHeartbeatScheduler *scheduler = [[SRGMediaPlayerHeartbeatScheduler alloc] initWithInterval:0.5];
+
+    HeartbeatTarget *target = [[HeartbeatTarget alloc] init];
+    NSDate *startDate = NSDate.date;
+    [scheduler addTarget:target];
+    XCTAssertTrue([scheduler containsTarget:target]);
+    XCTAssertEqual(scheduler.count, 1);
+
+    [self expectationForElapsedTimeInterval:1.25 withHandler:nil];
+    [self waitForExpectationsWithTimeout:5. handler:nil];
+
+    XCTAssertEqual(target.heartbeatDates.count, 2);
+    XCTAssertGreaterThanOrEqual([target.heartbeatDates.firstObject timeIntervalSinceDate:startDate], 0.5);
+}
+
+- (void)testCoalescedHeartbeats
+{
+    SRGMediaPlayerHeartbeatScheduler *scheduler = [[SRGMediaPlayerHeartbeatScheduler alloc] initWithInterval:0.5];
+
+    NSArray<HeartbeatTarget *> *targets = @[ [[HeartbeatTarget alloc] init], [[HeartbeatTarget alloc] init], [[HeartbeatTarget alloc] init] ];
+    for (HeartbeatTarget *target in targets) {
+        [scheduler addTarget:target];
+    }
+    XCTAssertEqual(scheduler.count, 3);
+
+    [self expectationForElapsedTimeInterval:0.75 withHandler:nil];
+    [self waitForExpectationsWithTimeout:5. handler:nil];
+
+    // Targets added within the same slot receive their heartbeats together
+    NSDate *heartbeatDate = targets.firstObject.heartbeatDates.firstObject;
+    XCTAssertNotNil(heartbeatDate);
+    for (HeartbeatTarget *target in targets) {
+        XCTAssertEqual(target.heartbeatDates.count, 1);
+        XCTAssertEqualWithAccuracy([target.heartbeatDates.firstObject timeIntervalSinceDate:heartbeatDate], 0., 0.01);
+    }
+}
+
+- (void)testRemoval
+{
+    SRGMediaPlayerHeartbeatScheduler *scheduler = [[SRGMediaPlayerHeartbeatScheduler alloc] initWithInterval:0.5];
+
+    HeartbeatTarget *target1 = [[HeartbeatTarget alloc] init];
+    [scheduler addTarget:target1];
+    [scheduler addTarget:target1];
+    XCTAssertEqual(scheduler.count, 1);
+
+    HeartbeatTarget *target2 = [[HeartbeatTarget alloc] init];
+    [scheduler addTarget:target2];
+    XCTAssertEqual(scheduler.count, 2);
+
+    [scheduler removeTarget:target1];
+    XCTAssertFalse([scheduler containsTarget:target1]);
+    XCTAssertEqual(scheduler.count, 1);
+
+    [self expectationForElapsedTimeInterval:0.75 withHandler:nil];
+    [self waitForExpectationsWithTimeout:5. handler:nil];
+
+    XCTAssertEqual(target1.heartbeatDates.count, 0);
+    XCTAssertEqual(target2.heartbeatDates.count, 1);
+}
+
+- (void)testDeallocatedTarget
+{
+    SRGMediaPlayerHeartbeatScheduler *scheduler = [[SRGMediaPlayerHeartbeatScheduler alloc] initWithInterval:0.5];
+
+    @autoreleasepool {
+        HeartbeatTarget *target = [[HeartbeatTarget alloc] init];
+        [scheduler addTarget:target];
+    }
+    XCTAssertEqual(scheduler.count, 1);
+
+    [self expectationForElapsedTimeInterval:0.75 withHandler:nil];
+    [self waitForExpectationsWithTimeout:5. handler:nil];
+
+    XCTAssertEqual(scheduler.count, 0);
+}
+
+@end
@@ -0,0 +1,122 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsLabels+Private.h"
+#import "XCTestCase+Tests.h"
+
+@interface LabelStoreTestCase : XCTestCase
+
+@end
+
+@implementation LabelStoreTestCase
+
+#pragma mark Tests
+
+- (void)testKeyInterning
+{
+    XCTAssertEqual(SRGAnalyticsLabelKeyFromString(@"media_position"), SRGAnalyticsLabelKeyMediaPosition);
+    XCTAssertEqualObjects(SRGAnalyticsLabelKeyString(SRGAnalyticsLabelKeyEventValue5), @"event_value_5");
+    XCTAssertEqual(SRGAnalyticsLabelKeyFromString(@"unknown_key"), NSNotFound);
+
+    for (NSInteger key = 0; key < SRGAnalyticsLabelKeyCount; ++key) {
+        XCTAssertEqual(SRGAnalyticsLabelKeyFromString(SRGAnalyticsLabelKeyString(key)), key);
+    }
+}
+
+- (void)testEmptyStore
+{
+    SRGAnalyticsLabelStore *store = [[SRGAnalyticsLabelStore alloc] init];
+    XCTAssertEqual(store.count, 0);
+    XCTAssertEqualObjects(store.dictionary, @{});
+    XCTAssertNil([store stringForKey:@"event_type"]);
+    XCTAssertNil([store stringForKey:@"unknown_key"]);
+}
+
+- (void)testValues
+{
+    SRGAnalyticsLabelStore *store = [[SRGAnalyticsLabelStore alloc] init];
+    [store setString:@"type" forLabelKey:SRGAnalyticsLabelKeyEventType];
+    [store setString:@"1" forKey:@"event_value_1"];
+    [store setString:@"custom" forKey:@"custom_key"];
+
+    XCTAssertEqual(store.count, 3);
+    XCTAssertEqualObjects([store stringForKey:@"event_type"], @"type");
+    XCTAssertEqualObjects([store stringForLabelKey:SRGAnalyticsLabelKeyEventValue1], @"1");
+    XCTAssertEqualObjects([store stringForKey:@"custom_key"], @"custom");
+    XCTAssertEqualObjects(store.dictionary, (@{ @"event_type" : @"type",
+                                                @"event_value_1" : @"1",
+                                                @"custom_key" : @"custom" }));
+
+    [store setString:nil forKey:@"event_type"];
+    [store setString:nil forKey:@"custom_key"];
+
+    XCTAssertEqual(store.count, 1);
+    XCTAssertEqualObjects(store.dictionary, @{ @"event_value_1" : @"1" });
+}
+
+- (void)testMerge
+{
+    SRGAnalyticsLabelStore *store1 = [[SRGAnalyticsLabelStore alloc] init];
+    [store1 addEntriesFromDictionary:@{ @"event_type" : @"type1",
+                                        @"event_value" : @"value1",
+                                        @"custom_key" : @"custom1" }];
+
+    SRGAnalyticsLabelStore *store2 = [[SRGAnalyticsLabelStore alloc] init];
+    [store2 addEntriesFromDictionary:@{ @"event_value" : @"value2",
+                                        @"custom_key" : @"custom2" }];
+
+    NSMutableDictionary<NSString *, NSString *> *dictionary = [NSMutableDictionary dictionary];
+    [store1 addEntriesToDictionary:dictionary];
+    [store2 addEntriesToDictionary:dictionary];
+
+    NSDictionary<NSString *, NSString *> *expectedDictionary = @{ @"event_type" : @"type1",
+                                                                  @"event_value" : @"value2",
+                                                                  @"custom_key" : @"custom2" };
+    XCTAssertEqualObjects(dictionary, expectedDictionary);
+
+    SRGAnalyticsLabelStore *mergedStore = store1.copy;
+    [mergedStore addEntriesFromStore:store2];
+    XCTAssertEqualObjects(mergedStore.dictionary, expectedDictionary);
+    XCTAssertEqualObjects(store1.dictionary[@"event_value"], @"value1");
+}
+
+- (void)testEquality
+{
+    SRGAnalyticsLabelStore *store1 = [[SRGAnalyticsLabelStore alloc] init];
+    [store1 addEntriesFromDictionary:@{ @"event_type" : @"type",
+                                        @"custom_key" : @"custom" }];
+
+    SRGAnalyticsLabelStore *store2 = [[SRGAnalyticsLabelStore alloc] init];
+    [store2 setString:@"custom" forKey:@"custom_key"];
+    [store2 setString:@"type" forKey:@"event_type"];
+
+    XCTAssertEqualObjects(store1, store2);
+    XCTAssertEqual(store1.hash, store2.hash);
+
+    [store2 setString:@"other_type" forKey:@"event_type"];
+    XCTAssertNotEqualObjects(store1, store2);
+}
+
+- (void)testLabelsCacheInvalidation
+{
+    SRGAnalyticsEventLabels *labels = [[SRGAnalyticsEventLabels alloc] init];
+    labels.type = @"type";
+    XCTAssertEqualObjects(labels.labelsDictionary, @{ @"event_type" : @"type" });
+    XCTAssertEqualObjects(labels.comScoreLabelsDictionary, @{ @"srg_evgroup" : @"type" });
+
+    NSUInteger hash = labels.hash;
+
+    labels.value = @"value";
+    XCTAssertEqualObjects(labels.labelsDictionary, (@{ @"event_type" : @"type",
+                                                       @"event_value" : @"value" }));
+    XCTAssertNotEqual(labels.hash, hash);
+
+    labels.customInfo = @{ @"event_type" : @"overridden_type" };
+    XCTAssertEqualObjects(labels.labelsDictionary, (@{ @"event_type" : @"overridden_type",
+                                                       @"event_value" : @"value" }));
+}
+
+@end
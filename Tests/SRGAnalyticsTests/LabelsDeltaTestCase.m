@@ -0,0 +1,172 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsDeltaEncoder.h"
+#import "SRGAnalyticsDeltaExpander.h"
+#import "SRGAnalyticsLabelsDelta.h"
+
+@import XCTest;
+
+static NSDictionary<NSString *, NSString *> *LabelsDeltaRandomLabels(NSDictionary<NSString *, NSString *> *previousLabels)
+{
+    static NSArray<NSString *> *s_keys;
+    static NSArray<NSString *> *s_values;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_keys = @[ @"media_position", @"media_volume", @"media_bandwidth", @"media_subtitles_on", @"media_audio_track", @"app_version", @"süd" ];
+        s_values = @[ @"0", @"1", @"true", @"false", @"", @"FR", @"änderung" ];
+    });
+    
+    NSMutableDictionary<NSString *, NSString *> *labels = [NSMutableDictionary dictionary];
+    for (NSString *key in s_keys) {
+        if (previousLabels && arc4random_uniform(4) != 0) {
+            labels[key] = previousLabels[key];
+        }
+        else if (arc4random_uniform(4) != 0) {
+            labels[key] = s_values[arc4random_uniform((uint32_t)s_values.count)];
+        }
+    }
+    return labels.copy;
+}
+
+@interface LabelsDeltaTestCase : XCTestCase
+
+@end
+
+@implementation LabelsDeltaTestCase
+
+#pragma mark Tests
+
+- (void)testKeyFrame
+{
+    SRGAnalyticsDeltaEncoder *encoder = [[SRGAnalyticsDeltaEncoder alloc] init];
+    NSDictionary<NSString *, NSString *> *labels = @{ @"key1" : @"value1", @"key2" : @"value2" };
+    
+    // The first record is always a key frame
+    NSDictionary<NSString *, NSString *> *encodedLabels = [encoder encodedLabelsWithLabels:labels keyFrame:NO];
+    XCTAssertEqualObjects(encodedLabels, (@{ @"key1" : @"value1",
+                                             @"key2" : @"value2",
+                                             @SRGAnalyticsLabelsDeltaSessionKey : encoder.sessionIdentifier,
+                                             @SRGAnalyticsLabelsDeltaSequenceKey : @"0" }));
+    
+    encodedLabels = [encoder encodedLabelsWithLabels:labels keyFrame:YES];
+    XCTAssertEqualObjects(encodedLabels, (@{ @"key1" : @"value1",
+                                             @"key2" : @"value2",
+                                             @SRGAnalyticsLabelsDeltaSessionKey : encoder.sessionIdentifier,
+                                             @SRGAnalyticsLabelsDeltaSequenceKey : @"1" }));
+}
+
+- (void)testDelta
+{
+    SRGAnalyticsDeltaEncoder *encoder = [[SRGAnalyticsDeltaEncoder alloc] init];
+    [encoder encodedLabelsWithLabels:@{ @"key1" : @"value1", @"key2" : @"value2", @"key3" : @"value3", @"key4" : @"value4" } keyFrame:YES];
+    
+    NSDictionary<NSString *, NSString *> *encodedLabels = [encoder encodedLabelsWithLabels:@{ @"key1" : @"value1", @"key2" : @"changed", @"key5" : @"value5" } keyFrame:NO];
+    XCTAssertEqualObjects(encodedLabels, (@{ @"key2" : @"changed",
+                                             @"key5" : @"value5",
+                                             @SRGAnalyticsLabelsDeltaSessionKey : encoder.sessionIdentifier,
+                                             @SRGAnalyticsLabelsDeltaSequenceKey : @"1",
+                                             @SRGAnalyticsLabelsDeltaBaseKey : @"0",
+                                             @SRGAnalyticsLabelsDeltaRemovedKey : @"key3,key4" }));
+    
+    encodedLabels = [encoder encodedLabelsWithLabels:@{ @"key1" : @"value1", @"key2" : @"changed", @"key5" : @"value5" } keyFrame:NO];
+    XCTAssertEqualObjects(encodedLabels, (@{ @SRGAnalyticsLabelsDeltaSessionKey : encoder.sessionIdentifier,
+                                             @SRGAnalyticsLabelsDeltaSequenceKey : @"2",
+                                             @SRGAnalyticsLabelsDeltaBaseKey : @"1" }));
+}
+
+- (void)testNeedsKeyFrame
+{
+    SRGAnalyticsDeltaEncoder *encoder = [[SRGAnalyticsDeltaEncoder alloc] init];
+    NSDictionary<NSString *, NSString *> *labels = @{ @"key1" : @"value1", @"key2" : @"value2" };
+    [encoder encodedLabelsWithLabels:labels keyFrame:YES];
+    
+    // The record following a lost one is a key frame
+    [encoder setNeedsKeyFrame];
+    NSDictionary<NSString *, NSString *> *encodedLabels = [encoder encodedLabelsWithLabels:labels keyFrame:NO];
+    XCTAssertEqualObjects(encodedLabels, (@{ @"key1" : @"value1",
+                                             @"key2" : @"value2",
+                                             @SRGAnalyticsLabelsDeltaSessionKey : encoder.sessionIdentifier,
+                                             @SRGAnalyticsLabelsDeltaSequenceKey : @"1" }));
+    
+    encodedLabels = [encoder encodedLabelsWithLabels:labels keyFrame:NO];
+    XCTAssertEqualObjects(encodedLabels, (@{ @SRGAnalyticsLabelsDeltaSessionKey : encoder.sessionIdentifier,
+                                             @SRGAnalyticsLabelsDeltaSequenceKey : @"2",
+                                             @SRGAnalyticsLabelsDeltaBaseKey : @"1" }));
+}
+
+- (void)testUnencodedLabels
+{
+    SRGAnalyticsDeltaExpander *expander = [[SRGAnalyticsDeltaExpander alloc] initWithSessionCapacity:1];
+    NSDictionary<NSString *, NSString *> *labels = @{ @"key1" : @"value1", @"key2" : @"value2" };
+    XCTAssertEqualObjects([expander expandedLabelsWithLabels:labels], labels);
+}
+
+- (void)testMissingBase
+{
+    SRGAnalyticsDeltaEncoder *encoder = [[SRGAnalyticsDeltaEncoder alloc] init];
+    NSDictionary<NSString *, NSString *> *keyFrameLabels = [encoder encodedLabelsWithLabels:@{ @"key" : @"value1" } keyFrame:YES];
+    NSDictionary<NSString *, NSString *> *lostLabels = [encoder encodedLabelsWithLabels:@{ @"key" : @"value2" } keyFrame:NO];
+    NSDictionary<NSString *, NSString *> *deltaLabels = [encoder encodedLabelsWithLabels:@{ @"key" : @"value3", @"other_key" : @"value" } keyFrame:NO];
+    
+    SRGAnalyticsDeltaExpander *expander = [[SRGAnalyticsDeltaExpander alloc] initWithSessionCapacity:1];
+    XCTAssertNil([expander expandedLabelsWithLabels:deltaLabels]);
+    
+    XCTAssertEqualObjects([expander expandedLabelsWithLabels:keyFrameLabels], @{ @"key" : @"value1" });
+    XCTAssertNil([expander expandedLabelsWithLabels:deltaLabels]);
+    
+    XCTAssertEqualObjects([expander expandedLabelsWithLabels:lostLabels], @{ @"key" : @"value2" });
+    XCTAssertEqualObjects([expander expandedLabelsWithLabels:deltaLabels], (@{ @"key" : @"value3", @"other_key" : @"value" }));
+}
+
+- (void)testMalformedLabels
+{
+    SRGAnalyticsDeltaExpander *expander = [[SRGAnalyticsDeltaExpander alloc] initWithSessionCapacity:1];
+    XCTAssertNil([expander expandedLabelsWithLabels:@{ @SRGAnalyticsLabelsDeltaSessionKey : @"session" }]);
+    XCTAssertNil([expander expandedLabelsWithLabels:@{ @SRGAnalyticsLabelsDeltaSessionKey : @"session",
+                                                       @SRGAnalyticsLabelsDeltaSequenceKey : @"-1" }]);
+    XCTAssertNil([expander expandedLabelsWithLabels:@{ @SRGAnalyticsLabelsDeltaSessionKey : @"session",
+                                                       @SRGAnalyticsLabelsDeltaSequenceKey : @"1",
+                                                       @SRGAnalyticsLabelsDeltaBaseKey : @"zero" }]);
+}
+
+- (void)testSessionEviction
+{
+    SRGAnalyticsDeltaEncoder *encoder1 = [[SRGAnalyticsDeltaEncoder alloc] init];
+    SRGAnalyticsDeltaEncoder *encoder2 = [[SRGAnalyticsDeltaEncoder alloc] init];
+    SRGAnalyticsDeltaEncoder *encoder3 = [[SRGAnalyticsDeltaEncoder alloc] init];
+    
+    SRGAnalyticsDeltaExpander *expander = [[SRGAnalyticsDeltaExpander alloc] initWithSessionCapacity:2];
+    XCTAssertNotNil([expander expandedLabelsWithLabels:[encoder1 encodedLabelsWithLabels:@{ @"key" : @"1" } keyFrame:YES]]);
+    XCTAssertNotNil([expander expandedLabelsWithLabels:[encoder2 encodedLabelsWithLabels:@{ @"key" : @"2" } keyFrame:YES]]);
+    XCTAssertNotNil([expander expandedLabelsWithLabels:[encoder1 encodedLabelsWithLabels:@{ @"key" : @"1" } keyFrame:NO]]);
+    
+    // The least recently used session is evicted
+    XCTAssertNotNil([expander expandedLabelsWithLabels:[encoder3 encodedLabelsWithLabels:@{ @"key" : @"3" } keyFrame:YES]]);
+    XCTAssertNil([expander expandedLabelsWithLabels:[encoder2 encodedLabelsWithLabels:@{ @"key" : @"2" } keyFrame:NO]]);
+    XCTAssertEqualObjects([expander expandedLabelsWithLabels:[encoder1 encodedLabelsWithLabels:@{ @"key" : @"1" } keyFrame:NO]], @{ @"key" : @"1" });
+}
+
+- (void)testRoundTrip
+{
+    SRGAnalyticsDeltaExpander *expander = [[SRGAnalyticsDeltaExpander alloc] initWithSessionCapacity:4];
+    
+    NSArray<SRGAnalyticsDeltaEncoder *> *encoders = @[ [[SRGAnalyticsDeltaEncoder alloc] init],
+                                                       [[SRGAnalyticsDeltaEncoder alloc] init],
+                                                       [[SRGAnalyticsDeltaEncoder alloc] init] ];
+    NSMutableArray<NSDictionary<NSString *, NSString *> *> *previousLabels = [NSMutableArray arrayWithObjects:@{}, @{}, @{}, nil];
+    
+    // Interleave sessions
+    for (NSUInteger i = 0; i < 1000; ++i) {
+        NSUInteger index = arc4random_uniform((uint32_t)encoders.count);
+        NSDictionary<NSString *, NSString *> *labels = LabelsDeltaRandomLabels(previousLabels[index]);
+        NSDictionary<NSString *, NSString *> *encodedLabels = [encoders[index] encodedLabelsWithLabels:labels keyFrame:(arc4random_uniform(20) == 0)];
+        XCTAssertEqualObjects([expander expandedLabelsWithLabels:encodedLabels], labels);
+        previousLabels[index] = labels;
+    }
+}
+
+@end
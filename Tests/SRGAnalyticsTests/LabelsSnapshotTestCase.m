@@ -0,0 +1,56 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsLabelsSnapshot.h"
+
+@import XCTest;
+
+@interface LabelsSnapshotTestCase : XCTestCase
+
+@end
+
+@implementation LabelsSnapshotTestCase
+
+#pragma mark Tests
+
+- (void)testEmptySnapshot
+{
+    SRGAnalyticsLabelsSnapshot *snapshot = [[SRGAnalyticsLabelsSnapshot alloc] initWithGlobalLabels:nil dataSourceLabels:nil version:1];
+    XCTAssertEqual(snapshot.version, 1);
+    XCTAssertEqualObjects(snapshot.labelsDictionary, @{});
+    XCTAssertEqualObjects(snapshot.comScoreLabelsDictionary, @{});
+}
+
+- (void)testMerge
+{
+    SRGAnalyticsLabels *globalLabels = [[SRGAnalyticsLabels alloc] init];
+    globalLabels.customInfo = @{ @"key1" : @"global1",
+                                 @"key2" : @"global2" };
+    globalLabels.comScoreCustomInfo = @{ @"cs_key" : @"global" };
+
+    SRGAnalyticsLabels *dataSourceLabels = [[SRGAnalyticsLabels alloc] init];
+    dataSourceLabels.customInfo = @{ @"key2" : @"data_source2",
+                                     @"key3" : @"data_source3" };
+
+    SRGAnalyticsLabelsSnapshot *snapshot = [[SRGAnalyticsLabelsSnapshot alloc] initWithGlobalLabels:globalLabels dataSourceLabels:dataSourceLabels version:1];
+    XCTAssertEqualObjects(snapshot.labelsDictionary, (@{ @"key1" : @"global1",
+                                                         @"key2" : @"data_source2",
+                                                         @"key3" : @"data_source3" }));
+    XCTAssertEqualObjects(snapshot.comScoreLabelsDictionary, @{ @"cs_key" : @"global" });
+}
+
+- (void)testImmutability
+{
+    SRGAnalyticsLabels *globalLabels = [[SRGAnalyticsLabels alloc] init];
+    globalLabels.customInfo = @{ @"key" : @"value" };
+
+    SRGAnalyticsLabelsSnapshot *snapshot = [[SRGAnalyticsLabelsSnapshot alloc] initWithGlobalLabels:globalLabels dataSourceLabels:nil version:1];
+    globalLabels.customInfo = @{ @"key" : @"other_value" };
+
+    XCTAssertEqualObjects(snapshot.labelsDictionary, @{ @"key" : @"value" });
+}
+
+@end
@@ -0,0 +1,55 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Minimal in-process HTTP server listening on the loopback interface, collecting batches of payloads posted as JSON
+ *  arrays, possibly gzip-compressed (@see `SRGAnalyticsHTTPEventSink`). Each request is answered with `statusCode` and
+ *  the connection closed.
+ */
+@interface LoopbackCollector : NSObject
+
+/**
+ *  Start a collector on an available port. Returns `nil` if the collector could not be started.
+ */
+- (nullable instancetype)init NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The URL to which batches must be posted.
+ */
+@property (nonatomic, readonly) NSURL *URL;
+
+/**
+ *  The batches received so far, in the order in which they were received.
+ */
+@property (nonatomic, readonly) NSArray<NSArray<NSDictionary<NSString *, id> *> *> *batches;
+
+/**
+ *  The `Content-Encoding` header value of each batch received (empty if none), in the same order as `batches`.
+ */
+@property (nonatomic, readonly) NSArray<NSString *> *contentEncodings;
+
+/**
+ *  The status code with which requests are answered. Default value is 204.
+ */
+@property NSInteger statusCode;
+
+/**
+ *  Handler called on an arbitrary thread when a batch is received.
+ */
+@property (copy, nullable) void (^batchHandler)(NSArray<NSDictionary<NSString *, id> *> *batch);
+
+/**
+ *  Stop the collector. Called automatically when the collector is deallocated.
+ */
+- (void)stop;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,222 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "LoopbackCollector.h"
+
+@import Network;
+
+#import <zlib.h>
+
+@interface LoopbackCollector ()
+
+@property (nonatomic) NSURL *URL;
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic) nw_listener_t listener;
+@property (nonatomic) NSMutableArray<NSArray<NSDictionary<NSString *, id> *> *> *receivedBatches;
+@property (nonatomic) NSMutableArray<NSString *> *receivedContentEncodings;
+
+@end
+
+@implementation LoopbackCollector
+
+#pragma mark Object lifecycle
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        self.queue = dispatch_queue_create("ch.srgssr.analytics.tests.loopback", DISPATCH_QUEUE_SERIAL);
+        self.receivedBatches = [NSMutableArray array];
+        self.receivedContentEncodings = [NSMutableArray array];
+        self.statusCode = 204;
+        
+        nw_parameters_t parameters = nw_parameters_create_secure_tcp(NW_PARAMETERS_DISABLE_PROTOCOL, NW_PARAMETERS_DEFAULT_CONFIGURATION);
+        nw_parameters_set_local_endpoint(parameters, nw_endpoint_create_host("127.0.0.1", "0"));
+        self.listener = nw_listener_create(parameters);
+        if (! self.listener) {
+            return nil;
+        }
+        nw_listener_set_queue(self.listener, self.queue);
+        
+        dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+        nw_listener_set_state_changed_handler(self.listener, ^(nw_listener_state_t state, nw_error_t _Nullable error) {
+            if (state == nw_listener_state_ready || state == nw_listener_state_failed) {
+                dispatch_semaphore_signal(semaphore);
+            }
+        });
+        
+        __weak __typeof(self) weakSelf = self;
+        nw_listener_set_new_connection_handler(self.listener, ^(nw_connection_t _Nonnull connection) {
+            [weakSelf handleConnection:connection];
+        });
+        nw_listener_start(self.listener);
+        
+        dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(5. * NSEC_PER_SEC)));
+        uint16_t port = nw_listener_get_port(self.listener);
+        if (port == 0) {
+            [self stop];
+            return nil;
+        }
+        self.URL = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%@/events", @(port)]];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self stop];
+}
+
+#pragma mark Getters and setters
+
+- (NSArray<NSArray<NSDictionary<NSString *,id> *> *> *)batches
+{
+    __block NSArray<NSArray<NSDictionary<NSString *, id> *> *> *batches = nil;
+    dispatch_sync(self.queue, ^{
+        batches = self.receivedBatches.copy;
+    });
+    return batches;
+}
+
+- (NSArray<NSString *> *)contentEncodings
+{
+    __block NSArray<NSString *> *contentEncodings = nil;
+    dispatch_sync(self.queue, ^{
+        contentEncodings = self.receivedContentEncodings.copy;
+    });
+    return contentEncodings;
+}
+
+#pragma mark Server
+
+- (void)stop
+{
+    if (self.listener) {
+        nw_listener_cancel(self.listener);
+        self.listener = nil;
+    }
+}
+
+- (void)handleConnection:(nw_connection_t)connection
+{
+    nw_connection_set_queue(connection, self.queue);
+    nw_connection_start(connection);
+    [self receiveOnConnection:connection buffer:[NSMutableData data]];
+}
+
+- (void)receiveOnConnection:(nw_connection_t)connection buffer:(NSMutableData *)buffer
+{
+    nw_connection_receive(connection, 1, UINT32_MAX, ^(dispatch_data_t _Nullable content, nw_content_context_t _Nullable context, bool isComplete, nw_error_t _Nullable error) {
+        if (content) {
+            dispatch_data_apply(content, ^bool(dispatch_data_t _Nonnull region, size_t offset, const void * _Nonnull bytes, size_t size) {
+                [buffer appendBytes:bytes length:size];
+                return true;
+            });
+        }
+        
+        NSString *contentEncoding = nil;
+        NSData *body = [self bodyFromRequestData:buffer contentEncoding:&contentEncoding];
+        if (body) {
+            [self collectBatchFromData:body contentEncoding:contentEncoding];
+            [self respondOnConnection:connection];
+        }
+        else if (error || isComplete) {
+            nw_connection_cancel(connection);
+        }
+        else {
+            [self receiveOnConnection:connection buffer:buffer];
+        }
+    });
+}
+
+// Return the body if the whole request has been received, `nil` otherwise
+- (NSData *)bodyFromRequestData:(NSData *)data contentEncoding:(NSString **)pContentEncoding
+{
+    NSData *separator = [@"\r\n\r\n" dataUsingEncoding:NSASCIIStringEncoding];
+    NSRange separatorRange = [data rangeOfData:separator options:0 range:NSMakeRange(0, data.length)];
+    if (separatorRange.location == NSNotFound) {
+        return nil;
+    }
+    
+    NSString *header = [[NSString alloc] initWithData:[data subdataWithRange:NSMakeRange(0, separatorRange.location)] encoding:NSASCIIStringEncoding];
+    NSUInteger contentLength = 0;
+    NSString *contentEncoding = @"";
+    for (NSString *line in [header componentsSeparatedByString:@"\r\n"]) {
+        if ([line.lowercaseString hasPrefix:@"content-length:"]) {
+            contentLength = [[line substringFromIndex:@"content-length:".length] integerValue];
+        }
+        else if ([line.lowercaseString hasPrefix:@"content-encoding:"]) {
+            contentEncoding = [[line substringFromIndex:@"content-encoding:".length] stringByTrimmingCharactersInSet:NSCharacterSet.whitespaceCharacterSet];
+        }
+    }
+    
+    NSUInteger bodyLocation = NSMaxRange(separatorRange);
+    if (data.length < bodyLocation + contentLength) {
+        return nil;
+    }
+    
+    if (pContentEncoding) {
+        *pContentEncoding = contentEncoding;
+    }
+    return [data subdataWithRange:NSMakeRange(bodyLocation, contentLength)];
+}
+
+// Return `nil` if the data is not valid gzip-compressed data
+- (NSData *)gzipDecompressedData:(NSData *)data
+{
+    z_stream stream = { 0 };
+    if (inflateInit2(&stream, MAX_WBITS + 16) != Z_OK) {
+        return nil;
+    }
+    
+    stream.next_in = (Bytef *)data.bytes;
+    stream.avail_in = (uInt)data.length;
+    
+    NSMutableData *decompressedData = [NSMutableData data];
+    uint8_t buffer[16384];
+    int status = Z_OK;
+    while (status == Z_OK) {
+        stream.next_out = buffer;
+        stream.avail_out = sizeof(buffer);
+        status = inflate(&stream, Z_NO_FLUSH);
+        [decompressedData appendBytes:buffer length:sizeof(buffer) - stream.avail_out];
+    }
+    inflateEnd(&stream);
+    
+    return (status == Z_STREAM_END) ? decompressedData.copy : nil;
+}
+
+- (void)collectBatchFromData:(NSData *)data contentEncoding:(NSString *)contentEncoding
+{
+    NSData *JSONData = [contentEncoding isEqualToString:@"gzip"] ? [self gzipDecompressedData:data] : data;
+    if (! JSONData) {
+        return;
+    }
+    
+    NSArray<NSDictionary<NSString *, id> *> *batch = [NSJSONSerialization JSONObjectWithData:JSONData options:0 error:NULL];
+    if (! [batch isKindOfClass:NSArray.class]) {
+        return;
+    }
+    
+    [self.receivedBatches addObject:batch];
+    [self.receivedContentEncodings addObject:contentEncoding];
+    
+    void (^batchHandler)(NSArray<NSDictionary<NSString *, id> *> *) = self.batchHandler;
+    if (batchHandler) {
+        batchHandler(batch);
+    }
+}
+
+- (void)respondOnConnection:(nw_connection_t)connection
+{
+    NSString *responseString = [NSString stringWithFormat:@"HTTP/1.1 %@ Status\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", @(self.statusCode)];
+    NSData *responseData = [responseString dataUsingEncoding:NSASCIIStringEncoding];
+    dispatch_data_t response = dispatch_data_create(responseData.bytes, responseData.length, self.queue, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+    nw_connection_send(connection, response, NW_CONNECTION_DEFAULT_MESSAGE_CONTEXT, true, ^(nw_error_t _Nullable error) {
+        nw_connection_cancel(connection);
+    });
+}
+
+@end
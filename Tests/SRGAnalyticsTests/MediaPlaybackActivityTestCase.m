@@ -0,0 +1,140 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlaybackActivityAggregator.h"
+
+@import XCTest;
+
+@interface MediaPlaybackActivityTestCase : XCTestCase
+
+@end
+
+@implementation MediaPlaybackActivityTestCase
+
+#pragma mark Tests
+
+- (void)testIdempotentTransitions
+{
+    NSMutableArray<NSNumber *> *changes = [NSMutableArray array];
+    dispatch_queue_t queue = dispatch_queue_create("ch.srgssr.analytics.tests.activity", DISPATCH_QUEUE_SERIAL);
+    SRGMediaPlaybackActivityAggregator *aggregator = [[SRGMediaPlaybackActivityAggregator alloc] initWithQueue:queue activityChangeBlock:^(BOOL active) {
+        [changes addObject:@(active)];
+    }];
+    XCTAssertEqual(aggregator.activeCount, 0);
+    
+    SRGMediaPlaybackActivityToken token1 = 0;
+    SRGMediaPlaybackActivityToken token2 = 0;
+    
+    XCTAssertFalse([aggregator endActivityWithToken:&token1 atTime:1000]);
+    XCTAssertEqual(aggregator.activeCount, 0);
+    
+    XCTAssertTrue([aggregator beginActivityWithToken:&token1 atTime:1000]);
+    XCTAssertFalse([aggregator beginActivityWithToken:&token1 atTime:1500]);
+    XCTAssertEqual(aggregator.activeCount, 1);
+    
+    XCTAssertTrue([aggregator beginActivityWithToken:&token2 atTime:2000]);
+    XCTAssertEqual(aggregator.activeCount, 2);
+    
+    XCTAssertTrue([aggregator endActivityWithToken:&token1 atTime:3000]);
+    XCTAssertFalse([aggregator endActivityWithToken:&token1 atTime:3500]);
+    XCTAssertEqual(aggregator.activeCount, 1);
+    
+    XCTAssertTrue([aggregator endActivityWithToken:&token2 atTime:4000]);
+    XCTAssertEqual(aggregator.activeCount, 0);
+    
+    dispatch_sync(queue, ^{});
+    XCTAssertEqualObjects(changes, (@[ @YES, @NO ]));
+}
+
+- (void)testActiveDuration
+{
+    SRGMediaPlaybackActivityAggregator *aggregator = [[SRGMediaPlaybackActivityAggregator alloc] initWithQueue:dispatch_get_main_queue() activityChangeBlock:nil];
+    XCTAssertEqual([aggregator activeDurationAtTime:1000], 0);
+    
+    SRGMediaPlaybackActivityToken token1 = 0;
+    SRGMediaPlaybackActivityToken token2 = 0;
+    
+    [aggregator beginActivityWithToken:&token1 atTime:1000];
+    XCTAssertEqual([aggregator activeDurationAtTime:1500], 500);
+    
+    // Durations of simultaneously active players are summed
+    [aggregator beginActivityWithToken:&token2 atTime:2000];
+    XCTAssertEqual([aggregator activeDurationAtTime:3000], 3000);
+    
+    [aggregator endActivityWithToken:&token1 atTime:4000];
+    XCTAssertEqual([aggregator activeDurationAtTime:4000], 5000);
+    
+    [aggregator endActivityWithToken:&token2 atTime:5000];
+    XCTAssertEqual([aggregator activeDurationAtTime:10000], 6000);
+    
+    // Times going backwards
+    [aggregator beginActivityWithToken:&token1 atTime:12000];
+    XCTAssertEqual([aggregator activeDurationAtTime:11000], 6000);
+    [aggregator endActivityWithToken:&token1 atTime:11000];
+    XCTAssertEqual([aggregator activeDurationAtTime:13000], 6000);
+}
+
+- (void)testConcurrentTransitions
+{
+    NSMutableArray<NSNumber *> *changes = [NSMutableArray array];
+    dispatch_queue_t queue = dispatch_queue_create("ch.srgssr.analytics.tests.activity", DISPATCH_QUEUE_SERIAL);
+    SRGMediaPlaybackActivityAggregator *aggregator = [[SRGMediaPlaybackActivityAggregator alloc] initWithQueue:queue activityChangeBlock:^(BOOL active) {
+        [changes addObject:@(active)];
+    }];
+    
+    static const size_t kPlayerCount = 16;
+    SRGMediaPlaybackActivityToken *tokens = calloc(kPlayerCount, sizeof(SRGMediaPlaybackActivityToken));
+    
+    // Redundant transitions for the same player are received from several threads
+    dispatch_apply(kPlayerCount * 4, DISPATCH_APPLY_AUTO, ^(size_t iteration) {
+        SRGMediaPlaybackActivityToken *token = &tokens[iteration % kPlayerCount];
+        for (uint64_t time = 1; time <= 1000; time++) {
+            if (time % 2 == 1) {
+                [aggregator beginActivityWithToken:token atTime:time];
+            }
+            else {
+                [aggregator endActivityWithToken:token atTime:time];
+            }
+        }
+    });
+    
+    for (size_t i = 0; i < kPlayerCount; i++) {
+        [aggregator endActivityWithToken:&tokens[i] atTime:1000];
+    }
+    free(tokens);
+    
+    XCTAssertEqual(aggregator.activeCount, 0);
+    
+    // Changes always alternate, starting and ending with the expected values
+    dispatch_sync(queue, ^{});
+    XCTAssertEqualObjects(changes.firstObject, @YES);
+    XCTAssertEqualObjects(changes.lastObject, @NO);
+    [changes enumerateObjectsUsingBlock:^(NSNumber * _Nonnull change, NSUInteger idx, BOOL * _Nonnull stop) {
+        XCTAssertEqual(change.boolValue, idx % 2 == 0);
+    }];
+}
+
+- (void)testChangeBlockCallingAggregator
+{
+    dispatch_queue_t queue = dispatch_queue_create("ch.srgssr.analytics.tests.activity", DISPATCH_QUEUE_SERIAL);
+    
+    __block SRGMediaPlaybackActivityAggregator *aggregator = nil;
+    NSMutableArray<NSNumber *> *activeCounts = [NSMutableArray array];
+    aggregator = [[SRGMediaPlaybackActivityAggregator alloc] initWithQueue:queue activityChangeBlock:^(BOOL active) {
+        // Would deadlock if the block was called with the aggregator lock held
+        [activeCounts addObject:@(aggregator.activeCount)];
+    }];
+    
+    SRGMediaPlaybackActivityToken token = 0;
+    [aggregator beginActivityWithToken:&token atTime:1000];
+    [aggregator endActivityWithToken:&token atTime:2000];
+    
+    dispatch_sync(queue, ^{});
+    XCTAssertEqual(activeCounts.count, 2);
+    aggregator = nil;
+}
+
+@end
@@ -0,0 +1,154 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlaybackContext.h"
+#import "XCTestCase+Tests.h"
+
+@interface SRGMediaPlaybackContext (Tests)
+
+- (AVPlayerItem *)currentPlayerItem;
+- (uint64_t)currentTime;
+- (NSNumber *)observedBitrateForPlayerItem:(AVPlayerItem *)playerItem;
+
+@end
+
+// Context reading from a fake item, clock and access log
+@interface TestMediaPlaybackContext : SRGMediaPlaybackContext
+
+@property (nonatomic) AVPlayerItem *playerItem;
+@property (nonatomic) uint64_t time;
+@property (nonatomic) NSNumber *observedBitrate;
+@property (nonatomic) NSUInteger accessLogReadCount;
+
+@end
+
+@interface MediaPlaybackContextTestCase : XCTestCase
+
+@property (nonatomic) TestMediaPlaybackContext *playbackContext;
+
+@end
+
+@implementation MediaPlaybackContextTestCase
+
+#pragma mark Setup and teardown
+
+- (void)setUp
+{
+    self.playbackContext = [[TestMediaPlaybackContext alloc] initWithMediaPlayerController:[[SRGMediaPlayerController alloc] init]];
+    self.playbackContext.playerItem = [AVPlayerItem playerItemWithURL:[NSURL fileURLWithPath:@"/media.m3u8"]];
+    self.playbackContext.time = 1000 * NSEC_PER_SEC;
+    self.playbackContext.observedBitrate = @1000000;
+}
+
+- (void)tearDown
+{
+    self.playbackContext = nil;
+}
+
+#pragma mark Tests
+
+- (void)testWithoutPlayerItem
+{
+    self.playbackContext.playerItem = nil;
+    XCTAssertNil(self.playbackContext.bandwidthInBitsPerSecond);
+    XCTAssertEqual(self.playbackContext.accessLogReadCount, 0);
+}
+
+- (void)testEventsInARowShareBandwidth
+{
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @1000000);
+
+    self.playbackContext.observedBitrate = @2000000;
+    self.playbackContext.time += SRGMediaPlaybackContextBandwidthMaximumAge * NSEC_PER_SEC / 2;
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @1000000);
+    XCTAssertEqual(self.playbackContext.accessLogReadCount, 1);
+}
+
+- (void)testHeartbeatBandwidth
+{
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @1000000);
+
+    // The bitrate observed for the same access log entry changes between heartbeats
+    self.playbackContext.observedBitrate = @2000000;
+    self.playbackContext.time += 30 * NSEC_PER_SEC;
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @2000000);
+
+    self.playbackContext.observedBitrate = @3000000;
+    self.playbackContext.time += 30 * NSEC_PER_SEC;
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @3000000);
+    XCTAssertEqual(self.playbackContext.accessLogReadCount, 3);
+}
+
+- (void)testInvalidation
+{
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @1000000);
+
+    self.playbackContext.observedBitrate = @2000000;
+    [self.playbackContext invalidateBandwidth];
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @2000000);
+    XCTAssertEqual(self.playbackContext.accessLogReadCount, 2);
+}
+
+- (void)testNewAccessLogEntry
+{
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @1000000);
+
+    self.playbackContext.observedBitrate = @2000000;
+    [NSNotificationCenter.defaultCenter postNotificationName:AVPlayerItemNewAccessLogEntryNotification object:self.playbackContext.playerItem];
+
+    // The notification is processed asynchronously on the main thread
+    [self expectationForPredicate:[NSPredicate predicateWithBlock:^BOOL(TestMediaPlaybackContext * _Nullable playbackContext, NSDictionary<NSString *,id> * _Nullable bindings) {
+        return [playbackContext.bandwidthInBitsPerSecond isEqual:@2000000];
+    }] evaluatedWithObject:self.playbackContext handler:nil];
+
+    [self waitForExpectationsWithTimeout:5. handler:nil];
+}
+
+- (void)testNewAccessLogEntryForOtherItem
+{
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @1000000);
+
+    self.playbackContext.observedBitrate = @2000000;
+    AVPlayerItem *otherPlayerItem = [AVPlayerItem playerItemWithURL:[NSURL fileURLWithPath:@"/other_media.m3u8"]];
+    [NSNotificationCenter.defaultCenter postNotificationName:AVPlayerItemNewAccessLogEntryNotification object:otherPlayerItem];
+
+    [self expectationForElapsedTimeInterval:1. withHandler:nil];
+    [self waitForExpectationsWithTimeout:5. handler:nil];
+
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @1000000);
+}
+
+- (void)testPlayerItemChange
+{
+    XCTAssertEqualObjects(self.playbackContext.bandwidthInBitsPerSecond, @1000000);
+
+    self.playbackContext.playerItem = [AVPlayerItem playerItemWithURL:[NSURL fileURLWithPath:@"/other_media.m3u8"]];
+    self.playbackContext.observedBitrate = nil;
+    XCTAssertNil(self.playbackContext.bandwidthInBitsPerSecond);
+    XCTAssertEqual(self.playbackContext.accessLogReadCount, 2);
+}
+
+@end
+
+@implementation TestMediaPlaybackContext
+
+- (AVPlayerItem *)currentPlayerItem
+{
+    return self.playerItem;
+}
+
+- (uint64_t)currentTime
+{
+    return self.time;
+}
+
+- (NSNumber *)observedBitrateForPlayerItem:(AVPlayerItem *)playerItem
+{
+    self.accessLogReadCount += 1;
+    return self.observedBitrate;
+}
+
+@end
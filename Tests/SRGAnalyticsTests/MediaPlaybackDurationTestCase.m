@@ -0,0 +1,131 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaAnalytics.h"
+#import "SRGMediaPlaybackDurationAccumulator.h"
+
+@import XCTest;
+
+@interface MediaPlaybackDurationTestCase : XCTestCase
+
+@end
+
+@implementation MediaPlaybackDurationTestCase
+
+#pragma mark Tests
+
+- (void)testInitialDurations
+{
+    SRGMediaPlaybackDurationAccumulator accumulator;
+    SRGMediaPlaybackDurationAccumulatorInit(&accumulator);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorActivity(&accumulator), SRGMediaPlaybackActivityIdle);
+    
+    for (SRGMediaPlaybackActivity activity = SRGMediaPlaybackActivityIdle; activity < SRGMediaPlaybackActivityCount; ++activity) {
+        XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, activity, 1000), 0);
+    }
+}
+
+- (void)testActivityForEvent
+{
+    XCTAssertEqual(SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEventPlay, SRGMediaPlaybackActivityIdle), SRGMediaPlaybackActivityPlaying);
+    XCTAssertEqual(SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEventPause, SRGMediaPlaybackActivityPlaying), SRGMediaPlaybackActivityPaused);
+    XCTAssertEqual(SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEventSeek, SRGMediaPlaybackActivityPlaying), SRGMediaPlaybackActivityBuffering);
+    XCTAssertEqual(SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEventBuffer, SRGMediaPlaybackActivityPlaying), SRGMediaPlaybackActivityBuffering);
+    XCTAssertEqual(SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEventEnd, SRGMediaPlaybackActivityPlaying), SRGMediaPlaybackActivityIdle);
+    XCTAssertEqual(SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEventStop, SRGMediaPlaybackActivityPaused), SRGMediaPlaybackActivityIdle);
+    XCTAssertEqual(SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEventPosition, SRGMediaPlaybackActivityPlaying), SRGMediaPlaybackActivityPlaying);
+    XCTAssertEqual(SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEventUptime, SRGMediaPlaybackActivityBuffering), SRGMediaPlaybackActivityBuffering);
+    XCTAssertEqual(SRGMediaPlaybackActivityForEvent(SRGMediaPlaybackEventSegment, SRGMediaPlaybackActivityPaused), SRGMediaPlaybackActivityPaused);
+}
+
+- (void)testSeparateCounters
+{
+    SRGMediaPlaybackDurationAccumulator accumulator;
+    SRGMediaPlaybackDurationAccumulatorInit(&accumulator);
+    
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityBuffering, 1000);
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPlaying, 1500);
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPaused, 4500);
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPlaying, 5000);
+    
+    // Time spent in the current activity is included
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPlaying, 6001), 4001);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityBuffering, 6001), 500);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPaused, 6001), 500);
+    
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityIdle, 7000);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPlaying, 10000), 5000);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityIdle, 10000), 0);
+}
+
+- (void)testSameActivity
+{
+    SRGMediaPlaybackDurationAccumulator accumulator;
+    SRGMediaPlaybackDurationAccumulatorInit(&accumulator);
+    
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPlaying, 0);
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPlaying, 2000);
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPlaying, 3000);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPlaying, 3500), 3500);
+}
+
+- (void)testSuspension
+{
+    SRGMediaPlaybackDurationAccumulator accumulator;
+    SRGMediaPlaybackDurationAccumulatorInit(&accumulator);
+    
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPaused, 0);
+    SRGMediaPlaybackDurationAccumulatorSuspend(&accumulator, 1000);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPaused, 50000), 1000);
+    
+    SRGMediaPlaybackDurationAccumulatorResume(&accumulator, 60000);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPaused, 61000), 2000);
+    
+    // Changing activity resumes a suspended accumulator
+    SRGMediaPlaybackDurationAccumulatorSuspend(&accumulator, 62000);
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPlaying, 70000);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPaused, 80000), 3000);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPlaying, 80000), 10000);
+}
+
+- (void)testClockGoingBackwards
+{
+    SRGMediaPlaybackDurationAccumulator accumulator;
+    SRGMediaPlaybackDurationAccumulatorInit(&accumulator);
+    
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPlaying, 5000);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPlaying, 4000), 0);
+}
+
+- (void)testReset
+{
+    SRGMediaPlaybackDurationAccumulator accumulator;
+    SRGMediaPlaybackDurationAccumulatorInit(&accumulator);
+    
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPaused, 0);
+    SRGMediaPlaybackDurationAccumulatorSetActivity(&accumulator, SRGMediaPlaybackActivityPlaying, 1000);
+    SRGMediaPlaybackDurationAccumulatorReset(&accumulator, 3000);
+    
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorActivity(&accumulator), SRGMediaPlaybackActivityPlaying);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPaused, 4000), 0);
+    XCTAssertEqual(SRGMediaPlaybackDurationAccumulatorDuration(&accumulator, SRGMediaPlaybackActivityPlaying, 4000), 1000);
+}
+
+- (void)testTimeToMilliseconds
+{
+    XCTAssertEqual(SRGMediaAnalyticsCMTimeToMilliseconds(kCMTimeInvalid), 0);
+    XCTAssertEqual(SRGMediaAnalyticsCMTimeToMilliseconds(kCMTimeIndefinite), 0);
+    XCTAssertEqual(SRGMediaAnalyticsCMTimeToMilliseconds(kCMTimePositiveInfinity), 0);
+    XCTAssertEqual(SRGMediaAnalyticsCMTimeToMilliseconds(CMTimeMake(-10, 1)), 0);
+    XCTAssertEqual(SRGMediaAnalyticsCMTimeToMilliseconds(CMTimeMake(1999, 1000)), 1999);
+    XCTAssertEqual(SRGMediaAnalyticsCMTimeToMilliseconds(CMTimeMake(2999999, 1000000)), 2999);
+    
+    // Livestream timestamps (seconds since 1970) are preserved to the millisecond
+    XCTAssertEqual(SRGMediaAnalyticsCMTimeToMilliseconds(CMTimeMake(1700000000123, 1000)), 1700000000123);
+    XCTAssertEqual(SRGMediaAnalyticsCMTimeToMilliseconds(CMTimeMake(153000000011070, 90000)), 1700000000123);
+}
+
+@end
@@ -0,0 +1,123 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlaybackStateMachine.h"
+
+@import XCTest;
+
+static SRGMediaPlaybackStateMachine StateMachineWithLastEvent(SRGMediaPlaybackEvent lastEvent)
+{
+    SRGMediaPlaybackStateMachine stateMachine;
+    SRGMediaPlaybackStateMachineInit(&stateMachine);
+    
+    if (lastEvent != SRGMediaPlaybackEventStop) {
+        SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+        SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPlay, events);
+        if (lastEvent != SRGMediaPlaybackEventPlay) {
+            SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, lastEvent, events);
+        }
+    }
+    return stateMachine;
+}
+
+@interface MediaPlaybackStateMachineTestCase : XCTestCase
+
+@end
+
+@implementation MediaPlaybackStateMachineTestCase
+
+#pragma mark Tests
+
+- (void)testInitialState
+{
+    SRGMediaPlaybackStateMachine stateMachine;
+    SRGMediaPlaybackStateMachineInit(&stateMachine);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), SRGMediaPlaybackEventStop);
+}
+
+- (void)testStateEvents
+{
+    XCTAssertFalse(SRGMediaPlaybackEventIsStateEvent(SRGMediaPlaybackEventNone));
+    XCTAssertTrue(SRGMediaPlaybackEventIsStateEvent(SRGMediaPlaybackEventPlay));
+    XCTAssertTrue(SRGMediaPlaybackEventIsStateEvent(SRGMediaPlaybackEventBuffer));
+    XCTAssertTrue(SRGMediaPlaybackEventIsStateEvent(SRGMediaPlaybackEventStop));
+    XCTAssertFalse(SRGMediaPlaybackEventIsStateEvent(SRGMediaPlaybackEventPosition));
+    XCTAssertFalse(SRGMediaPlaybackEventIsStateEvent(SRGMediaPlaybackEventSegment));
+}
+
+// Check all transitions against the expected behavior, expressed as accepted transitions between states
+- (void)testAllTransitions
+{
+    NSDictionary<NSNumber *, NSArray<NSNumber *> *> *acceptedEvents = @{ @(SRGMediaPlaybackEventPlay) : @[ @(SRGMediaPlaybackEventPause), @(SRGMediaPlaybackEventSeek), @(SRGMediaPlaybackEventStop), @(SRGMediaPlaybackEventEnd) ],
+                                                                        @(SRGMediaPlaybackEventPause) : @[ @(SRGMediaPlaybackEventPlay), @(SRGMediaPlaybackEventSeek), @(SRGMediaPlaybackEventStop), @(SRGMediaPlaybackEventEnd) ],
+                                                                        @(SRGMediaPlaybackEventSeek) : @[ @(SRGMediaPlaybackEventPlay), @(SRGMediaPlaybackEventPause), @(SRGMediaPlaybackEventStop), @(SRGMediaPlaybackEventEnd) ],
+                                                                        @(SRGMediaPlaybackEventStop) : @[ @(SRGMediaPlaybackEventPlay) ],
+                                                                        @(SRGMediaPlaybackEventEnd) : @[ @(SRGMediaPlaybackEventPlay) ] };
+    
+    for (NSNumber *state in acceptedEvents) {
+        for (NSInteger event = SRGMediaPlaybackEventNone; event < SRGMediaPlaybackEventCount; ++event) {
+            SRGMediaPlaybackStateMachine stateMachine = StateMachineWithLastEvent(state.intValue);
+            XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), state.intValue);
+            
+            SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+            size_t eventCount = SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, (SRGMediaPlaybackEvent)event, events);
+            
+            if (event == SRGMediaPlaybackEventNone) {
+                XCTAssertEqual(eventCount, 0);
+                XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), state.intValue);
+            }
+            else if (! SRGMediaPlaybackEventIsStateEvent((SRGMediaPlaybackEvent)event)) {
+                XCTAssertEqual(eventCount, 1);
+                XCTAssertEqual(events[0], event);
+                XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), state.intValue);
+            }
+            else if (state.integerValue == SRGMediaPlaybackEventStop && (event == SRGMediaPlaybackEventPause || event == SRGMediaPlaybackEventSeek)) {
+                XCTAssertEqual(eventCount, 2);
+                XCTAssertEqual(events[0], SRGMediaPlaybackEventPlay);
+                XCTAssertEqual(events[1], event);
+                XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), event);
+            }
+            else if ([acceptedEvents[state] containsObject:@(event)]) {
+                XCTAssertEqual(eventCount, 1);
+                XCTAssertEqual(events[0], event);
+                XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), event);
+            }
+            else {
+                XCTAssertEqual(eventCount, 0);
+                XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), state.intValue);
+            }
+        }
+    }
+}
+
+- (void)testInvalidEvent
+{
+    SRGMediaPlaybackStateMachine stateMachine;
+    SRGMediaPlaybackStateMachineInit(&stateMachine);
+    
+    SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+    XCTAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventCount, events), 0);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, (SRGMediaPlaybackEvent)-1, events), 0);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), SRGMediaPlaybackEventStop);
+}
+
+- (void)testSession
+{
+    SRGMediaPlaybackStateMachine stateMachine;
+    SRGMediaPlaybackStateMachineInit(&stateMachine);
+    
+    SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+    XCTAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventBuffer, events), 0);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPlay, events), 1);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPosition, events), 1);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPlay, events), 0);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventEnd, events), 1);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventStop, events), 0);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, SRGMediaPlaybackEventPause, events), 0);
+    XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachine), SRGMediaPlaybackEventEnd);
+}
+
+@end
@@ -0,0 +1,173 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsHistogram.h"
+#import "SRGAnalyticsMetrics+Private.h"
+
+@import SRGAnalytics;
+@import XCTest;
+
+@interface MetricsTestCase : XCTestCase
+
+@end
+
+@implementation MetricsTestCase
+
+#pragma mark Setup and teardown
+
+- (void)tearDown
+{
+    SRGAnalyticsMetricsSetEnabled(NO);
+}
+
+#pragma mark Tests
+
+- (void)testHistogramBuckets
+{
+    for (size_t i = 0; i < SRGAnalyticsHistogramBucketCount; i++) {
+        uint64_t upperBound = SRGAnalyticsHistogramBucketUpperBound(i);
+        XCTAssertEqual(SRGAnalyticsHistogramBucketIndex(upperBound), i);
+        if (i + 1 < SRGAnalyticsHistogramBucketCount) {
+            XCTAssertEqual(SRGAnalyticsHistogramBucketIndex(upperBound + 1), i + 1);
+        }
+    }
+    XCTAssertEqual(SRGAnalyticsHistogramBucketIndex(UINT64_MAX), SRGAnalyticsHistogramBucketCount - 1);
+    
+    // Bounded relative error
+    for (NSUInteger i = 0; i < 100000; i++) {
+        uint64_t value = ((uint64_t)arc4random() << 32 | arc4random()) >> arc4random_uniform(64);
+        uint64_t upperBound = SRGAnalyticsHistogramBucketUpperBound(SRGAnalyticsHistogramBucketIndex(value));
+        XCTAssertGreaterThanOrEqual(upperBound, value);
+        if (value >= 16) {
+            XCTAssertLessThan((double)(upperBound - value) / (double)value, 0.125);
+        }
+    }
+}
+
+- (void)testHistogramQuantiles
+{
+    SRGAnalyticsHistogram *histogram = calloc(1, sizeof(SRGAnalyticsHistogram));
+    SRGAnalyticsHistogramSnapshot *snapshot = calloc(1, sizeof(SRGAnalyticsHistogramSnapshot));
+    
+    SRGAnalyticsHistogramCopy(histogram, snapshot, false);
+    XCTAssertEqual(SRGAnalyticsHistogramSnapshotValueAtQuantile(snapshot, 0.5), 0);
+    
+    for (uint64_t value = 1; value <= 1000; value++) {
+        SRGAnalyticsHistogramRecord(histogram, value * 1000);
+    }
+    
+    SRGAnalyticsHistogramCopy(histogram, snapshot, true);
+    XCTAssertEqual(snapshot->count, 1000);
+    XCTAssertEqual(snapshot->sum, 500500000);
+    XCTAssertEqual(snapshot->maximum, 1000000);
+    XCTAssertEqualWithAccuracy(SRGAnalyticsHistogramSnapshotValueAtQuantile(snapshot, 0.5), 500000, 500000 * 0.125);
+    XCTAssertEqualWithAccuracy(SRGAnalyticsHistogramSnapshotValueAtQuantile(snapshot, 0.9), 900000, 900000 * 0.125);
+    XCTAssertEqual(SRGAnalyticsHistogramSnapshotValueAtQuantile(snapshot, 1.), 1000000);
+    
+    SRGAnalyticsHistogramCopy(histogram, snapshot, false);
+    XCTAssertEqual(snapshot->count, 0);
+    XCTAssertEqual(snapshot->maximum, 0);
+    
+    free(snapshot);
+    free(histogram);
+}
+
+- (void)testConcurrentRecording
+{
+    SRGAnalyticsHistogram *histogram = calloc(1, sizeof(SRGAnalyticsHistogram));
+    dispatch_apply(8, DISPATCH_APPLY_AUTO, ^(size_t iteration) {
+        for (uint64_t value = 0; value < 10000; value++) {
+            SRGAnalyticsHistogramRecord(histogram, value);
+        }
+    });
+    
+    SRGAnalyticsHistogramSnapshot *snapshot = calloc(1, sizeof(SRGAnalyticsHistogramSnapshot));
+    SRGAnalyticsHistogramCopy(histogram, snapshot, false);
+    XCTAssertEqual(snapshot->count, 80000);
+    XCTAssertEqual(snapshot->maximum, 9999);
+    
+    free(snapshot);
+    free(histogram);
+}
+
+- (void)testDisabledMetrics
+{
+    SRGAnalyticsMetricsSetEnabled(NO);
+    XCTAssertFalse(SRGAnalyticsMetricsEnabled());
+    XCTAssertEqual(SRGAnalyticsMetricsStartTime(), 0);
+    XCTAssertNil(SRGAnalyticsMetricsTakeSnapshot(NO));
+    XCTAssertNil([SRGAnalyticsTracker.sharedTracker metricsSnapshotWithReset:NO]);
+}
+
+- (void)testSnapshot
+{
+    SRGAnalyticsMetricsSetEnabled(YES);
+    
+    uint64_t startTime = SRGAnalyticsMetricsStartTime();
+    XCTAssertNotEqual(startTime, 0);
+    [NSThread sleepForTimeInterval:0.01];
+    SRGAnalyticsMetricsRecordLatency(SRGAnalyticsMetricsLatencySerialization, startTime);
+    
+    SRGAnalyticsMetricsRecordEvent(@"play");
+    SRGAnalyticsMetricsRecordEvent(@"play");
+    SRGAnalyticsMetricsRecordEvent(@"pos");
+    SRGAnalyticsMetricsRecordProducedBytes(100);
+    SRGAnalyticsMetricsRecordProducedBytes(50);
+    SRGAnalyticsMetricsRecordEventQueueDepth(12);
+    SRGAnalyticsMetricsRecordEventQueueDepth(3);
+    SRGAnalyticsMetricsRecordHeartbeatTimerWakeUp();
+    SRGAnalyticsMetricsRecordMediaPlayerTrackerHeartbeats(4);
+    SRGAnalyticsMetricsRecordMediaPlayerTrackerHeartbeats(6);
+    
+    SRGAnalyticsMetricsSnapshot *snapshot = [SRGAnalyticsTracker.sharedTracker metricsSnapshotWithReset:YES];
+    XCTAssertGreaterThan(snapshot.duration, 0.);
+    SRGAnalyticsMetricsDistribution *serializationLatencies = snapshot.stageLatencies[SRGAnalyticsMetricsStageSerialization];
+    XCTAssertEqual(serializationLatencies.count, 1);
+    XCTAssertGreaterThanOrEqual(serializationLatencies.maximum, 0.01);
+    XCTAssertEqual([serializationLatencies valueAtPercentile:100.], serializationLatencies.maximum);
+    
+    XCTAssertEqualObjects(snapshot.eventCounts[@"play"], @2);
+    XCTAssertEqualObjects(snapshot.eventCounts[@"pos"], @1);
+    XCTAssertEqual(snapshot.producedByteCount, 150);
+    XCTAssertEqual(snapshot.eventQueueHighWaterMark, 12);
+    XCTAssertEqual(snapshot.heartbeatTimerWakeUpCount, 1);
+    XCTAssertEqual(snapshot.mediaPlayerTrackerHeartbeats.count, 2);
+    XCTAssertEqual(snapshot.mediaPlayerTrackerHeartbeats.mean, 5.);
+    XCTAssertEqual(snapshot.mediaPlayerTrackerHeartbeats.maximum, 6.);
+    
+    SRGAnalyticsMetricsSnapshot *resetSnapshot = [SRGAnalyticsTracker.sharedTracker metricsSnapshotWithReset:NO];
+    XCTAssertNil(resetSnapshot.stageLatencies[SRGAnalyticsMetricsStageSerialization]);
+    XCTAssertNil(resetSnapshot.eventCounts[@"play"]);
+    XCTAssertEqual(resetSnapshot.producedByteCount, 0);
+    XCTAssertEqual(resetSnapshot.eventQueueHighWaterMark, 0);
+    XCTAssertEqual(resetSnapshot.heartbeatTimerWakeUpCount, 0);
+    XCTAssertEqual(resetSnapshot.mediaPlayerTrackerHeartbeats.count, 0);
+}
+
+- (void)testEventCountsAreBounded
+{
+    SRGAnalyticsMetricsSetEnabled(YES);
+    
+    for (NSUInteger i = 0; i < SRGAnalyticsMetricsMaximumEventNameCount + 10; ++i) {
+        SRGAnalyticsMetricsRecordEvent([NSString stringWithFormat:@"page %@", @(i)]);
+    }
+    SRGAnalyticsMetricsRecordEvent(@"page 0");
+    SRGAnalyticsMetricsRecordEvent(@"page 1000");
+    
+    SRGAnalyticsMetricsSnapshot *snapshot = [SRGAnalyticsTracker.sharedTracker metricsSnapshotWithReset:YES];
+    XCTAssertEqual(snapshot.eventCounts.count, SRGAnalyticsMetricsMaximumEventNameCount + 1);
+    XCTAssertEqualObjects(snapshot.eventCounts[@"page 0"], @2);
+    XCTAssertNil(snapshot.eventCounts[@"page 1000"]);
+    XCTAssertEqualObjects(snapshot.eventCounts[SRGAnalyticsMetricsOtherEventsName], @11);
+    
+    // Names are counted again after a reset
+    SRGAnalyticsMetricsRecordEvent(@"page 1000");
+    SRGAnalyticsMetricsSnapshot *resetSnapshot = [SRGAnalyticsTracker.sharedTracker metricsSnapshotWithReset:NO];
+    XCTAssertEqualObjects(resetSnapshot.eventCounts[@"page 1000"], @1);
+    XCTAssertNil(resetSnapshot.eventCounts[SRGAnalyticsMetricsOtherEventsName]);
+}
+
+@end
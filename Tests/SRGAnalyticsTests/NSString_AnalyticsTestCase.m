@@ -8,6 +8,21 @@
 
 @import XCTest;
 
+// Former Foundation-based implementation, used as reference
+static NSString *ReferenceComScoreFormattedString(NSString *string)
+{
+    NSLocale *posixLocale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
+    NSString *normalizedString = [string.lowercaseString stringByFoldingWithOptions:NSDiacriticInsensitiveSearch locale:posixLocale];
+    
+    NSCharacterSet *andSet = [NSCharacterSet characterSetWithCharactersInString:@"+&"];
+    normalizedString = [[normalizedString componentsSeparatedByCharactersInSet:andSet] componentsJoinedByString:@"and"];
+    
+    NSRegularExpression *regularExpression = [NSRegularExpression regularExpressionWithPattern:@"[^a-z0-9]+" options:0 error:NULL];
+    normalizedString = [regularExpression stringByReplacingMatchesInString:normalizedString options:0 range:NSMakeRange(0, normalizedString.length) withTemplate:@"-"];
+    
+    return [normalizedString stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"-"]];
+}
+
 @interface NSString_AnalyticsTestCase : XCTestCase
 
 @end
@@ -26,6 +41,61 @@
     XCTAssertEqualObjects(@"     trimmed!   ".srg_comScoreFormattedString, @"trimmed");
     XCTAssertEqualObjects(@"Vue aérienne de la zone de la \"potentielle attaque terroriste\" à Londres".srg_comScoreFormattedString, @"vue-aerienne-de-la-zone-de-la-potentielle-attaque-terroriste-a-londres");
     XCTAssertEqualObjects(@"News: \"Hello\"".srg_comScoreFormattedString, @"news-hello");
+    XCTAssertEqualObjects(@"Ça coûte + de 1000 €".srg_comScoreFormattedString, @"ca-coute-and-de-1000");
+    XCTAssertEqualObjects(@"Rhône-Alpes: l'été en 4K, un très long titre de page pour éviter le chemin rapide".srg_comScoreFormattedString, @"rhone-alpes-l-ete-en-4k-un-tres-long-titre-de-page-pour-eviter-le-chemin-rapide");
+    XCTAssertEqualObjects(@"Tiếng Việt".srg_comScoreFormattedString, @"tieng-viet");
+    XCTAssertEqualObjects(@"日本語".srg_comScoreFormattedString, @"");
+    XCTAssertEqualObjects(@"".srg_comScoreFormattedString, @"");
+    XCTAssertEqualObjects(@"ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcdefghijklmnopqrstuvwxyz".srg_comScoreFormattedString, @"abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz");
+}
+
+- (void)testFormattedStringWithNullCharacter
+{
+    NSString *string = [NSString stringWithFormat:@"Before%Cafter", (unichar)0];
+    XCTAssertEqualObjects(string.srg_comScoreFormattedString, @"before-after");
+}
+
+- (void)testFormattedStringsAgainstReference
+{
+    NSMutableArray<NSString *> *alphabet = @[ @"a", @"b", @"X", @"Y", @"0", @"9", @" ", @"+", @"&", @"-", @"_", @"!", @":", @"/", @"\"", @"'", @".", @"(",
+                                              @"é", @"È", @"ü", @"Ö", @"ç", @"ñ", @"Å", @"ệ", @"Ǖ", @"e\u0301", @"\u0308", @"日", @"Ω", @"😀", @"€",
+                                              @"ø", @"Ø", @"đ", @"Đ", @"ł", @"Ł", @"ħ", @"ŧ", @"ß", @"æ", @"Æ", @"ı", @"İ" ].mutableCopy;
+    
+    // Sample of the Latin Extended-B and Latin Extended Additional blocks covered by the folding tables
+    for (unichar character = 0x0180; character <= 0x024F; character += 7) {
+        [alphabet addObject:[NSString stringWithCharacters:&character length:1]];
+    }
+    for (unichar character = 0x1E00; character <= 0x1EFF; character += 5) {
+        [alphabet addObject:[NSString stringWithCharacters:&character length:1]];
+    }
+    
+    // Seeded so that failures can be reproduced
+    uint32_t seed = arc4random();
+    NSLog(@"Random seed: %u", seed);
+    unsigned short state[3] = { (unsigned short)seed, (unsigned short)(seed >> 16), 0x330E };
+    
+    for (NSInteger i = 0; i < 2000; ++i) {
+        NSMutableString *string = [NSMutableString string];
+        NSUInteger length = nrand48(state) % 40;
+        for (NSUInteger j = 0; j < length; ++j) {
+            [string appendString:alphabet[nrand48(state) % alphabet.count]];
+        }
+        XCTAssertEqualObjects(string.srg_comScoreFormattedString, ReferenceComScoreFormattedString(string), @"Input: %@ (seed: %u)", string, seed);
+    }
+}
+
+- (void)testFoldedCharactersAgainstReference
+{
+    void (^checkCharacters)(unichar, unichar) = ^(unichar firstCharacter, unichar lastCharacter) {
+        for (unichar character = firstCharacter; character <= lastCharacter; ++character) {
+            NSString *string = [NSString stringWithFormat:@"a%Cb", character];
+            XCTAssertEqualObjects(string.srg_comScoreFormattedString, ReferenceComScoreFormattedString(string), @"Character: U+%04X", character);
+        }
+    };
+    
+    // All characters covered by the folding tables
+    checkCharacters(0x00C0, 0x024F);
+    checkCharacters(0x1E00, 0x1EFF);
 }
 
 @end
@@ -0,0 +1,79 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsPageViewCoalescer.h"
+
+@import XCTest;
+
+@interface PageViewCoalescerTestCase : XCTestCase
+
+@end
+
+@implementation PageViewCoalescerTestCase
+
+#pragma mark Tests
+
+- (void)testIdenticalPageViews
+{
+    SRGAnalyticsPageViewCoalescer *coalescer = [[SRGAnalyticsPageViewCoalescer alloc] initWithInterval:60.];
+    
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:@[ @"level" ] labels:nil fromPushNotification:NO]);
+    XCTAssertFalse([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:@[ @"level" ] labels:nil fromPushNotification:NO]);
+    XCTAssertFalse([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:@[ @"level" ].mutableCopy labels:nil fromPushNotification:NO]);
+}
+
+- (void)testDifferentPageViews
+{
+    SRGAnalyticsPageViewCoalescer *coalescer = [[SRGAnalyticsPageViewCoalescer alloc] initWithInterval:60.];
+    
+    SRGAnalyticsPageViewLabels *labels1 = [[SRGAnalyticsPageViewLabels alloc] init];
+    labels1.customInfo = @{ @"key" : @"value1" };
+    
+    SRGAnalyticsPageViewLabels *labels2 = [[SRGAnalyticsPageViewLabels alloc] init];
+    labels2.customInfo = @{ @"key" : @"value2" };
+    
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:nil labels:nil fromPushNotification:NO]);
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"other_title" type:@"type" levels:nil labels:nil fromPushNotification:NO]);
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"other_type" levels:nil labels:nil fromPushNotification:NO]);
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:@[ @"level" ] labels:nil fromPushNotification:NO]);
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:nil labels:labels1 fromPushNotification:NO]);
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:nil labels:labels2 fromPushNotification:NO]);
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:nil labels:nil fromPushNotification:YES]);
+    
+    SRGAnalyticsPageViewLabels *labels1Copy = [[SRGAnalyticsPageViewLabels alloc] init];
+    labels1Copy.customInfo = @{ @"key" : @"value1" };
+    XCTAssertFalse([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:nil labels:labels1Copy fromPushNotification:NO]);
+}
+
+- (void)testInterval
+{
+    SRGAnalyticsPageViewCoalescer *coalescer = [[SRGAnalyticsPageViewCoalescer alloc] initWithInterval:0.2];
+    
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:nil labels:nil fromPushNotification:NO]);
+    XCTAssertFalse([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:nil labels:nil fromPushNotification:NO]);
+    
+    [NSThread sleepForTimeInterval:0.3];
+    
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:nil labels:nil fromPushNotification:NO]);
+}
+
+// A page view whose information changed within the interval must be sent
+- (void)testChangedPageView
+{
+    SRGAnalyticsPageViewCoalescer *coalescer = [[SRGAnalyticsPageViewCoalescer alloc] initWithInterval:60.];
+    
+    SRGAnalyticsPageViewLabels *labels = [[SRGAnalyticsPageViewLabels alloc] init];
+    labels.customInfo = @{ @"key" : @"value" };
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:@[ @"level" ] labels:labels fromPushNotification:NO]);
+    XCTAssertFalse([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:@[ @"level" ] labels:labels fromPushNotification:NO]);
+    
+    labels.customInfo = @{ @"key" : @"other_value" };
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:@[ @"level" ] labels:labels fromPushNotification:NO]);
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"title" type:@"type" levels:@[ @"level", @"sublevel" ] labels:labels fromPushNotification:NO]);
+    XCTAssertTrue([coalescer shouldTrackPageViewWithTitle:@"new_title" type:@"type" levels:@[ @"level", @"sublevel" ] labels:labels fromPushNotification:NO]);
+}
+
+@end
@@ -0,0 +1,327 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "NSString+SRGAnalytics.h"
+#import "SRGAnalyticsEventJournal.h"
+#import "SRGAnalyticsLabels+Private.h"
+#import "SRGAnalyticsLabelsSnapshot.h"
+#import "SRGMediaPlaybackStateMachine.h"
+#import "SRGMediaPlayerTracker+Private.h"
+#import "SRGMediaPlayerTrackerRegistry.h"
+#import "TrackerSingletonSetup.h"
+#import "XCTestCase+Tests.h"
+
+@import Mantle;
+@import SRGAnalyticsDataProvider;
+
+#import <stdatomic.h>
+#import <time.h>
+
+// Private but stable hook, used by malloc stack logging and by Instruments
+typedef void (MallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t frameCount);
+extern MallocLogger *malloc_logger;
+
+static _Atomic uint64_t s_allocationCount;
+static _Atomic uint64_t s_allocatedBytes;
+
+static void CountingMallocLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t frameCount)
+{
+    static const uint32_t kTypeAllocate = 2;
+    static const uint32_t kTypeDeallocate = 4;
+    
+    if (type & kTypeAllocate) {
+        // Reallocations provide the new size as third argument
+        atomic_fetch_add_explicit(&s_allocationCount, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&s_allocatedBytes, (type & kTypeDeallocate) ? arg3 : arg2, memory_order_relaxed);
+    }
+}
+
+static NSURL *FixtureURL(NSString *name, NSString *extension)
+{
+    return [SWIFTPM_MODULE_BUNDLE URLForResource:name withExtension:extension subdirectory:@"Resources"];
+}
+
+static SRGMediaComposition *MediaCompositionFixture(void)
+{
+    NSData *data = [NSData dataWithContentsOfURL:FixtureURL(@"MediaComposition", @"json")];
+    NSDictionary *JSONDictionary = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+    return [MTLJSONAdapter modelOfClass:SRGMediaComposition.class fromJSONDictionary:JSONDictionary error:NULL];
+}
+
+static SRGAnalyticsLabels *GlobalTestLabels(void)
+{
+    SRGAnalyticsLabels *labels = [[SRGAnalyticsLabels alloc] init];
+    labels.customInfo = @{ @"consent_services" : @"service1,service2,service3",
+                           @"app_version" : @"1.0",
+                           @"user_is_logged" : @"false" };
+    labels.comScoreCustomInfo = @{ @"cs_ucfr" : @"1" };
+    return labels;
+}
+
+static SRGAnalyticsEventLabels *EventTestLabels(void)
+{
+    SRGAnalyticsEventLabels *labels = [[SRGAnalyticsEventLabels alloc] init];
+    labels.type = @"toggle";
+    labels.value = @"value";
+    labels.source = @"source";
+    labels.extraValue1 = @"extra1";
+    labels.extraValue2 = @"extra2";
+    labels.extraValue3 = @"extra3";
+    labels.customInfo = @{ @"custom_key1" : @"custom_value1",
+                           @"custom_key2" : @"custom_value2" };
+    return labels;
+}
+
+static NSArray<NSString *> *PageTestTitles(void)
+{
+    return @[ @"Home", @"Vidéos à la une", @"Émissions: Temps Présent", @"Sport + Météo", @"Tagesschau vom 17.10.2026",
+              @"Rhône-Alpes: l'été en 4K", @"Radio & Podcasts", @"Live" ];
+}
+
+/**
+ *  Benchmarks for the library hot paths, with local fixtures only. Besides XCTest metrics (baselines can be recorded
+ *  from Xcode), each benchmark prints a machine-readable line with the mean time, number of heap allocations and number
+ *  of allocated bytes per operation:
+ *
+ *    SRGAnalyticsBenchmark {"name":"<name>","operations":<count>,"ns_per_op":<value>,"allocations_per_op":<value>,"bytes_per_op":<value>}
+ *
+ *  Allocations are counted for the whole process, including those made by the tracker worker in the meantime.
+ */
+@interface PerformanceTestCase : XCTestCase
+
+@property (nonatomic) NSURL *directoryURL;
+
+@end
+
+@implementation PerformanceTestCase
+
+#pragma mark Setup and teardown
+
++ (void)setUp
+{
+    SetupTestSingletonTracker();
+}
+
+- (void)setUp
+{
+    self.directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+}
+
+- (void)tearDown
+{
+    [NSFileManager.defaultManager removeItemAtURL:self.directoryURL error:NULL];
+}
+
+#pragma mark Helpers
+
+- (void)reportOperationsWithName:(NSString *)name count:(NSUInteger)count block:(void (NS_NOESCAPE ^)(NSUInteger index))block
+{
+    // Warm up caches first, then time a single run for the machine-readable report
+    @autoreleasepool {
+        for (NSUInteger i = 0; i < count; ++i) {
+            block(i);
+        }
+    }
+
+    uint64_t allocationCount = atomic_load_explicit(&s_allocationCount, memory_order_relaxed);
+    uint64_t allocatedBytes = atomic_load_explicit(&s_allocatedBytes, memory_order_relaxed);
+    MallocLogger *previousMallocLogger = malloc_logger;
+    malloc_logger = CountingMallocLogger;
+    
+    uint64_t startTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    @autoreleasepool {
+        for (NSUInteger i = 0; i < count; ++i) {
+            block(i);
+        }
+    }
+    uint64_t duration = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - startTime;
+    
+    malloc_logger = previousMallocLogger;
+    allocationCount = atomic_load_explicit(&s_allocationCount, memory_order_relaxed) - allocationCount;
+    allocatedBytes = atomic_load_explicit(&s_allocatedBytes, memory_order_relaxed) - allocatedBytes;
+    
+    printf("SRGAnalyticsBenchmark {\"name\":\"%s\",\"operations\":%lu,\"ns_per_op\":%.1f,\"allocations_per_op\":%.2f,\"bytes_per_op\":%.1f}\n",
+           name.UTF8String, (unsigned long)count, (double)duration / count, (double)allocationCount / count, (double)allocatedBytes / count);
+}
+
+// XCTest metrics can only be measured once per test method
+- (void)measureOperationsWithName:(NSString *)name count:(NSUInteger)count block:(void (^)(NSUInteger index))block
+{
+    [self reportOperationsWithName:name count:count block:block];
+
+    void (^measuredBlock)(void) = ^{
+        @autoreleasepool {
+            for (NSUInteger i = 0; i < count; ++i) {
+                block(i);
+            }
+        }
+    };
+
+    if (@available(iOS 13, tvOS 13, *)) {
+        [self measureWithMetrics:@[ [[XCTClockMetric alloc] init], [[XCTCPUMetric alloc] init], [[XCTMemoryMetric alloc] init] ] block:measuredBlock];
+    }
+    else {
+        [self measureBlock:measuredBlock];
+    }
+}
+
+#pragma mark Tests
+
+- (void)testLabelsDictionaryPerformance
+{
+    [self measureOperationsWithName:@"labels_dictionary" count:10000 block:^(NSUInteger index) {
+        SRGAnalyticsEventLabels *labels = EventTestLabels();
+        XCTAssertEqual(labels.labelsDictionary.count, 8);
+    }];
+}
+
+- (void)testDefaultLabelsMergePerformance
+{
+    SRGAnalyticsLabels *globalLabels = GlobalTestLabels();
+    SRGAnalyticsLabels *dataSourceLabels = EventTestLabels();
+
+    [self measureOperationsWithName:@"default_labels_merge" count:10000 block:^(NSUInteger index) {
+        SRGAnalyticsLabelsSnapshot *snapshot = [[SRGAnalyticsLabelsSnapshot alloc] initWithGlobalLabels:globalLabels dataSourceLabels:dataSourceLabels version:index];
+        XCTAssertNotNil(snapshot.labelsDictionary);
+        XCTAssertNotNil(snapshot.comScoreLabelsDictionary);
+    }];
+}
+
+- (void)testPageIdFormattingPerformance
+{
+    NSArray<NSString *> *titles = PageTestTitles();
+
+    [self measureOperationsWithName:@"page_id_formatting" count:10000 block:^(NSUInteger index) {
+        XCTAssertNotNil(titles[index % titles.count].srg_comScoreFormattedString);
+    }];
+}
+
+- (void)testMediaPlayerEventStateMachinePerformance
+{
+    SRGMediaPlayerController *mediaPlayerController = [[SRGMediaPlayerController alloc] init];
+
+    SRGAnalyticsStreamLabels *labels = [[SRGAnalyticsStreamLabels alloc] init];
+    labels.customInfo = @{ @"media_urn" : @"urn:test:video:1",
+                           @"media_title" : @"Title" };
+
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePaused;
+    }];
+
+    [mediaPlayerController prepareToPlayURL:FixtureURL(@"Silence", @"wav") atPosition:nil withSegments:nil analyticsLabels:labels userInfo:nil completionHandler:nil];
+
+    [self waitForExpectationsWithTimeout:5. handler:nil];
+
+    SRGMediaPlayerTracker *tracker = [SRGMediaPlayerTrackerRegistry.sharedRegistry trackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
+    XCTAssertNotNil(tracker);
+
+    // Cycle through valid and invalid transitions
+    static const SRGMediaPlayerPlaybackState kPlaybackStates[] = {
+        SRGMediaPlayerPlaybackStatePlaying,
+        SRGMediaPlayerPlaybackStatePlaying,
+        SRGMediaPlayerPlaybackStateSeeking,
+        SRGMediaPlayerPlaybackStatePaused,
+        SRGMediaPlayerPlaybackStatePlaying,
+        SRGMediaPlayerPlaybackStateEnded
+    };
+    NSUInteger playbackStateCount = sizeof(kPlaybackStates) / sizeof(kPlaybackStates[0]);
+
+    NSDictionary *userInfo = mediaPlayerController.userInfo;
+    [self measureOperationsWithName:@"media_player_event" count:1200 block:^(NSUInteger index) {
+        [tracker recordEventForPlaybackState:kPlaybackStates[index % playbackStateCount]
+                              withStreamType:SRGMediaPlayerStreamTypeOnDemand
+                                        time:CMTimeMakeWithSeconds(index, NSEC_PER_SEC)
+                                   timeshift:nil
+                             analyticsLabels:nil
+                                    userInfo:userInfo];
+    }];
+
+    [mediaPlayerController reset];
+}
+
+- (void)testMediaPlaybackStateMachineTransitionPerformance
+{
+    static const SRGMediaPlaybackEvent kStates[] = {
+        SRGMediaPlaybackEventPlay,
+        SRGMediaPlaybackEventPause,
+        SRGMediaPlaybackEventSeek,
+        SRGMediaPlaybackEventEnd,
+        SRGMediaPlaybackEventStop
+    };
+    static const NSUInteger kStateCount = sizeof(kStates) / sizeof(kStates[0]);
+    static const NSUInteger kEventCount = SRGMediaPlaybackEventCount - SRGMediaPlaybackEventPlay;
+    
+    // Reach each state once, then copy the state machine for each measured transition
+    NSMutableData *stateMachinesData = [NSMutableData dataWithLength:kStateCount * sizeof(SRGMediaPlaybackStateMachine)];
+    SRGMediaPlaybackStateMachine *stateMachines = stateMachinesData.mutableBytes;
+    for (NSUInteger i = 0; i < kStateCount; ++i) {
+        SRGMediaPlaybackStateMachineInit(&stateMachines[i]);
+        
+        SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+        if (kStates[i] != SRGMediaPlaybackEventStop) {
+            SRGMediaPlaybackStateMachineProcessEvent(&stateMachines[i], SRGMediaPlaybackEventPlay, events);
+            SRGMediaPlaybackStateMachineProcessEvent(&stateMachines[i], kStates[i], events);
+        }
+        XCTAssertEqual(SRGMediaPlaybackStateMachineLastEvent(&stateMachines[i]), kStates[i]);
+    }
+    
+    __block size_t eventCount = 0;
+    for (NSUInteger i = 0; i < kStateCount; ++i) {
+        for (NSUInteger j = 0; j < kEventCount; ++j) {
+            NSString *name = [NSString stringWithFormat:@"state_machine_transition_%@_%@", @(kStates[i]), @(SRGMediaPlaybackEventPlay + j)];
+            [self reportOperationsWithName:name count:100000 block:^(NSUInteger index) {
+                SRGMediaPlaybackStateMachine stateMachine = stateMachines[i];
+                SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+                eventCount += SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, (SRGMediaPlaybackEvent)(SRGMediaPlaybackEventPlay + j), events);
+            }];
+        }
+    }
+    
+    [self measureOperationsWithName:@"state_machine_transitions" count:100000 block:^(NSUInteger index) {
+        SRGMediaPlaybackStateMachine stateMachine = stateMachines[index % kStateCount];
+        SRGMediaPlaybackEvent events[SRGMediaPlaybackStateMachineMaximumEventCount];
+        eventCount += SRGMediaPlaybackStateMachineProcessEvent(&stateMachine, (SRGMediaPlaybackEvent)(SRGMediaPlaybackEventPlay + index % kEventCount), events);
+    }];
+    XCTAssertNotEqual(eventCount, 0);
+}
+
+- (void)testResourceSelectionPerformance
+{
+    SRGMediaComposition *mediaComposition = MediaCompositionFixture();
+    XCTAssertNotNil(mediaComposition);
+
+    SRGPlaybackSettings *settings = [[SRGPlaybackSettings alloc] init];
+    settings.quality = SRGQualitySD;
+    settings.streamType = SRGStreamTypeDVR;
+
+    [self measureOperationsWithName:@"resource_selection" count:2000 block:^(NSUInteger index) {
+        BOOL resolved = [mediaComposition playbackContextWithPreferredSettings:(index % 2 == 0) ? settings : nil contextBlock:^(NSURL * _Nonnull streamURL, SRGResource * _Nonnull resource, NSArray<id<SRGSegment>> * _Nullable segments, NSInteger index, SRGAnalyticsStreamLabels * _Nullable analyticsLabels) {}];
+        XCTAssertTrue(resolved);
+    }];
+}
+
+- (void)testEventSerializationPerformance
+{
+    SRGAnalyticsEventJournal *journal = [[SRGAnalyticsEventJournal alloc] initWithDirectoryURL:self.directoryURL];
+    XCTAssertNotNil(journal);
+
+    SRGAnalyticsLabelsSnapshot *snapshot = [[SRGAnalyticsLabelsSnapshot alloc] initWithGlobalLabels:GlobalTestLabels() dataSourceLabels:nil version:1];
+    SRGAnalyticsEventLabels *eventLabels = EventTestLabels();
+
+    // Same steps as the tracker: merge labels, serialize the payload to the journal, acknowledge after delivery
+    [self measureOperationsWithName:@"event_serialization" count:2000 block:^(NSUInteger index) {
+        NSMutableDictionary<NSString *, NSString *> *labels = snapshot.labelsDictionary.mutableCopy;
+        [eventLabels.labelStore addEntriesToDictionary:labels];
+
+        NSDictionary<NSString *, id> *payload = @{ @"kind" : @"custom",
+                                                   @"name" : @"event",
+                                                   @"labels" : labels.copy };
+        SRGAnalyticsEventJournalRecord *record = [journal recordByAppendingPayload:payload];
+        [journal acknowledgeRecord:record];
+    }];
+}
+
+@end
@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsDeltaEncoder.h
\ No newline at end of file
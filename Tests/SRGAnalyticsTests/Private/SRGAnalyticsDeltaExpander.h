@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsDeltaExpander.h
\ No newline at end of file
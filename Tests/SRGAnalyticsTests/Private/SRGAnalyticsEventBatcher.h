@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsEventBatcher.h
\ No newline at end of file
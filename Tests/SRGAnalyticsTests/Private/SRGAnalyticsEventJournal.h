@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsEventJournal.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsEventSampler.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsEventSink.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsFileEventSink.h
\ No newline at end of file
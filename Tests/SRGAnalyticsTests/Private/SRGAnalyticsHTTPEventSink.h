@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsHTTPEventSink.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsHistogram.h
\ No newline at end of file
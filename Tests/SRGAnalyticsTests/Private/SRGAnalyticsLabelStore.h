@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsLabelStore.h
\ No newline at end of file
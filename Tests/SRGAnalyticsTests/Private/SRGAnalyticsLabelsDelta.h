@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsLabelsDelta.h
\ No newline at end of file
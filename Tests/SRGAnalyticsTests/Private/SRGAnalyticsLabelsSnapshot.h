@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsLabelsSnapshot.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsMemoryEventSink.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsPageViewCoalescer.h
\ No newline at end of file
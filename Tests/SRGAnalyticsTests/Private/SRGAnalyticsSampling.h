@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsSampling.h
\ No newline at end of file
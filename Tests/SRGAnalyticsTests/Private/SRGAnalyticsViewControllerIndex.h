@@ -0,0 +1 @@
+../../../Sources/SRGAnalytics/SRGAnalyticsViewControllerIndex.h
\ No newline at end of file
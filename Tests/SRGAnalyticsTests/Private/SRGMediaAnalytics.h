@@ -0,0 +1 @@
+../../../Sources/SRGAnalyticsMediaPlayer/SRGMediaAnalytics.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalyticsDataProvider/SRGMediaComposition+SRGAnalyticsDataProvider_Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalyticsMediaPlayer/SRGMediaPlaybackActivityAggregator.h
\ No newline at end of file
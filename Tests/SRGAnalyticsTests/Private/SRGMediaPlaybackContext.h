@@ -0,0 +1 @@
+../../../Sources/SRGAnalyticsMediaPlayer/SRGMediaPlaybackContext.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalyticsMediaPlayer/SRGMediaPlaybackDurationAccumulator.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalyticsMediaPlayer/SRGMediaPlaybackStateMachine.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGAnalyticsMediaPlayer/SRGMediaPlayerHeartbeatScheduler.h
\ No newline at end of file
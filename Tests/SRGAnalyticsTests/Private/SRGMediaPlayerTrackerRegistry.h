@@ -0,0 +1 @@
+../../../Sources/SRGAnalyticsMediaPlayer/SRGMediaPlayerTrackerRegistry.h
\ No newline at end of file
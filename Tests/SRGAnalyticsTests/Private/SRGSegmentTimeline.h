@@ -0,0 +1 @@
+../../../Sources/SRGAnalyticsDataProvider/SRGSegmentTimeline.h
\ No newline at end of file
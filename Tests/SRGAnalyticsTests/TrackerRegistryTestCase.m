@@ -0,0 +1,117 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerTrackerRegistry.h"
+
+@import XCTest;
+
+@interface TrackerRegistryTestCase : XCTestCase
+
+@end
+
+@implementation TrackerRegistryTestCase
+
+#pragma mark Tests
+
+- (void)testRegistration
+{
+    SRGMediaPlayerTrackerRegistry *registry = [[SRGMediaPlayerTrackerRegistry alloc] init];
+    SRGMediaPlayerController *mediaPlayerController = [[SRGMediaPlayerController alloc] init];
+    XCTAssertFalse([registry containsMediaPlayerController:mediaPlayerController]);
+    XCTAssertNil([registry trackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController]);
+
+    NSObject *tracker = [[NSObject alloc] init];
+    NSObject *comScoreTracker = [[NSObject alloc] init];
+    [registry setTracker:tracker ofKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
+    [registry setTracker:comScoreTracker ofKind:SRGMediaPlayerTrackerKindComScore forMediaPlayerController:mediaPlayerController];
+    XCTAssertTrue([registry containsMediaPlayerController:mediaPlayerController]);
+    XCTAssertEqual(registry.count, 1);
+    XCTAssertEqual([registry trackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController], tracker);
+    XCTAssertEqual([registry trackerOfKind:SRGMediaPlayerTrackerKindComScore forMediaPlayerController:mediaPlayerController], comScoreTracker);
+
+    XCTAssertEqual([registry removeTrackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController], tracker);
+    XCTAssertNil([registry removeTrackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController]);
+    XCTAssertTrue([registry containsMediaPlayerController:mediaPlayerController]);
+
+    XCTAssertEqual([registry removeTrackerOfKind:SRGMediaPlayerTrackerKindComScore forMediaPlayerController:mediaPlayerController], comScoreTracker);
+    XCTAssertFalse([registry containsMediaPlayerController:mediaPlayerController]);
+    XCTAssertEqual(registry.count, 0);
+}
+
+- (void)testGrowth
+{
+    SRGMediaPlayerTrackerRegistry *registry = [[SRGMediaPlayerTrackerRegistry alloc] init];
+
+    NSMutableArray<SRGMediaPlayerController *> *mediaPlayerControllers = [NSMutableArray array];
+    for (NSInteger i = 0; i < 100; ++i) {
+        SRGMediaPlayerController *mediaPlayerController = [[SRGMediaPlayerController alloc] init];
+        [registry setTracker:@(i) ofKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
+        [mediaPlayerControllers addObject:mediaPlayerController];
+    }
+    XCTAssertEqual(registry.count, 100);
+
+    [mediaPlayerControllers enumerateObjectsUsingBlock:^(SRGMediaPlayerController * _Nonnull mediaPlayerController, NSUInteger idx, BOOL * _Nonnull stop) {
+        XCTAssertEqualObjects([registry trackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController], @(idx));
+        if (idx % 2 == 0) {
+            [registry setTracker:nil ofKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
+        }
+    }];
+    XCTAssertEqual(registry.count, 50);
+}
+
+- (void)testDeallocatedController
+{
+    SRGMediaPlayerTrackerRegistry *registry = [[SRGMediaPlayerTrackerRegistry alloc] init];
+
+    __weak NSObject *weakTracker = nil;
+    @autoreleasepool {
+        SRGMediaPlayerController *mediaPlayerController = [[SRGMediaPlayerController alloc] init];
+        NSObject *tracker = [[NSObject alloc] init];
+        [registry setTracker:tracker ofKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
+        weakTracker = tracker;
+    }
+    XCTAssertEqual(registry.count, 1);
+
+    // New controllers are often allocated at the address of the deallocated one, and must never find its tracker
+    NSMutableArray<SRGMediaPlayerController *> *mediaPlayerControllers = [NSMutableArray array];
+    for (NSInteger i = 0; i < 20; ++i) {
+        SRGMediaPlayerController *mediaPlayerController = [[SRGMediaPlayerController alloc] init];
+        XCTAssertNil([registry trackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController]);
+        [registry setTracker:@(i) ofKind:SRGMediaPlayerTrackerKindComScore forMediaPlayerController:mediaPlayerController];
+        [mediaPlayerControllers addObject:mediaPlayerController];
+    }
+
+    // The registration of the deallocated controller has been discarded, at the latest when the table was resized
+    XCTAssertEqual(registry.count, 20);
+    XCTAssertNil(weakTracker);
+}
+
+- (void)testConcurrentAccess
+{
+    SRGMediaPlayerTrackerRegistry *registry = [[SRGMediaPlayerTrackerRegistry alloc] init];
+
+    NSMutableArray<SRGMediaPlayerController *> *mediaPlayerControllers = [NSMutableArray array];
+    for (NSInteger i = 0; i < 8; ++i) {
+        [mediaPlayerControllers addObject:[[SRGMediaPlayerController alloc] init]];
+    }
+
+    dispatch_apply(1000, DISPATCH_APPLY_AUTO, ^(size_t iteration) {
+        SRGMediaPlayerController *mediaPlayerController = mediaPlayerControllers[iteration % mediaPlayerControllers.count];
+        if (iteration % 3 == 0) {
+            [registry setTracker:@(iteration) ofKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
+        }
+        else if (iteration % 3 == 1) {
+            [registry removeTrackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
+        }
+        else {
+            [registry trackerOfKind:SRGMediaPlayerTrackerKindCommandersAct forMediaPlayerController:mediaPlayerController];
+        }
+    });
+
+    XCTAssertLessThanOrEqual(registry.count, mediaPlayerControllers.count);
+}
+
+@end
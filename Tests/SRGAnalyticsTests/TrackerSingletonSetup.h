@@ -10,4 +10,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 OBJC_EXPORT void SetupTestSingletonTracker(void);
 
+/**
+ *  Change the consent services supplied by the test tracker data source. Set to `nil` to restore the default value.
+ */
+OBJC_EXPORT void SetTestConsentServices(NSString * _Nullable consentServices);
+
 NS_ASSUME_NONNULL_END
@@ -4,8 +4,12 @@
 //  License information is available from the LICENSE file.
 //
 
+#import "TrackerSingletonSetup.h"
+
 @import SRGAnalytics;
 
+static NSString *s_consentServices = nil;
+
 @interface TestDataSource : NSObject <SRGAnalyticsTrackerDataSource>
 
 @end
@@ -19,7 +23,7 @@
         @"cs_ucfr": @"1"
     };
     labels.customInfo = @{
-        @"consent_services": @"service1,service2,service3"
+        @"consent_services": s_consentServices ?: @"service1,service2,service3"
     };
     return labels;
 }
@@ -41,6 +45,11 @@ void SetupTestSingletonTracker(void)
                                                                                                        sourceKey:@"39ae8f94-595c-4ca4-81f7-fb7748bd3f04"
                                                                                                         siteName:@"srg-test-analytics-apple"];
     configuration.unitTesting = YES;
+    
+    // Use a journal of our own, so that events left over by the application or by previous runs are not replayed
+    NSString *journalDirectoryName = [NSString stringWithFormat:@"ch.srgssr.analytics.tests-%@", NSUUID.UUID.UUIDString];
+    configuration.journalDirectoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:journalDirectoryName] isDirectory:YES];
+    
     [SRGAnalyticsTracker.sharedTracker startWithConfiguration:configuration dataSource:dataSource()];
 
     // The comScore SDK caches events recorded during the initial ~5 seconds after it has been initialized. Then events
@@ -48,3 +57,8 @@ void SetupTestSingletonTracker(void)
     // after starting the tracker
     [NSThread sleepForTimeInterval:6.];
 }
+
+void SetTestConsentServices(NSString *consentServices)
+{
+    s_consentServices = consentServices.copy;
+}
@@ -5,6 +5,7 @@
 //
 
 #import "NSNotificationCenter+Tests.h"
+#import "SRGAnalyticsTracker+Private.h"
 #import "TrackerSingletonSetup.h"
 #import "XCTestCase+Tests.h"
 
@@ -79,6 +80,32 @@
     [self waitForExpectationsWithTimeout:20. handler:nil];
 }
 
+- (void)testGlobalLabelsUpdate
+{
+    [self expectationForEventNotificationWithHandler:^BOOL(NSString *event, NSDictionary *labels) {
+        XCTAssertEqualObjects(labels[@"consent_services"], @"service1,service2,service3");
+        return YES;
+    }];
+    
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Event"];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    // Labels are requested from the data source for each event
+    SetTestConsentServices(@"service4");
+    
+    [self expectationForEventNotificationWithHandler:^BOOL(NSString *event, NSDictionary *labels) {
+        XCTAssertEqualObjects(labels[@"consent_services"], @"service4");
+        return YES;
+    }];
+    
+    [SRGAnalyticsTracker.sharedTracker trackEventWithName:@"Event"];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    SetTestConsentServices(nil);
+}
+
 - (void)testEvent
 {
     [self expectationForEventNotificationWithHandler:^BOOL(NSString *event, NSDictionary *labels) {
@@ -264,4 +291,17 @@
     [self waitForExpectationsWithTimeout:20. handler:nil];
 }
 
+- (void)testStartupPhaseDurations
+{
+    NSDictionary<NSString *, NSNumber *> *startupPhaseDurations = SRGAnalyticsTracker.sharedTracker.startupPhaseDurations;
+    for (NSString *phase in @[ @"start", @"comscore", @"commanders_act", @"journal" ]) {
+        XCTAssertNotNil(startupPhaseDurations[phase]);
+        XCTAssertGreaterThanOrEqual(startupPhaseDurations[phase].doubleValue, 0.);
+    }
+    
+    // Both SDKs are started synchronously by default
+    XCTAssertLessThanOrEqual(startupPhaseDurations[@"comscore"].doubleValue + startupPhaseDurations[@"commanders_act"].doubleValue,
+                             startupPhaseDurations[@"start"].doubleValue);
+}
+
 @end
@@ -0,0 +1,199 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGAnalyticsViewControllerIndex.h"
+
+@import XCTest;
+
+@interface ViewControllerIndexTestCase : XCTestCase
+
+@property (nonatomic) SRGAnalyticsViewControllerIndex *index;
+@property (nonatomic) NSHashTable<UIViewController *> *trackedViewControllers;
+@property (nonatomic) NSCountedSet<UIViewController *> *visitedViewControllers;
+
+@end
+
+@implementation ViewControllerIndexTestCase
+
+#pragma mark Helpers
+
+- (UIViewController *)trackedViewController
+{
+    UIViewController *viewController = [[UIViewController alloc] init];
+    [self.trackedViewControllers addObject:viewController];
+    return viewController;
+}
+
+- (NSArray<UIViewController *> *)viewControllersWithRootViewController:(UIViewController *)rootViewController
+{
+    NSMutableArray<UIViewController *> *viewControllers = [NSMutableArray array];
+    [self.index enumerateViewControllersWithRootViewController:rootViewController usingBlock:^(UIViewController * _Nonnull viewController) {
+        [viewControllers addObject:viewController];
+    }];
+    return viewControllers.copy;
+}
+
+#pragma mark Setup and teardown
+
+- (void)setUp
+{
+    self.trackedViewControllers = [NSHashTable weakObjectsHashTable];
+    self.visitedViewControllers = [NSCountedSet set];
+    
+    __weak __typeof(self) weakSelf = self;
+    self.index = [[SRGAnalyticsViewControllerIndex alloc] initWithChildViewControllersBlock:^NSArray<UIViewController *> * _Nonnull(UIViewController * _Nonnull viewController) {
+        [weakSelf.visitedViewControllers addObject:viewController];
+        return viewController.childViewControllers;
+    } trackedBlock:^BOOL(UIViewController * _Nonnull viewController) {
+        return [weakSelf.trackedViewControllers containsObject:viewController];
+    }];
+}
+
+- (void)tearDown
+{
+    self.index = nil;
+    self.trackedViewControllers = nil;
+    self.visitedViewControllers = nil;
+}
+
+#pragma mark Tests
+
+- (void)testLookup
+{
+    UIViewController *rootViewController = [self trackedViewController];
+    UIViewController *containerViewController = [[UIViewController alloc] init];
+    UIViewController *childViewController1 = [self trackedViewController];
+    UIViewController *childViewController2 = [self trackedViewController];
+    UIViewController *childViewController3 = [self trackedViewController];
+    
+    [rootViewController addChildViewController:containerViewController];
+    [rootViewController addChildViewController:childViewController3];
+    [containerViewController addChildViewController:childViewController1];
+    [containerViewController addChildViewController:childViewController2];
+    
+    // Depth-first, children before their parent, untracked view controllers omitted
+    NSArray<UIViewController *> *expectedViewControllers = @[ childViewController1, childViewController2, childViewController3, rootViewController ];
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], expectedViewControllers);
+    XCTAssertEqual([self.visitedViewControllers countForObject:rootViewController], 1);
+    
+    // Unchanged hierarchy is not walked again
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], expectedViewControllers);
+    XCTAssertEqual([self.visitedViewControllers countForObject:rootViewController], 1);
+    
+    // Subtrees can be enumerated on their own and are cached as well
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:containerViewController], (@[ childViewController1, childViewController2 ]));
+    XCTAssertEqual([self.visitedViewControllers countForObject:containerViewController], 1);
+}
+
+- (void)testEmptyHierarchy
+{
+    UIViewController *viewController = [[UIViewController alloc] init];
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:viewController], @[]);
+    
+    UIViewController *trackedViewController = [self trackedViewController];
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:trackedViewController], @[ trackedViewController ]);
+}
+
+- (void)testChildAddition
+{
+    UIViewController *rootViewController = [[UIViewController alloc] init];
+    UIViewController *containerViewController1 = [[UIViewController alloc] init];
+    UIViewController *containerViewController2 = [[UIViewController alloc] init];
+    UIViewController *childViewController1 = [self trackedViewController];
+    
+    [rootViewController addChildViewController:containerViewController1];
+    [rootViewController addChildViewController:containerViewController2];
+    [containerViewController1 addChildViewController:childViewController1];
+    
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], @[ childViewController1 ]);
+    
+    UIViewController *childViewController2 = [self trackedViewController];
+    [containerViewController2 addChildViewController:childViewController2];
+    [self.index invalidateViewController:childViewController2];
+    
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], (@[ childViewController1, childViewController2 ]));
+    
+    // Only the affected subtree is walked again
+    XCTAssertEqual([self.visitedViewControllers countForObject:rootViewController], 2);
+    XCTAssertEqual([self.visitedViewControllers countForObject:containerViewController2], 2);
+    XCTAssertEqual([self.visitedViewControllers countForObject:containerViewController1], 1);
+    XCTAssertEqual([self.visitedViewControllers countForObject:childViewController1], 1);
+}
+
+- (void)testChildRemoval
+{
+    UIViewController *rootViewController = [[UIViewController alloc] init];
+    UIViewController *containerViewController = [[UIViewController alloc] init];
+    UIViewController *childViewController1 = [self trackedViewController];
+    UIViewController *childViewController2 = [self trackedViewController];
+    
+    [rootViewController addChildViewController:containerViewController];
+    [containerViewController addChildViewController:childViewController1];
+    [containerViewController addChildViewController:childViewController2];
+    
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], (@[ childViewController1, childViewController2 ]));
+    
+    // The former parent must be invalidated while the child is still attached to it
+    [self.index invalidateViewController:childViewController1];
+    [childViewController1 removeFromParentViewController];
+    
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], @[ childViewController2 ]);
+    XCTAssertEqual([self.visitedViewControllers countForObject:childViewController2], 1);
+}
+
+- (void)testContainerInvalidation
+{
+    UIViewController *rootViewController = [[UIViewController alloc] init];
+    UIViewController *containerViewController = [[UIViewController alloc] init];
+    UIViewController *childViewController = [self trackedViewController];
+    
+    [rootViewController addChildViewController:containerViewController];
+    
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], @[]);
+    
+    // Stale until invalidated
+    [containerViewController addChildViewController:childViewController];
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], @[]);
+    
+    [self.index invalidateViewController:containerViewController];
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], @[ childViewController ]);
+}
+
+// Inactive children are never visited, and therefore never cached, but invalidating them must still update their parent
+- (void)testUncachedChildInvalidation
+{
+    UIViewController *rootViewController = [self trackedViewController];
+    UIViewController *childViewController = [self trackedViewController];
+    
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], @[ rootViewController ]);
+    
+    [rootViewController addChildViewController:childViewController];
+    [self.index invalidateViewController:childViewController];
+    
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], (@[ childViewController, rootViewController ]));
+}
+
+- (void)testDeallocatedViewController
+{
+    UIViewController *rootViewController = [[UIViewController alloc] init];
+    
+    __weak UIViewController *weakChildViewController = nil;
+    @autoreleasepool {
+        UIViewController *childViewController = [self trackedViewController];
+        weakChildViewController = childViewController;
+        [rootViewController addChildViewController:childViewController];
+        XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], @[ childViewController ]);
+        
+        [childViewController removeFromParentViewController];
+        [self.visitedViewControllers removeAllObjects];
+    }
+    
+    // View controllers are not retained by the index, and deallocated ones are skipped
+    XCTAssertNil(weakChildViewController);
+    XCTAssertEqualObjects([self viewControllersWithRootViewController:rootViewController], @[]);
+}
+
+@end